@@ -0,0 +1,175 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file align.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_ALIGN_H_
+#define BARRETT_LOG_ALIGN_H_
+
+
+#include <string>
+#include <vector>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/segmented_reader.h>
+
+
+namespace barrett {
+namespace log {
+
+
+/// A log that log::align() can read: a schema and random access to channels.
+class AlignInput {
+public:
+	virtual ~AlignInput() {}
+
+	virtual const Schema& getSchema() const = 0;
+	virtual size_t numRecords() const = 0;
+	/// See ColumnReader::readChannel(). Only called from one thread at a time.
+	virtual void readChannel(size_t channel, double* dest, size_t first, size_t count) const = 0;
+};
+
+/// Opens a log with a ReaderType such as ColumnReader or SegmentedReader.
+template<typename ReaderType>
+class ReaderAlignInput : public AlignInput {
+public:
+	explicit ReaderAlignInput(const char* fileName) : reader(fileName) {}
+
+	const ReaderType& getReader() const {  return reader;  }
+
+	virtual const Schema& getSchema() const {  return reader.getSchema();  }
+	virtual size_t numRecords() const {  return reader.numRecords();  }
+	virtual void readChannel(size_t channel, double* dest, size_t first, size_t count) const {
+		reader.readChannel(channel, dest, first, count);
+	}
+
+protected:
+	ReaderType reader;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(ReaderAlignInput);
+};
+
+typedef ReaderAlignInput<ColumnReader> ColumnLogInput;
+typedef ReaderAlignInput<SegmentedReader> SegmentedLogInput;
+
+/** A raw log (as written by log::Writer or log::RealTimeWriter), memory-
+ * mapped. schema must describe its records; see Traits::describe() and
+ * Schema::fromFormat().
+ */
+class RawLogInput : public AlignInput {
+public:
+	/// Throws std::runtime_error if the file can't be mapped or isn't a whole number of records.
+	RawLogInput(const char* fileName, const Schema& schema);
+	virtual ~RawLogInput();
+
+	virtual const Schema& getSchema() const {  return schema;  }
+	virtual size_t numRecords() const {  return recordCount;  }
+	virtual void readChannel(size_t channel, double* dest, size_t first, size_t count) const;
+
+protected:
+	Schema schema;
+	char* data;
+	size_t size;
+	size_t recordCount;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(RawLogInput);
+};
+
+
+/// One of the logs given to log::align().
+struct AlignSource {
+	/** Channels of input are written as "<name>.<channel>" (e.g.
+	 * "hand.jp[2]"). timeChannel holds each record's timestamp; the
+	 * timestamps must not decrease.
+	 */
+	AlignSource(const AlignInput* input_, const std::string& name_, const std::string& timeChannel_ = "time") :
+		input(input_), name(name_), timeChannel(timeChannel_) {}
+
+	const AlignInput* input;
+	std::string name;
+	std::string timeChannel;
+};
+
+struct AlignOptions {
+	enum Method {
+		HOLD,  ///< The most recent sample
+		LINEAR,
+		CUBIC  ///< A Catmull-Rom (cubic Hermite) spline through the samples
+	};
+
+	AlignOptions() :
+		period(0.0), method(LINEAR), unionOfSpans(false), numThreads(0),
+		recordsPerBlock(4096), columnOptions() {}
+
+	/** The output's sample period. If it's zero, the output has a record at
+	 * every timestamp of every input, merged in order.
+	 */
+	double period;
+	/// How floating-point channels are resampled. Other channels are always held.
+	Method method;
+	/** If true, the output spans from the earliest input's start to the
+	 * latest one's end, and channels are NaN where their log has no data.
+	 * Otherwise it only spans the time that all the inputs cover.
+	 */
+	bool unionOfSpans;
+	size_t numThreads;  ///< Zero means one per core
+	size_t recordsPerBlock;  ///< Of the output, which is resampled a block at a time
+	ColumnOptions columnOptions;  ///< The output's compression. fieldNames is ignored.
+};
+
+/** Resamples several logs onto a common time base and writes the result as
+ * a single column log (see log::ColumnReader) with a "time" channel followed
+ * by the other channels of each source, as doubles. Returns the number of
+ * records written.
+ *
+ * The inputs are read a block of output records at a time, so memory use
+ * doesn't grow with their length. Within a block, the channels are resampled
+ * in parallel.
+ *
+ * Throws std::runtime_error if an input is empty, and std::logic_error if
+ * the sources' names collide or don't have their time channels.
+ */
+/** Resamples the sources onto one time base and writes them to outputFile as
+ * a column log, with a "time" channel followed by each source's channels.
+ * The inputs are read a block at a time, so they can be much larger than
+ * memory. Returns the number of records written.
+ */
+size_t align(const std::vector<AlignSource>& sources, const char* outputFile, const AlignOptions& options = AlignOptions());
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_ALIGN_H_ */
@@ -0,0 +1,94 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file column_options.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_COLUMN_OPTIONS_H_
+#define BARRETT_LOG_COLUMN_OPTIONS_H_
+
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <barrett/log/schema.h>
+
+
+namespace barrett {
+namespace log {
+
+
+/** How a log::ColumnWriter or log::RealTimeWriter lays out a column log.
+ *
+ * If compress is true, each block is packed channel by channel: integers as
+ * varint-coded deltas from the previous record, and floating-point values
+ * either XORed with the previous record (exact) or rounded to a multiple of
+ * their resolution and delta-coded (lossy, but much smaller for smoothly
+ * varying signals such as joint positions). Channels that don't shrink are
+ * stored raw. log::ColumnReader decodes blocks transparently.
+ */
+struct ColumnOptions {
+	/** fieldNames is passed to Traits::describe() (see Schema::elementName()).
+	 * resolution is the default quantization step for floating-point fields;
+	 * zero keeps them exact.
+	 */
+	explicit ColumnOptions(const std::string& fieldNames_ = "", bool compress_ = true, double resolution_ = 0.0) :
+		fieldNames(fieldNames_), compress(compress_), resolution(resolution_), fieldResolutions() {}
+
+	/// Overrides the default resolution for one field, such as "jp".
+	ColumnOptions& setResolution(const std::string& field, double r) {
+		fieldResolutions[field] = r;
+		return *this;
+	}
+
+	/// The quantization step of each of schema's channels.
+	std::vector<double> channelResolutions(const Schema& schema) const {
+		std::vector<double> r(schema.numChannels(), 0.0);
+		for (size_t i = 0; i < schema.numChannels(); ++i) {
+			const Schema::Channel& c = schema.channel(i);
+			if (c.type == Schema::FLOAT64  ||  c.type == Schema::FLOAT32) {
+				std::map<std::string, double>::const_iterator it = fieldResolutions.find(schema.field(c.field).name);
+				r[i] = (it == fieldResolutions.end()) ? resolution : it->second;
+			}
+		}
+		return r;
+	}
+
+	std::string fieldNames;
+	bool compress;
+	double resolution;
+	std::map<std::string, double> fieldResolutions;
+};
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_COLUMN_OPTIONS_H_ */
@@ -0,0 +1,155 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file column_reader.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_COLUMN_READER_H_
+#define BARRETT_LOG_COLUMN_READER_H_
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/schema.h>
+
+
+namespace barrett {
+namespace log {
+
+
+/** Reads a log written by log::ColumnWriter.
+ *
+ * The file is memory-mapped and its schema is read from the header, so any
+ * column log can be opened without knowing the type that was logged.
+ * readChannel() only touches the pages that hold the requested channel.
+ * Compressed blocks (see log::ColumnOptions) are decoded as they're read.
+ *
+ * A block that was cut short (e.g. because the writer crashed) is ignored,
+ * along with anything after it.
+ */
+class ColumnReader {
+public:
+	explicit ColumnReader(const char* fileName);
+	~ColumnReader();
+
+	const Schema& getSchema() const {  return schema;  }
+	size_t numRecords() const {  return recordCount;  }
+
+	/** Converts channel values (of records [first, first + count)) to doubles
+	 * and appends them to dest. Throws std::out_of_range if the records don't
+	 * exist.
+	 */
+	void readChannel(size_t channel, std::vector<double>* dest, size_t first, size_t count) const;
+	/// Writes the count values to dest instead of appending them to a vector.
+	void readChannel(size_t channel, double* dest, size_t first, size_t count) const;
+	void readChannel(size_t channel, std::vector<double>* dest) const {
+		readChannel(channel, dest, 0, numRecords());
+	}
+	/// channel is a name, such as "time" or "jt[3]". See Schema::findChannel().
+	void readChannel(const std::string& channel, std::vector<double>* dest) const {
+		readChannel(schema.findChannel(channel), dest);
+	}
+	void readChannel(const std::string& channel, std::vector<double>* dest, size_t first, size_t count) const {
+		readChannel(schema.findChannel(channel), dest, first, count);
+	}
+
+	/// Copies record i into dest in the layout that Traits::serialize() produced.
+	void readRecord(size_t i, char* dest) const;
+
+	/// Throws std::logic_error if the records are not TraitsType::serializedLength() bytes long.
+	template<typename T, typename TraitsType> T getRecord(size_t i) const;
+	template<typename T> T getRecord(size_t i) const {
+		return getRecord<T, Traits<T> >(i);
+	}
+
+	size_t numBlocks() const {  return blocks.size();  }
+	size_t blockFirstRecord(size_t b) const {  return blocks[b].firstRecord;  }
+	size_t blockNumRecords(size_t b) const {  return blocks[b].numRecords;  }
+	/** Returns block b as a raw payload (see detail/column_format.h),
+	 * decoding it into buffer if it's packed. Unlike the other read methods,
+	 * this is safe to call from several threads at once (with different
+	 * buffers).
+	 */
+	const char* readBlock(size_t b, std::vector<char>* buffer) const;
+
+	void close();
+
+protected:
+	struct Block {
+		size_t firstRecord, numRecords;
+		int encoding;
+		const char* payload;
+		size_t payloadLength;
+	};
+
+	const Block& findBlock(size_t record) const;
+	// A pointer to the n values of channel c in b, decoding them if needed.
+	const char* channelData(const Block& b, size_t c) const;
+	// A raw payload for b, decoding it if needed.
+	const char* rawPayload(const Block& b) const;
+
+	int fd;
+	char* data;
+	size_t size;
+
+	Schema schema;
+	std::vector<Block> blocks;
+	size_t recordCount;
+	mutable std::vector<char> row;
+
+	// Decoded data of packed blocks
+	mutable std::vector<char> channelBuffer;
+	mutable std::vector<char> blockBuffer;
+	mutable const Block* bufferedBlock;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(ColumnReader);
+};
+
+
+template<typename T, typename TraitsType>
+T ColumnReader::getRecord(size_t i) const
+{
+	if (TraitsType::serializedLength() != schema.recordLength()) {
+		throw(std::logic_error("(log::ColumnReader::getRecord()): The file does not contain this type of data."));
+	}
+
+	readRecord(i, &row[0]);
+	return TraitsType::unserialize(&row[0]);
+}
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_COLUMN_READER_H_ */
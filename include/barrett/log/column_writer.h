@@ -0,0 +1,107 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file column_writer.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_COLUMN_WRITER_H_
+#define BARRETT_LOG_COLUMN_WRITER_H_
+
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+/** Writes a self-describing, column-oriented log.
+ *
+ * The file starts with a log::Schema built by Traits::describe(), and the
+ * records follow in blocks of recordsPerBlock. Within a block, each channel
+ * (e.g. "jt[3]") is stored contiguously, so a log::ColumnReader can load one
+ * channel without reading the others, and can open the file without knowing
+ * T. Blocks may also be compressed; see log::ColumnOptions.
+ *
+ * Like log::Writer, this class is not real-time safe.
+ */
+template<typename T, typename Traits = Traits<T> >
+class ColumnWriter {
+public:
+	typedef typename Traits::parameter_type parameter_type;
+	static const size_t DEFAULT_RECORDS_PER_BLOCK = 1024;
+
+	/** fieldNames is passed on to Traits::describe(). For tuples, it may be a
+	 * comma-separated list (e.g. "time,jp,jt"). samplePeriod is recorded in
+	 * the schema; use zero if it's unknown.
+	 */
+	explicit ColumnWriter(const char* fileName, const std::string& fieldNames = "",
+			double samplePeriod = 0.0, size_t recordsPerBlock = DEFAULT_RECORDS_PER_BLOCK);
+	ColumnWriter(const char* fileName, const ColumnOptions& options,
+			double samplePeriod = 0.0, size_t recordsPerBlock = DEFAULT_RECORDS_PER_BLOCK);
+	~ColumnWriter();
+
+	const Schema& getSchema() const {  return encoder.getSchema();  }
+
+	void putRecord(parameter_type data);
+	/// Writes the buffered records as a (short) block.
+	void flush();
+	void close();
+
+protected:
+	void writeHeader();
+
+	std::ofstream file;
+	size_t recordLength, recordsPerBlock;
+	detail::BlockEncoder encoder;
+
+	std::vector<char> rows;
+	size_t numBuffered;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(ColumnWriter);
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/log/detail/column_writer-inl.h>
+
+
+#endif /* BARRETT_LOG_COLUMN_WRITER_H_ */
@@ -0,0 +1,87 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file csv_export.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_CSV_EXPORT_H_
+#define BARRETT_LOG_CSV_EXPORT_H_
+
+
+#include <string>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/column_reader.h>
+
+
+namespace barrett {
+namespace log {
+
+
+struct CSVOptions {
+	CSVOptions() : numThreads(0), precision(10), header(true), recordsPerChunk(16384) {}
+
+	size_t numThreads;  ///< Zero means one per core
+	int precision;  ///< Significant digits, as with printf()'s %g
+	bool header;  ///< Start with a line of channel names
+	size_t recordsPerChunk;  ///< For raw logs. Column logs are split at their blocks.
+};
+
+
+/** Converts a column log to CSV, one line per record and one column per
+ * channel.
+ *
+ * The records are split into chunks that are formatted in parallel into
+ * per-thread buffers, then written to csvFile in order. Numbers are
+ * formatted the way printf("%.*g") would, without going through iostreams
+ * or the C locale.
+ */
+void exportCSV(const ColumnReader& reader, const char* csvFile, const CSVOptions& options = CSVOptions());
+void exportCSV(const char* columnLogFile, const char* csvFile, const CSVOptions& options = CSVOptions());
+
+/** Converts a raw log (as written by log::Writer or log::RealTimeWriter)
+ * to CSV. schema must describe its records; see Traits::describe().
+ */
+void exportRawCSV(const char* rawLogFile, const Schema& schema, const char* csvFile, const CSVOptions& options = CSVOptions());
+
+
+namespace detail {
+
+/** Writes x to dest as printf("%.*g", precision, x) would and returns the
+ * number of characters written (at most 32; no terminating NUL).
+ */
+size_t formatDouble(double x, int precision, char* dest);
+
+}
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_CSV_EXPORT_H_ */
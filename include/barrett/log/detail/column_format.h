@@ -0,0 +1,173 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file column_format.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_DETAIL_COLUMN_FORMAT_H_
+#define BARRETT_LOG_DETAIL_COLUMN_FORMAT_H_
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/column_options.h>
+
+
+namespace barrett {
+namespace log {
+namespace detail {
+
+
+// The layout of a column log (all integers in host byte order):
+//
+//   char[8]  "BTLOGCOL"
+//   uint32   format version
+//   uint32   records per full block
+//   uint32   schema length, followed by the Schema::serialize()d schema
+//
+// followed by any number of blocks, each of which is a BlockHeader and a
+// payload. A raw payload holds numRecords values of the first channel, then
+// numRecords values of the second channel, and so on, so channel c of a
+// block starts numRecords * channel(c).offset bytes into the payload.
+//
+// A packed payload starts with a PackedChannelHeader for each channel,
+// followed by the data of each channel in turn, coded as described by its
+// header. Varints are unsigned LEB128 and signed values are zigzag coded.
+
+const char COLUMN_LOG_MAGIC[] = "BTLOGCOL";
+const size_t COLUMN_LOG_MAGIC_LENGTH = 8;
+const boost::uint32_t COLUMN_LOG_VERSION = 1;
+
+enum BlockEncoding {
+	RAW_ENCODING = 0,
+	PACKED_ENCODING = 1
+};
+
+struct BlockHeader {
+	boost::uint32_t numRecords;
+	boost::uint32_t payloadLength;
+	boost::uint8_t encoding;
+	boost::uint8_t reserved[3];
+};
+const size_t BLOCK_HEADER_LENGTH = 12;
+
+enum ChannelCoding {
+	RAW_CODING = 0,  // numRecords values, as in a raw payload
+	DELTA_CODING = 1,  // Integers: a varint of the difference from the previous value (starting from 0)
+	XOR_CODING = 2,  // Floating-point: a varint of the bits XORed with the previous value's (starting from 0)
+	QUANTIZED_CODING = 3  // Floating-point: a double resolution r, then DELTA_CODING of round(value / r)
+};
+
+struct PackedChannelHeader {
+	boost::uint8_t coding;
+	boost::uint8_t reserved[3];
+	boost::uint32_t length;  // Of the channel's data
+};
+const size_t PACKED_CHANNEL_HEADER_LENGTH = 8;
+
+
+/// The schema of records serialized by Traits, checked against Traits::serializedLength().
+template<typename Traits>
+Schema describe(const std::string& fieldNames, double samplePeriod)
+{
+	if (Traits::serializedLength() == 0) {
+		throw(std::logic_error("(log::detail::describe()): The record length "
+				"(Traits::serializedLength()) cannot be zero."));
+	}
+
+	Schema schema(samplePeriod);
+	Traits::describe(fieldNames, &schema);
+	if (schema.recordLength() != Traits::serializedLength()) {
+		throw(std::logic_error("(log::detail::describe()): Traits::describe() "
+				"doesn't agree with Traits::serializedLength()."));
+	}
+	return schema;
+}
+
+void writeColumnLogHeader(const Schema& schema, size_t recordsPerBlock, std::vector<char>* buffer);
+bool isColumnLog(const char* source, size_t size);
+/// Returns the length of the header. Throws std::runtime_error if source doesn't start with a valid header.
+size_t readColumnLogHeader(const char* source, size_t size, Schema* schema, size_t* recordsPerBlock);
+
+/// Transposes n records (in the layout Traits::serialize() produces) into a raw payload.
+void rowsToColumns(const Schema& schema, const char* rows, size_t n, char* payload);
+/// Gathers record i back out of a raw payload of n records.
+void columnsToRow(const Schema& schema, const char* payload, size_t n, size_t i, char* row);
+
+/// An upper bound on the length of a packed payload of n records.
+size_t maxPackedLength(const Schema& schema, size_t n);
+/** Packs n records (in the layout Traits::serialize() produces) into a
+ * packed payload and returns its length. resolutions holds the quantization
+ * step of each channel, or zero for exact coding.
+ */
+size_t packRows(const Schema& schema, const double* resolutions, const char* rows, size_t n, char* payload);
+/** Unpacks channel c of a packed payload of n records into n contiguous
+ * values (as they'd appear in a raw payload). Throws std::runtime_error if
+ * the payload is corrupt.
+ */
+void unpackChannel(const Schema& schema, const char* payload, size_t length, size_t n, size_t c, char* dest);
+
+
+// Turns buffers of records into blocks, as options dictate. Allocates
+// everything it needs up front.
+class BlockEncoder {
+public:
+	BlockEncoder(const Schema& schema, const ColumnOptions& options, size_t maxRecords);
+
+	const Schema& getSchema() const {  return schema;  }
+	/// Appends the file header to buffer.
+	void writeHeader(std::vector<char>* buffer) const;
+
+	/// Encodes n <= maxRecords records as a block (header included) and returns its length. The block is at data().
+	size_t encode(const char* rows, size_t n);
+	const char* data() const {  return &block[0];  }
+
+protected:
+	Schema schema;
+	bool compress;
+	std::vector<double> resolutions;
+	size_t maxRecords;
+	std::vector<char> block;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(BlockEncoder);
+};
+
+
+}
+}
+}
+
+
+#endif /* BARRETT_LOG_DETAIL_COLUMN_FORMAT_H_ */
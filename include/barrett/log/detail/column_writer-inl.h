@@ -0,0 +1,112 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file column_writer-inl.h
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+template<typename T, typename Traits>
+ColumnWriter<T, Traits>::ColumnWriter(const char* fileName, const std::string& fieldNames,
+		double samplePeriod, size_t recordsPerBlock_) :
+	file(fileName, std::ios_base::binary),
+	recordLength(Traits::serializedLength()), recordsPerBlock(recordsPerBlock_),
+	encoder(detail::describe<Traits>(fieldNames, samplePeriod), ColumnOptions(fieldNames, false), recordsPerBlock_),
+	rows(recordLength * recordsPerBlock), numBuffered(0)
+{
+	writeHeader();
+}
+
+template<typename T, typename Traits>
+ColumnWriter<T, Traits>::ColumnWriter(const char* fileName, const ColumnOptions& options,
+		double samplePeriod, size_t recordsPerBlock_) :
+	file(fileName, std::ios_base::binary),
+	recordLength(Traits::serializedLength()), recordsPerBlock(recordsPerBlock_),
+	encoder(detail::describe<Traits>(options.fieldNames, samplePeriod), options, recordsPerBlock_),
+	rows(recordLength * recordsPerBlock), numBuffered(0)
+{
+	writeHeader();
+}
+
+template<typename T, typename Traits>
+ColumnWriter<T, Traits>::~ColumnWriter()
+{
+	if (file.is_open()) {
+		close();
+	}
+}
+
+template<typename T, typename Traits>
+void ColumnWriter<T, Traits>::writeHeader()
+{
+	std::vector<char> header;
+	encoder.writeHeader(&header);
+	file.write(&header[0], header.size());
+}
+
+template<typename T, typename Traits>
+inline void ColumnWriter<T, Traits>::putRecord(parameter_type data)
+{
+	Traits::serialize(data, &rows[numBuffered * recordLength]);
+	if (++numBuffered == recordsPerBlock) {
+		flush();
+	}
+}
+
+template<typename T, typename Traits>
+void ColumnWriter<T, Traits>::flush()
+{
+	if (numBuffered == 0) {
+		return;
+	}
+
+	file.write(encoder.data(), encoder.encode(&rows[0], numBuffered));
+	numBuffered = 0;
+}
+
+template<typename T, typename Traits>
+inline void ColumnWriter<T, Traits>::close()
+{
+	flush();
+	file.close();
+}
+
+
+}
+}
@@ -110,7 +110,7 @@ void Reader<T, Traits>::exportCSV(std::ostream& os)
 	try {
 		for (size_t i = 0; i < numRecords(); ++i) {
 			Traits::asCSV(getRecord(), os);
-			os << std::endl;
+			os << '\n';
 		}
 	} catch (std::underflow_error) {}
 }
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
@@ -51,8 +52,51 @@ template<typename T, typename Traits>
 RealTimeWriter<T, Traits>::RealTimeWriter(const char* fileName, double recordPeriod_s, int priority_) :
 	Writer<T, Traits>(fileName), period(0.0), singleBufferSize(0),
 	inBuff(NULL), outBuff(NULL), endInBuff(NULL), endOutBuff(NULL), currentPos(NULL), writeToDisk(false),
-	thread(), priority(priority_)
+	thread(), priority(priority_), encoder(NULL)
 {
+	init(recordsForPeriod(recordPeriod_s));
+}
+
+template<typename T, typename Traits>
+RealTimeWriter<T, Traits>::RealTimeWriter(const char* fileName, double approxPeriod_s, size_t recordsInSingleBuffer, int priority_) :
+	Writer<T, Traits>(fileName), period(approxPeriod_s),
+	inBuff(NULL), outBuff(NULL), endInBuff(NULL), endOutBuff(NULL), currentPos(NULL), writeToDisk(false),
+	thread(), priority(priority_), encoder(NULL)
+{
+	init(recordsInSingleBuffer);
+}
+
+template<typename T, typename Traits>
+RealTimeWriter<T, Traits>::RealTimeWriter(const char* fileName, double recordPeriod_s, const ColumnOptions& options, int priority_) :
+	Writer<T, Traits>(fileName), period(0.0), singleBufferSize(0),
+	inBuff(NULL), outBuff(NULL), endInBuff(NULL), endOutBuff(NULL), currentPos(NULL), writeToDisk(false),
+	thread(), priority(priority_), encoder(NULL)
+{
+	size_t recordsInSingleBuffer = recordsForPeriod(recordPeriod_s);
+	initColumnLog(options, recordPeriod_s, recordsInSingleBuffer);
+	init(recordsInSingleBuffer);
+}
+
+template<typename T, typename Traits>
+RealTimeWriter<T, Traits>::RealTimeWriter(const char* fileName, double approxPeriod_s, size_t recordsInSingleBuffer, const ColumnOptions& options, int priority_) :
+	Writer<T, Traits>(fileName), period(approxPeriod_s),
+	inBuff(NULL), outBuff(NULL), endInBuff(NULL), endOutBuff(NULL), currentPos(NULL), writeToDisk(false),
+	thread(), priority(priority_), encoder(NULL)
+{
+	initColumnLog(options, 0.0, recordsInSingleBuffer);
+	init(recordsInSingleBuffer);
+}
+
+template<typename T, typename Traits>
+RealTimeWriter<T, Traits>::RealTimeWriter(double approxPeriod_s, int priority_) :
+	Writer<T, Traits>(), period(approxPeriod_s), singleBufferSize(0),
+	inBuff(NULL), outBuff(NULL), endInBuff(NULL), endOutBuff(NULL), currentPos(NULL), writeToDisk(false),
+	thread(), priority(priority_), encoder(NULL)
+{
+}
+
+template<typename T, typename Traits>
+size_t RealTimeWriter<T, Traits>::recordsForPeriod(double recordPeriod_s) {
 	if (this->recordLength > 1024) {
 		throw(std::logic_error("(log::RealTimeWriter::RealTimeWriter()): This constructor was not designed for records this big."));
 	}
@@ -67,16 +111,17 @@ RealTimeWriter<T, Traits>::RealTimeWriter(const char* fileName, double recordPer
 	}
 	period = std::min(period, 1.0);  // limit period to a maximum of 1 second
 
-	init(recordsInSingleBuffer);
+	return recordsInSingleBuffer;
 }
 
+// Only instantiated for column logs, so raw logs don't need Traits::describe().
 template<typename T, typename Traits>
-RealTimeWriter<T, Traits>::RealTimeWriter(const char* fileName, double approxPeriod_s, size_t recordsInSingleBuffer, int priority_) :
-	Writer<T, Traits>(fileName), period(approxPeriod_s),
-	inBuff(NULL), outBuff(NULL), endInBuff(NULL), endOutBuff(NULL), currentPos(NULL), writeToDisk(false),
-	thread(), priority(priority_)
-{
-	init(recordsInSingleBuffer);
+void RealTimeWriter<T, Traits>::initColumnLog(const ColumnOptions& options, double samplePeriod, size_t recordsInSingleBuffer) {
+	encoder = new detail::BlockEncoder(detail::describe<Traits>(options.fieldNames, samplePeriod), options, recordsInSingleBuffer);
+
+	std::vector<char> header;
+	encoder->writeHeader(&header);
+	this->file.write(&header[0], header.size());
 }
 
 template<typename T, typename Traits>
@@ -104,12 +149,21 @@ RealTimeWriter<T, Traits>::~RealTimeWriter()
 	if (this->file.is_open()) {
 		close();
 	}
+
+	delete encoder;
+	encoder = NULL;
 }
 
 template<typename T, typename Traits>
 void RealTimeWriter<T, Traits>::putRecord(parameter_type data)
 {
-	Traits::serialize(data, currentPos);
+	Traits::serialize(data, beginRecord());
+	endRecord();
+}
+
+template<typename T, typename Traits>
+inline void RealTimeWriter<T, Traits>::endRecord()
+{
 	currentPos += this->recordLength;
 
 	if (currentPos >= endInBuff) {
@@ -131,11 +185,12 @@ void RealTimeWriter<T, Traits>::close()
 	thread.join();
 
 	if (writeToDisk) {
-		this->file.write(outBuff, singleBufferSize);
+		writeBuffer(outBuff, singleBufferSize);
 		writeToDisk = false;
 	}
 	if (currentPos != inBuff) {
-		this->file.write(inBuff, currentPos - inBuff);
+		writeBuffer(inBuff, currentPos - inBuff);
+		currentPos = inBuff;
 	}
 
 	this->Writer<T, Traits>::close();
@@ -148,12 +203,22 @@ void RealTimeWriter<T, Traits>::writeToDiskEntryPoint()
 	while ( !boost::this_thread::interruption_requested() ) {
 		loopTimer.wait();
 		if (writeToDisk) {
-			this->file.write(outBuff, singleBufferSize);
+			writeBuffer(outBuff, singleBufferSize);
 			writeToDisk = false;
 		}
 	}
 }
 
+template<typename T, typename Traits>
+void RealTimeWriter<T, Traits>::writeBuffer(const char* buff, size_t length)
+{
+	if (encoder == NULL) {
+		this->file.write(buff, length);
+	} else {
+		this->file.write(encoder->data(), encoder->encode(buff, length / this->recordLength));
+	}
+}
+
 
 }
 }
@@ -0,0 +1,136 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file segmented_format.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_DETAIL_SEGMENTED_FORMAT_H_
+#define BARRETT_LOG_DETAIL_SEGMENTED_FORMAT_H_
+
+
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace log {
+
+struct SegmentOptions;
+
+namespace detail {
+
+
+// A segmented log called <base> is a series of column logs (segments)
+// called <base>.000000.log, <base>.000001.log, ... that all have the same
+// schema, plus an index called <base>.index (all integers in host byte
+// order):
+//
+//   char[8]  "BTLOGIDX"
+//   uint32   format version
+//   int32    time channel, or -1 if record i was taken at i * sample period
+//
+// followed by a SegmentIndexEntry for each block, in the order the blocks
+// were written. An entry is only appended once its block is in the segment,
+// and a segment is synced to disk before the next one is started, so every
+// entry refers to a complete block.
+
+const char SEGMENT_INDEX_MAGIC[] = "BTLOGIDX";
+const size_t SEGMENT_INDEX_MAGIC_LENGTH = 8;
+const boost::uint32_t SEGMENT_INDEX_VERSION = 1;
+const size_t SEGMENT_INDEX_HEADER_LENGTH = 16;
+
+struct SegmentIndexEntry {
+	boost::uint32_t segment;
+	boost::uint32_t numRecords;
+	boost::uint64_t offset;  // Of the BlockHeader, in bytes from the start of the segment
+	boost::uint64_t firstRecord;  // Counting from the start of the first segment
+	double firstTime, lastTime;  // Of the first and last records in the block
+};
+const size_t SEGMENT_INDEX_ENTRY_LENGTH = 40;
+
+std::string segmentFileName(const std::string& baseName, size_t segment);
+std::string segmentIndexFileName(const std::string& baseName);
+
+
+// Writes blocks of records to a segmented log, starting a new segment when
+// the current one reaches options.maxSegmentBytes or
+// options.maxSegmentDuration. Used by log::SegmentedWriter's disk thread;
+// none of this is real-time safe.
+class SegmentedLogFiles {
+public:
+	/// Throws std::runtime_error if the first segment or the index can't be created.
+	SegmentedLogFiles(const std::string& baseName, const Schema& schema, const SegmentOptions& options, size_t maxRecords);
+	~SegmentedLogFiles();
+
+	const Schema& getSchema() const {  return encoder.getSchema();  }
+	size_t numSegments() const {  return segment + 1;  }
+	boost::uint64_t numRecords() const {  return recordCount;  }
+
+	/// Encodes n <= maxRecords records (in the layout Traits::serialize() produces) as a block.
+	void writeBlock(const char* rows, size_t n);
+	/// Syncs and closes the current segment and the index.
+	void close();
+
+protected:
+	double recordTime(const char* row, boost::uint64_t record) const;
+	void openSegment();
+	void closeSegment();
+
+	std::string baseName;
+	int timeChannel;  // -1 for record number * sample period
+	size_t recordLength;
+	boost::uint64_t maxSegmentBytes;
+	double maxSegmentDuration;
+
+	BlockEncoder encoder;
+	std::vector<char> header;
+
+	int indexFd, segmentFd;
+	size_t segment;
+	boost::uint64_t segmentBytes;
+	size_t segmentBlocks;
+	double segmentStartTime;
+	boost::uint64_t recordCount;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(SegmentedLogFiles);
+};
+
+
+}
+}
+}
+
+
+#endif /* BARRETT_LOG_DETAIL_SEGMENTED_FORMAT_H_ */
@@ -0,0 +1,92 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file segmented_writer-inl.h
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+template<typename T, typename Traits>
+SegmentedWriter<T, Traits>::SegmentedWriter(const char* baseName, double recordPeriod_s, const SegmentOptions& options, int priority_) :
+	RealTimeWriter<T, Traits>(0.0, priority_), files(NULL)
+{
+	size_t recordsInSingleBuffer = this->recordsForPeriod(recordPeriod_s);
+	initFiles(baseName, options, recordPeriod_s, recordsInSingleBuffer);
+	this->init(recordsInSingleBuffer);
+}
+
+template<typename T, typename Traits>
+SegmentedWriter<T, Traits>::SegmentedWriter(const char* baseName, double approxPeriod_s, size_t recordsInSingleBuffer, const SegmentOptions& options, int priority_) :
+	RealTimeWriter<T, Traits>(approxPeriod_s, priority_), files(NULL)
+{
+	initFiles(baseName, options, 0.0, recordsInSingleBuffer);
+	this->init(recordsInSingleBuffer);
+}
+
+template<typename T, typename Traits>
+void SegmentedWriter<T, Traits>::initFiles(const char* baseName, const SegmentOptions& options, double samplePeriod, size_t recordsInSingleBuffer) {
+	files = new detail::SegmentedLogFiles(baseName,
+			detail::describe<Traits>(options.columnOptions.fieldNames, samplePeriod), options, recordsInSingleBuffer);
+}
+
+template<typename T, typename Traits>
+SegmentedWriter<T, Traits>::~SegmentedWriter()
+{
+	close();
+}
+
+template<typename T, typename Traits>
+void SegmentedWriter<T, Traits>::close()
+{
+	if (files == NULL) {
+		return;
+	}
+
+	// Stops the disk thread and flushes both buffers through writeBuffer().
+	this->RealTimeWriter<T, Traits>::close();
+
+	files->close();
+	delete files;
+	files = NULL;
+}
+
+template<typename T, typename Traits>
+void SegmentedWriter<T, Traits>::writeBuffer(const char* buff, size_t length)
+{
+	files->writeBlock(buff, length / this->recordLength);
+}
+
+
+}
+}
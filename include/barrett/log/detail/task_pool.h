@@ -0,0 +1,96 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file task_pool.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_DETAIL_TASK_POOL_H_
+#define BARRETT_LOG_DETAIL_TASK_POOL_H_
+
+
+#include <boost/exception_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+#include <barrett/detail/ca_macro.h>
+
+
+namespace barrett {
+namespace log {
+namespace detail {
+
+
+// Runs batches of tasks on a set of worker threads. Used by the offline log
+// tools (exportCSV(), align()), not in real time.
+//
+// start() hands f(0) through f(n - 1) to the workers and returns right away,
+// so the caller can do something else (like write out the previous batch)
+// in the meantime. wait() helps with whatever is left and returns once every
+// task has finished. If a task throws, the tasks that haven't started are
+// skipped and wait() rethrows the first exception in the caller's thread.
+class TaskPool {
+public:
+	// numThreads counts the caller, which works during wait(). Zero means one
+	// per core.
+	explicit TaskPool(size_t numThreads);
+	~TaskPool();
+
+	size_t numThreads() const {  return workers.size() + 1;  }
+
+	void start(const boost::function<void (size_t)>& f, size_t n);
+	void wait();
+	void run(const boost::function<void (size_t)>& f, size_t n) {
+		start(f, n);
+		wait();
+	}
+
+protected:
+	void workerEntryPoint();
+	void work();
+
+	boost::mutex mutex;
+	boost::condition_variable cond, done;
+	boost::thread_group workers;
+
+	boost::function<void (size_t)> task;
+	size_t numTasks, nextTask, unfinished;
+	size_t generation;
+	bool stopping;
+	boost::exception_ptr error;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(TaskPool);
+};
+
+
+}
+}
+}
+
+
+#endif /* BARRETT_LOG_DETAIL_TASK_POOL_H_ */
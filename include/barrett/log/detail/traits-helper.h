@@ -35,7 +35,14 @@
 
 
 #include <ostream>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+
 #include <boost/tuple/tuple.hpp>
+#include <boost/core/demangle.hpp>
+
+#include <barrett/log/schema.h>
 
 
 namespace barrett {
@@ -58,6 +65,31 @@ inline void arrayAsCSV(std::ostream& os, const T& array, const size_t size)
 	os << array[size - 1];
 }
 
+inline std::string indexedName(const std::string& name, size_t i)
+{
+	std::stringstream ss;
+	ss << name << "[" << i << "]";
+	return ss.str();
+}
+
+// The name of a math::Matrix's Units, without the namespace of the built-in units.
+template<typename Units>
+inline std::string unitsName()
+{
+	const std::string prefix = "barrett::units::";
+	std::string name = boost::core::demangle(typeid(Units).name());
+	if (name.compare(0, prefix.size(), prefix) == 0) {
+		name.erase(0, prefix.size());
+	}
+	return name;
+}
+
+template<>
+inline std::string unitsName<void>()
+{
+	return "";
+}
+
 
 template<size_t N, typename TraitsType>
 struct TupleTraitsHelper {
@@ -92,6 +124,11 @@ struct TupleTraitsHelper {
 		element_traits::asCSV(boost::get<INDEX>(source), os);
 		next_helper::asCSV(source, os);
 	}
+
+	static void describe(const std::string& names, Schema* schema) {
+		element_traits::describe(Schema::elementName(names, INDEX), schema);
+		next_helper::describe(names, schema);
+	}
 };
 
 // base-case specialization (N == 0)
@@ -105,6 +142,7 @@ struct TupleTraitsHelper<0, TraitsType> {
 	static void serialize(parameter_type source, char* dest) {}
 	static void unserialize(char* source, tuple_type* t) {}
 	static void asCSV(parameter_type source, std::ostream& os) {}
+	static void describe(const std::string& names, Schema* schema) {}
 };
 
 
@@ -49,6 +49,17 @@ Writer<T, Traits>::Writer(const char* fileName) :
 	buffer = new char[recordLength];
 }
 
+template<typename T, typename Traits>
+Writer<T, Traits>::Writer() :
+	file(), recordLength(Traits::serializedLength())
+{
+	if (recordLength == 0) {
+		throw(std::logic_error("(log::Writer::Writer): The record length "
+				"(Traits::serializedLength()) cannot be zero."));
+	}
+	buffer = new char[recordLength];
+}
+
 template<typename T, typename Traits>
 Writer<T, Traits>::~Writer()
 {
@@ -63,7 +74,13 @@ Writer<T, Traits>::~Writer()
 template<typename T, typename Traits>
 inline void Writer<T, Traits>::putRecord(parameter_type data)
 {
-	Traits::serialize(data, buffer);
+	Traits::serialize(data, beginRecord());
+	endRecord();
+}
+
+template<typename T, typename Traits>
+inline void Writer<T, Traits>::endRecord()
+{
 	file.write(buffer, recordLength);
 }
 
@@ -39,6 +39,8 @@
 #include <barrett/detail/ca_macro.h>
 #include <barrett/log/traits.h>
 #include <barrett/log/writer.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/detail/column_format.h>
 
 
 namespace barrett {
@@ -46,6 +48,10 @@ namespace log {
 
 
 // A log writer that is real-time safe. The data is double-buffered and is written to disk in a separate thread.
+//
+// The constructors that take a ColumnOptions write a column log (read it
+// with log::ColumnReader) instead of raw records. Any compression happens in
+// the disk thread; putRecord() costs the same either way.
 template<typename T, typename Traits = Traits<T> >
 class RealTimeWriter : public Writer<T, Traits> {
 public:
@@ -54,14 +60,30 @@ public:
 
 	RealTimeWriter(const char* fileName, double recordPeriod_s, int priority_ = DEFAULT_PRIORITY);
 	RealTimeWriter(const char* fileName, double approxPeriod_s, size_t recordsInSingleBuffer, int priority_ = DEFAULT_PRIORITY);
-	~RealTimeWriter();
+	RealTimeWriter(const char* fileName, double recordPeriod_s, const ColumnOptions& options, int priority_ = DEFAULT_PRIORITY);
+	RealTimeWriter(const char* fileName, double approxPeriod_s, size_t recordsInSingleBuffer, const ColumnOptions& options, int priority_ = DEFAULT_PRIORITY);
+	virtual ~RealTimeWriter();
 
 	void putRecord(parameter_type data);
 	void close();
 
+	/// See Writer::beginRecord(). Both are real-time safe.
+	char* beginRecord() {  return currentPos;  }
+	void endRecord();
+
 protected:
+	/** For subclasses that override writeBuffer() to send the records
+	 * somewhere other than a single file. No file is opened, and the disk
+	 * thread doesn't start until the subclass calls init().
+	 */
+	RealTimeWriter(double approxPeriod_s, int priority_);
+
+	size_t recordsForPeriod(double recordPeriod_s);
+	void initColumnLog(const ColumnOptions& options, double samplePeriod, size_t recordsInSingleBuffer);
 	void init(size_t recordsInSingleBuffer);
 	void writeToDiskEntryPoint();
+	/// Called from the disk thread (and from close()) with whole records.
+	virtual void writeBuffer(const char* buff, size_t length);
 
 	double period;
 	size_t singleBufferSize;
@@ -75,6 +97,8 @@ protected:
 	boost::thread thread;
 	int priority;
 
+	detail::BlockEncoder* encoder;  // NULL unless writing a column log
+
 private:
 	DISALLOW_COPY_AND_ASSIGN(RealTimeWriter);
 };
@@ -0,0 +1,193 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file schema.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_SCHEMA_H_
+#define BARRETT_LOG_SCHEMA_H_
+
+
+#include <string>
+#include <vector>
+
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_signed.hpp>
+
+
+namespace barrett {
+namespace log {
+
+
+/** Describes the layout of a log record: its fields' names, types,
+ * dimensions and units, plus the period at which records were taken.
+ *
+ * A schema is built by log::Traits<T>::describe() and written at the start
+ * of every log::ColumnWriter file, so a log::ColumnReader can open the file
+ * without knowing T.
+ *
+ * Each field is a rows x cols array of elements of one scalar type, stored
+ * in the record in column-major order. Every element is a channel: the unit
+ * that is stored contiguously on disk. Channels are named after their field,
+ * with the element index appended for fields of more than one element
+ * (e.g. "jt[3]").
+ */
+class Schema {
+public:
+	/// Codes match Python's struct module (and NumPy's dtype characters).
+	enum ScalarType {
+		OPAQUE = 'x',  ///< Bytes that only the type's Traits know how to interpret
+		BOOL = '?',
+		INT8 = 'b', UINT8 = 'B',
+		INT16 = 'h', UINT16 = 'H',
+		INT32 = 'i', UINT32 = 'I',
+		INT64 = 'q', UINT64 = 'Q',
+		FLOAT32 = 'f', FLOAT64 = 'd'
+	};
+
+	struct Field {
+		std::string name;
+		ScalarType type;
+		size_t elementSize;  ///< In bytes
+		size_t rows, cols;
+		std::string units;
+
+		size_t offset;  ///< Of the first element, in bytes from the start of the record
+		size_t firstChannel;
+
+		size_t numElements() const {  return rows * cols;  }
+		size_t length() const {  return elementSize * numElements();  }
+	};
+
+	struct Channel {
+		size_t field;
+		size_t element;
+		ScalarType type;
+		size_t size;  ///< In bytes
+		size_t offset;  ///< In bytes from the start of the record
+	};
+
+
+	/// A samplePeriod of zero means the period is unknown.
+	explicit Schema(double samplePeriod = 0.0);
+
+	void addField(const std::string& name, ScalarType type, size_t elementSize,
+			size_t rows = 1, size_t cols = 1, const std::string& units = "");
+
+	/** Merges fields first, first+1, ... (the last ones added) into a single
+	 * rows x cols field called name, if they are all single elements of the
+	 * same type and units. Otherwise leaves them alone.
+	 *
+	 * This lets containers describe their elements one at a time and still
+	 * end up with a single array-valued field when that's possible.
+	 */
+	void groupFields(size_t first, const std::string& name, size_t rows, size_t cols);
+
+	/** The name of element index of a tuple described as names.
+	 *
+	 * names may be a comma-separated list with one name per element (e.g.
+	 * "time,jp,jt"). A single name becomes a prefix ("pose" -> "pose.0") and
+	 * missing names default to "field<index>".
+	 */
+	static std::string elementName(const std::string& names, size_t index);
+
+	/** Builds a schema from a Python struct-style format, such as "d7d7d"
+	 * for the time, jp and jt of a 7-DOF WAM: a type code per field, each
+	 * optionally preceded by a count. Fields are named as by elementName().
+	 * Throws std::runtime_error if format is invalid.
+	 */
+	static Schema fromFormat(const std::string& format, const std::string& fieldNames = "", double samplePeriod = 0.0);
+
+	size_t numFields() const {  return fields.size();  }
+	const Field& field(size_t i) const {  return fields[i];  }
+	/// Throws std::out_of_range if there is no field called name.
+	size_t findField(const std::string& name) const;
+
+	size_t numChannels() const {  return channels.size();  }
+	const Channel& channel(size_t i) const {  return channels[i];  }
+	std::string channelName(size_t i) const;
+	/// Accepts "name" for single-element fields and "name[i]" otherwise. Throws std::out_of_range if there is no such channel.
+	size_t findChannel(const std::string& name) const;
+
+	size_t recordLength() const {  return length;  }
+
+	double getSamplePeriod() const {  return samplePeriod;  }
+	void setSamplePeriod(double samplePeriod_) {  samplePeriod = samplePeriod_;  }
+
+	/// Appends the binary representation of the schema to buffer.
+	void serialize(std::vector<char>* buffer) const;
+	/** Reads a schema written by serialize() from the first size bytes of
+	 * source and returns the number of bytes it used. Throws
+	 * std::runtime_error if source is truncated or corrupt.
+	 */
+	size_t unserialize(const char* source, size_t size);
+
+	bool operator== (const Schema& other) const;
+	bool operator!= (const Schema& other) const {  return !(*this == other);  }
+
+	/// The ScalarType that represents T, or OPAQUE.
+	template<typename T> static ScalarType scalarTypeOf();
+	static ScalarType integerType(bool isSigned, size_t size);
+	static size_t scalarSize(ScalarType type);
+	/// Converts one element of type at source to a double. OPAQUE elements become NaN.
+	static double toDouble(ScalarType type, const char* source);
+
+protected:
+	void updateLayout();
+
+	double samplePeriod;
+	std::vector<Field> fields;
+	std::vector<Channel> channels;
+	size_t length;
+};
+
+
+template<typename T> inline Schema::ScalarType Schema::scalarTypeOf()
+{
+	if (boost::is_same<T, bool>::value) {
+		return BOOL;
+	} else if (boost::is_floating_point<T>::value) {
+		if (sizeof(T) == 4) {
+			return FLOAT32;
+		} else if (sizeof(T) == 8) {
+			return FLOAT64;
+		}
+	} else if (boost::is_integral<T>::value) {
+		return integerType(boost::is_signed<T>::value, sizeof(T));
+	}
+	return OPAQUE;
+}
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_SCHEMA_H_ */
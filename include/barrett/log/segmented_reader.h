@@ -0,0 +1,143 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file segmented_reader.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_SEGMENTED_READER_H_
+#define BARRETT_LOG_SEGMENTED_READER_H_
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/detail/segmented_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+/** Reads a log written by log::SegmentedWriter as if it were a single
+ * column log.
+ *
+ * Only the index is read up front. Finding the records at a given time is a
+ * binary search of the index followed by a search of a single block, and
+ * segments are opened (see log::ColumnReader) the first time their records
+ * are needed. So pulling the few seconds around an event out of a
+ * multi-day recording only touches the blocks that hold them.
+ *
+ * Blocks written after the last index entry (e.g. because the writer
+ * crashed) are ignored.
+ */
+class SegmentedReader {
+public:
+	/// baseName is the name that was given to the SegmentedWriter.
+	explicit SegmentedReader(const char* baseName);
+	~SegmentedReader();
+
+	const Schema& getSchema() const {  return schema;  }
+	size_t numRecords() const {  return recordCount;  }
+	size_t numSegments() const {  return segments.size();  }
+
+	/// The timestamps of the first and last records, or zero if there are none.
+	double startTime() const {  return entries.empty() ? 0.0 : entries.front().firstTime;  }
+	double endTime() const {  return entries.empty() ? 0.0 : entries.back().lastTime;  }
+	double recordTime(size_t i) const;
+
+	/// The first record whose timestamp is at or after t, or numRecords() if there is none.
+	size_t findTime(double t) const;
+	/// The records whose timestamps are in [t0, t1).
+	void findTimeRange(double t0, double t1, size_t* first, size_t* count) const;
+
+	/// See ColumnReader::readChannel(). The records may span several segments.
+	void readChannel(size_t channel, std::vector<double>* dest, size_t first, size_t count) const;
+	void readChannel(size_t channel, double* dest, size_t first, size_t count) const;
+	void readChannel(const std::string& channel, std::vector<double>* dest, size_t first, size_t count) const {
+		readChannel(schema.findChannel(channel), dest, first, count);
+	}
+
+	/// Copies record i into dest in the layout that Traits::serialize() produced.
+	void readRecord(size_t i, char* dest) const;
+
+	/// Throws std::logic_error if the records are not TraitsType::serializedLength() bytes long.
+	template<typename T, typename TraitsType> T getRecord(size_t i) const;
+	template<typename T> T getRecord(size_t i) const {
+		return getRecord<T, Traits<T> >(i);
+	}
+
+	void close();
+
+protected:
+	struct Segment {
+		size_t firstRecord, numRecords;
+		ColumnReader* reader;  // NULL until it's needed
+	};
+
+	const detail::SegmentIndexEntry& findEntry(size_t record) const;
+	const ColumnReader& segmentReader(size_t s) const;
+	// The timestamps of the records in e
+	void blockTimes(const detail::SegmentIndexEntry& e, std::vector<double>* dest) const;
+
+	std::string baseName;
+	int timeChannel;
+	std::vector<detail::SegmentIndexEntry> entries;
+	mutable std::vector<Segment> segments;
+	size_t recordCount;
+
+	Schema schema;
+	mutable std::vector<char> row;
+	mutable std::vector<double> times;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(SegmentedReader);
+};
+
+
+template<typename T, typename TraitsType>
+T SegmentedReader::getRecord(size_t i) const
+{
+	if (TraitsType::serializedLength() != schema.recordLength()) {
+		throw(std::logic_error("(log::SegmentedReader::getRecord()): The file does not contain this type of data."));
+	}
+
+	readRecord(i, &row[0]);
+	return TraitsType::unserialize(&row[0]);
+}
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_SEGMENTED_READER_H_ */
@@ -0,0 +1,107 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file segmented_writer.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_SEGMENTED_WRITER_H_
+#define BARRETT_LOG_SEGMENTED_WRITER_H_
+
+
+#include <string>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/real_time_writer.h>
+#include <barrett/log/detail/segmented_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+/// How a log::SegmentedWriter lays out and splits its log.
+struct SegmentOptions {
+	/** timeChannel names the channel (e.g. "time") that holds each
+	 * record's timestamp. The timestamps must not decrease. If timeChannel
+	 * is empty, record i is taken to be at i times the sample period.
+	 */
+	explicit SegmentOptions(const ColumnOptions& columnOptions_ = ColumnOptions(), const std::string& timeChannel_ = "time") :
+		columnOptions(columnOptions_), timeChannel(timeChannel_),
+		maxSegmentBytes(64 << 20), maxSegmentDuration(3600.0) {}
+
+	ColumnOptions columnOptions;
+	std::string timeChannel;
+	size_t maxSegmentBytes;  ///< Zero means no limit
+	double maxSegmentDuration;  ///< In seconds of log time. Zero means no limit.
+};
+
+
+/** A real-time safe log writer for long recordings. A log::RealTimeWriter
+ * writing a column log, but the log is split into segments.
+ *
+ * Segments are column logs called <baseName>.000000.log,
+ * <baseName>.000001.log, and so on. A new one is started (at a block
+ * boundary) once the current segment reaches options.maxSegmentBytes or
+ * covers options.maxSegmentDuration. Finished segments are synced to disk,
+ * so a crash loses at most the tail of the current one. Each block is also
+ * listed, with its first and last timestamps, in <baseName>.index, which
+ * log::SegmentedReader uses to find the records at a given time without
+ * reading the segments.
+ */
+template<typename T, typename Traits = Traits<T> >
+class SegmentedWriter : public RealTimeWriter<T, Traits> {
+public:
+	SegmentedWriter(const char* baseName, double recordPeriod_s, const SegmentOptions& options, int priority_ = RealTimeWriter<T, Traits>::DEFAULT_PRIORITY);
+	/// The sample period is unknown, so options.timeChannel can't be empty.
+	SegmentedWriter(const char* baseName, double approxPeriod_s, size_t recordsInSingleBuffer, const SegmentOptions& options, int priority_ = RealTimeWriter<T, Traits>::DEFAULT_PRIORITY);
+	~SegmentedWriter();
+
+	void close();
+
+protected:
+	void initFiles(const char* baseName, const SegmentOptions& options, double samplePeriod, size_t recordsInSingleBuffer);
+	virtual void writeBuffer(const char* buff, size_t length);
+
+	detail::SegmentedLogFiles* files;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(SegmentedWriter);
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/log/detail/segmented_writer-inl.h>
+
+
+#endif /* BARRETT_LOG_SEGMENTED_WRITER_H_ */
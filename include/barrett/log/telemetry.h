@@ -0,0 +1,230 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file telemetry.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_LOG_TELEMETRY_H_
+#define BARRETT_LOG_TELEMETRY_H_
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/schema.h>
+
+
+namespace barrett {
+namespace log {
+
+
+namespace detail {
+struct TelemetryHeader;
+}
+
+
+/** A ring of records in a named POSIX shared-memory segment, for streaming
+ * data out of the realtime thread to other processes.
+ *
+ * There is one writer (the TelemetryRing) and any number of readers (see
+ * TelemetryReader and python/barrett_telemetry.py), which may attach and
+ * detach at any time. Writing a record is wait-free and makes no system
+ * calls: the segment is created, zeroed and (if permitted) locked in memory
+ * by the constructor. Readers never block the writer; a reader that falls
+ * more than a ring's length behind loses records, and is told so.
+ *
+ * The segment starts with a 64-byte header (all fields in native byte
+ * order), followed by the records' Schema and then the slots:
+ *
+ *     offset  type      field
+ *          0  char[8]   magic, "BTTELEM" (written last, once the segment is ready)
+ *          8  uint32    version (2)
+ *         12  uint32    headerLength (offset of the first slot)
+ *         16  uint32    schemaLength (Schema::serialize() bytes at offset 64)
+ *         20  uint32    recordLength
+ *         24  uint32    slotLength
+ *         28  uint32    capacity (number of slots, a power of two)
+ *         32  float64   samplePeriod (seconds, 0 if unknown; stored atomically)
+ *         40  uint64    writeCount (records written so far)
+ *         48  uint32    open (1 until the writer is destroyed)
+ *
+ * Record n is stored in slot n % capacity, which holds a uint64 sequence
+ * number followed by the record. The sequence number is 2n + 1 while the
+ * record is being written and 2n + 2 once it is complete; a reader copies
+ * the record and accepts it if the sequence number was 2n + 2 both before
+ * and after the copy.
+ *
+ * When a writer is destroyed, it marks its segment closed and unlinks it,
+ * so a new writer with the same name gets a fresh segment. Readers of the
+ * old segment see TelemetryReader::isPublisherOpen() go false and can
+ * attach() again.
+ */
+class TelemetryRing {
+public:
+	static const size_t DEFAULT_CAPACITY = 4096;
+
+	/// name is a POSIX shared-memory name; a leading '/' is added if it's missing. capacity is rounded up to a power of two.
+	TelemetryRing(const std::string& name, const Schema& schema, size_t capacity = DEFAULT_CAPACITY);
+	~TelemetryRing();
+
+	const std::string& getName() const {  return name;  }
+	const Schema& getSchema() const {  return schema;  }
+	size_t getCapacity() const {  return capacity;  }
+	boost::uint64_t getNumWritten() const {  return count;  }
+
+	void setSamplePeriod(double samplePeriod);
+
+	/** Returns the slot for the next record, which the caller must fill with
+	 * getSchema().recordLength() bytes before calling endWrite(). Only one
+	 * thread may write.
+	 */
+	char* beginWrite();
+	void endWrite();
+
+	void write(const char* record);
+
+protected:
+	std::string name;
+	Schema schema;
+	size_t capacity;
+	size_t slotLength;
+
+	int fd;
+	char* data;
+	size_t size;
+	detail::TelemetryHeader* header;
+	char* slots;
+
+	boost::uint64_t count;
+	char* slot;  // Being written
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(TelemetryRing);
+};
+
+
+/** Reads the records of a TelemetryRing from any process.
+ *
+ * A reader starts with the next record to be written and then read()s
+ * records in order. It may instead jump to the newest record with
+ * readLatest(), which suits displays that only need the current value.
+ */
+class TelemetryReader {
+public:
+	TelemetryReader();
+	/// Throws std::runtime_error if there is no ring called name.
+	explicit TelemetryReader(const std::string& name);
+	~TelemetryReader();
+
+	/** Attaches to the ring called name, detaching from the current one
+	 * first. Returns false if there's no such ring (yet). Throws
+	 * std::runtime_error if the segment isn't a ring this version can read.
+	 */
+	bool attach(const std::string& name);
+	void detach();
+	bool isAttached() const {  return data != NULL;  }
+
+	/// False once the writer has been destroyed. New records will only appear after attaching again.
+	bool isPublisherOpen() const;
+
+	/// The sample period is the writer's most recent setSamplePeriod().
+	Schema getSchema() const;
+	size_t recordLength() const {  return schema.recordLength();  }
+	size_t getCapacity() const {  return capacity;  }
+
+	/// The number of records written but not yet read, at most getCapacity().
+	size_t numAvailable() const;
+	/// Records that were overwritten before they could be read.
+	boost::uint64_t getNumLost() const {  return numLost;  }
+
+	/** Copies the next record (recordLength() bytes) into dest. Returns false
+	 * if no new record has been written.
+	 */
+	bool read(char* dest);
+	/// Copies the newest record and skips any older unread ones. Returns false if no new record has been written.
+	bool readLatest(char* dest);
+
+	/// Throws std::logic_error if the records are not TraitsType::serializedLength() bytes long.
+	template<typename T, typename TraitsType> bool read(T* record);
+	template<typename T> bool read(T* record) {
+		return read<T, Traits<T> >(record);
+	}
+
+protected:
+	boost::uint64_t writeCount() const;
+	// Copies record n into dest. Returns false if it has been overwritten.
+	bool copyRecord(boost::uint64_t n, char* dest) const;
+
+	int fd;
+	const char* data;
+	size_t size;
+	const detail::TelemetryHeader* header;
+	const char* slots;
+
+	Schema schema;
+	size_t capacity;
+	size_t slotLength;
+
+	boost::uint64_t next;
+	boost::uint64_t numLost;
+	std::vector<char> buffer;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(TelemetryReader);
+};
+
+
+template<typename T, typename TraitsType>
+bool TelemetryReader::read(T* record)
+{
+	if ( !isAttached() ) {
+		return false;
+	}
+	if (TraitsType::serializedLength() != recordLength()) {
+		throw(std::logic_error("(log::TelemetryReader::read()): The records in this ring are not the size of T."));
+	}
+
+	buffer.resize(recordLength());
+	if ( !read(&buffer[0]) ) {
+		return false;
+	}
+	*record = TraitsType::unserialize(&buffer[0]);
+	return true;
+}
+
+
+}
+}
+
+
+#endif /* BARRETT_LOG_TELEMETRY_H_ */
@@ -36,12 +36,14 @@
 
 #include <ostream>
 #include <cstring>
+#include <string>
 
 #include <boost/tuple/tuple.hpp>
 #include <boost/array.hpp>
 #include <Eigen/Geometry>
 
 #include <barrett/math/matrix.h>
+#include <barrett/log/schema.h>
 #include <barrett/log/detail/traits-helper.h>
 
 
@@ -50,6 +52,10 @@ namespace log {
 
 
 // default traits delegate to the type in question
+//
+// Traits also describe() the layout of what they serialize by appending
+// fields to a log::Schema. Types without a more specific description are
+// logged as a single opaque field.
 template<typename T> struct DefaultTraits {
 	typedef const T& parameter_type;
 
@@ -68,6 +74,10 @@ template<typename T> struct DefaultTraits {
 	static void asCSV(parameter_type source, std::ostream& os) {
 		os << source;
 	}
+
+	static void describe(const std::string& name, Schema* schema) {
+		schema->addField(name, Schema::OPAQUE, serializedLength());
+	}
 };
 
 template<typename T> struct Traits : public DefaultTraits<T> {};
@@ -91,6 +101,10 @@ template<typename T> struct PODTraits {
 	static void asCSV(parameter_type source, std::ostream& os) {
 		os << source;
 	}
+
+	static void describe(const std::string& name, Schema* schema) {
+		schema->addField(name, Schema::scalarTypeOf<T>(), sizeof(T));
+	}
 };
 
 template<> struct Traits<bool>					: public PODTraits<bool> {};
@@ -134,6 +148,14 @@ template<typename T, size_t N> struct Traits< ::boost::array<T,N> > {
 	static void asCSV(parameter_type source, std::ostream& os) {
 		detail::arrayAsCSV(os, source, N);
 	}
+
+	static void describe(const std::string& name, Schema* schema) {
+		size_t first = schema->numFields();
+		for (size_t i = 0; i < N; ++i) {
+			Traits<T>::describe(detail::indexedName(name, i), schema);
+		}
+		schema->groupFields(first, name, N, 1);
+	}
 };
 
 
@@ -158,6 +180,11 @@ template<typename Scalar> struct Traits<Eigen::Quaternion<Scalar> > {
 	static void asCSV(parameter_type source, std::ostream& os) {
 		os << source.w() << "," << source.x() << "," << source.y() << "," << source.z();
 	}
+
+	// Stored in Eigen's coefficient order.
+	static void describe(const std::string& name, Schema* schema) {
+		schema->addField(name, Schema::scalarTypeOf<Scalar>(), sizeof(Scalar), 4, 1, "quaternion (x, y, z, w)");
+	}
 };
 
 
@@ -180,6 +207,10 @@ template<int R, int C, typename Units> struct Traits<math::Matrix<R,C, Units> >
 	static void asCSV(parameter_type source, std::ostream& os) {
 		detail::arrayAsCSV(os, source, source.size());
 	}
+
+	static void describe(const std::string& name, Schema* schema) {
+		schema->addField(name, Schema::FLOAT64, sizeof(double), R, C, detail::unitsName<Units>());
+	}
 };
 
 
@@ -212,6 +243,11 @@ struct Traits<boost::tuple<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9> > {
 	static void asCSV(parameter_type source, std::ostream& os) {
 		tuple_traits_helper::asCSV(source, os);
 	}
+
+	// names may be a comma-separated list of names for the elements. See Schema::elementName().
+	static void describe(const std::string& names, Schema* schema) {
+		tuple_traits_helper::describe(names, schema);
+	}
 };
 
 
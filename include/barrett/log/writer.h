@@ -55,7 +55,17 @@ public:
 	void putRecord(parameter_type data);
 	void close();
 
+	/** Lets the caller serialize a record in place (recordLength bytes at
+	 * the returned address) instead of calling putRecord(). endRecord()
+	 * must follow each beginRecord().
+	 */
+	char* beginRecord() {  return buffer;  }
+	void endRecord();
+
 protected:
+	/// For subclasses that don't write to a single file. file is left closed.
+	Writer();
+
 	std::ofstream file;
 	size_t recordLength;
 	char* buffer;
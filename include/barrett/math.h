@@ -48,6 +48,8 @@
 
 #include <barrett/math/kinematics.h>
 #include <barrett/math/dynamics.h>
+#include <barrett/math/gravity.h>
+#include <barrett/math/inverse_kinematics.h>
 
 
 #endif /* BARRETT_MATH_H_ */
@@ -0,0 +1,119 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file aabb_tree.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_MATH_AABB_TREE_H_
+#define BARRETT_MATH_AABB_TREE_H_
+
+
+#include <vector>
+#include <limits>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+
+namespace barrett {
+namespace math {
+
+
+/** A static bounding-volume hierarchy of axis-aligned boxes in 3-space.
+ *
+ * Items are identified by their index in the vector of boxes passed to
+ * build(). Building the tree allocates memory; the queries do not, so they
+ * are safe to call from the realtime thread.
+ */
+class AabbTree {
+public:
+	typedef Eigen::AlignedBox<double, 3> box_type;
+	typedef std::vector<box_type, Eigen::aligned_allocator<box_type> > box_vector;
+
+	static const size_t NONE = static_cast<size_t>(-1);
+
+	AabbTree() {}
+	explicit AabbTree(const box_vector& boxes) {  build(boxes);  }
+
+	void build(const box_vector& boxes);
+	void clear();
+	void swap(AabbTree& other);
+
+	size_t size() const {  return boxes.size();  }
+	bool empty() const {  return boxes.empty();  }
+	const box_type& getBox(size_t item) const {  return boxes[item];  }
+
+	/** Calls visit(item) for each item whose box is within radius of p.
+	 */
+	template<typename Visitor>
+	void query(const Eigen::Vector3d& p, double radius, Visitor& visit) const;
+
+	/** Branch-and-bound search for the item closest to p.
+	 *
+	 * sqDist(item, p) must return the squared distance from p to the item,
+	 * which can be no less than the squared distance from p to the item's box.
+	 * Items whose boxes are farther than the best distance found so far are
+	 * never passed to sqDist(). Returns NONE if the tree is empty or if no item
+	 * is closer than maxDistance. If distance is not NULL, the distance to the
+	 * closest item is written there.
+	 */
+	template<typename SquaredDistance>
+	size_t nearest(const Eigen::Vector3d& p, SquaredDistance& sqDist,
+			double* distance = NULL,
+			double maxDistance = std::numeric_limits<double>::infinity()) const;
+
+protected:
+	static const size_t MAX_LEAF_SIZE = 2;
+	static const size_t MAX_DEPTH = 64;
+
+	struct Node {
+		box_type box;
+		size_t left, right;  // children, or NONE for a leaf
+		size_t first, count;  // range in items (leaves only)
+
+		bool isLeaf() const {  return left == NONE;  }
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	size_t buildNode(size_t first, size_t count, size_t depth);
+
+	box_vector boxes;
+	std::vector<Node, Eigen::aligned_allocator<Node> > nodes;
+	std::vector<size_t> items;
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/math/detail/aabb_tree-inl.h>
+
+
+#endif /* BARRETT_MATH_AABB_TREE_H_ */
@@ -0,0 +1,124 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file aabb_tree-inl.h
+ * @date 10/19/2026
+ */
+
+#include <cassert>
+#include <cmath>
+
+
+namespace barrett {
+namespace math {
+
+
+template<typename Visitor>
+void AabbTree::query(const Eigen::Vector3d& p, double radius, Visitor& visit) const
+{
+	if (nodes.empty()) {
+		return;
+	}
+
+	const double sqRadius = radius * radius;
+	size_t stack[MAX_DEPTH + 1];
+	size_t top = 0;
+	stack[top++] = 0;
+
+	while (top > 0) {
+		const Node& node = nodes[stack[--top]];
+		if (node.box.squaredExteriorDistance(p) > sqRadius) {
+			continue;
+		}
+
+		if (node.isLeaf()) {
+			for (size_t i = node.first; i < node.first + node.count; ++i) {
+				if (boxes[items[i]].squaredExteriorDistance(p) <= sqRadius) {
+					visit(items[i]);
+				}
+			}
+		} else {
+			assert(top + 2 <= MAX_DEPTH + 1);
+			stack[top++] = node.left;
+			stack[top++] = node.right;
+		}
+	}
+}
+
+template<typename SquaredDistance>
+size_t AabbTree::nearest(const Eigen::Vector3d& p, SquaredDistance& sqDist,
+		double* distance, double maxDistance) const
+{
+	size_t best = NONE;
+	double bestSq = maxDistance * maxDistance;
+
+	if ( !nodes.empty() ) {
+		size_t stack[MAX_DEPTH + 1];
+		size_t top = 0;
+		stack[top++] = 0;
+
+		while (top > 0) {
+			const Node& node = nodes[stack[--top]];
+			if (node.box.squaredExteriorDistance(p) >= bestSq) {
+				continue;
+			}
+
+			if (node.isLeaf()) {
+				for (size_t i = node.first; i < node.first + node.count; ++i) {
+					const size_t item = items[i];
+					if (boxes[item].squaredExteriorDistance(p) < bestSq) {
+						double d = sqDist(item, p);
+						if (d < bestSq) {
+							bestSq = d;
+							best = item;
+						}
+					}
+				}
+			} else {
+				// Visit the nearer child first so that more of the farther
+				// child's subtree gets pruned.
+				size_t nearChild = node.left, farChild = node.right;
+				if (nodes[farChild].box.squaredExteriorDistance(p) <
+						nodes[nearChild].box.squaredExteriorDistance(p)) {
+					nearChild = node.right;
+					farChild = node.left;
+				}
+
+				assert(top + 2 <= MAX_DEPTH + 1);
+				stack[top++] = farChild;
+				stack[top++] = nearChild;
+			}
+		}
+	}
+
+	if (distance != NULL) {
+		*distance = (best == NONE) ? maxDistance : std::sqrt(bestSq);
+	}
+	return best;
+}
+
+
+}
+}
@@ -6,8 +6,11 @@
  */
 
 #include <libconfig.h++>
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
 
 #include <barrett/units.h>
+#include <barrett/cdlbt/kinematics.h>
 #include <barrett/cdlbt/dynamics.h>
 
 
@@ -15,12 +18,38 @@ namespace barrett {
 namespace math {
 
 
+namespace detail {
+
+// Read-only, zero-copy views of the gsl_vector and gsl_matrix members of
+// the cdlbt structs
+typedef Eigen::Map<const Eigen::Vector3d, Eigen::Unaligned, Eigen::InnerStride<> > GslVector3Map;
+typedef Eigen::Map<const Eigen::Matrix<double, 3,3, Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > GslMatrix3Map;
+
+inline GslVector3Map mapGsl3(const gsl_vector* v)
+{
+	return GslVector3Map(v->data, 3, Eigen::InnerStride<>(v->stride));
+}
+inline GslMatrix3Map mapGsl3(const gsl_matrix* m)
+{
+	return GslMatrix3Map(m->data, 3, 3, Eigen::OuterStride<>(m->tda));
+}
+
+}
+
+
 template<size_t DOF>
-Dynamics<DOF>::Dynamics(const libconfig::Setting& setting)
+Dynamics<DOF>::Dynamics(const libconfig::Setting& setting) :
+	jt(0.0), M(0.0), h(0.0), g(0.0), ja(0.0), llt()
 {
 	if (bt_dynamics_create(&impl, setting.getCSetting(), DOF)) {
 		throw(std::runtime_error("(math::Dynamics::Dynamics): Couldn't initialize Dynamics struct."));
 	}
+
+	for (size_t j = 0; j < DOF; ++j) {
+		mass[j] = impl->link[j]->mass;
+		com[j] = detail::mapGsl3(impl->link[j]->com);
+		inertia[j] = detail::mapGsl3(impl->link[j]->I);
+	}
 }
 
 template<size_t DOF>
@@ -32,10 +61,147 @@ Dynamics<DOF>::~Dynamics()
 template<size_t DOF>
 const typename units::JointTorques<DOF>::type& Dynamics<DOF>::evalInverse(const Kinematics<DOF>& kin, const jv_type& jv, const ja_type& ja)
 {
-	bt_dynamics_eval_inverse(impl, kin.impl, jv.asGslType(), ja.asGslType(), jt.asGslType());
+	evalRnea(kin, jv, &ja, &jt);
 	return jt;
 }
 
+template<size_t DOF>
+const typename Dynamics<DOF>::sqm_type& Dynamics<DOF>::evalMassMatrix(const Kinematics<DOF>& kin)
+{
+	const struct bt_kinematics* k = kin.impl;
+
+	// Composite-rigid-body algorithm, in the world frame. Each joint's motion
+	// is described at the world origin by the angular velocity z and the
+	// linear velocity o x z of the point there. Moving the composite body
+	// beyond joint j that way takes momentum (f, n), and
+	//     M(i,j) = z_i . n + (o_i x z_i) . f      for i <= j.
+	Eigen::Vector3d z[DOF], oz[DOF];
+	for (size_t i = 0; i < DOF; ++i) {
+		// Joint i turns about the z-axis of the frame before it.
+		const struct bt_kinematics_link* joint = (i == 0) ? k->base : k->link[i-1];
+		z[i] = detail::mapGsl3(joint->axis_z);
+		oz[i] = detail::mapGsl3(joint->origin_pos).cross(z[i]);
+	}
+
+	double m = 0.0;  // mass,
+	Eigen::Vector3d h(0.0, 0.0, 0.0);  // first moment,
+	Eigen::Matrix3d J = Eigen::Matrix3d::Zero();  // and inertia about the world origin of the composite body
+	for (int j = DOF - 1; j >= 0; --j) {
+		const detail::GslMatrix3Map R = detail::mapGsl3(k->link[j]->rot_to_world);
+		const Eigen::Vector3d c = detail::mapGsl3(k->link[j]->origin_pos) + R * com[j];
+
+		m += mass[j];
+		h += mass[j] * c;
+		J += R * inertia[j] * R.transpose();
+		J += mass[j] * (c.squaredNorm() * Eigen::Matrix3d::Identity() - c * c.transpose());
+
+		const Eigen::Vector3d f = m * oz[j] + z[j].cross(h);
+		const Eigen::Vector3d n = J * z[j] + h.cross(oz[j]);
+		for (int i = 0; i <= j; ++i) {
+			M(i,j) = M(j,i) = z[i].dot(n) + oz[i].dot(f);
+		}
+	}
+
+	return M;
+}
+
+template<size_t DOF>
+const typename units::JointTorques<DOF>::type& Dynamics<DOF>::evalBias(const Kinematics<DOF>& kin, const jv_type& jv)
+{
+	evalRnea(kin, jv, NULL, &h);
+	return h;
+}
+
+template<size_t DOF>
+const typename units::JointAccelerations<DOF>::type& Dynamics<DOF>::evalForward(const Kinematics<DOF>& kin, const jv_type& jv, const jt_type& torque)
+{
+	evalMassMatrix(kin);
+	evalBias(kin, jv);
+
+	llt.compute(M);
+	ja = llt.solve(torque - h);
+	return ja;
+}
+
+template<size_t DOF>
+const typename units::JointTorques<DOF>::type& Dynamics<DOF>::evalGravity(const Kinematics<DOF>& kin, double gravity)
+{
+	const struct bt_kinematics* k = kin.impl;
+
+	// Each joint holds up the weight of every link beyond it.
+	g.setZero();
+	for (size_t j = 0; j < DOF; ++j) {
+		const detail::GslMatrix3Map R = detail::mapGsl3(k->link[j]->rot_to_world);
+		const Eigen::Vector3d p = detail::mapGsl3(k->link[j]->origin_pos) + R * com[j];
+		const Eigen::Vector3d weight(0.0, 0.0, mass[j] * gravity);
+
+		for (size_t i = 0; i <= j; ++i) {
+			const struct bt_kinematics_link* joint = (i == 0) ? k->base : k->link[i-1];
+			const Eigen::Vector3d z = detail::mapGsl3(joint->axis_z);
+
+			g[i] -= z.dot((p - detail::mapGsl3(joint->origin_pos)).cross(weight));
+		}
+	}
+
+	return g;
+}
+
+template<size_t DOF>
+void Dynamics<DOF>::evalRnea(const Kinematics<DOF>& kin, const jv_type& jv, const ja_type* jaIn, jt_type* result) const
+{
+	const struct bt_kinematics* k = kin.impl;
+
+	// Forward pass, in each link's frame. The base is inertial.
+	Eigen::Vector3d omega[DOF], alpha[DOF], a[DOF];
+	Eigen::Vector3d prevOmega(0.0, 0.0, 0.0), prevAlpha(0.0, 0.0, 0.0), prevA(0.0, 0.0, 0.0);
+	for (size_t j = 0; j < DOF; ++j) {
+		const struct bt_kinematics_link* link = k->link[j];
+		const detail::GslMatrix3Map Rt = detail::mapGsl3(link->rot_to_prev);
+		const Eigen::Vector3d z = detail::mapGsl3(link->prev_axis_z);
+		// From the previous origin to this one, in this link's frame
+		const Eigen::Vector3d r = Rt.transpose() * detail::mapGsl3(link->prev_origin_pos);
+
+		const Eigen::Vector3d omegaPrev = Rt.transpose() * prevOmega;
+		omega[j] = omegaPrev + jv[j] * z;
+		alpha[j] = Rt.transpose() * prevAlpha + omegaPrev.cross(jv[j] * z);
+		if (jaIn != NULL) {
+			alpha[j] += (*jaIn)[j] * z;
+		}
+		// The previous origin is on joint j's axis, so this origin moves with link j.
+		a[j] = Rt.transpose() * prevA + alpha[j].cross(r) + omega[j].cross(omega[j].cross(r));
+
+		prevOmega = omega[j];
+		prevAlpha = alpha[j];
+		prevA = a[j];
+	}
+
+	// Backward pass. The toolplate is massless, so nothing comes back from it.
+	Eigen::Vector3d f(0.0, 0.0, 0.0), t(0.0, 0.0, 0.0);
+	for (int j = DOF - 1; j >= 0; --j) {
+		const struct bt_kinematics_link* link = k->link[j];
+
+		const Eigen::Vector3d fnet = mass[j] * (a[j] + alpha[j].cross(com[j]) + omega[j].cross(omega[j].cross(com[j])));
+		const Eigen::Vector3d tnet = inertia[j] * alpha[j] + omega[j].cross(inertia[j] * omega[j]);
+
+		Eigen::Vector3d fj = fnet;
+		Eigen::Vector3d tj = tnet + com[j].cross(fnet);
+		if (j < (int)DOF - 1) {
+			const detail::GslMatrix3Map Rn = detail::mapGsl3(link->next->rot_to_prev);
+			const Eigen::Vector3d fNext = Rn * f;
+			fj += fNext;
+			tj += Rn * t + detail::mapGsl3(link->next->prev_origin_pos).cross(fNext);
+		}
+
+		// tj is about this link's origin. Joint j's axis passes through the
+		// previous origin instead, so move the moment there before taking
+		// its component along the axis.
+		const Eigen::Vector3d r = detail::mapGsl3(link->rot_to_prev).transpose() * detail::mapGsl3(link->prev_origin_pos);
+		(*result)[j] = detail::mapGsl3(link->prev_axis_z).dot(tj + r.cross(fj));
+		f = fj;
+		t = tj;
+	}
+}
+
 //template<size_t DOF>
 //const units::JointTorques<DOF>::type& Dynamics<DOF>::operator() (const boost::tuple<jv_type, ja_type>& jointState)
 //{
@@ -0,0 +1,110 @@
+/*
+ * gravity-inl.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <sstream>
+#include <stdexcept>
+
+#include <libconfig.h++>
+#include <Eigen/Core>
+
+#include <barrett/units.h>
+#include <barrett/cdlbt/kinematics.h>
+#include <barrett/math/matrix.h>
+
+
+namespace barrett {
+namespace math {
+namespace detail {
+
+
+// A read-only, zero-copy view of one of bt_kinematics' 3x3 gsl_matrix members
+typedef Eigen::Map<const Eigen::Matrix<double, 3,3, Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > GslRotationMap;
+
+inline GslRotationMap mapGslRotation(const gsl_matrix* m)
+{
+	return GslRotationMap(m->data, 3, 3, Eigen::OuterStride<>(m->tda));
+}
+
+// Row i of R times x, summed left to right from 0.0 as the reference BLAS
+// dgemv does. Eigen is free to reassociate the sum (and to turn -0.0 into
+// +0.0 differently), which would make the results differ from
+// bt_calgrav_eval() in the last bit.
+inline double gemvRow(const GslRotationMap& R, int i, const Eigen::Vector3d& x)
+{
+	return ((0.0 + x[0] * R(i,0)) + x[1] * R(i,1)) + x[2] * R(i,2);
+}
+
+
+}
+
+
+template<size_t DOF>
+const double Gravity<DOF>::DEFAULT_GRAVITY = -9.805;
+
+
+template<size_t DOF>
+Gravity<DOF>::Gravity(const libconfig::Setting& setting) :
+	gravity(DEFAULT_GRAVITY), jt(0.0)
+{
+	const libconfig::Setting& mus = setting["mus"];
+	if ( !mus.isList()  ||  mus.getLength() != (int)DOF ) {
+		std::stringstream ss;
+		ss << "(math::Gravity::Gravity): \"mus\" must be a list with " << DOF
+				<< " elements. Path: \"" << mus.getPath() << "\", Line: "
+				<< mus.getSourceLine();
+		throw std::runtime_error(ss.str());
+	}
+
+	for (size_t j = 0; j < DOF; ++j) {
+		mu[j] = Vector<3>::type(mus[j]);
+	}
+}
+
+template<size_t DOF>
+void Gravity<DOF>::eval(const Kinematics<DOF>& kin, jt_type* jtOut) const
+{
+	Eigen::Vector3d g, t, nextT;
+
+	// For each moving link, backwards...
+	for (int j = DOF - 1; j >= 0; --j) {
+		const struct bt_kinematics_link* link = kin.impl->link[j];
+		const detail::GslRotationMap rotToWorld = detail::mapGslRotation(link->rot_to_world);
+		const detail::GslRotationMap rotToPrev = detail::mapGslRotation(link->rot_to_prev);
+
+		// This link's gravity vector (rotToWorld^T * <0, 0, gravity>)
+		g[0] = 0.0 + gravity * rotToWorld(2,0);
+		g[1] = 0.0 + gravity * rotToWorld(2,1);
+		g[2] = 0.0 + gravity * rotToWorld(2,2);
+
+		// This link's torque (t = g x mu)
+		t[0] = 0.0 + (g[1] * mu[j][2] - g[2] * mu[j][1]);
+		t[1] = 0.0 + (g[2] * mu[j][0] - g[0] * mu[j][2]);
+		t[2] = 0.0 + (g[0] * mu[j][1] - g[1] * mu[j][0]);
+
+		// Plus the torque from the links beyond this one
+		if (j < (int)DOF - 1) {
+			const detail::GslRotationMap nextRotToPrev = detail::mapGslRotation(link->next->rot_to_prev);
+			t[0] += detail::gemvRow(nextRotToPrev, 0, nextT);
+			t[1] += detail::gemvRow(nextRotToPrev, 1, nextT);
+			t[2] += detail::gemvRow(nextRotToPrev, 2, nextT);
+		}
+
+		// The z component in the previous frame is the joint torque
+		(*jtOut)[j] = 0.0 + detail::gemvRow(rotToPrev, 2, t);
+		nextT = t;
+	}
+}
+
+template<size_t DOF>
+inline const typename units::JointTorques<DOF>::type& Gravity<DOF>::eval(const Kinematics<DOF>& kin)
+{
+	eval(kin, &jt);
+	return jt;
+}
+
+
+}
+}
@@ -0,0 +1,205 @@
+/*
+ * inverse_kinematics-inl.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/tuple/tuple.hpp>
+#include <libconfig.h++>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Cholesky>
+
+#include <barrett/units.h>
+#include <barrett/cdlbt/kinematics.h>
+
+
+namespace barrett {
+namespace math {
+
+
+template<size_t DOF> const size_t InverseKinematics<DOF>::DEFAULT_MAX_ITERATIONS;
+template<size_t DOF> const double InverseKinematics<DOF>::DEFAULT_DAMPING = 0.01;
+template<size_t DOF> const double InverseKinematics<DOF>::DEFAULT_POSITION_TOLERANCE = 1e-5;
+template<size_t DOF> const double InverseKinematics<DOF>::DEFAULT_ORIENTATION_TOLERANCE = 1e-4;
+template<size_t DOF> const double InverseKinematics<DOF>::DEFAULT_MAX_STEP = 0.2;
+template<size_t DOF> const double InverseKinematics<DOF>::DEFAULT_JOINT_LIMIT_GAIN = 0.05;
+template<size_t DOF> const double InverseKinematics<DOF>::NULLSPACE_DAMPING = 1e-4;
+
+
+template<size_t DOF>
+InverseKinematics<DOF>::InverseKinematics(const libconfig::Setting& kinSetting) :
+	kin(kinSetting), q(0.0),
+	lower(dof_vector::Constant(-std::numeric_limits<double>::infinity())),
+	upper(dof_vector::Constant(std::numeric_limits<double>::infinity())),
+	rest(dof_vector::Zero()), restGain(0.0),
+	damping(DEFAULT_DAMPING), maxIterations(DEFAULT_MAX_ITERATIONS),
+	positionTolerance(DEFAULT_POSITION_TOLERANCE), orientationTolerance(DEFAULT_ORIENTATION_TOLERANCE),
+	maxStep(DEFAULT_MAX_STEP), jointLimitGain(DEFAULT_JOINT_LIMIT_GAIN)
+{
+}
+
+template<size_t DOF>
+InverseKinematics<DOF>::InverseKinematics(const libconfig::Setting& kinSetting, const jp_type& lowerLimit, const jp_type& upperLimit) :
+	kin(kinSetting), q(0.0),
+	lower(), upper(),
+	rest(dof_vector::Zero()), restGain(0.0),
+	damping(DEFAULT_DAMPING), maxIterations(DEFAULT_MAX_ITERATIONS),
+	positionTolerance(DEFAULT_POSITION_TOLERANCE), orientationTolerance(DEFAULT_ORIENTATION_TOLERANCE),
+	maxStep(DEFAULT_MAX_STEP), jointLimitGain(DEFAULT_JOINT_LIMIT_GAIN)
+{
+	setJointLimits(lowerLimit, upperLimit);
+}
+
+template<size_t DOF>
+void InverseKinematics<DOF>::setJointLimits(const jp_type& lowerLimit, const jp_type& upperLimit)
+{
+	if ( !(lowerLimit.array() <= upperLimit.array()).all() ) {
+		throw std::invalid_argument("(math::InverseKinematics::setJointLimits): lowerLimit must not be greater than upperLimit.");
+	}
+
+	lower = lowerLimit;
+	upper = upperLimit;
+}
+
+template<size_t DOF>
+void InverseKinematics<DOF>::setRestPosition(const jp_type& restPosition, double gain)
+{
+	rest = restPosition;
+	restGain = gain;
+}
+
+template<size_t DOF>
+inline typename InverseKinematics<DOF>::Result InverseKinematics<DOF>::solve(const cp_type& position, jp_type* jp)
+{
+	return solveImpl<3>(position, Eigen::Matrix3d::Identity(), jp);
+}
+
+template<size_t DOF>
+inline typename InverseKinematics<DOF>::Result InverseKinematics<DOF>::solve(const cp_type& position, const Eigen::Quaterniond& orientation, jp_type* jp)
+{
+	return solveImpl<6>(position, orientation.normalized().toRotationMatrix(), jp);
+}
+
+template<size_t DOF>
+inline typename InverseKinematics<DOF>::Result InverseKinematics<DOF>::solve(const pose_type& pose, jp_type* jp)
+{
+	return solve(boost::get<0>(pose), boost::get<1>(pose), jp);
+}
+
+template<size_t DOF>
+template<typename InputIterator, typename OutputIterator>
+size_t InverseKinematics<DOF>::solvePath(InputIterator first, InputIterator last, const jp_type& seed, OutputIterator result)
+{
+	size_t numConverged = 0;
+	jp_type jp(seed);
+	for ( ; first != last; ++first, ++result) {
+		if (solve(*first, &jp).converged) {
+			++numConverged;
+		}
+		*result = jp;
+	}
+	return numConverged;
+}
+
+template<size_t DOF>
+template<int TaskDim>
+typename InverseKinematics<DOF>::Result InverseKinematics<DOF>::solveImpl(const Eigen::Vector3d& position, const Eigen::Matrix3d& orientation, jp_type* jp)
+{
+	typedef Eigen::Matrix<double, TaskDim, 1> task_vector;
+	typedef Eigen::Matrix<double, TaskDim, DOF> jacobian_type;
+	typedef Eigen::Matrix<double, TaskDim, TaskDim> task_matrix;
+
+	// Views into bt_kinematics' results
+	typedef Eigen::Map<const Eigen::Matrix<double, 6, DOF, Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > JacobianMap;
+	typedef Eigen::Map<const Eigen::Matrix<double, 3,3, Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > RotationMap;
+	typedef Eigen::Map<const Eigen::Vector3d, Eigen::Unaligned, Eigen::InnerStride<> > PositionMap;
+
+	const struct bt_kinematics* impl = kin.impl;
+	const JacobianMap toolJacobian(impl->tool_jacobian->data, 6, DOF, Eigen::OuterStride<>(impl->tool_jacobian->tda));
+	const RotationMap toolRotation(impl->tool->rot_to_world->data, 3, 3, Eigen::OuterStride<>(impl->tool->rot_to_world->tda));
+	const PositionMap toolPosition(impl->tool->origin_pos->data, 3, Eigen::InnerStride<>(impl->tool->origin_pos->stride));
+
+	const dof_vector mid = (lower + upper) / 2.0;
+	const dof_vector range = upper - lower;
+
+	Result result;
+	result.converged = false;
+
+	dof_vector qi = *jp;
+	clampToLimits(&qi);
+
+	task_vector e;
+	jacobian_type J;
+	task_matrix A;
+	dof_vector dq, z;
+
+	for (result.iterations = 0; ; ++result.iterations) {
+		q = qi;
+		bt_kinematics_eval(kin.impl, q.asGslType().get(), NULL);
+
+		e.template head<3>() = position - toolPosition;
+		result.positionError = e.template head<3>().norm();
+		result.orientationError = 0.0;
+		if (TaskDim == 6) {
+			// Rotation taking the tool to the target, as an axis times an angle in the world frame
+			Eigen::AngleAxisd error(orientation * toolRotation.transpose());
+			e.template tail<3>() = error.angle() * error.axis();
+			result.orientationError = error.angle();
+		}
+
+		if (result.positionError <= positionTolerance  &&  result.orientationError <= orientationTolerance) {
+			result.converged = true;
+			break;
+		}
+		if (result.iterations >= maxIterations) {
+			break;
+		}
+
+		J = toolJacobian.template topRows<TaskDim>();
+		// Error-dependent damping (Levenberg-Marquardt style): heavy when far
+		// from the target, where the linearization is poor, and light near
+		// it, so convergence stays fast even close to singularities.
+		const double lambda2 = damping * damping + 0.5 * e.squaredNorm();
+		A = J * J.transpose();
+		A.diagonal().array() += lambda2;
+		dq = J.transpose() * A.ldlt().solve(e);
+
+		// Secondary objectives, projected into the nullspace of the task.
+		// Projecting with the task's damping would leak part of z into the
+		// task and leave a steady-state error, so the projector gets only
+		// enough damping to stay bounded near singularities.
+		for (size_t i = 0; i < DOF; ++i) {
+			z[i] = std::isfinite(range[i]) && range[i] > 0.0 ?
+					-jointLimitGain * (qi[i] - mid[i]) / (range[i] * range[i]) : 0.0;
+		}
+		z += restGain * (rest - qi);
+		A.diagonal().array() += NULLSPACE_DAMPING * NULLSPACE_DAMPING - lambda2;
+		dq += z - J.transpose() * A.ldlt().solve(J * z);
+
+		const double stepSize = dq.cwiseAbs().maxCoeff();
+		if (stepSize > maxStep) {
+			dq *= maxStep / stepSize;
+		}
+
+		qi += dq;
+		clampToLimits(&qi);
+	}
+
+	*jp = qi;
+	return result;
+}
+
+template<size_t DOF>
+inline void InverseKinematics<DOF>::clampToLimits(dof_vector* qi) const
+{
+	*qi = qi->cwiseMax(lower).cwiseMin(upper);
+}
+
+
+}
+}
@@ -32,7 +32,7 @@ Kinematics<DOF>::~Kinematics()
 template<size_t DOF>
 void Kinematics<DOF>::eval(const jp_type& jp, const jv_type& jv)
 {
-	bt_kinematics_eval(impl, jp.asGslType(), jv.asGslType());
+	bt_kinematics_eval(impl, jp.asGslType().get(), jv.asGslType().get());
 }
 
 template<size_t DOF>
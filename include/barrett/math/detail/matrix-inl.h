@@ -24,67 +24,58 @@ namespace math {
 
 //template<int R, int C, typename Units>
 //inline Matrix<R,C, Units>::Matrix() :
-//	Base(), gsl()
+//	Base()
 //{
-//	initGslType(&gsl);
 //}
 //
 //template<int R, int C, typename Units>
 //inline Matrix<R,C, Units>::Matrix(int dim) :
-//	Base(dim), gsl()
+//	Base(dim)
 //{
-//	initGslType(&gsl);
 //}
 //
 //template<int R, int C, typename Units>
 //inline Matrix<R,C, Units>::Matrix(int r, int c) :
-//	Base(r, c), gsl()
+//	Base(r, c)
 //{
-//	initGslType(&gsl);
 //}
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(double x, double y) :
-	Base(x, y), gsl()
+	Base(x, y)
 {
-	initGslType(&gsl);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(double x, double y, double z) :
-	Base(x, y, z), gsl()
+	Base(x, y, z)
 {
-	initGslType(&gsl);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(double x, double y, double z, double w) :
-	Base(x, y, z, w), gsl()
+	Base(x, y, z, w)
 {
-	initGslType(&gsl);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(const double* data) :
-	Base(data), gsl()
+	Base(data)
 {
-	initGslType(&gsl);
 }
 
 template<int R, int C, typename Units>
 template<typename OtherDerived>
 inline Matrix<R,C, Units>::Matrix(const Eigen::MatrixBase<OtherDerived>& other) :
-	Base(other), gsl()
+	Base(other)
 {
-	initGslType(&gsl);
 }
 
 template<int R, int C, typename Units>
 template<typename OtherDerived>
 inline Matrix<R,C, Units>::Matrix(const Eigen::RotationBase<OtherDerived,Base::ColsAtCompileTime>& r) :
-	Base(r), gsl()
+	Base(r)
 {
-	initGslType(&gsl);
 }
 
 //template<int R, int C, typename Units>
@@ -98,43 +89,38 @@ inline Matrix<R,C, Units>::Matrix(const Eigen::RotationBase<OtherDerived,Base::C
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(double d) :
-	Base(), gsl()
+	Base()
 {
-	initGslType(&gsl);
 	this->setConstant(d);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(int r, double d) :
-	Base(r), gsl()
+	Base(r)
 {
-	initGslType(&gsl);
 	this->setConstant(d);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(int r, int c, double d) :
-	Base(r,c), gsl()
+	Base(r,c)
 {
-	initGslType(&gsl);
 	this->setConstant(d);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(const gsl_type* gslType) :
-	Base(), gsl()
+	Base()
 {
 	resizeToMatchIfDynamic(gslType);
-	initGslType(&gsl);
 	copyFrom(gslType);
 }
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(const libconfig::Setting& setting) :
-	Base(), gsl()
+	Base()
 {
 	resizeIfDynamic(setting.getLength(), setting[0].isNumber() ? 1 : setting[0].getLength());
-	initGslType(&gsl);
 	copyFrom(setting);
 }
 
@@ -142,9 +128,8 @@ inline Matrix<R,C, Units>::Matrix(const libconfig::Setting& setting) :
 
 template<int R, int C, typename Units>
 inline Matrix<R,C, Units>::Matrix(const Matrix& a) :
-	Base(a), gsl(a.gsl)
+	Base(a)
 {
-	initGslType(&gsl);
 }
 
 template<int R, int C, typename Units>
@@ -241,15 +226,19 @@ inline void Matrix<R,C, Units>::copyFrom(const libconfig::Setting& setting)
 }
 
 template<int R, int C, typename Units>
-inline typename Matrix<R,C, Units>::gsl_type* Matrix<R,C, Units>::asGslType()
+inline typename Matrix<R,C, Units>::gsl_view_type Matrix<R,C, Units>::asGslType()
 {
-	return &(this->gsl);
+	gsl_type g;
+	initGslType(&g);
+	return gsl_view_type(g);
 }
 
 template<int R, int C, typename Units>
-inline const typename Matrix<R,C, Units>::gsl_type* Matrix<R,C, Units>::asGslType() const
+inline typename Matrix<R,C, Units>::const_gsl_view_type Matrix<R,C, Units>::asGslType() const
 {
-	return &(this->gsl);
+	gsl_type g;
+	initGslType(&g);
+	return const_gsl_view_type(g);
 }
 
 template<int R, int C, typename Units>
@@ -261,21 +250,21 @@ inline void Matrix<R,C, Units>::resizeIfDynamic(int r, int c)
 }
 
 template<int R, int C, typename Units>
-inline void Matrix<R,C, Units>::initGslType(gsl_vector* g)
+inline void Matrix<R,C, Units>::initGslType(gsl_vector* g) const
 {
 	g->size = this->size();
 	g->stride = 1;
-	g->data = this->data();
+	g->data = const_cast<double*>(this->data());
 	g->block = NULL;
 	g->owner = 0;
 }
 template<int R, int C, typename Units>
-inline void Matrix<R,C, Units>::initGslType(gsl_matrix* g)
+inline void Matrix<R,C, Units>::initGslType(gsl_matrix* g) const
 {
 	g->size1 = this->rows();
 	g->size2 = this->cols();
 	g->tda = this->cols();
-	g->data = this->data();
+	g->data = const_cast<double*>(this->data());
 	g->block = NULL;
 	g->owner = 0;
 }
@@ -30,12 +30,12 @@
 
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 #include <cassert>
 
-#include <gsl/gsl_interp.h>
-
 #include <barrett/math/utils.h>
-#include <barrett/cdlbt/spline.h>
 
 
 namespace barrett {
@@ -45,80 +45,137 @@ namespace math {
 template<typename T>
 template<template<typename, typename> class Container, typename Allocator>
 Spline<T>::Spline(const Container<tuple_type, Allocator>& samples, bool saturateS) :
-	impl(NULL), sat(saturateS), s_0(0.0), s_f(0.0)
+	knots(samples.size()), coefficients(), sat(saturateS), s_0(0.0), s_f(0.0)
 {
-	s_0 = boost::get<0>(samples[0]);
-
-	bt_spline_create(&impl, boost::get<1>(samples[0]).asGslType(), BT_SPLINE_MODE_EXTERNAL);
-
-	typename Container<tuple_type, Allocator>::const_iterator i;
-	for (i = ++(samples.begin()); i != samples.end(); ++i) {  // start with the 2nd sample
-		bt_spline_add(impl, boost::get<1>(*i).asGslType(), boost::get<0>(*i) - s_0);
+	std::vector<T, Eigen::aligned_allocator<T> > points(samples.size());
+	for (size_t i = 0; i < samples.size(); ++i) {
+		knots[i] = boost::get<0>(samples[i]);
+		points[i] = boost::get<1>(samples[i]);
 	}
 
-	bt_spline_init(impl, NULL, NULL);
-	s_f = s_0 + changeInS();
+	init(points);
 }
 
 template<typename T>
 template<template<typename, typename> class Container, typename Allocator>
 Spline<T>::Spline(const Container<T, Allocator>& points, /*const typename T::unitless_type& initialDirection,*/ bool saturateS) :
-	impl(NULL), sat(saturateS), s_0(0.0), s_f(0.0)
+	knots(points.size()), coefficients(), sat(saturateS), s_0(0.0), s_f(0.0)
 {
-	bt_spline_create(&impl, points[0].asGslType(), BT_SPLINE_MODE_ARCLEN);
+	// Parameterize by the length of the polyline through the points.
+	knots[0] = 0.0;
+	for (size_t i = 1; i < points.size(); ++i) {
+		double len = (points[i] - points[i-1]).norm();
 
-	typename Container<T, Allocator>::const_iterator i;
-	for (i = ++(points.begin()); i != points.end(); ++i) {  // start with the 2nd sample
-		bt_spline_add(impl, (*i).asGslType(), 0);
+		// Keep coincident points from producing a zero-length segment.
+		knots[i] = knots[i-1] + (len != 0.0 ? len : 1e-5);
 	}
 
-	/*
-	// local copy because init modifies its 3rd parameter
-	typename T::unitless_type id(initialDirection);
-	bt_spline_init(impl, NULL, id.asGslType());
-	*/
-	bt_spline_init(impl, NULL, NULL);
-
-	s_f = s_0 + changeInS();
+	init(points);
 }
 
+// Computes the coefficients of a natural cubic spline through points at
+// knots. The tridiagonal system for the quadratic coefficients has the same
+// matrix for every dimension, so it is solved once with vector right-hand
+// sides.
 template<typename T>
-Spline<T>::~Spline()
+template<typename Container>
+void Spline<T>::init(const Container& points)
 {
-	bt_spline_destroy(impl);
-	impl = NULL;
+	typedef Eigen::Matrix<double, T::RowsAtCompileTime, 1> column_type;
+	typedef std::vector<column_type, Eigen::aligned_allocator<column_type> > column_vector;
+
+	const size_t n = knots.size();
+	assert(n >= 2);
+	const int dim = points[0].size();
+
+	s_0 = knots.front();
+	s_f = knots.back();
+
+	std::vector<double> h(n - 1);
+	column_vector slope(n - 1, column_type(dim));
+	for (size_t i = 0; i < n - 1; ++i) {
+		h[i] = knots[i+1] - knots[i];
+		assert(h[i] > 0.0);  // s must be strictly increasing
+		slope[i] = (points[i+1] - points[i]) / h[i];
+	}
+
+	// Solve for c[1] ... c[n-2] using the Thomas algorithm. The natural end
+	// conditions are c[0] = c[n-1] = 0.
+	column_vector c(n, column_type::Zero(dim));
+	if (n > 2) {
+		std::vector<double> diag(n);
+		column_vector rhs(n, column_type::Zero(dim));
+		for (size_t i = 1; i < n - 1; ++i) {
+			diag[i] = 2.0 * (h[i-1] + h[i]);
+			rhs[i] = 3.0 * (slope[i] - slope[i-1]);
+		}
+		for (size_t i = 2; i < n - 1; ++i) {
+			double w = h[i-1] / diag[i-1];
+			diag[i] -= w * h[i-1];
+			rhs[i] -= w * rhs[i-1];
+		}
+		c[n-2] = rhs[n-2] / diag[n-2];
+		for (size_t i = n - 3; i >= 1; --i) {
+			c[i] = (rhs[i] - h[i] * c[i+1]) / diag[i];
+		}
+	}
+
+	coefficients.resize(n - 1, coefficient_type(dim, 4));
+	for (size_t i = 0; i < n - 1; ++i) {
+		coefficients[i].col(0) = points[i];
+		coefficients[i].col(1) = slope[i] - h[i] * (2.0 * c[i] + c[i+1]) / 3.0;
+		coefficients[i].col(2) = c[i];
+		coefficients[i].col(3) = (c[i+1] - c[i]) / (3.0 * h[i]);
+	}
 }
 
 template<typename T>
-inline double Spline<T>::changeInS() const
+inline size_t Spline<T>::findSegment(double s) const
 {
-	return impl->length;
+	// The first and last segments extend to cover values of s that are out
+	// of range (only possible when not saturating).
+	std::vector<double>::const_iterator i =
+			std::upper_bound(knots.begin() + 1, knots.end() - 1, s);
+	return (i - knots.begin()) - 1;
 }
 
 template<typename T>
 inline T Spline<T>::eval(double s) const
 {
-	if (sat) {
-		s = saturate(s, s_0, s_f);
-	}
-
 	T result;
-	bt_spline_get(impl, result.asGslType(), s - s_0);
+	eval(s, &result, NULL, NULL);
 	return result;
 }
 
 template<typename T>
 inline T Spline<T>::evalDerivative(double s) const
+{
+	T result;
+	eval(s, NULL, &result, NULL);
+	return result;
+}
+
+template<typename T>
+inline void Spline<T>::eval(double s, T* position, T* velocity, T* acceleration) const
 {
 	if (sat) {
 		s = saturate(s, s_0, s_f);
 	}
 
-	T result;
-	for (int i = 0; i < impl->dimension; ++i) {
-		result[i] = gsl_interp_eval_deriv(impl->interps[i], impl->ss, impl->points[i], s - s_0, impl->acc);
+	const size_t i = findSegment(s);
+	const double ds = s - knots[i];
+	const coefficient_type& c = coefficients[i];
+
+	// Horner's method, for all dimensions at once
+	if (position != NULL) {
+		*position = ((c.col(3) * ds + c.col(2)) * ds + c.col(1)) * ds + c.col(0);
+	}
+	if (velocity != NULL) {
+		*velocity = (3.0 * c.col(3) * ds + 2.0 * c.col(2)) * ds + c.col(1);
+	}
+	if (acceleration != NULL) {
+		*acceleration = 6.0 * c.col(3) * ds + 2.0 * c.col(2);
 	}
-	return result;
 }
 
 
@@ -126,64 +183,185 @@ inline T Spline<T>::evalDerivative(double s) const
 template<typename Scalar>
 template<template<typename, typename> class Container, typename Allocator>
 Spline<Eigen::Quaternion<Scalar> >::Spline(const Container<tuple_type, Allocator>& samples, bool saturateS) :
-	data(samples.begin(), samples.end()), sat(saturateS), index(0), rate(-1.0)
+	knots(samples.size()), segments(), sat(saturateS), uniformRate(0.0)
 {
-	// Make sure s is monotonic.
-	for (size_t i = 0; i < data.size() - 1; ++i) {
-		assert(boost::get<0>(data[i]) < boost::get<0>(data[i+1]));
+	std::vector<data_type, Eigen::aligned_allocator<data_type> > points(samples.size());
+	for (size_t i = 0; i < samples.size(); ++i) {
+		knots[i] = boost::get<0>(samples[i]);
+		points[i] = boost::get<1>(samples[i]);
 	}
+
+	init(points);
 }
 
 template<typename Scalar>
 template<template<typename, typename> class Container, typename Allocator>
 Spline<Eigen::Quaternion<Scalar> >::Spline(const Container<data_type, Allocator>& points, bool saturateS) :
-	data(points.size()), sat(saturateS), index(0), rate(-1.0)
+	knots(points.size()), segments(), sat(saturateS), uniformRate(0.0)
 {
-	double s = 0.0;
-	for (size_t i = 0; i < data.size(); ++i) {
-		if (i > 0) {
-			double ad = points.at(i).angularDistance(points.at(i-1));
-			assert(ad >= 0.0);
+	knots[0] = 0.0;
+	for (size_t i = 1; i < points.size(); ++i) {
+		double ad = points.at(i).angularDistance(points.at(i-1));
+		assert(ad >= 0.0);
+
+		// If the points are too close together, enforce an artificial
+		// minimum distance. This keeps division by delta-s under control.
+		knots[i] = knots[i-1] + math::max(ad, 1e-4);
+	}
 
-			// If the points are too close together, enforce an artificial
-			// minimum distance. This keeps division by delta-s under control.
-			s += math::max(ad, 1e-4);
+	init(points);
+}
+
+// Computes the SQUAD inner control points and the slerp angles of each
+// segment. With L+ = log(q_i^-1 q_i+1) and L- = log(q_i^-1 q_i-1), the
+// angular velocity at q_i is taken to be w = (L+ - L-) / (h_i-1 + h_i), and
+// the control points on either side of q_i are
+//   a_i+ = q_i exp((h_i w - L+) / 2)      (starts segment i)
+//   a_i- = q_i exp(-(h_i-1 w + L-) / 2)   (ends segment i-1)
+// so the spline is C1 in s even if the knots are unevenly spaced. For evenly
+// spaced knots both reduce to the usual q_i exp(-(L+ + L-) / 4).
+template<typename Scalar>
+template<typename Container>
+void Spline<Eigen::Quaternion<Scalar> >::init(const Container& points)
+{
+	typedef Eigen::Matrix<Scalar, 3,1> tangent_type;
+
+	const size_t n = knots.size();
+	assert(n >= 2);
+
+	// q and -q are the same orientation. Pick signs so that neighbors are
+	// in the same hemisphere and each segment takes the short way around.
+	std::vector<data_type, Eigen::aligned_allocator<data_type> > q(points.begin(), points.end());
+	for (size_t i = 1; i < n; ++i) {
+		if (q[i].dot(q[i-1]) < 0.0) {
+			q[i].coeffs() = -q[i].coeffs();
 		}
+	}
 
-		boost::get<0>(data[i]) = s;
-		boost::get<1>(data[i]) = points.at(i);
+	std::vector<data_type, Eigen::aligned_allocator<data_type> > aPlus(q), aMinus(q);
+	for (size_t i = 1; i < n - 1; ++i) {
+		data_type qInv = q[i].conjugate();
+		tangent_type lPlus = log(qInv * q[i+1]);
+		tangent_type lMinus = log(qInv * q[i-1]);
+		double hPrev = knots[i] - knots[i-1];
+		double hNext = knots[i+1] - knots[i];
+		tangent_type w = (lPlus - lMinus) / (hPrev + hNext);
+
+		aPlus[i] = q[i] * exp(0.5 * (hNext * w - lPlus));
+		aMinus[i] = q[i] * exp(-0.5 * (hPrev * w + lMinus));
 	}
 
-	// Make sure s is monotonic.
-	for (size_t i = 0; i < data.size() - 1; ++i) {
-		assert(boost::get<0>(data[i]) < boost::get<0>(data[i+1]));
+	segments.resize(n - 1);
+	for (size_t i = 0; i < n - 1; ++i) {
+		assert(knots[i] < knots[i+1]);  // s must be strictly increasing
+
+		segments[i].outer.init(q[i], q[i+1]);
+		segments[i].inner.init(aPlus[i], aMinus[i+1]);
+		segments[i].rate = 1.0 / (knots[i+1] - knots[i]);
+	}
+
+	// Evenly spaced knots (e.g. a recording sampled at a fixed rate) let
+	// findSegment() skip the search.
+	const double h = knots[1] - knots[0];
+	uniformRate = 1.0 / h;
+	for (size_t i = 1; i < n - 1; ++i) {
+		if (std::abs((knots[i+1] - knots[i]) - h) > 1e-9 * h) {
+			uniformRate = 0.0;
+			break;
+		}
+	}
+}
+
+template<typename Scalar>
+inline size_t Spline<Eigen::Quaternion<Scalar> >::findSegment(double s) const
+{
+	if (uniformRate > 0.0) {
+		double i = std::floor((s - knots.front()) * uniformRate);
+		if (i <= 0.0) {
+			return 0;
+		}
+		return std::min(static_cast<size_t>(i), segments.size() - 1);
+	} else {
+		std::vector<double>::const_iterator i =
+				std::upper_bound(knots.begin() + 1, knots.end() - 1, s);
+		return (i - knots.begin()) - 1;
 	}
 }
 
 template<typename Scalar>
 typename Spline<Eigen::Quaternion<Scalar> >::data_type Spline<Eigen::Quaternion<Scalar> >::eval(double s) const
 {
+	// Orientation splines are always saturated; there is no sensible way to
+	// extrapolate past the end quaternions.
 	s = saturate(s, initialS(), finalS());
 
-	while (index > 0  &&  s < boost::get<0>(data[index])) {
-		--index;
-		rate = -1.0;
+	const size_t i = findSegment(s);
+	const Segment& seg = segments[i];
+	const Scalar t = saturate((s - knots[i]) * seg.rate, 0.0, 1.0);
+
+	return seg.outer.eval(t).slerp(2.0 * t * (1.0 - t), seg.inner.eval(t));
+}
+
+template<typename Scalar>
+void Spline<Eigen::Quaternion<Scalar> >::Arc::init(const data_type& a, const data_type& b)
+{
+	from = a;
+	to = b;
+
+	Scalar d = a.dot(b);
+	if (d < 0.0) {
+		to.coeffs() = -to.coeffs();
+		d = -d;
 	}
-	while (index < data.size()-1  &&  s >= boost::get<0>(data[index+1])) {
-		++index;
-		rate = -1.0;
+
+	if (d >= 1.0 - Eigen::NumTraits<Scalar>::dummy_precision()) {
+		angle = 0.0;
+		invSinAngle = 0.0;
+	} else {
+		angle = std::acos(d);
+		invSinAngle = 1.0 / std::sin(angle);
 	}
-	assert(index < data.size());
+}
 
-	if (index == data.size()-1) {
-		return boost::get<1>(data[index]);
+template<typename Scalar>
+inline typename Spline<Eigen::Quaternion<Scalar> >::data_type Spline<Eigen::Quaternion<Scalar> >::Arc::eval(Scalar t) const
+{
+	data_type result;
+	if (invSinAngle == 0.0) {
+		// Nearly coincident end points: lerp
+		result.coeffs() = (1.0 - t) * from.coeffs() + t * to.coeffs();
+		result.normalize();
 	} else {
-		if (rate < 0.0) {
-			rate = 1.0 / (boost::get<0>(data[index+1]) - boost::get<0>(data[index]));
-		}
+		result.coeffs() = (std::sin((1.0 - t) * angle) * invSinAngle) * from.coeffs() +
+				(std::sin(t * angle) * invSinAngle) * to.coeffs();
+	}
+	return result;
+}
 
-		return boost::get<1>(data[index]).slerp(rate * (s - boost::get<0>(data[index])), boost::get<1>(data[index+1]));
+template<typename Scalar>
+Eigen::Matrix<Scalar, 3,1> Spline<Eigen::Quaternion<Scalar> >::log(const data_type& q)
+{
+	const Scalar sinAngle = q.vec().norm();
+	if (sinAngle < Eigen::NumTraits<Scalar>::dummy_precision()) {
+		return q.vec();
+	}
+	return q.vec() * (std::atan2(sinAngle, q.w()) / sinAngle);
+}
+
+template<typename Scalar>
+typename Spline<Eigen::Quaternion<Scalar> >::data_type Spline<Eigen::Quaternion<Scalar> >::exp(const Eigen::Matrix<Scalar, 3,1>& v)
+{
+	const Scalar angle = v.norm();
+	data_type result;
+	if (angle < Eigen::NumTraits<Scalar>::dummy_precision()) {
+		result.w() = 1.0;
+		result.vec() = v;
+		result.normalize();
+	} else {
+		result.w() = std::cos(angle);
+		result.vec() = v * (std::sin(angle) / angle);
 	}
+	return result;
 }
 
 
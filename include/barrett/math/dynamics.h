@@ -11,6 +11,8 @@
 
 #include <libconfig.h++>
 #include <boost/tuple/tuple.hpp>
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
 
 #include <barrett/detail/ca_macro.h>
 #include <barrett/units.h>
@@ -33,17 +35,53 @@ public:
 	Dynamics(const libconfig::Setting& setting);
 	~Dynamics();
 
+	/// Joint torques for the given motion (RNEA). Doesn't include gravity.
 	const jt_type& evalInverse(const Kinematics<DOF>& kin, const jv_type& jv, const ja_type& ja);
 
+	/** @name Model-based control
+	 *
+	 * These are computed on fixed-size types from the parameters read at
+	 * construction; kin must already be evaluated at the current joint
+	 * positions. Like evalInverse(), they don't include gravity.
+	 */
+	//@{
+	/// The joint-space inertia matrix M(q)
+	const sqm_type& evalMassMatrix(const Kinematics<DOF>& kin);
+	/// Coriolis and centrifugal torques h(q, qd)
+	const jt_type& evalBias(const Kinematics<DOF>& kin, const jv_type& jv);
+	/// Joint accelerations M^-1 (jt - h), from a Cholesky factorization of M
+	const ja_type& evalForward(const Kinematics<DOF>& kin, const jv_type& jv, const jt_type& jt);
+	/// The torques that hold the links still against gravity (in m/s^2, along the world z-axis)
+	const jt_type& evalGravity(const Kinematics<DOF>& kin, double gravity);
+	//@}
+
 //	typedef const jt_type& result_type;  ///< For use with boost::bind().
 //	result_type operator() (const boost::tuple<jv_type, ja_type>& jointState);
 
 protected:
+	typedef Eigen::Matrix<double, DOF,DOF> dof_matrix;
+
+	// RNEA on fixed-size types, behind both evalInverse() and evalBias()
+	void evalRnea(const Kinematics<DOF>& kin, const jv_type& jv, const ja_type* ja, jt_type* result) const;
+
 	struct bt_dynamics* impl;
 	jt_type jt;
 
+	double mass[DOF];
+	Eigen::Vector3d com[DOF];  // in the link frame
+	Eigen::Matrix3d inertia[DOF];  // about the COM, in the link frame
+
+	sqm_type M;
+	jt_type h;
+	jt_type g;
+	ja_type ja;
+	Eigen::LLT<dof_matrix> llt;
+
 private:
 	DISALLOW_COPY_AND_ASSIGN(Dynamics);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
 
@@ -0,0 +1,73 @@
+/*
+ * gravity.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef BARRETT_MATH_GRAVITY_H_
+#define BARRETT_MATH_GRAVITY_H_
+
+
+#include <libconfig.h++>
+#include <Eigen/Core>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/units.h>
+#include <barrett/math/kinematics.h>
+
+
+namespace barrett {
+namespace math {
+
+
+/** Calibrated gravity compensation on fixed-size types.
+ *
+ * Computes the same joint torques as bt_calgrav_eval(), from the same "mus"
+ * configuration, but keeps its state in fixed-size Eigen vectors and reads
+ * the link rotations from the Kinematics object in place. The per-link loop
+ * has a compile-time trip count, so each DOF gets its own unrolled kernel.
+ *
+ * The arithmetic is done in the same order as the reference BLAS used by
+ * the C version, so the results are identical, not just close.
+ */
+template<size_t DOF>
+class Gravity {
+	BARRETT_UNITS_TEMPLATE_TYPEDEFS(DOF);
+
+public:
+	static const double DEFAULT_GRAVITY;  ///< z-component of gravity in the world frame (m/s^2)
+
+	/// @param setting The "gravity_compensation" group (must contain "mus")
+	explicit Gravity(const libconfig::Setting& setting);
+
+	void setGravity(double gz) {  gravity = gz;  }
+	double getGravity() const {  return gravity;  }
+
+	const Eigen::Vector3d& getMu(size_t link) const {  return mu[link];  }
+
+	/// Computes gravity-compensating torques for the current state of kin.
+	void eval(const Kinematics<DOF>& kin, jt_type* jt) const;
+	const jt_type& eval(const Kinematics<DOF>& kin);
+
+protected:
+	Eigen::Vector3d mu[DOF];
+	double gravity;
+	jt_type jt;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(Gravity);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/math/detail/gravity-inl.h>
+
+
+#endif /* BARRETT_MATH_GRAVITY_H_ */
@@ -0,0 +1,138 @@
+/*
+ * inverse_kinematics.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef BARRETT_MATH_INVERSE_KINEMATICS_H_
+#define BARRETT_MATH_INVERSE_KINEMATICS_H_
+
+
+#include <libconfig.h++>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/units.h>
+#include <barrett/math/kinematics.h>
+
+
+namespace barrett {
+namespace math {
+
+
+/** Damped-least-squares inverse kinematics.
+ *
+ * Each iteration evaluates the forward kinematics and the tool Jacobian J
+ * and takes the step
+ *
+ *     dq = J^T (J J^T + lambda^2 I)^-1 e  +  (I - J^+ J) z
+ *
+ * where lambda^2 = damping^2 + |e|^2 / 2 grows with the error, e is the
+ * position (and optionally orientation) error and z pulls the
+ * joints away from their limits and toward an optional rest posture without
+ * disturbing the tool. Steps are clamped to a maximum joint-space length and
+ * the result is clamped to the joint limits.
+ *
+ * Solving is warm-started from the joint positions passed in and stops after
+ * a bounded number of iterations. Nothing is allocated after construction,
+ * so solve() can be called from the realtime thread. The solver owns its own
+ * Kinematics object, so it doesn't disturb the WAM's; an instance must only
+ * be used by one thread at a time.
+ */
+template<size_t DOF>
+class InverseKinematics {
+	BARRETT_UNITS_TEMPLATE_TYPEDEFS(DOF);
+
+public:
+	struct Result {
+		bool converged;
+		size_t iterations;
+		double positionError;  ///< m
+		double orientationError;  ///< rad
+	};
+
+	static const size_t DEFAULT_MAX_ITERATIONS = 100;
+	static const double DEFAULT_DAMPING;
+	static const double DEFAULT_POSITION_TOLERANCE;
+	static const double DEFAULT_ORIENTATION_TOLERANCE;
+	static const double DEFAULT_MAX_STEP;
+	static const double DEFAULT_JOINT_LIMIT_GAIN;
+
+	/// @param kinSetting The "kinematics" group of the WAM's configuration
+	explicit InverseKinematics(const libconfig::Setting& kinSetting);
+	InverseKinematics(const libconfig::Setting& kinSetting, const jp_type& lowerLimit, const jp_type& upperLimit);
+
+	void setJointLimits(const jp_type& lowerLimit, const jp_type& upperLimit);
+	/// The damping used at the target; it grows with the error away from it.
+	void setDamping(double lambda) {  damping = lambda;  }
+	void setMaxIterations(size_t n) {  maxIterations = n;  }
+	void setTolerance(double position, double orientation) {
+		positionTolerance = position;
+		orientationTolerance = orientation;
+	}
+	/// Largest joint-space step (rad) taken in one iteration
+	void setMaxStep(double step) {  maxStep = step;  }
+	/// Strength of the nullspace push toward the middle of the joint ranges
+	void setJointLimitGain(double gain) {  jointLimitGain = gain;  }
+	/// Adds a nullspace pull toward rest. A gain of 0 disables it.
+	void setRestPosition(const jp_type& rest, double gain);
+
+	/// Solves for the tool position only. *jp is the initial guess and the result.
+	Result solve(const cp_type& position, jp_type* jp);
+	/// Solves for the tool position and orientation.
+	Result solve(const cp_type& position, const Eigen::Quaterniond& orientation, jp_type* jp);
+	Result solve(const pose_type& pose, jp_type* jp);
+
+	/** Converts a Cartesian path into a joint path.
+	 *
+	 * Each point is warm-started from the previous solution, starting from
+	 * seed. The value type of the input range can be cp_type or pose_type;
+	 * one jp_type is written to result per input. Returns the number of
+	 * points that converged.
+	 */
+	template<typename InputIterator, typename OutputIterator>
+	size_t solvePath(InputIterator first, InputIterator last, const jp_type& seed, OutputIterator result);
+
+	const Kinematics<DOF>& getKinematics() const {  return kin;  }
+
+protected:
+	typedef Eigen::Matrix<double, DOF, 1> dof_vector;
+
+	template<int TaskDim>
+	Result solveImpl(const Eigen::Vector3d& position, const Eigen::Matrix3d& orientation, jp_type* jp);
+
+	void clampToLimits(dof_vector* q) const;
+
+	static const double NULLSPACE_DAMPING;
+
+	Kinematics<DOF> kin;
+	jp_type q;  // gsl-compatible scratch for bt_kinematics_eval()
+
+	dof_vector lower, upper;
+	dof_vector rest;
+	double restGain;
+
+	double damping;
+	size_t maxIterations;
+	double positionTolerance, orientationTolerance;
+	double maxStep;
+	double jointLimitGain;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(InverseKinematics);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/math/detail/inverse_kinematics-inl.h>
+
+
+#endif /* BARRETT_MATH_INVERSE_KINEMATICS_H_ */
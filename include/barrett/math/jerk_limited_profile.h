@@ -0,0 +1,128 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file jerk_limited_profile.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_MATH_JERK_LIMITED_PROFILE_H_
+#define BARRETT_MATH_JERK_LIMITED_PROFILE_H_
+
+
+#include <boost/array.hpp>
+
+
+namespace barrett {
+namespace math {
+
+
+/** A jerk-limited (S-curve) move of one coordinate to rest at a target.
+ *
+ * plan() starts from any position, velocity and acceleration, so a move can
+ * be re-planned from the current state whenever the target changes. The
+ * profile has at most seven constant-jerk phases: bring the velocity to a
+ * peak (ending with zero acceleration), cruise, then bring it to zero. The
+ * peak velocity is the fastest one that respects the limits, making the move
+ * time-optimal among profiles of that shape.
+ *
+ * plan() and stretch() run a fixed number of bisection steps, and eval() is
+ * a lookup over the seven phases. None of them allocate, so all are safe to
+ * call from the realtime thread.
+ */
+class JerkLimitedProfile {
+public:
+	static const size_t MAX_PHASES = 7;
+
+	/// At rest at position p.
+	explicit JerkLimitedProfile(double p = 0.0);
+
+	/** Plans the fastest move from (p0, v0, a0) to rest at pf.
+	 *
+	 * vMax, aMax and jMax must be positive. If |v0| or |a0| is already above
+	 * its limit, the profile first brings it back within the limit.
+	 */
+	void plan(double p0, double v0, double a0, double pf, double vMax, double aMax, double jMax);
+
+	/** Slows the planned move down so it takes duration seconds, by lowering
+	 * the peak velocity.
+	 *
+	 * Returns false, leaving the profile unchanged, if duration is shorter than
+	 * finalT() or if the move can't be slowed down (because it only consists
+	 * of coming to a stop). Starting from a high speed, slowing down for a
+	 * while before stopping can also overshoot pf, so some durations can't be
+	 * reached either.
+	 */
+	bool stretch(double duration);
+
+	double finalT() const { return tf; }
+	double finalValue() const { return pf; }
+
+	/// Any of the output pointers may be NULL. For t >= finalT(), the result is exactly (finalValue(), 0, 0).
+	void eval(double t, double* p, double* v = NULL, double* a = NULL) const;
+	double eval(double t) const {
+		double p;
+		eval(t, &p);
+		return p;
+	}
+
+	typedef double result_type;  ///< For use with boost::bind().
+	result_type operator() (double t) const {
+		return eval(t);
+	}
+
+protected:
+	struct Phase {
+		double j, duration;
+	};
+	typedef boost::array<Phase, MAX_PHASES> phase_array;
+
+	// Fills in the three phases that take (v, a) to (v1, 0) as fast as possible.
+	void velocityChange(double v, double a, double v1, Phase* phases) const;
+	// Fills in all phases for a move through velocity peak that cruises for cruiseT.
+	void build(double peak, double cruiseT, phase_array* phases) const;
+	// The distance covered by phases.
+	double distance(const phase_array& phases) const;
+	double duration(const phase_array& phases) const;
+	// The cruise time (possibly negative) needed for a move through velocity peak to end at pf.
+	double cruiseTime(double peak) const;
+	void setPhases(const phase_array& phases);
+
+	double p0, v0, a0, pf;
+	double vMax, aMax, jMax;
+	double dir;  // The direction of the cruise, or 0.0 if the move only has to come to a stop
+	double vPeak;  // The magnitude of the peak velocity
+
+	phase_array phases;
+	// The state at the start of each phase
+	boost::array<double, MAX_PHASES> tStart, pStart, vStart, aStart;
+	double tf;
+};
+
+
+}
+}
+
+
+#endif /* BARRETT_MATH_JERK_LIMITED_PROFILE_H_ */
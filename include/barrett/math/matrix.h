@@ -13,6 +13,7 @@
 #include <stdexcept>
 
 #include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_const.hpp>
 #include <boost/mpl/assert.hpp>
 #include <boost/mpl/if.hpp>
 #include <boost/mpl/or.hpp>
@@ -32,6 +33,32 @@ namespace math {
 
 template<int R, int C, typename Units = void> class Matrix;
 
+
+/** A gsl_vector or gsl_matrix that shares a Matrix's storage.
+ *
+ * Matrix doesn't carry a GSL view of itself; Matrix::asGslType() makes one
+ * when a GSL or cdlbt function needs it:
+ *   gsl_vector_get(v.asGslType().get(), i);
+ * The pointer returned by get() points into the GslView, so it dies with the
+ * GslView. There is deliberately no implicit conversion to GslType*: it made
+ * "gsl_vector* g = v.asGslType();" compile and dangle. To keep a GSL struct
+ * around, fill one with Matrix::initGslType() instead. Either way it must not
+ * outlive the Matrix it was made from.
+ */
+template<typename GslType>
+class GslView {
+public:
+	typedef typename boost::remove_const<GslType>::type struct_type;
+
+	explicit GslView(const struct_type& g) : g(g) {}
+
+	GslType* get() const { return &g; }
+	GslType* operator->() const { return &g; }
+
+private:
+	mutable struct_type g;
+};
+
 template<int R, typename Units = void>
 struct Vector {
 	typedef math::Matrix<R,1, Units> type;
@@ -49,6 +76,8 @@ public:
 		gsl_vector,
 		gsl_matrix
 	>::type gsl_type;
+	typedef GslView<gsl_type> gsl_view_type;
+	typedef GslView<const gsl_type> const_gsl_view_type;
 
 	// TODO(dc): disable SIZE somehow for dynamic Matrices?
 	static const size_t SIZE = R*C;  ///< Length of the array. Avoid using this if possible in case dynamic sizing is supported in the future.
@@ -80,12 +109,8 @@ public:
     return this->rows() == 1 || this->cols() == 1;
   }
 
-	// the default operator= does it wrong.
 	inline Matrix& operator=(const Matrix& other) {
-		if (this != &other) {
-			// GSL stuff doen't need to be altered
-			this->Base::operator=(other);
-		}
+		this->Base::operator=(other);
 		return *this;
 	}
 
@@ -98,7 +123,6 @@ public:
 								boost::is_same<Units,	OtherUnits>
 							> ));
 
-		// GSL stuff doen't need to be altered
 		this->Base::operator=(other);
 		return *this;
 	}
@@ -137,15 +161,17 @@ public:
 
 	void copyFrom(const libconfig::Setting& setting);
 
-	gsl_type* asGslType();
-	const gsl_type* asGslType() const;
+	/// A GSL view of this Matrix's coefficients, made on demand. Don't keep it past the Matrix's lifetime.
+	gsl_view_type asGslType();
+	const_gsl_view_type asGslType() const;
+
+	/// Points *g at this Matrix's coefficients. *g is valid until the Matrix is resized or destroyed.
+	void initGslType(gsl_vector* g) const;
+	void initGslType(gsl_matrix* g) const;
 
 protected:
 	void resizeIfDynamic(int r, int c = 1);
 
-	void initGslType(gsl_vector* g);
-	void initGslType(gsl_matrix* g);
-
 	void resizeToMatchIfDynamic(const gsl_vector* g);
 	void resizeToMatchIfDynamic(const gsl_matrix* g);
 
@@ -157,8 +183,6 @@ protected:
 
 	void copyFromHelper(const gsl_vector* g);
 	void copyFromHelper(const gsl_matrix* g);
-
-	gsl_type gsl;
 };
 
 
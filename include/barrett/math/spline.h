@@ -45,14 +45,17 @@
 #include <barrett/math/detail/spline-helper.h>
 
 
-// forward declaration from <barrett/spline/spline.h>
-struct bt_spline;
-
-
 namespace barrett {
 namespace math {
 
 
+/** A natural cubic spline through a sequence of Eigen vectors.
+ *
+ * The polynomial coefficients of each segment are stored together for all
+ * dimensions, so an evaluation does one segment search (a binary search,
+ * without any mutable state, so const methods are safe to call concurrently)
+ * followed by Horner steps that operate on whole vectors.
+ */
 template<typename T>
 class Spline {
 public:
@@ -66,25 +69,38 @@ public:
 	template<template<typename, typename> class Container, typename Allocator>
 	Spline(const Container<T, Allocator>& points, /*const typename T::unitless_type& initialDirection = typename T::unitless_type(0.0),*/ bool saturateS = true);
 
-	~Spline();
-
 	double initialS() const { return s_0; }
 	double finalS() const { return s_f; }
-	double changeInS() const;
+	double changeInS() const { return s_f - s_0; }
 
 	T eval(double s) const;
 	T evalDerivative(double s) const;
 
+	/// Evaluates the spline and its first and second derivatives at s with a
+	/// single segment search. Any of the output pointers may be NULL.
+	void eval(double s, T* position, T* velocity, T* acceleration = NULL) const;
+
 	typedef T result_type;  ///< For use with boost::bind().
 	result_type operator() (double s) const {
 		return eval(s);
 	}
 
-	// Access the low-level spline implementation. Please avoid using this.
-	struct bt_spline* getImplementation() { return impl; }
+	/// The value of s at each of the points the spline was constructed from.
+	size_t numKnots() const { return knots.size(); }
+	double getKnot(size_t i) const { return knots[i]; }
 
 protected:
-	struct bt_spline* impl;
+	typedef Eigen::Matrix<double, T::RowsAtCompileTime, 4> coefficient_type;
+
+	template<typename Container> void init(const Container& points);
+	size_t findSegment(double s) const;
+
+	std::vector<double> knots;
+
+	// Column k of coefficients[i] holds the (s - knots[i])^k coefficients of
+	// segment i for every dimension.
+	std::vector<coefficient_type, Eigen::aligned_allocator<coefficient_type> > coefficients;
+
 	bool sat;
 	double s_0, s_f;
 
@@ -95,6 +111,13 @@ private:
 
 
 // Specialization for Eigen::Quaternion<> types
+/** A C1-continuous spherical spline (SQUAD) through a sequence of orientations.
+ *
+ * The inner control points and the slerp angles of every segment are
+ * computed by the constructor. A segment is found in constant time when the
+ * knots are evenly spaced and by binary search otherwise; eval() keeps no
+ * state between calls, so const methods are safe to call concurrently.
+ */
 template<typename Scalar>
 class Spline<Eigen::Quaternion<Scalar> > {
 public:
@@ -108,8 +131,8 @@ public:
 	template<template<typename, typename> class Container, typename Allocator>
 	Spline(const Container<data_type, Allocator>& points, bool saturateS = true);
 
-	double initialS() const { return boost::get<0>(data.front()); }
-	double finalS() const { return boost::get<0>(data.back()); }
+	double initialS() const { return knots.front(); }
+	double finalS() const { return knots.back(); }
 	double changeInS() const { return finalS() - initialS(); }
 
 	data_type eval(double s) const;
@@ -119,12 +142,45 @@ public:
 		return eval(s);
 	}
 
+	/// The value of s at each of the orientations the spline was constructed from.
+	size_t numKnots() const { return knots.size(); }
+	double getKnot(size_t i) const { return knots[i]; }
+
+	/// True if the knots are evenly spaced, so segments are found without a search.
+	bool hasUniformKnots() const { return uniformRate > 0.0; }
+
 protected:
-	std::vector<tuple_type, Eigen::aligned_allocator<tuple_type> > data;
-	bool sat;
+	// A slerp between two fixed quaternions, with the angle between them
+	// precomputed.
+	struct Arc {
+		data_type from, to;
+		Scalar angle, invSinAngle;  // invSinAngle == 0 means lerp
+
+		void init(const data_type& a, const data_type& b);
+		data_type eval(Scalar t) const;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+	};
 
-	mutable size_t index;
-	mutable double rate;
+	// Segment i runs from knots[i] to knots[i+1].
+	struct Segment {
+		Arc outer;  // slerp(q_i, q_i+1)
+		Arc inner;  // slerp(a_i+, a_i+1-), between the SQUAD control points
+		double rate;  // 1 / (knots[i+1] - knots[i])
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+	};
+
+	template<typename Container> void init(const Container& points);
+	size_t findSegment(double s) const;
+
+	static Eigen::Matrix<Scalar, 3,1> log(const data_type& q);
+	static data_type exp(const Eigen::Matrix<Scalar, 3,1>& v);
+
+	std::vector<double> knots;
+	std::vector<Segment, Eigen::aligned_allocator<Segment> > segments;
+	bool sat;
+	double uniformRate;  // segments per unit s if the knots are evenly spaced, 0.0 otherwise
 
 private:
 	// TODO(dc): write a real copy constructor and assignment operator?
@@ -0,0 +1,227 @@
+/*
+ * @file simulated_low_level_wam-inl.h
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+#include <Eigen/Cholesky>
+#include <libconfig.h++>
+
+#include <barrett/detail/libconfig_utils.h>
+#include <barrett/units.h>
+#include <barrett/cdlbt/kinematics.h>
+#include <barrett/products/safety_module.h>
+#include <barrett/math/kinematics.h>
+#include <barrett/math/dynamics.h>
+#include <barrett/math/gravity.h>
+
+#include <barrett/products/simulated_low_level_wam.h>
+
+
+namespace barrett {
+
+
+template<size_t DOF>
+SimulatedLowLevelWam<DOF>::SimulatedLowLevelWam(const libconfig::Setting& setting, double period_s) :
+	period(period_s), time(0.0), substeps(1),
+	home(setting["low_level"]["home"]), j2mp(setting["low_level"]["j2mp"]),
+	motorTorqueLimits(std::numeric_limits<double>::infinity()),
+	countsPerRad(DEFAULT_ENCODER_COUNTS / (2*M_PI)), radsPerCount(2*M_PI / DEFAULT_ENCODER_COUNTS),
+	rotorInertia(0.0), damping(0.0), velocityLimit(0.0),
+	gravity(math::Gravity<DOF>::DEFAULT_GRAVITY),
+	kin(setting["kinematics"]), dyn(setting["dynamics"]), llt(),
+	q(0.0), qd(0.0), jtCommanded(0.0), jtApplied(0.0),
+	mode(SafetyModule::ACTIVE), velocityFault(false)
+{
+	if (period <= 0.0) {
+		throw std::invalid_argument("(SimulatedLowLevelWam::SimulatedLowLevelWam): period_s must be positive.");
+	}
+
+	// Compute motor/joint transforms
+	Eigen::FullPivLU<typename sqm_type::Base> lu(j2mp);
+	if (!lu.isInvertible()) {
+		throw std::runtime_error("(SimulatedLowLevelWam::SimulatedLowLevelWam): j2mp matrix is not invertible.");
+	}
+	m2jp = lu.inverse();
+	j2mt = m2jp.transpose();
+
+	if (setting.exists("simulation")) {
+		const libconfig::Setting& sim = setting["simulation"];
+
+		if (sim.exists("motor_torque_limits")) {
+			motorTorqueLimits = v_type(sim["motor_torque_limits"]);
+		}
+		if (sim.exists("motor_encoder_counts")) {
+			v_type counts(sim["motor_encoder_counts"]);
+			for (size_t i = 0; i < DOF; ++i) {
+				countsPerRad[i] = counts[i] / (2*M_PI);
+				radsPerCount[i] = 2*M_PI / counts[i];
+			}
+		}
+		if (sim.exists("motor_inertias")) {
+			// Each rotor's inertia, as felt at the joints
+			v_type motorInertias(sim["motor_inertias"]);
+			rotorInertia = j2mp.transpose() * motorInertias.asDiagonal() * j2mp;
+		}
+		if (sim.exists("joint_damping")) {
+			damping = v_type(sim["joint_damping"]);
+		}
+		if (sim.exists("velocity_limit")) {
+			velocityLimit = detail::numericToDouble(sim["velocity_limit"]);
+		}
+		if (sim.exists("substeps")) {
+			substeps = sim["substeps"];
+			if (substeps < 1) {
+				throw std::invalid_argument("(SimulatedLowLevelWam::SimulatedLowLevelWam): substeps must be at least 1.");
+			}
+		}
+	}
+
+	definePosition(home);
+}
+
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::update()
+{
+	const double dt = period / substeps;
+	for (int s = 0; s < substeps; ++s) {
+		integrate(dt);
+	}
+	time += period;
+
+	if (mode == SafetyModule::ACTIVE  &&  velocityLimit > 0.0  &&  checkVelocityLimit()) {
+		velocityFault = true;
+		idle();
+	}
+
+	measure();
+	jv_best = (jp_best - jp_best_1) / period;
+	jp_best_1 = jp_best;
+}
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::setTorques(const jt_type& jt)
+{
+	jtCommanded = jt;
+
+	if (mode != SafetyModule::ACTIVE) {
+		jtApplied.setZero();
+		return;
+	}
+
+	// Saturate each motor, then map back to the joints
+	v_type mt = j2mt * jt;
+	for (size_t i = 0; i < DOF; ++i) {
+		mt[i] = std::max(-motorTorqueLimits[i], std::min(mt[i], motorTorqueLimits[i]));
+	}
+	jtApplied = j2mp.transpose() * mt;
+}
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::definePosition(const jp_type& jp)
+{
+	setState(jp, jv_type(0.0));
+
+	// Don't report the jump as a velocity
+	measure();
+	jp_best_1 = jp_best;
+	jv_best.setZero();
+}
+
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::setState(const jp_type& jp, const jv_type& jv)
+{
+	q = jp;
+	qd = jv;
+	kin.eval(q, qd);
+}
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::activate()
+{
+	mode = SafetyModule::ACTIVE;
+	velocityFault = false;
+	setTorques(jtCommanded);
+}
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::idle()
+{
+	mode = SafetyModule::IDLE;
+	jtApplied.setZero();
+}
+
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::integrate(double dt)
+{
+	// Semi-implicit Euler, with the damping taken implicitly so that light
+	// distal links stay stable:
+	//     (M + dt B) qd' = M qd + dt (jt - h - g)
+	//     q' = q + dt qd'
+	dof_matrix M = dyn.evalMassMatrix(kin);
+	M += rotorInertia;
+
+	jt_type rhs = jtApplied;
+	rhs -= dyn.evalBias(kin, qd);
+	rhs -= dyn.evalGravity(kin, gravity);
+	typename jt_type::Base momentum = M * qd + dt * rhs;
+
+	M.diagonal() += dt * damping;
+	llt.compute(M);
+	qd = llt.solve(momentum);
+	q += dt * qd;
+
+	kin.eval(q, qd);
+}
+
+template<size_t DOF>
+bool SimulatedLowLevelWam<DOF>::checkVelocityLimit() const
+{
+	const double limit2 = velocityLimit * velocityLimit;
+	const struct bt_kinematics* k = kin.impl;
+
+	if (math::detail::mapGsl3(k->tool_velocity).squaredNorm() > limit2) {
+		return true;
+	}
+
+	for (size_t j = 0; j < DOF; ++j) {
+		const Eigen::Vector3d p = math::detail::mapGsl3(k->link[j]->origin_pos);
+
+		Eigen::Vector3d v(0.0, 0.0, 0.0);
+		for (size_t i = 0; i <= j; ++i) {
+			const struct bt_kinematics_link* joint = (i == 0) ? k->base : k->link[i-1];
+			v += qd[i] * math::detail::mapGsl3(joint->axis_z).cross(p - math::detail::mapGsl3(joint->origin_pos));
+		}
+
+		if (v.squaredNorm() > limit2) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<size_t DOF>
+void SimulatedLowLevelWam<DOF>::measure()
+{
+	// The motor encoders see whole counts
+	mp = j2mp * q;
+	for (size_t i = 0; i < DOF; ++i) {
+		mp[i] = std::floor(mp[i] * countsPerRad[i]) * radsPerCount[i];
+	}
+	jp_best = m2jp * mp;
+}
+
+
+}
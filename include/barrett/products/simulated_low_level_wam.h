@@ -0,0 +1,185 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+/*
+ * @file simulated_low_level_wam.h
+ * @date 10/19/2026
+ *
+ */
+
+#ifndef BARRETT_PRODUCTS_SIMULATED_LOW_LEVEL_WAM_H_
+#define BARRETT_PRODUCTS_SIMULATED_LOW_LEVEL_WAM_H_
+
+
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+#include <libconfig.h++>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/units.h>
+#include <barrett/products/safety_module.h>
+#include <barrett/math/kinematics.h>
+#include <barrett/math/dynamics.h>
+#include <barrett/math/gravity.h>
+
+
+namespace barrett {
+
+
+/** A stand-in for LowLevelWam that integrates the arm's rigid-body dynamics
+ * instead of talking to Pucks.
+ *
+ * It is built from the same configuration group as systems::Wam (using its
+ * "low_level", "kinematics" and "dynamics" groups) and has the parts of
+ * LowLevelWam's interface that the control loop uses. Simulated time advances
+ * by exactly one period per update(), so an ExecutionManager that is stepped
+ * by hand runs the arm as fast as the CPU allows.
+ *
+ * Like the real hardware, the plant holds the most recent torques for the
+ * whole period, clips them to the motors' torque limits, reports positions
+ * quantized by the motor encoders, and idles (applies no torque) after a
+ * velocity fault until activate() is called. These effects are configured by
+ * an optional "simulation" group:
+ *
+ *     simulation:
+ *     {
+ *         motor_torque_limits = (...);   # N*m at each motor; default: none
+ *         motor_encoder_counts = (...);  # counts per motor revolution; default: 4096
+ *         motor_inertias = (...);        # kg*m^2 of each rotor; default: 0
+ *         joint_damping = (...);         # N*m*s/rad; default: 0
+ *         velocity_limit = 1.5;          # m/s of any link origin or the tool; default: none
+ *         substeps = 4;                  # integration steps per period; default: 1
+ *     };
+ */
+template<size_t DOF>
+class SimulatedLowLevelWam {
+	BARRETT_UNITS_TEMPLATE_TYPEDEFS(DOF);
+
+public:
+	static const int DEFAULT_ENCODER_COUNTS = 4096;
+
+	/// setting is the WAM's configuration group, as passed to systems::Wam
+	SimulatedLowLevelWam(const libconfig::Setting& setting, double period_s);
+	~SimulatedLowLevelWam() {}
+
+
+	/// The measured (quantized) joint positions
+	const jp_type& getJointPositions() const { return jp_best; }
+	/// Differentiated measured positions, as reported by LowLevelWam
+	const jv_type& getJointVelocities() const { return jv_best; }
+
+	const jp_type& getHomePosition() const { return home; }
+
+	const sqm_type& getJointToMotorPositionTransform() const { return j2mp; }
+	const sqm_type& getMotorToJointPositionTransform() const { return m2jp; }
+	const sqm_type& getJointToMotorTorqueTransform() const { return j2mt; }
+
+
+	/// Advances the simulation by one period and takes a new measurement
+	void update();
+	/// Commands the torques that will be applied during the next period
+	void setTorques(const jt_type& jt);
+	/// Moves the simulated arm to jp and stops it
+	void definePosition(const jp_type& jp);
+
+
+	/** @name Simulation state
+	 *
+	 * Not available on the real hardware. Don't call these from another
+	 * thread while the ExecutionManager is running.
+	 */
+	//@{
+	double getPeriod() const { return period; }
+	double getTime() const { return time; }
+
+	/// Places the simulated arm in the given state. Unlike definePosition(), the jump shows up in the next measured velocity.
+	void setState(const jp_type& jp, const jv_type& jv);
+	/// The plant's exact joint positions and velocities
+	const jp_type& getTrueJointPositions() const { return q; }
+	const jv_type& getTrueJointVelocities() const { return qd; }
+	/// The torques actually applied after saturation (zero unless ACTIVE)
+	const jt_type& getAppliedTorques() const { return jtApplied; }
+
+	double getGravity() const { return gravity; }
+	void setGravity(double g) { gravity = g; }
+
+	enum SafetyModule::SafetyMode getSafetyMode() const { return mode; }
+	bool hasVelocityFault() const { return velocityFault; }
+	/// Clears any fault and starts applying torques
+	void activate();
+	/// Stops applying torques
+	void idle();
+	//@}
+
+protected:
+	typedef Eigen::Matrix<double, DOF,DOF> dof_matrix;
+
+	void integrate(double dt);
+	bool checkVelocityLimit() const;
+	void measure();
+
+	const double period;
+	double time;
+	int substeps;
+
+	jp_type home;
+	sqm_type j2mp, m2jp, j2mt;
+	v_type motorTorqueLimits;
+	v_type countsPerRad, radsPerCount;
+	sqm_type rotorInertia;  // reflected to the joints
+	v_type damping;
+	double velocityLimit;
+	double gravity;
+
+	math::Kinematics<DOF> kin;  // always evaluated at (q, qd)
+	math::Dynamics<DOF> dyn;
+	Eigen::LLT<dof_matrix> llt;
+
+	jp_type q;
+	jv_type qd;
+	jt_type jtCommanded, jtApplied;
+
+	v_type mp;
+	jp_type jp_best, jp_best_1;
+	jv_type jv_best;
+
+	enum SafetyModule::SafetyMode mode;
+	bool velocityFault;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(SimulatedLowLevelWam);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+
+
+// include template definitions
+#include <barrett/products/detail/simulated_low_level_wam-inl.h>
+
+
+#endif /* BARRETT_PRODUCTS_SIMULATED_LOW_LEVEL_WAM_H_ */
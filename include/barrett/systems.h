@@ -53,11 +53,16 @@
 #include <barrett/systems/exposed_output.h>
 
 #include <barrett/systems/ramp.h>
+#include <barrett/systems/trajectory_executor.h>
+#include <barrett/systems/streaming_reference.h>
 
 // sinks
 #include <barrett/systems/print_to_stream.h>
 #include <barrett/systems/periodic_data_logger.h>
+#include <barrett/systems/grouped_data_logger.h>
 #include <barrett/systems/triggered_data_logger.h>
+#include <barrett/systems/flight_recorder.h>
+#include <barrett/systems/telemetry_publisher.h>
 
 // operators
 #include <barrett/systems/kinematics_base.h>
@@ -73,6 +78,7 @@
 #include <barrett/systems/haptic_ball.h>
 #include <barrett/systems/haptic_box.h>
 #include <barrett/systems/haptic_path.h>
+#include <barrett/systems/haptic_scene.h>
 
 #include <barrett/systems/summer.h>
 #include <barrett/systems/gain.h>
@@ -80,6 +86,7 @@
 #include <barrett/systems/pid_controller.h>
 #include <barrett/systems/first_order_filter.h>
 #include <barrett/systems/rate_limiter.h>
+#include <barrett/systems/fused_chain.h>
 
 #include <barrett/systems/callback.h>
 
@@ -22,6 +22,12 @@ inline thread::Mutex& System::getEmMutex() const
 	}
 }
 
+inline double System::getEffectivePeriod() const
+{
+	assert(hasExecutionManager());
+	return getExecutionManager()->getPeriod() * rateDivisor;
+}
+
 
 inline thread::Mutex& System::AbstractInput::getEmMutex() const
 {
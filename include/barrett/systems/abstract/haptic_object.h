@@ -53,6 +53,11 @@ public:		Output<cf_type> directionOutput;
 protected:	Output<cf_type>::Value* directionOutputValue;
 
 public:
+	/// HapticBall and HapticBox (and the same shapes in a HapticScene) stop
+	/// pushing and let the tool through once it is this far past their
+	/// surface.
+	static constexpr double ACTIVATION_DISTANCE = 0.02;
+
 	HapticObject(const std::string& sysName = "HapticObject") :
 		System(sysName), SingleInput<cp_type>(this),
 		depthOutput(this, &depthOutputValue),
@@ -69,7 +69,8 @@ public:
 
 
 	explicit System(const std::string& sysName = "System") :
-			name(sysName), em(NULL), emDirect(false), ut(UT_NULL) {}
+			name(sysName), em(NULL), emDirect(false),
+			rateDivisor(1), ratePhase(0), rateStarted(false), ut(UT_NULL) {}
 	virtual ~System() { mandatoryCleanUp(); }
 
 	void setName(const std::string& newName) { name = newName; }
@@ -80,6 +81,22 @@ public:
 	ExecutionManager* getExecutionManager() const { return em; }
 	thread::Mutex& getEmMutex() const;
 
+	// Multi-rate execution. By default, a System operates every execution
+	// cycle. After setRateDivisor(n, k), it operates only on cycles where
+	// (cycle % n == k) and its Outputs hold their last values in between.
+	// Staggering the phase of several slow Systems spreads their cost across
+	// cycles. Systems that are only pulled by a slow System are only pulled
+	// on its cycles, so they slow down with it (per-subgraph rates). A System
+	// always operates on the first cycle after it gains an ExecutionManager,
+	// so its Outputs are never left undefined while waiting for its phase.
+	void setRateDivisor(size_t divisor, size_t phase = 0);
+	size_t getRateDivisor() const { return rateDivisor; }
+	size_t getRatePhase() const { return ratePhase; }
+
+	// The time between calls to operate(): the ExecutionManager's period
+	// multiplied by the rate divisor.
+	double getEffectivePeriod() const;
+
 protected:
 	void mandatoryCleanUp();
 
@@ -97,6 +114,9 @@ protected:
 	ExecutionManager* em;
 	bool emDirect;
 
+	size_t rateDivisor, ratePhase;
+	bool rateStarted;
+
 
 public:
 	class AbstractInput {
@@ -65,7 +65,7 @@ void FirstOrderFilter<T,MathTraits>::getSamplePeriodFromEM()
 {
 	if (this->hasExecutionManager()) {
 		assert(this->getExecutionManager()->getPeriod() > 0.0);
-		this->setSamplePeriod(this->getExecutionManager()->getPeriod());
+		this->setSamplePeriod(this->getEffectivePeriod());
 	} else {
 		this->setSamplePeriod(0.0);
 	}
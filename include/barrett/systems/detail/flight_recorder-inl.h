@@ -0,0 +1,249 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file flight_recorder-inl.h
+ * @date 10/19/2026
+ */
+
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <barrett/os.h>
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+template<typename T, typename LogTraits>
+FlightRecorder<T, LogTraits>::FlightRecorder(ExecutionManager* em, const std::string& fileNamePrefix_,
+		double preTrigger_s_, double postTrigger_s_, const log::ColumnOptions& options_,
+		int priority_, const std::string& sysName) :
+	System(sysName), SingleInput<T>(this), triggerInput(this),
+	fileNamePrefix(fileNamePrefix_), preTrigger_s(preTrigger_s_), postTrigger_s(postTrigger_s_),
+	preTriggerRecords(0), postTriggerRecords(0), capacity(0),
+	recordLength(LogTraits::serializedLength()), schema(log::detail::describe<LogTraits>(options_.fieldNames, 0.0)),
+	options(options_), priority(priority_), T_s(0.0),
+	active(0), capturing(false), stalled(false), remaining(0), lastTriggerValue(false),
+	triggerRequested(false), numDumps(0), numMissedTriggers(0), numDroppedRecords(0),
+	callbackMutex(), callback(), thread()
+{
+	if (em == NULL  ||  em->getPeriod() <= 0.0) {
+		throw(std::invalid_argument("(systems::FlightRecorder::FlightRecorder()): em must not be NULL and must have a known period."));
+	}
+	if (preTrigger_s < 0.0  ||  postTrigger_s <= 0.0) {
+		throw(std::invalid_argument("(systems::FlightRecorder::FlightRecorder()): The post-trigger window must be positive and the pre-trigger window can't be negative."));
+	}
+
+	// A rate divisor can only lengthen the effective period, so this is the
+	// most records the windows can need. onExecutionManagerChanged() sets the
+	// windows themselves.
+	capacity = windowRecords(preTrigger_s, em->getPeriod()) + windowRecords(postTrigger_s, em->getPeriod());
+
+	// Allocate (and touch) everything now so operate() never has to.
+	for (size_t i = 0; i < 2; ++i) {
+		rings[i].data.resize(capacity * recordLength);
+		rings[i].count = 0;
+		rings[i].triggerRecord = 0;
+		rings[i].preTriggerRecords = 0;
+		rings[i].samplePeriod = 0.0;
+		rings[i].state.store(FREE, boost::memory_order_relaxed);
+	}
+	startRecording(0);
+
+	boost::thread tmpThread(boost::bind(&FlightRecorder<T, LogTraits>::dumpEntryPoint, this));
+	thread.swap(tmpThread);
+
+	em->startManaging(*this);
+}
+
+template<typename T, typename LogTraits>
+FlightRecorder<T, LogTraits>::~FlightRecorder()
+{
+	// Removing the System from its ExecutionManager resets T_s.
+	double samplePeriod = T_s;
+	mandatoryCleanUp();
+	T_s = samplePeriod;
+
+	thread.interrupt();
+	thread.join();
+
+	// operate() can't run any more, so finish what it started.
+	if (capturing) {
+		handOff();
+	}
+	for (size_t i = 0; i < 2; ++i) {
+		if (rings[i].state.load(boost::memory_order_acquire) == CAPTURED) {
+			dump(rings[i]);
+		}
+	}
+}
+
+template<typename T, typename LogTraits>
+void FlightRecorder<T, LogTraits>::setDumpCallback(callback_type cb)
+{
+	boost::lock_guard<boost::mutex> lock(callbackMutex);
+	callback = cb;
+}
+
+template<typename T, typename LogTraits>
+void FlightRecorder<T, LogTraits>::operate()
+{
+	bool triggered = triggerRequested.exchange(false, boost::memory_order_acquire);
+	if (triggerInput.valueDefined()) {
+		bool value = triggerInput.getValue();
+		triggered = triggered  ||  (value  &&  !lastTriggerValue);
+		lastTriggerValue = value;
+	}
+
+	if (stalled) {
+		if (rings[1 - active].state.load(boost::memory_order_acquire) != FREE) {
+			numDroppedRecords.fetch_add(1, boost::memory_order_relaxed);
+			if (triggered) {
+				numMissedTriggers.fetch_add(1, boost::memory_order_relaxed);
+			}
+			return;
+		}
+		startRecording(1 - active);
+		stalled = false;
+	}
+
+	Ring& ring = rings[active];
+	if (triggered  &&  !capturing) {
+		capturing = true;
+		ring.triggerRecord = ring.count;
+		remaining = postTriggerRecords;
+	}
+
+	LogTraits::serialize(this->input.getValue(), &ring.data[(ring.count % capacity) * recordLength]);
+	++ring.count;
+
+	if (capturing  &&  --remaining == 0) {
+		handOff();
+	}
+}
+
+template<typename T, typename LogTraits>
+void FlightRecorder<T, LogTraits>::startRecording(size_t i)
+{
+	active = i;
+	rings[i].count = 0;
+	rings[i].state.store(RECORDING, boost::memory_order_relaxed);
+}
+
+template<typename T, typename LogTraits>
+void FlightRecorder<T, LogTraits>::handOff()
+{
+	Ring& ring = rings[active];
+	ring.preTriggerRecords = preTriggerRecords;
+	ring.samplePeriod = T_s;
+	ring.state.store(CAPTURED, boost::memory_order_release);
+	capturing = false;
+
+	if (rings[1 - active].state.load(boost::memory_order_acquire) == FREE) {
+		startRecording(1 - active);
+	} else {
+		stalled = true;
+	}
+}
+
+template<typename T, typename LogTraits>
+void FlightRecorder<T, LogTraits>::dumpEntryPoint()
+{
+	PeriodicLoopTimer loopTimer(0.05, priority);
+	while ( !boost::this_thread::interruption_requested() ) {
+		loopTimer.wait();
+		for (size_t i = 0; i < 2; ++i) {
+			if (rings[i].state.load(boost::memory_order_acquire) == CAPTURED) {
+				dump(rings[i]);
+			}
+		}
+	}
+}
+
+template<typename T, typename LogTraits>
+void FlightRecorder<T, LogTraits>::dump(Ring& ring)
+{
+	// Name the file after the time of the dump so that later runs don't overwrite it.
+	char timeStr[32];
+	std::time_t now = std::time(NULL);
+	std::strftime(timeStr, sizeof(timeStr), "%Y%m%d-%H%M%S", std::localtime(&now));
+
+	Dump d;
+	d.fileName = fileNamePrefix + "-" + timeStr + "-" + boost::lexical_cast<std::string>(getNumDumps()) + ".log";
+	// A partial capture (see the destructor) may have more than the pre-trigger window.
+	boost::uint64_t first = ring.count - std::min(ring.count, static_cast<boost::uint64_t>(capacity));
+	if (ring.triggerRecord > first + ring.preTriggerRecords) {
+		first = ring.triggerRecord - ring.preTriggerRecords;
+	}
+	d.numRecords = ring.count - first;
+	d.triggerRecord = ring.triggerRecord - first;
+
+	log::Schema s(schema);
+	s.setSamplePeriod(ring.samplePeriod);
+	const size_t blockRecords = std::min(capacity, static_cast<size_t>(1024));
+	log::detail::BlockEncoder encoder(s, options, blockRecords);
+
+	std::ofstream file(d.fileName.c_str(), std::ios_base::binary);
+	std::vector<char> header;
+	encoder.writeHeader(&header);
+	file.write(&header[0], header.size());
+
+	// The ring holds the records oldest first, starting at first % capacity.
+	size_t i = 0;
+	while (i < d.numRecords) {
+		size_t pos = (first + i) % capacity;
+		size_t n = std::min(std::min(d.numRecords - i, capacity - pos), blockRecords);
+		file.write(encoder.data(), encoder.encode(&ring.data[pos * recordLength], n));
+		i += n;
+	}
+	file.close();
+
+	ring.state.store(FREE, boost::memory_order_release);
+
+	if (file.fail()) {
+		logMessage("FlightRecorder::%s(): Couldn't write the file '%s'.", true) % __func__ % d.fileName;
+		return;
+	}
+	numDumps.fetch_add(1, boost::memory_order_release);
+
+	boost::lock_guard<boost::mutex> lock(callbackMutex);
+	if (callback) {
+		callback(d);
+	}
+}
+
+
+}
+}
@@ -0,0 +1,309 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file fused_chain-inl.h
+ * @date 10/19/2026
+ */
+
+#include <cassert>
+#include <stdexcept>
+
+#include <barrett/math/utils.h>
+#include <barrett/thread/abstract/mutex.h>
+#include <barrett/systems/abstract/execution_manager.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+namespace fusion {
+
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+Sum<T, numSideInputs, MathTraits>::Sum() :
+	inputs(), polarity(), strict(true), sum()
+{
+	inputs.assign(NULL);
+	polarity.assign(1);
+}
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+Sum<T, numSideInputs, MathTraits>::~Sum()
+{
+	// The parent FusedChain has already called mandatoryCleanUp().
+	for (size_t i = 0; i < numSideInputs; ++i) {
+		delete inputs[i];
+	}
+}
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+void Sum<T, numSideInputs, MathTraits>::setPolarity(const std::string& polarityStr)
+{
+	if (polarityStr.size() != numSideInputs) {
+		throw std::invalid_argument("(systems::fusion::Sum::setPolarity): "
+				"polarityStr must have one character per side input.");
+	}
+
+	for (size_t i = 0; i < numSideInputs; ++i) {
+		switch (polarityStr[i]) {
+		case '+':
+			polarity[i] = 1;
+			break;
+		case '-':
+			polarity[i] = -1;
+			break;
+		default:
+			throw std::invalid_argument("(systems::fusion::Sum::setPolarity): "
+					"polarityStr must contain only '+' and '-' characters.");
+			break;
+		}
+	}
+}
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+inline System::Input<T>& Sum<T, numSideInputs, MathTraits>::getInput(const size_t i)
+{
+	assert(inputs[i] != NULL);  // Not yet attached to a FusedChain
+	return *inputs[i];
+}
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+void Sum<T, numSideInputs, MathTraits>::attach(System* parent)
+{
+	for (size_t i = 0; i < numSideInputs; ++i) {
+		inputs[i] = new System::Input<T>(parent);
+	}
+}
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+inline bool Sum<T, numSideInputs, MathTraits>::inputsValid()
+{
+	if (strict) {
+		for (size_t i = 0; i < numSideInputs; ++i) {
+			if ( !inputs[i]->valueDefined() ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template<typename T, size_t numSideInputs, typename MathTraits>
+inline const T& Sum<T, numSideInputs, MathTraits>::eval(const T& x)
+{
+	typedef MathTraits MT;
+
+	sum = MT::add(MT::zero(), x);
+	for (size_t i = 0; i < numSideInputs; ++i) {
+		if ( !strict  &&  !inputs[i]->valueDefined() ) {
+			continue;
+		}
+		sum = MT::add(sum, MT::mult(polarity[i], inputs[i]->getValue()));
+	}
+	return sum;
+}
+
+
+template<typename InputType, typename OutputType, typename MathTraits>
+PID<InputType, OutputType, MathTraits>::PID() :
+	parentSys(NULL), T_s(0.0), error_1(0.0), intError(0.0), intErrorLimit(0.0),
+	kp(0.0), ki(0.0), kd(0.0), controlSignal(0.0), controlSignalLimit(0.0)
+{
+}
+
+template<typename InputType, typename OutputType, typename MathTraits>
+void PID<InputType, OutputType, MathTraits>::setFromConfig(const libconfig::Setting& setting)
+{
+	setKp(setting.exists("kp") ? unitless_type(setting["kp"]) : unitless_type(0.0));
+	setKi(setting.exists("ki") ? unitless_type(setting["ki"]) : unitless_type(0.0));
+	setKd(setting.exists("kd") ? unitless_type(setting["kd"]) : unitless_type(0.0));
+	setIntegratorLimit(setting.exists("integrator_limit") ?
+			unitless_type(setting["integrator_limit"]) : unitless_type(0.0));
+	setControlSignalLimit(setting.exists("control_signal_limit") ?
+			unitless_type(setting["control_signal_limit"]) : unitless_type(0.0));
+}
+
+template<typename InputType, typename OutputType, typename MathTraits>
+void PID<InputType, OutputType, MathTraits>::setIntegratorState(const unitless_type& integratorState)
+{
+	// intError is written and read in eval(), so it needs to be locked.
+	if (parentSys != NULL) {
+		BARRETT_SCOPED_LOCK(parentSys->getEmMutex());
+		intError = integratorState;
+	} else {
+		intError = integratorState;
+	}
+}
+
+template<typename InputType, typename OutputType, typename MathTraits>
+inline const OutputType& PID<InputType, OutputType, MathTraits>::eval(const InputType& error)
+{
+	typedef MathTraits MT;
+
+	// Same arithmetic as PIDController::operate()
+	intError = MT::add(intError, MT::mult(ki, MT::mult(T_s, error_1)));
+	if (intErrorLimit != MT::zero()) {
+		intError = math::saturate(intError, intErrorLimit);
+	}
+
+	controlSignal = MT::add(MT::mult(kp, error),
+							MT::add(intError,
+								MT::mult(kd, MT::div(MT::sub(error, error_1), T_s))));
+	if (controlSignalLimit != MT::zero()) {
+		controlSignal = math::saturate(controlSignal, controlSignalLimit);
+	}
+
+	error_1 = error;
+	return controlSignal;
+}
+
+
+}
+
+
+namespace detail {
+
+
+template<typename Stage, typename Next>
+struct FusedChainNode {
+	typedef Stage stage_type;
+	typedef Next next_type;
+	typedef typename Stage::input_type input_type;
+	typedef typename Next::output_type output_type;
+
+	BOOST_STATIC_ASSERT((boost::is_same<typename Stage::output_type, typename Next::input_type>::value));
+
+	Stage stage;
+	Next next;
+
+	void attach(System* parent) {
+		stage.attach(parent);
+		next.attach(parent);
+	}
+	bool inputsValid() {
+		return stage.inputsValid()  &&  next.inputsValid();
+	}
+	void setSamplePeriod(double T_s) {
+		stage.setSamplePeriod(T_s);
+		next.setSamplePeriod(T_s);
+	}
+	const output_type& eval(const input_type& x) {
+		return next.eval(stage.eval(x));
+	}
+};
+
+template<typename Stage>
+struct FusedChainNode<Stage, fusion::None> {
+	typedef Stage stage_type;
+	typedef fusion::None next_type;
+	typedef typename Stage::input_type input_type;
+	typedef typename Stage::output_type output_type;
+
+	Stage stage;
+
+	void attach(System* parent) {
+		stage.attach(parent);
+	}
+	bool inputsValid() {
+		return stage.inputsValid();
+	}
+	void setSamplePeriod(double T_s) {
+		stage.setSamplePeriod(T_s);
+	}
+	const output_type& eval(const input_type& x) {
+		return stage.eval(x);
+	}
+};
+
+
+template<typename S1, typename S2, typename S3, typename S4, typename S5, typename S6>
+struct MakeFusedChain {
+	typedef FusedChainNode<S1, typename MakeFusedChain<S2, S3, S4, S5, S6, fusion::None>::type> type;
+};
+
+template<typename S1>
+struct MakeFusedChain<S1, fusion::None, fusion::None, fusion::None, fusion::None, fusion::None> {
+	typedef FusedChainNode<S1, fusion::None> type;
+};
+
+
+template<typename Node, size_t N>
+struct FusedChainStage {
+	typedef FusedChainStage<typename Node::next_type, N - 1> next_stage;
+	typedef typename next_stage::type type;
+
+	static type& get(Node& node) {
+		return next_stage::get(node.next);
+	}
+};
+
+template<typename Node>
+struct FusedChainStage<Node, 0> {
+	typedef typename Node::stage_type type;
+
+	static type& get(Node& node) {
+		return node.stage;
+	}
+};
+
+
+}
+
+
+template<typename S1, typename S2, typename S3, typename S4, typename S5, typename S6>
+FusedChain<S1, S2, S3, S4, S5, S6>::FusedChain(const std::string& sysName) :
+	SingleIO<input_type, output_type>(sysName), chain()
+{
+	chain.attach(this);
+	getSamplePeriodFromEM();
+}
+
+template<typename S1, typename S2, typename S3, typename S4, typename S5, typename S6>
+inline bool FusedChain<S1, S2, S3, S4, S5, S6>::inputsValid()
+{
+	return this->input.valueDefined()  &&  chain.inputsValid();
+}
+
+template<typename S1, typename S2, typename S3, typename S4, typename S5, typename S6>
+inline void FusedChain<S1, S2, S3, S4, S5, S6>::operate()
+{
+	this->outputValue->setData(&chain.eval(this->input.getValue()));
+}
+
+template<typename S1, typename S2, typename S3, typename S4, typename S5, typename S6>
+void FusedChain<S1, S2, S3, S4, S5, S6>::getSamplePeriodFromEM()
+{
+	if (this->hasExecutionManager()) {
+		assert(this->getExecutionManager()->getPeriod() > 0.0);
+		chain.setSamplePeriod(this->getEffectivePeriod());
+	} else {
+		chain.setSamplePeriod(0.0);
+	}
+}
+
+
+}
+}
@@ -0,0 +1,103 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file grouped_data_logger-helper.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_DETAIL_GROUPED_DATA_LOGGER_HELPER_H_
+#define BARRETT_SYSTEMS_DETAIL_GROUPED_DATA_LOGGER_HELPER_H_
+
+
+#include <boost/static_assert.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/log/traits.h>
+#include <barrett/systems/abstract/system.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+// doxygen can't handle FieldInputHolder's recursive inheritance.
+#ifndef BARRETT_PARSED_BY_DOXYGEN
+namespace detail {
+
+
+// Holds the inputs for the first N elements of TupleType, along with the
+// offset of each element in a record serialized by log::Traits<TupleType>.
+template<size_t N, typename TupleType>
+struct FieldInputHolder : public FieldInputHolder<N-1, TupleType> {
+
+	typedef FieldInputHolder<N-1, TupleType> inherited_type;
+	typedef typename boost::tuples::element<N-1, TupleType>::type value_type;
+	typedef log::Traits<value_type> traits_type;
+
+	explicit FieldInputHolder(System* parent) :
+		inherited_type(parent), input(parent), offset(inherited_type::endOffset()) {}
+
+	template<size_t Index>
+	System::Input<typename boost::tuples::element<Index, TupleType>::type>&
+	getInput() {
+		BOOST_STATIC_ASSERT(Index < N);
+		return ( static_cast<FieldInputHolder<Index+1, TupleType>*>(this) )->input;  //NOLINT: lint doesn't know that these are templates
+	}
+
+	bool valuesDefined() const {
+		return input.valueDefined()  &&  inherited_type::valuesDefined();
+	}
+
+	size_t endOffset() const {
+		return offset + traits_type::serializedLength();
+	}
+
+	// Serializes each input straight from its Output::Value.
+	void serialize(char* dest) const {
+		inherited_type::serialize(dest);
+		traits_type::serialize(input.getValue(), dest + offset);
+	}
+
+	System::Input<value_type> input;
+	const size_t offset;
+};
+
+template<typename TupleType>
+struct FieldInputHolder<0, TupleType> {
+	explicit FieldInputHolder(System* parent) {}
+
+	bool valuesDefined() const {  return true;  }
+	size_t endOffset() const {  return 0;  }
+	void serialize(char* dest) const {}
+};
+
+
+}
+#endif // BARRETT_PARSED_BY_DOXYGEN
+}
+}
+
+
+#endif /* BARRETT_SYSTEMS_DETAIL_GROUPED_DATA_LOGGER_HELPER_H_ */
@@ -36,6 +36,7 @@
 
 #include <barrett/products/puck.h>
 #include <barrett/products/low_level_wam.h>
+#include <barrett/products/simulated_low_level_wam.h>
 #include <barrett/products/safety_module.h>
 
 
@@ -51,34 +52,107 @@ LowLevelWamWrapper<DOF>::LowLevelWamWrapper(
 		const libconfig::Setting& setting,
 		std::vector<int> torqueGroupIds,
 		const std::string& sysName) :
+	LowLevelWamWrapper(em, genericPucks, safetyModule, setting, torqueGroupIds, NULL, sysName)
+{
+}
+
+template<size_t DOF>
+LowLevelWamWrapper<DOF>::LowLevelWamWrapper(
+		ExecutionManager* em,
+		SimulatedLowLevelWam<DOF>* simulatedWam,
+		const std::string& sysName) :
 	input(sink.input),
 	jpOutput(source.jpOutput), jvOutput(source.jvOutput),
-	llw(genericPucks, safetyModule, setting, torqueGroupIds),
+	llw(), sim(simulatedWam),
 	sink(this, em, sysName + "::Sink"), source(this, em, sysName + "::Source")
 {
+	if (sim == NULL) {
+		throw std::invalid_argument("systems::LowLevelWamWrapper::LowLevelWamWrapper(): simulatedWam must not be NULL.");
+	}
+}
+
+template<size_t DOF>
+LowLevelWamWrapper<DOF>::LowLevelWamWrapper(
+		ExecutionManager* em,
+		const std::vector<Puck*>& genericPucks,
+		SafetyModule* safetyModule,
+		const libconfig::Setting& setting,
+		std::vector<int> torqueGroupIds,
+		SimulatedLowLevelWam<DOF>* simulatedWam,
+		const std::string& sysName) :
+	input(sink.input),
+	jpOutput(source.jpOutput), jvOutput(source.jvOutput),
+	llw(simulatedWam == NULL ? new LowLevelWam<DOF>(genericPucks, safetyModule, setting, torqueGroupIds) : NULL),
+	sim(simulatedWam),
+	sink(this, em, sysName + "::Sink"), source(this, em, sysName + "::Source")
+{
+}
+
+template<size_t DOF>
+LowLevelWam<DOF>& LowLevelWamWrapper<DOF>::getLowLevelWam()
+{
+	if (isSimulated()) {
+		throw std::logic_error("systems::LowLevelWamWrapper::getLowLevelWam(): There is no LowLevelWam when simulating.");
+	}
+	return *llw;
+}
+
+template<size_t DOF>
+const LowLevelWam<DOF>& LowLevelWamWrapper<DOF>::getLowLevelWam() const
+{
+	if (isSimulated()) {
+		throw std::logic_error("systems::LowLevelWamWrapper::getLowLevelWam(): There is no LowLevelWam when simulating.");
+	}
+	return *llw;
+}
+
+template<size_t DOF>
+inline const typename LowLevelWamWrapper<DOF>::jp_type& LowLevelWamWrapper<DOF>::getHomePosition() const
+{
+	return isSimulated() ? sim->getHomePosition() : llw->getHomePosition();
+}
+
+template<size_t DOF>
+inline const typename LowLevelWamWrapper<DOF>::jp_type& LowLevelWamWrapper<DOF>::getJointPositions() const
+{
+	return isSimulated() ? sim->getJointPositions() : llw->getJointPositions();
+}
+
+template<size_t DOF>
+inline const typename LowLevelWamWrapper<DOF>::jv_type& LowLevelWamWrapper<DOF>::getJointVelocities() const
+{
+	return isSimulated() ? sim->getJointVelocities() : llw->getJointVelocities();
 }
 
 template<size_t DOF>
 void LowLevelWamWrapper<DOF>::Sink::operate()
 {
-	parent->llw.setTorques(this->input.getValue());
+	if (parent->isSimulated()) {
+		parent->sim->setTorques(this->input.getValue());
+	} else {
+		parent->llw->setTorques(this->input.getValue());
+	}
 }
 
 template<size_t DOF>
 void LowLevelWamWrapper<DOF>::Source::operate()
 {
-	try {
-		parent->llw.update();
-	} catch (const std::runtime_error& e) {
-		if (parent->llw.getSafetyModule() != NULL  &&  parent->llw.getSafetyModule()->getMode(true) == SafetyModule::ESTOP) {
-			throw ExecutionManagerException("systems::LowLevelWamWrapper::Source::operate(): E-stop! Cannot communicate with Pucks.");
-		} else {
-			throw;
+	if (parent->isSimulated()) {
+		parent->sim->update();
+	} else {
+		try {
+			parent->llw->update();
+		} catch (const std::runtime_error& e) {
+			if (parent->llw->getSafetyModule() != NULL  &&  parent->llw->getSafetyModule()->getMode(true) == SafetyModule::ESTOP) {
+				throw ExecutionManagerException("systems::LowLevelWamWrapper::Source::operate(): E-stop! Cannot communicate with Pucks.");
+			} else {
+				throw;
+			}
 		}
 	}
 
-	this->jpOutputValue->setData( &(parent->llw.getJointPositions()) );
-	this->jvOutputValue->setData( &(parent->llw.getJointVelocities()) );
+	this->jpOutputValue->setData( &(parent->getJointPositions()) );
+	this->jvOutputValue->setData( &(parent->getJointVelocities()) );
 }
 
 
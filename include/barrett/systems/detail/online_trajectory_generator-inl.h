@@ -0,0 +1,220 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file online_trajectory_generator-inl.h
+ * @date 10/19/2026
+ */
+
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace barrett {
+namespace systems {
+
+
+template<typename T>
+OnlineTrajectoryGenerator<T>::OnlineTrajectoryGenerator(const limit_type& velocity, const limit_type& acceleration, const limit_type& jerk,
+		bool synchronize, size_t capacity, const std::string& sysName) :
+	System(sysName), SingleOutput<T>(this),
+	sync(synchronize), T_s(0.0),
+	velocity(), acceleration(), jerk(),
+	commands(capacity), numPending(0), moving(false),
+	profiles(), stateDefined(false), t(0.0), finalT(0.0), y()
+{
+	setLimits(velocity, acceleration, jerk);
+	getSamplePeriodFromEM();
+}
+
+template<typename T>
+void OnlineTrajectoryGenerator<T>::setLimits(const limit_type& velocity_, const limit_type& acceleration_, const limit_type& jerk_)
+{
+	assert((velocity_.array() > 0.0).all());
+	assert((acceleration_.array() > 0.0).all());
+	assert((jerk_.array() > 0.0).all());
+
+	boost::lock_guard<boost::mutex> lg(producerMutex);
+	velocity = velocity_;
+	acceleration = acceleration_;
+	jerk = jerk_;
+}
+
+template<typename T>
+bool OnlineTrajectoryGenerator<T>::setTarget(const T& target)
+{
+	Command c;
+	c.isTarget = true;
+	c.value = target;
+	return push(c);
+}
+
+template<typename T>
+bool OnlineTrajectoryGenerator<T>::reset(const T& position)
+{
+	Command c;
+	c.isTarget = false;
+	c.value = position;
+	return push(c);
+}
+
+template<typename T>
+bool OnlineTrajectoryGenerator<T>::push(Command& c)
+{
+	boost::lock_guard<boost::mutex> lg(producerMutex);
+	c.velocity = velocity;
+	c.acceleration = acceleration;
+	c.jerk = jerk;
+
+	// Count the command before the execution thread can see it, so isDone()
+	// never reports a move that hasn't started yet as finished.
+	numPending.fetch_add(1, boost::memory_order_acq_rel);
+	if ( !commands.push(c) ) {
+		numPending.fetch_sub(1, boost::memory_order_acq_rel);
+		return false;
+	}
+	return true;
+}
+
+template<typename T>
+void OnlineTrajectoryGenerator<T>::onExecutionManagerChanged()
+{
+	System::onExecutionManagerChanged();  // First, call super
+	getSamplePeriodFromEM();
+
+	// This is called while holding the ExecutionManager's mutex, so operate()
+	// can't be running. If we're no longer being executed, nobody is tracking
+	// our output: forget the state rather than resuming a stale move the next
+	// time we are connected. Drop the commands that are still queued too, or
+	// isDone() would wait for them forever. (While disconnected, we're the
+	// only consumer.)
+	if ( !this->hasExecutionManager() ) {
+		size_t numPopped = 0;
+		while (commands.pop()) {
+			++numPopped;
+		}
+		stateDefined = false;
+		moving.store(false, boost::memory_order_release);
+		if (numPopped != 0) {
+			numPending.fetch_sub(numPopped, boost::memory_order_acq_rel);
+		}
+	}
+}
+
+template<typename T>
+void OnlineTrajectoryGenerator<T>::getSamplePeriodFromEM()
+{
+	if (this->hasExecutionManager()) {
+		assert(this->getExecutionManager()->getPeriod() > 0.0);
+		T_s = this->getEffectivePeriod();
+	} else {
+		T_s = 0.0;
+	}
+}
+
+template<typename T>
+void OnlineTrajectoryGenerator<T>::operate()
+{
+	// Only the most recent target matters, so plan at most once per cycle.
+	Command target;
+	bool haveTarget = false;
+	size_t numPopped = 0;
+	while (commands.read_available() != 0) {
+		const Command& c = commands.front();
+		if (c.isTarget) {
+			target = c;
+			haveTarget = true;
+		} else {
+			startAt(c.value);
+			haveTarget = false;
+		}
+		commands.pop();
+		++numPopped;
+	}
+
+	if (haveTarget) {
+		if (stateDefined) {
+			plan(target);
+		} else {
+			startAt(target.value);
+		}
+	}
+
+	if (stateDefined) {
+		for (size_t i = 0; i < DIMENSION; ++i) {
+			y[i] = profiles[i].eval(t);
+		}
+		this->outputValue->setData(&y);
+
+		if (t >= finalT) {
+			moving.store(false, boost::memory_order_release);
+		}
+		t += T_s;
+	} else {
+		this->outputValue->setUndefined();
+	}
+
+	// moving has been updated, so it's safe to let isDone() look at it.
+	if (numPopped != 0) {
+		numPending.fetch_sub(numPopped, boost::memory_order_acq_rel);
+	}
+}
+
+template<typename T>
+void OnlineTrajectoryGenerator<T>::startAt(const T& position)
+{
+	for (size_t i = 0; i < DIMENSION; ++i) {
+		profiles[i] = math::JerkLimitedProfile(position[i]);
+	}
+	stateDefined = true;
+	t = 0.0;
+	finalT = 0.0;
+	moving.store(false, boost::memory_order_release);
+}
+
+template<typename T>
+void OnlineTrajectoryGenerator<T>::plan(const Command& c)
+{
+	finalT = 0.0;
+	for (size_t i = 0; i < DIMENSION; ++i) {
+		double p, v, a;
+		profiles[i].eval(t, &p, &v, &a);
+		profiles[i].plan(p, v, a, c.value[i], c.velocity[i], c.acceleration[i], c.jerk[i]);
+		finalT = std::max(finalT, profiles[i].finalT());
+	}
+
+	if (sync) {
+		for (size_t i = 0; i < DIMENSION; ++i) {
+			profiles[i].stretch(finalT);
+		}
+	}
+
+	t = 0.0;
+	moving.store(true, boost::memory_order_release);
+}
+
+
+}
+}
@@ -41,9 +41,9 @@ template<typename T, typename LogWriterType>
 PeriodicDataLogger<T, LogWriterType>::PeriodicDataLogger(ExecutionManager* em,
 		LogWriterType* logWriter, size_t periodMultiplier, const std::string& sysName) :
 	System(sysName), SingleInput<T>(this),
-	lw(logWriter), logging(true),
-	ecCount(0), ecCountRollover(periodMultiplier)
+	lw(logWriter), logging(true)
 {
+	setRateDivisor(periodMultiplier);
 	if (em != NULL) {
 		em->startManaging(*this);
 	}
@@ -85,8 +85,7 @@ void PeriodicDataLogger<T, LogWriterType>::closeLog() {
 
 template<typename T, typename LogWriterType>
 inline bool PeriodicDataLogger<T, LogWriterType>::inputsValid() {
-	ecCount = (ecCount + 1) % ecCountRollover;
-	return logging  &&  ecCount == 0  &&  this->input.valueDefined();
+	return logging  &&  this->input.valueDefined();
 }
 
 template<typename T, typename LogWriterType>
@@ -177,7 +177,7 @@ void PIDController<InputType, OutputType, MathTraits>::getSamplePeriodFromEM()
 {
 	if (this->hasExecutionManager()) {
 		assert(this->getExecutionManager()->getPeriod() > 0.0);
-		setSamplePeriod(this->getExecutionManager()->getPeriod());
+		setSamplePeriod(this->getEffectivePeriod());
 	} else {
 		setSamplePeriod(0.0);
 	}
@@ -0,0 +1,131 @@
+/*
+	Copyright 2009, 2010 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file print_to_stream-inl.h
+ * @date 10/19/2026
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/bind.hpp>
+
+#include <barrett/os.h>
+#include <barrett/thread/abstract/mutex.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+template<typename T>
+PrintToStream<T>::PrintToStream(ExecutionManager* em, const std::string& prependedLabel,
+		std::ostream& ostream, const std::string& sysName, size_t capacity) :
+	System(sysName), SingleInput<T>(this), label(prependedLabel), os(ostream),
+	T_s(0.0), maxRate(0.0), credit(1.0), queue(capacity), stopping(false), thread(),
+	numPrinted(0), numDropped(0), numRateLimited(0)
+{
+	boost::thread tmpThread(boost::bind(&PrintToStream<T>::printEntryPoint, this));
+	thread.swap(tmpThread);
+
+	if (em != NULL) {
+		em->startManaging(*this);
+	}
+}
+
+template<typename T>
+PrintToStream<T>::~PrintToStream()
+{
+	mandatoryCleanUp();
+
+	stopping.store(true, boost::memory_order_release);
+	thread.join();
+	printQueued();
+}
+
+template<typename T>
+void PrintToStream<T>::setMaxRate(double linesPerSecond)
+{
+	assert(linesPerSecond >= 0.0);
+
+	BARRETT_SCOPED_LOCK(getEmMutex());
+	maxRate = linesPerSecond;
+	credit = 1.0;
+}
+
+template<typename T>
+typename PrintToStream<T>::Statistics PrintToStream<T>::getStatistics() const
+{
+	Statistics s;
+	s.numPrinted = numPrinted.load(boost::memory_order_relaxed);
+	s.numDropped = numDropped.load(boost::memory_order_relaxed);
+	s.numRateLimited = numRateLimited.load(boost::memory_order_relaxed);
+	return s;
+}
+
+template<typename T>
+void PrintToStream<T>::operate()
+{
+	if (maxRate > 0.0) {
+		credit = std::min(credit + maxRate * T_s, 1.0);
+		if (credit < 1.0 - 1e-9) {
+			numRateLimited.fetch_add(1, boost::memory_order_relaxed);
+			return;
+		}
+		credit = std::max(credit - 1.0, 0.0);
+	}
+
+	if ( !queue.push(this->input.getValue()) ) {
+		numDropped.fetch_add(1, boost::memory_order_relaxed);
+	}
+}
+
+template<typename T>
+void PrintToStream<T>::printEntryPoint()
+{
+	while ( !stopping.load(boost::memory_order_acquire) ) {
+		printQueued();
+		btsleep(0.01);
+	}
+}
+
+template<typename T>
+void PrintToStream<T>::printQueued()
+{
+	T value;
+	unsigned long n = 0;
+	while (queue.pop(value)) {
+		os << label << value << '\n';
+		++n;
+	}
+	if (n != 0) {
+		os.flush();
+		numPrinted.fetch_add(n, boost::memory_order_relaxed);
+	}
+}
+
+
+}
+}
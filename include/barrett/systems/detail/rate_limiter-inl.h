@@ -74,7 +74,7 @@ void RateLimiter<T,MathTraits>::getSamplePeriodFromEM()
 {
 	if (this->hasExecutionManager()) {
 		assert(this->getExecutionManager()->getPeriod() > 0.0);
-		T_s = this->getExecutionManager()->getPeriod();
+		T_s = this->getEffectivePeriod();
 	} else {
 		T_s = 0.0;
 	}
@@ -0,0 +1,248 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file streaming_reference-inl.h
+ * @date 10/19/2026
+ */
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace barrett {
+namespace systems {
+
+
+template<typename T, typename MathTraits>
+StreamingReference<T,MathTraits>::StreamingReference(ExecutionManager* em,
+		enum InterpolationMode mode, double delay, double maxExtrapolation,
+		size_t capacity, const std::string& sysName) :
+	System(sysName), SingleOutput<T>(this),
+	mode(mode), delay(delay), maxExtrapolation(maxExtrapolation), T_s(0.0),
+	queue(capacity), window(), windowCount(0), anchorTime(0.0), numCycles(0), playbackTime(0.0), y(),
+	numReceived(0), numDropped(0), numLate(0), numUnderruns(0), numResyncs(0)
+{
+	assert(delay >= 0.0);
+	assert(maxExtrapolation >= 0.0);
+
+	// Update every execution cycle so the queue is drained even if the output
+	// isn't being used.
+	if (em != NULL) {
+		em->startManaging(*this);
+	}
+
+	getSamplePeriodFromEM();
+}
+
+template<typename T, typename MathTraits>
+bool StreamingReference<T,MathTraits>::push(double t, const T& setpoint)
+{
+	if (queue.push(Sample(t, setpoint))) {
+		numReceived.fetch_add(1, boost::memory_order_relaxed);
+		return true;
+	} else {
+		numDropped.fetch_add(1, boost::memory_order_relaxed);
+		return false;
+	}
+}
+
+template<typename T, typename MathTraits>
+typename StreamingReference<T,MathTraits>::Statistics StreamingReference<T,MathTraits>::getStatistics() const
+{
+	Statistics stats;
+	stats.numReceived = numReceived.load(boost::memory_order_relaxed);
+	stats.numDropped = numDropped.load(boost::memory_order_relaxed);
+	stats.numLate = numLate.load(boost::memory_order_relaxed);
+	stats.numUnderruns = numUnderruns.load(boost::memory_order_relaxed);
+	stats.numResyncs = numResyncs.load(boost::memory_order_relaxed);
+	return stats;
+}
+
+template<typename T, typename MathTraits>
+void StreamingReference<T,MathTraits>::getSamplePeriodFromEM()
+{
+	if (this->hasExecutionManager()) {
+		assert(this->getExecutionManager()->getPeriod() > 0.0);
+		T_s = this->getEffectivePeriod();
+	} else {
+		T_s = 0.0;
+	}
+}
+
+template<typename T, typename MathTraits>
+void StreamingReference<T,MathTraits>::operate()
+{
+	// Computed from a cycle count, rather than accumulated, to avoid drift
+	playbackTime = anchorTime + numCycles * T_s;
+	consumeSamples();
+
+	if (windowCount == 0) {
+		// Nothing has been received yet.
+		this->outputValue->setUndefined();
+		return;
+	}
+
+	const Sample& newest = window[windowCount - 1];
+	if (playbackTime <= window[0].t) {
+		y = window[0].value;
+	} else if (playbackTime >= newest.t) {
+		if (playbackTime > newest.t) {
+			numUnderruns.fetch_add(1, boost::memory_order_relaxed);
+		}
+		extrapolate();
+	} else {
+		size_t k = windowCount - 2;
+		while (window[k].t > playbackTime) {
+			--k;
+		}
+		interpolate(k);
+	}
+
+	this->outputValue->setData(&y);
+	++numCycles;
+}
+
+template<typename T, typename MathTraits>
+void StreamingReference<T,MathTraits>::consumeSamples()
+{
+	// Samples are consumed just in time: stop as soon as there is a sample
+	// after the current playback time. Later samples wait in the queue.
+	while (queue.read_available() != 0) {
+		if (windowCount != 0  &&  window[windowCount - 1].t > playbackTime) {
+			break;
+		}
+
+		const Sample& s = queue.front();
+
+		if (windowCount == 0) {
+			// First sample: start playback delay seconds before it.
+			anchor(s.t - delay);
+		} else if (s.t <= window[windowCount - 1].t) {
+			numDropped.fetch_add(1, boost::memory_order_relaxed);
+			queue.pop();
+			continue;
+		} else if (playbackTime - window[windowCount - 1].t > maxExtrapolation) {
+			// The stream stalled and the output has been held. Restart playback
+			// from the held value rather than jumping part-way along a segment
+			// that spans the gap.
+			numResyncs.fetch_add(1, boost::memory_order_relaxed);
+
+			anchor(s.t - delay);
+			windowCount = 0;
+			if (delay > 0.0) {
+				addToWindow(Sample(playbackTime, y));
+			}
+		} else if (s.t <= playbackTime - T_s) {
+			// This sample should have been available during a previous cycle.
+			numLate.fetch_add(1, boost::memory_order_relaxed);
+		}
+
+		addToWindow(s);
+		queue.pop();
+	}
+}
+
+template<typename T, typename MathTraits>
+inline void StreamingReference<T,MathTraits>::anchor(double t)
+{
+	anchorTime = playbackTime = t;
+	numCycles = 0;
+}
+
+template<typename T, typename MathTraits>
+inline void StreamingReference<T,MathTraits>::addToWindow(const Sample& sample)
+{
+	if (windowCount < WINDOW_SIZE) {
+		window[windowCount++] = sample;
+	} else {
+		for (size_t i = 1; i < WINDOW_SIZE; ++i) {
+			window[i - 1] = window[i];
+		}
+		window[WINDOW_SIZE - 1] = sample;
+	}
+}
+
+template<typename T, typename MathTraits>
+void StreamingReference<T,MathTraits>::interpolate(size_t k)
+{
+	const Sample& a = window[k];
+	const Sample& b = window[k + 1];
+
+	if (mode == HOLD) {
+		y = a.value;
+		return;
+	}
+
+	const double h = b.t - a.t;
+	const double s = (playbackTime - a.t) / h;
+
+	if (mode == LINEAR) {
+		y = a.value + s * (b.value - a.value);
+		return;
+	}
+
+	// Catmull-Rom tangents, falling back to one-sided differences at the
+	// ends of the available data.
+	const T m0 = (k > 0) ? tangent(window[k - 1], b) : tangent(a, b);
+	T m1;
+	if (k + 2 < windowCount) {
+		m1 = tangent(a, window[k + 2]);
+	} else if (queue.read_available() != 0  &&  queue.front().t > b.t) {
+		m1 = tangent(a, queue.front());
+	} else {
+		m1 = tangent(a, b);
+	}
+
+	const double s2 = s * s;
+	const double s3 = s2 * s;
+	y = (2.0*s3 - 3.0*s2 + 1.0) * a.value
+		+ ((s3 - 2.0*s2 + s) * h) * m0
+		+ (-2.0*s3 + 3.0*s2) * b.value
+		+ ((s3 - s2) * h) * m1;
+}
+
+template<typename T, typename MathTraits>
+void StreamingReference<T,MathTraits>::extrapolate()
+{
+	const Sample& newest = window[windowCount - 1];
+
+	if (mode == HOLD  ||  windowCount < 2) {
+		y = newest.value;
+		return;
+	}
+
+	const double dt = std::min(playbackTime - newest.t, maxExtrapolation);
+	y = newest.value + dt * tangent(window[windowCount - 2], newest);
+}
+
+template<typename T, typename MathTraits>
+inline T StreamingReference<T,MathTraits>::tangent(const Sample& prev, const Sample& next) const
+{
+	return (next.value - prev.value) / (next.t - prev.t);
+}
+
+
+}
+}
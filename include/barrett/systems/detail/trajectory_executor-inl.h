@@ -0,0 +1,298 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file trajectory_executor-inl.h
+ * @date 10/19/2026
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/tuple/tuple.hpp>
+#include <Eigen/Geometry>
+
+#include <barrett/thread/abstract/mutex.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+namespace detail {
+
+// Interpolates from a (alpha == 0) to b (alpha == 1).
+template<typename T>
+inline T trajectoryBlend(const T& a, const T& b, double alpha) {
+	return a + alpha * (b - a);
+}
+
+template<typename Scalar>
+inline Eigen::Quaternion<Scalar> trajectoryBlend(const Eigen::Quaternion<Scalar>& a, const Eigen::Quaternion<Scalar>& b, double alpha) {
+	return a.slerp(alpha, b);
+}
+
+inline boost::tuples::null_type trajectoryBlend(const boost::tuples::null_type& /*a*/, const boost::tuples::null_type& /*b*/, double /*alpha*/) {
+	return boost::tuples::null_type();
+}
+
+template<typename Head, typename Tail>
+inline boost::tuples::cons<Head, Tail> trajectoryBlend(const boost::tuples::cons<Head, Tail>& a, const boost::tuples::cons<Head, Tail>& b, double alpha) {
+	return boost::tuples::cons<Head, Tail>(trajectoryBlend(a.get_head(), b.get_head(), alpha), trajectoryBlend(a.get_tail(), b.get_tail(), alpha));
+}
+
+template <
+	typename T0, typename T1, typename T2, typename T3, typename T4,
+	typename T5, typename T6, typename T7, typename T8, typename T9>
+inline boost::tuple<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9> trajectoryBlend(
+		const boost::tuple<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9>& a,
+		const boost::tuple<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9>& b,
+		double alpha)
+{
+	typedef typename boost::tuple<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9>::inherited cons_type;
+	return trajectoryBlend(static_cast<const cons_type&>(a), static_cast<const cons_type&>(b), alpha);
+}
+
+}
+
+
+template<typename T>
+TrajectoryExecutor<T>::TrajectoryExecutor(size_t capacity, const std::string& sysName) :
+	System(sysName), SingleOutput<T>(this),
+	T_s(0.0), capacity(capacity),
+	commands(capacity + 1), retired(capacity + 1), numOutstanding(0), end(),
+	pending(capacity + 1), current(), t(0.0), yDefined(false), y()
+{
+	getSamplePeriodFromEM();
+}
+
+template<typename T>
+TrajectoryExecutor<T>::~TrajectoryExecutor()
+{
+	this->mandatoryCleanUp();
+
+	Command c;
+	while (commands.pop(c)) {
+		delete c.segment;
+	}
+	retireAll();
+	collectGarbage();
+}
+
+template<typename T>
+bool TrajectoryExecutor<T>::enqueue(Segment* segment, enum Mode mode, double blendDuration)
+{
+	assert(segment != NULL);
+
+	boost::lock_guard<boost::mutex> lg(producerMutex);
+	collectGarbage();
+
+	// One extra slot is reserved so that a REPLACE can always get through a
+	// full queue. At most capacity + 1 Segments are ever outstanding, so none
+	// of the queues can overflow.
+	if (numOutstanding.load(boost::memory_order_acquire) >= capacity + (mode == REPLACE ? 1 : 0)) {
+		return false;
+	}
+
+	end = segment->eval(segment->finalT());
+
+	numOutstanding.fetch_add(1, boost::memory_order_acq_rel);
+	bool pushed = commands.push(Command(segment, mode, blendDuration));
+	assert(pushed);
+	(void) pushed;  // Avoid an unused-variable warning when NDEBUG is defined
+
+	return true;
+}
+
+template<typename T>
+bool TrajectoryExecutor<T>::getEnd(T* endValue)
+{
+	boost::lock_guard<boost::mutex> lg(producerMutex);
+	if (isDone()) {
+		return false;
+	}
+
+	*endValue = end;
+	return true;
+}
+
+template<typename T>
+void TrajectoryExecutor<T>::onExecutionManagerChanged()
+{
+	System::onExecutionManagerChanged();  // First, call super
+	getSamplePeriodFromEM();
+
+	// This is called while holding the ExecutionManager's mutex, so operate()
+	// can't be running. If we're no longer being executed, nobody is tracking
+	// our output: abandon whatever we were doing rather than resuming a stale
+	// trajectory the next time we are connected.
+	if ( !this->hasExecutionManager() ) {
+		retireAll();
+		yDefined = false;
+	}
+}
+
+template<typename T>
+void TrajectoryExecutor<T>::getSamplePeriodFromEM()
+{
+	if (this->hasExecutionManager()) {
+		assert(this->getExecutionManager()->getPeriod() > 0.0);
+		T_s = this->getEffectivePeriod();
+	} else {
+		T_s = 0.0;
+	}
+}
+
+template<typename T>
+void TrajectoryExecutor<T>::operate()
+{
+	Command c;
+	while (commands.pop(c)) {
+		accept(c);
+	}
+
+	// Move on to the next Segment if the current one is finished. (A very
+	// short Segment might finish within a single execution cycle.)
+	while (current.segment != NULL  &&  t >= current.segment->finalT()) {
+		if (pending.empty()) {
+			y = current.segment->eval(current.segment->finalT());
+			yDefined = true;
+
+			retire(current.segment);
+			current = Command();
+		} else {
+			t -= startOfNext(pending.front());
+
+			retire(current.segment);
+			current = pending.front();
+			pending.pop_front();
+		}
+	}
+
+	if (current.segment != NULL) {
+		y = current.segment->eval(t);
+		yDefined = true;
+
+		if ( !pending.empty()  &&  pending.front().mode == BLEND) {
+			const double tNext = t - startOfNext(pending.front());
+			if (tNext > 0.0) {
+				// Smooth-step from the current Segment to the next one
+				const double alpha = tNext / blendDurationOf(pending.front());
+				y = detail::trajectoryBlend(y, pending.front().segment->eval(tNext), alpha * alpha * (3.0 - 2.0 * alpha));
+			}
+		}
+
+		t += T_s;
+	}
+
+	if (yDefined) {
+		this->outputValue->setData(&y);
+	} else {
+		this->outputValue->setUndefined();
+	}
+}
+
+template<typename T>
+void TrajectoryExecutor<T>::accept(const Command& c)
+{
+	if (c.mode == REPLACE) {
+		retireAll();
+	}
+
+	if (current.segment == NULL) {
+		current = c;
+		t = 0.0;
+	} else {
+		assert( !pending.full() );
+		pending.push_back(c);
+	}
+}
+
+template<typename T>
+inline void TrajectoryExecutor<T>::retire(Segment* segment)
+{
+	bool pushed = retired.push(segment);
+	assert(pushed);
+	(void) pushed;  // Avoid an unused-variable warning when NDEBUG is defined
+
+	numOutstanding.fetch_sub(1, boost::memory_order_acq_rel);
+}
+
+template<typename T>
+void TrajectoryExecutor<T>::retireAll()
+{
+	if (current.segment != NULL) {
+		retire(current.segment);
+		current = Command();
+	}
+	while ( !pending.empty() ) {
+		retire(pending.front().segment);
+		pending.pop_front();
+	}
+}
+
+template<typename T>
+inline void TrajectoryExecutor<T>::collectGarbage()
+{
+	Segment* segment;
+	while (retired.pop(segment)) {
+		delete segment;
+	}
+}
+
+template<typename T>
+inline double TrajectoryExecutor<T>::blendDurationOf(const Command& next) const
+{
+	if (next.mode != BLEND) {
+		return 0.0;
+	}
+	return std::max(0.0, std::min(next.blendDuration, std::min(current.segment->finalT(), next.segment->finalT())));
+}
+
+template<typename T>
+inline double TrajectoryExecutor<T>::startOfNext(const Command& next) const
+{
+	return current.segment->finalT() - blendDurationOf(next);
+}
+
+
+template<typename T>
+ProfiledSplineSegment<T>::ProfiledSplineSegment(const T& start, const T& end, double velocity, double acceleration) :
+	spline(makePoints(start, end)),
+	profile(velocity, acceleration, 0.0, spline.changeInS())
+{
+}
+
+template<typename T>
+typename ProfiledSplineSegment<T>::point_vector_type ProfiledSplineSegment<T>::makePoints(const T& start, const T& end)
+{
+	point_vector_type points;
+	points.push_back(start);
+	points.push_back(end);
+	return points;
+}
+
+
+}
+}
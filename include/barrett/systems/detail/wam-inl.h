@@ -30,6 +30,7 @@
 
 
 #include <unistd.h>  // usleep
+#include <stdexcept>
 
 #include <boost/ref.hpp>
 #include <boost/bind.hpp>
@@ -65,7 +66,23 @@ template<size_t DOF>
 Wam<DOF>::Wam(ExecutionManager* em, const std::vector<Puck*>& genericPucks,
 		SafetyModule* safetyModule, const libconfig::Setting& setting,
 		std::vector<int> torqueGroupIds, const std::string& sysName) :
-	llww(em, genericPucks, safetyModule, setting["low_level"], torqueGroupIds, sysName + "::LowLevel"),
+	Wam(em, genericPucks, safetyModule, NULL, setting, torqueGroupIds, sysName)
+{
+}
+
+template<size_t DOF>
+Wam<DOF>::Wam(ExecutionManager* em, SimulatedLowLevelWam<DOF>* simulatedWam,
+		const libconfig::Setting& setting, const std::string& sysName) :
+	Wam(em, std::vector<Puck*>(), NULL, simulatedWam, setting, std::vector<int>(), sysName)
+{
+}
+
+template<size_t DOF>
+Wam<DOF>::Wam(ExecutionManager* em, const std::vector<Puck*>& genericPucks,
+		SafetyModule* safetyModule, SimulatedLowLevelWam<DOF>* simulatedWam,
+		const libconfig::Setting& setting, std::vector<int> torqueGroupIds,
+		const std::string& sysName) :
+	llww(em, genericPucks, safetyModule, setting["low_level"], torqueGroupIds, simulatedWam, sysName + "::LowLevel"),
 	kinematicsBase(setting["kinematics"]),
 	gravity(setting["gravity_compensation"]),
 	jvFilter(setting["joint_velocity_filter"]),
@@ -93,9 +110,13 @@ Wam<DOF>::Wam(ExecutionManager* em, const std::vector<Puck*>& genericPucks,
 
 	jtSum(true),
 
+	jpTrajectory(), tpTrajectory(), toTrajectory(), tpoTrajectory(),
+	jpOnlineTrajectory(typename jp_type::unitless_type(0.5), typename jp_type::unitless_type(0.5), typename jp_type::unitless_type(5.0)),
+
+	statePublisher(em, safetyModule, sysName + "::StatePublisher"),
+
 	input(jtSum.getInput(JT_INPUT)), jpOutput(llww.jpOutput), jvOutput(jvFilter.output),
 
-	doneMoving(true),
 	kin(setting["kinematics"])
 {
 	connect(llww.jpOutput, kinematicsBase.jpInput);
@@ -161,14 +182,17 @@ Wam<DOF>::Wam(ExecutionManager* em, const std::vector<Puck*>& genericPucks,
 
 	connect(supervisoryController.output, jtSum.getInput(SC_INPUT));
 	connect(jtSum.output, llww.input);
+
+	connect(llww.jpOutput, statePublisher.jpInput);
+	connect(jvOutput, statePublisher.jvInput);
+	connect(jtSum.output, statePublisher.jtInput);
+	connect(toolPosition.output, statePublisher.toolPositionInput);
+	connect(toolOrientation.output, statePublisher.toolOrientationInput);
 }
 
 template<size_t DOF>
 Wam<DOF>::~Wam()
 {
-	// Make sure any outstanding moveTo() threads are cleaned up
-	mtThreadGroup.interrupt_all();
-	mtThreadGroup.join_all();
 }
 
 template<size_t DOF>
@@ -178,15 +202,33 @@ void Wam<DOF>::trackReferenceSignal(System::Output<T>& referenceSignal)
 	supervisoryController.connectInputTo(referenceSignal);
 }
 
+template<size_t DOF>
+inline bool Wam<DOF>::getState(State* state) const
+{
+	const thread::SeqLock<State>& ps = statePublisher.getPublishedState();
+	if ( !ps.hasBeenWritten() ) {
+		return false;
+	}
+
+	ps.read(state);
+	statePublisher.getSafetyMode(state);
+	return true;
+}
+
 template<size_t DOF>
 inline const typename Wam<DOF>::jp_type& Wam<DOF>::getHomePosition() const
 {
-	return getLowLevelWam().getHomePosition();
+	return llww.getHomePosition();
 }
 
 template<size_t DOF>
 typename Wam<DOF>::jt_type Wam<DOF>::getJointTorques() const
 {
+	State state;
+	if (getState(&state)) {
+		return state.jt;
+	}
+
 	{
 		BARRETT_SCOPED_LOCK(getEmMutex());
 		if (llww.input.valueDefined()) {
@@ -200,12 +242,22 @@ typename Wam<DOF>::jt_type Wam<DOF>::getJointTorques() const
 template<size_t DOF>
 inline typename Wam<DOF>::jp_type Wam<DOF>::getJointPositions() const
 {
-	return getLowLevelWam().getJointPositions();
+	State state;
+	if (getState(&state)) {
+		return state.jp;
+	}
+
+	return llww.getJointPositions();
 }
 
 template<size_t DOF>
 inline typename Wam<DOF>::jv_type Wam<DOF>::getJointVelocities() const
 {
+	State state;
+	if (getState(&state)) {
+		return state.jv;
+	}
+
 	{
 		BARRETT_SCOPED_LOCK(getEmMutex());
 
@@ -216,12 +268,17 @@ inline typename Wam<DOF>::jv_type Wam<DOF>::getJointVelocities() const
 	}
 
 	// Otherwise just return differentiated positions.
-	return getLowLevelWam().getJointVelocities();
+	return llww.getJointVelocities();
 }
 
 template<size_t DOF>
 typename Wam<DOF>::cp_type Wam<DOF>::getToolPosition() const
 {
+	State state;
+	if (getState(&state)) {
+		return state.toolPosition;
+	}
+
 	{
 		BARRETT_SCOPED_LOCK(getEmMutex());
 		if (tpController.feedbackInput.valueDefined()) {
@@ -243,6 +300,11 @@ typename Wam<DOF>::cv_type Wam<DOF>::getToolVelocity() const
 template<size_t DOF>
 Eigen::Quaterniond Wam<DOF>::getToolOrientation() const
 {
+	State state;
+	if (getState(&state)) {
+		return state.toolOrientation;
+	}
+
 	{
 		BARRETT_SCOPED_LOCK(getEmMutex());
 		if (toController.feedbackInput.valueDefined()) {
@@ -258,6 +320,12 @@ Eigen::Quaterniond Wam<DOF>::getToolOrientation() const
 template<size_t DOF>
 inline typename Wam<DOF>::pose_type Wam<DOF>::getToolPose() const
 {
+	// Take both halves of the pose from the same snapshot, if possible.
+	State state;
+	if (getState(&state)) {
+		return boost::make_tuple(state.toolPosition, state.toolOrientation);
+	}
+
 	return boost::make_tuple(getToolPosition(), getToolOrientation());
 }
 
@@ -335,18 +403,10 @@ template<size_t DOF>
 template<typename T>
 void Wam<DOF>::moveTo(const T& currentPos, /*const typename T::unitless_type& currentVel,*/ const T& destination, bool blocking, double velocity, double acceleration)
 {
-	bool started = false;
-	boost::promise<boost::thread*> threadPtrPromise;
-	boost::shared_future<boost::thread*> threadPtrFuture(threadPtrPromise.get_future());
-	boost::thread* threadPtr = new boost::thread(&Wam<DOF>::moveToThread<T>, this, boost::ref(currentPos), /*currentVel,*/ boost::ref(destination), velocity, acceleration, &started, threadPtrFuture);
-	mtThreadGroup.add_thread(threadPtr);
-	threadPtrPromise.set_value(threadPtr);
-	
-
-	// wait until move starts
-	while ( !started ) {
-		btsleep(0.001);
-	}
+	// TODO(dc): Use currentVel. Requires changes to math::spline<Eigen::Quaternion<T> > specialization.
+	startMove(getTrajectoryExecutor(destination),
+			new ProfiledSplineSegment<T>(currentPos, destination, velocity, acceleration),
+			TrajectoryExecutor<T>::REPLACE, 0.0);
 
 	if (blocking) {
 		while (!moveIsDone()) {
@@ -355,10 +415,76 @@ void Wam<DOF>::moveTo(const T& currentPos, /*const typename T::unitless_type& cu
 	}
 }
 
+template<size_t DOF>
+inline void Wam<DOF>::queueMoveTo(const jp_type& destination, double blendDuration, double velocity, double acceleration)
+{
+	queueMoveTo(currentPosHelper(getJointPositions()), destination, blendDuration, velocity, acceleration);
+}
+
+template<size_t DOF>
+inline void Wam<DOF>::queueMoveTo(const cp_type& destination, double blendDuration, double velocity, double acceleration)
+{
+	queueMoveTo(currentPosHelper(getToolPosition()), destination, blendDuration, velocity, acceleration);
+}
+
+template<size_t DOF>
+inline void Wam<DOF>::queueMoveTo(const Eigen::Quaterniond& destination, double blendDuration, double velocity, double acceleration)
+{
+	queueMoveTo(currentPosHelper(getToolOrientation()), destination, blendDuration, velocity, acceleration);
+}
+
+template<size_t DOF>
+inline void Wam<DOF>::queueMoveTo(const pose_type& destination, double blendDuration, double velocity, double acceleration)
+{
+	queueMoveTo(currentPosHelper(getToolPose()), destination, blendDuration, velocity, acceleration);
+}
+
+template<size_t DOF>
+template<typename T>
+void Wam<DOF>::queueMoveTo(const T& currentPos, const T& destination, double blendDuration, double velocity, double acceleration)
+{
+	TrajectoryExecutor<T>& te = getTrajectoryExecutor(destination);
+
+	// Only append if te is still being tracked and has something to append to.
+	T start;
+	if (te.hasExecutionManager()  &&  te.getEnd(&start)) {
+		startMove(te, new ProfiledSplineSegment<T>(start, destination, velocity, acceleration),
+				blendDuration > 0.0 ? TrajectoryExecutor<T>::BLEND : TrajectoryExecutor<T>::QUEUE,
+				blendDuration);
+	} else {
+		moveTo(currentPos, destination, false, velocity, acceleration);
+	}
+}
+
+template<size_t DOF>
+void Wam<DOF>::moveToOnline(const jp_type& destination, double velocity, double acceleration, double jerk)
+{
+	typedef typename jp_type::unitless_type limit_type;
+	OnlineTrajectoryGenerator<jp_type>& otg = jpOnlineTrajectory;
+
+	otg.setLimits(limit_type(velocity), limit_type(acceleration), limit_type(jerk));
+
+	// If the generator isn't being tracked, it has no state to re-plan from.
+	// Start it at rest, then switch controllers. Both commands will be picked
+	// up in the first execution cycle after the connection.
+	const bool tracking = otg.hasExecutionManager();
+	if ( !tracking ) {
+		otg.reset(currentPosHelper(getJointPositions()));
+	}
+	if ( !otg.setTarget(destination) ) {
+		(logMessage("Wam::%s(): Too many targets are waiting for the control loop.")
+				% __func__).template raise<std::runtime_error>();
+	}
+	if ( !tracking ) {
+		trackReferenceSignal(otg.output);
+	}
+}
+
 template<size_t DOF>
 bool Wam<DOF>::moveIsDone() const
 {
-	return doneMoving;
+	return jpTrajectory.isDone()  &&  tpTrajectory.isDone()  &&  toTrajectory.isDone()  &&  tpoTrajectory.isDone()  &&
+			jpOnlineTrajectory.isDone();
 }
 
 template<size_t DOF>
@@ -368,6 +494,111 @@ void Wam<DOF>::idle()
 }
 
 
+template<size_t DOF>
+const double Wam<DOF>::StatePublisher::SAFETY_MODE_PERIOD = 0.1;
+
+template<size_t DOF>
+Wam<DOF>::StatePublisher::StatePublisher(ExecutionManager* em,
+		SafetyModule* safetyModule, const std::string& sysName) :
+	System(sysName),
+	jpInput(this), jvInput(this), jtInput(this),
+	toolPositionInput(this), toolOrientationInput(this),
+	sm(safetyModule), safetyMode(), safetyModeWanted(false), stopping(false), smThread(),
+	state(), published()
+{
+	state.cycle = 0;
+
+	SafetyModeReading r;
+	r.mode = SafetyModule::ACTIVE;  // Reported when there is no SafetyModule to ask.
+	r.time = 0.0;
+	safetyMode.write(r);
+
+	if (sm != NULL) {
+		// Don't report a made-up mode before the first poll.
+		readSafetyMode(true);
+
+		boost::thread tmpThread(boost::bind(&StatePublisher::pollSafetyModeEntryPoint, this));
+		smThread.swap(tmpThread);
+	}
+
+	// Publish every execution cycle because this is a sink.
+	if (em != NULL) {
+		em->startManaging(*this);
+	}
+}
+
+template<size_t DOF>
+Wam<DOF>::StatePublisher::~StatePublisher()
+{
+	mandatoryCleanUp();
+
+	stopping.store(true, boost::memory_order_release);
+	smThread.join();
+}
+
+template<size_t DOF>
+void Wam<DOF>::StatePublisher::getSafetyMode(State* s) const
+{
+	SafetyModeReading r;
+	safetyMode.read(&r);
+	s->safetyMode = r.mode;
+	s->safetyModeTime = r.time;
+
+	safetyModeWanted.store(true, boost::memory_order_relaxed);
+}
+
+template<size_t DOF>
+void Wam<DOF>::StatePublisher::operate()
+{
+	state.jp = jpInput.getValue();
+	state.jv = jvInput.getValue();
+	state.jt = jtInput.getValue();
+	state.toolPosition = toolPositionInput.getValue();
+	state.toolOrientation = toolOrientationInput.getValue();
+	++state.cycle;
+	state.time = highResolutionSystemTime();
+
+	published.write(state);
+}
+
+template<size_t DOF>
+bool Wam<DOF>::StatePublisher::readSafetyMode(bool logFailure)
+{
+	SafetyModeReading r;
+	try {
+		r.mode = sm->getMode();
+	} catch (const std::runtime_error& e) {
+		if (logFailure) {
+			logMessage("Wam::StatePublisher::%s(): Couldn't read the SafetyModule's mode: %s", true)
+					% __func__ % e.what();
+		}
+		return false;
+	}
+	r.time = highResolutionSystemTime();
+	safetyMode.write(r);
+	return true;
+}
+
+template<size_t DOF>
+void Wam<DOF>::StatePublisher::pollSafetyModeEntryPoint()
+{
+	bool failing = false;
+	while ( !stopping.load(boost::memory_order_acquire) ) {
+		btsleep(SAFETY_MODE_PERIOD);
+
+		// Nobody is looking, so stay off the bus.
+		if ( !safetyModeWanted.exchange(false, boost::memory_order_relaxed) ) {
+			continue;
+		}
+
+		// A failed read keeps the last good reading, whose time shows how old
+		// it is. Only the first failure in a row is logged so a flaky bus
+		// doesn't flood syslog.
+		failing = !readSafetyMode( !failing );
+	}
+}
+
+
 template<size_t DOF>
 template<typename T>
 T Wam<DOF>::currentPosHelper(const T& currentPos)
@@ -389,62 +620,22 @@ T Wam<DOF>::currentPosHelper(const T& currentPos)
 
 template<size_t DOF>
 template<typename T>
-void Wam<DOF>::moveToThread(const T& currentPos, /*const typename T::unitless_type& currentVel,*/ const T& destination, double velocity, double acceleration, bool* started, boost::shared_future<boost::thread*> threadPtrFuture)
+void Wam<DOF>::startMove(TrajectoryExecutor<T>& te, typename TrajectoryExecutor<T>::Segment* segment, enum TrajectoryExecutor<T>::Mode mode, double blendDuration)
 {
-	// Only remove this thread from mtThreadGroup on orderly exit. (Don't remove on exception.)
-	bool removeThread = false;
-	
-	try {
-		std::vector<T, Eigen::aligned_allocator<T> > vec;
-		vec.push_back(currentPos);
-		vec.push_back(destination);
-
-		// TODO(dc): Use currentVel. Requires changes to math::spline<Eigen::Quaternion<T> > specialization.
-		//math::Spline<T> spline(vec, currentVel);
-		//math::TrapezoidalVelocityProfile profile(velocity, acceleration, currentVel.norm(), spline.changeInS());
-		math::Spline<T> spline(vec);
-		math::TrapezoidalVelocityProfile profile(velocity, acceleration, 0.0, spline.changeInS());
-
-		Ramp time(NULL, 1.0);
-		Callback<double, T> trajectory(boost::bind(boost::ref(spline), boost::bind(boost::ref(profile), _1)));
-
-		connect(time.output, trajectory.input);
-		trackReferenceSignal(trajectory.output);
-		time.start();
-
-		doneMoving = false;
-		*started = true;
-
-		// The value of trajectory.input will be undefined until the next execution cycle.
-		// It may become undefined again if trajectory.output is disconnected and this chain
-		// of Systems loses its ExecutionManager. We must check that the value is defined
-		// before calling getValue().
-		while ( !trajectory.input.valueDefined()  ||  trajectory.input.getValue() < profile.finalT()) {
-			// if the move is interrupted, clean up and end the thread
-			if ( !trajectory.output.isConnected() ||  boost::this_thread::interruption_requested() ) {
-				removeThread = true;
-				break;
-			}
-			btsleep(0.01);  // Interruption point. May throw boost::thread_interrupted
-		}
-
-		if ( !removeThread ) {
-			doneMoving = true;
+	if ( !te.enqueue(segment, mode, blendDuration) ) {
+		delete segment;
+		(logMessage("Wam::%s(): Too many moves are queued. "
+				"Wait for moveIsDone() before queuing more.")
+				% __func__).template raise<std::runtime_error>();
+	}
 
-			// Wait until the trajectory is no longer referenced by supervisoryController
-			while (trajectory.hasExecutionManager()  &&  !boost::this_thread::interruption_requested()) {
-				btsleep(0.01);  // Interruption point. May throw boost::thread_interrupted
-			}
-			removeThread = true;
-		}
-	} catch (const boost::thread_interrupted& e) {}
-	
-	if (removeThread) {
-		mtThreadGroup.remove_thread(threadPtrFuture.get());
-		delete threadPtrFuture.get();
+	// The executor only has an ExecutionManager while supervisoryController
+	// is tracking it. Otherwise, switch controllers. The enqueued Segment
+	// will be picked up in the first execution cycle after the connection.
+	if ( !te.hasExecutionManager() ) {
+		trackReferenceSignal(te.output);
 	}
 }
 
-
 }
 }
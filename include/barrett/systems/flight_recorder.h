@@ -0,0 +1,194 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file flight_recorder.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_FLIGHT_RECORDER_H_
+#define BARRETT_SYSTEMS_FLIGHT_RECORDER_H_
+
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/column_options.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/abstract/single_io.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** Keeps the last few seconds of its input in memory and writes them to a
+ * column log (see log::ColumnReader) when something goes wrong.
+ *
+ * Every execution cycle, the input is serialized into a preallocated ring
+ * that holds preTrigger_s + postTrigger_s seconds of records. Nothing is
+ * written to disk until a trigger: a rising edge on triggerInput (e.g. a
+ * fault flag or a change of safety mode) or a call to trigger() from any
+ * thread (e.g. a user's request). Recording then continues for
+ * postTrigger_s seconds, after which the ring is handed to a background
+ * thread that writes it to "<fileNamePrefix>-<date>-<time>-<n>.log" while
+ * the realtime side carries on in a second ring. Steady-state disk cost is
+ * zero.
+ *
+ * Triggers during the post-trigger window belong to the same dump. If a
+ * new dump is due before the previous one has been written, records are
+ * dropped (and counted) until the background thread catches up.
+ *
+ * If the FlightRecorder is destroyed mid-capture, the partial capture is
+ * written before the destructor returns.
+ */
+template<typename T, typename LogTraits = log::Traits<T> >
+class FlightRecorder : public System, public SingleInput<T> {
+// IO
+public:	System::Input<bool> triggerInput;
+
+
+public:
+	struct Dump {
+		std::string fileName;
+		size_t numRecords;
+		size_t triggerRecord;  ///< The index in the file of the first record logged after the trigger
+	};
+	typedef boost::function<void (const Dump&)> callback_type;
+
+	static const int DEFAULT_PRIORITY = 20;
+
+
+	/** em must not be NULL and must have a known period. The windows are
+	 * converted into records with the System's effective period, so they
+	 * keep their length in seconds after a setRateDivisor(). options control
+	 * the dumps' field names and compression.
+	 */
+	FlightRecorder(ExecutionManager* em, const std::string& fileNamePrefix,
+			double preTrigger_s, double postTrigger_s,
+			const log::ColumnOptions& options = log::ColumnOptions(),
+			int priority = DEFAULT_PRIORITY,
+			const std::string& sysName = "FlightRecorder");
+	virtual ~FlightRecorder();
+
+	/// Starts a dump at the next execution cycle. Safe to call from any thread.
+	void trigger() {  triggerRequested.store(true, boost::memory_order_release);  }
+
+	/// Called from the background thread after each dump is written.
+	void setDumpCallback(callback_type callback);
+
+	size_t getPreTriggerRecords() const {  return preTriggerRecords;  }
+	size_t getPostTriggerRecords() const {  return postTriggerRecords;  }
+
+	size_t getNumDumps() const {  return numDumps.load(boost::memory_order_acquire);  }
+	/// Triggers that arrived while no ring was free to capture them
+	size_t getNumMissedTriggers() const {  return numMissedTriggers.load(boost::memory_order_relaxed);  }
+	/// Records that weren't kept because no ring was free
+	size_t getNumDroppedRecords() const {  return numDroppedRecords.load(boost::memory_order_relaxed);  }
+
+protected:
+	enum RingState { FREE, RECORDING, CAPTURED };
+
+	struct Ring {
+		std::vector<char> data;
+		boost::uint64_t count;  // Records written since the ring was last reset
+		boost::uint64_t triggerRecord;
+		size_t preTriggerRecords;
+		double samplePeriod;
+		boost::atomic<int> state;
+	};
+
+	virtual bool inputsValid() {  return this->input.valueDefined();  }
+	virtual void operate();
+	// Optimization: this System has no Outputs to invalidate.
+	virtual void invalidateOutputs() {}
+
+	virtual void onExecutionManagerChanged() {
+		System::onExecutionManagerChanged();  // First, call super
+		T_s = hasExecutionManager() ? getEffectivePeriod() : 0.0;
+		if (T_s > 0.0) {
+			// The rings were sized for em's own period, which is the shortest
+			// T_s can be, so this only fails to fit if em has been replaced.
+			postTriggerRecords = std::min(windowRecords(postTrigger_s, T_s), capacity);
+			preTriggerRecords = std::min(windowRecords(preTrigger_s, T_s), capacity - postTriggerRecords);
+		}
+	}
+
+	static size_t windowRecords(double window_s, double period) {
+		return std::ceil(window_s / period - 1e-9);
+	}
+
+	void startRecording(size_t i);
+	void handOff();
+
+	void dumpEntryPoint();
+	void dump(Ring& ring);
+
+	std::string fileNamePrefix;
+	double preTrigger_s, postTrigger_s;
+	size_t preTriggerRecords, postTriggerRecords, capacity;
+	size_t recordLength;
+	log::Schema schema;
+	log::ColumnOptions options;
+	int priority;
+	double T_s;
+
+	// Only accessed from operate() (and the destructor, once operate() can no longer run)
+	Ring rings[2];
+	size_t active;
+	bool capturing, stalled;
+	size_t remaining;
+	bool lastTriggerValue;
+
+	boost::atomic<bool> triggerRequested;
+	boost::atomic<size_t> numDumps, numMissedTriggers, numDroppedRecords;
+
+	boost::mutex callbackMutex;
+	callback_type callback;
+	boost::thread thread;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(FlightRecorder);
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/systems/detail/flight_recorder-inl.h>
+
+
+#endif /* BARRETT_SYSTEMS_FLIGHT_RECORDER_H_ */
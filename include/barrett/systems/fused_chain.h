@@ -0,0 +1,301 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file fused_chain.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_FUSED_CHAIN_H_
+#define BARRETT_SYSTEMS_FUSED_CHAIN_H_
+
+
+#include <string>
+
+#include <boost/array.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <Eigen/Core>
+#include <libconfig.h++>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/math/traits.h>
+#include <barrett/math/first_order_filter.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/abstract/single_io.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** Stages that can be fused into a FusedChain.
+ *
+ * A stage is a plain (non-System) object that performs the work of one System
+ * in a linear chain. It must provide:
+ *   - typedefs input_type and output_type;
+ *   - void attach(System* parent): called once from the FusedChain's
+ *     constructor, to create any additional Inputs on the parent;
+ *   - bool inputsValid(): whether those additional Inputs are usable;
+ *   - void setSamplePeriod(double T_s);
+ *   - const output_type& eval(const input_type& x).
+ *
+ * None of these are virtual: the whole chain is inlined into
+ * FusedChain::operate().
+ */
+namespace fusion {
+
+
+/// Placeholder for unused FusedChain stages.
+struct None {};
+
+
+/// y = gain * x. Equivalent to systems::Gain.
+template<typename InputType, typename GainType = InputType, typename OutputType = InputType>
+class Gain {
+public:
+	typedef InputType input_type;
+	typedef OutputType output_type;
+
+	Gain() : gain(1.0), y() {}
+
+	void setGain(const GainType& g) {  gain = g;  }
+	const GainType& getGain() const {  return gain;  }
+
+	void attach(System* /*parent*/) {}
+	bool inputsValid() {  return true;  }
+	void setSamplePeriod(double /*T_s*/) {}
+
+	const output_type& eval(const input_type& x) {
+		y = gain * x;
+		return y;
+	}
+
+protected:
+	GainType gain;
+	output_type y;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(Gain);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(math::Traits<GainType>::RequiresAlignment || math::Traits<OutputType>::RequiresAlignment)
+};
+
+
+/** y = x + sum(+/- side inputs). Equivalent to a systems::Summer whose first
+ * input is fed by the previous stage.
+ *
+ * The side Inputs are created on the FusedChain and are available through
+ * getInput() after it has been constructed.
+ */
+template<typename T, size_t numSideInputs = 1, typename MathTraits = math::Traits<T> >
+class Sum {
+public:
+	typedef T input_type;
+	typedef T output_type;
+
+	Sum();
+	~Sum();
+
+	/// One '+' or '-' per side input. Default: all positive.
+	void setPolarity(const std::string& polarityStr);
+	/// If true, undefined side inputs are skipped rather than making the
+	/// FusedChain's output undefined (see Summer's undefinedIsZero).
+	void setUndefinedIsZero(bool undefinedIsZero) {  strict = !undefinedIsZero;  }
+
+	System::Input<T>& getInput(const size_t i);
+
+	void attach(System* parent);
+	bool inputsValid();
+	void setSamplePeriod(double /*T_s*/) {}
+
+	const output_type& eval(const input_type& x);
+
+protected:
+	boost::array<System::Input<T>*, numSideInputs> inputs;
+	boost::array<int, numSideInputs> polarity;
+	bool strict;
+	T sum;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(Sum);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(MathTraits::RequiresAlignment)
+};
+
+
+/** Control signal from an error signal. Equivalent to a systems::PIDController
+ * whose error (reference - feedback) is computed by a preceding Sum stage.
+ */
+template<typename InputType,
+		 typename OutputType = typename InputType::actuator_type,
+		 typename MathTraits = math::Traits<InputType> >
+class PID {
+public:
+	typedef InputType input_type;
+	typedef OutputType output_type;
+	typedef typename MathTraits::unitless_type unitless_type;
+
+	PID();
+
+	void setFromConfig(const libconfig::Setting& setting);
+	void setKp(const unitless_type& proportionalGains) {  kp = proportionalGains;  }
+	void setKi(const unitless_type& integralGains) {  ki = integralGains;  }
+	void setKd(const unitless_type& derivitiveGains) {  kd = derivitiveGains;  }
+	void setIntegratorState(const unitless_type& integratorState);
+	void setIntegratorLimit(const unitless_type& intSaturations) {  intErrorLimit = intSaturations;  }
+	void setControlSignalLimit(const unitless_type& csSaturations) {  controlSignalLimit = csSaturations;  }
+
+	void resetIntegrator() {  setIntegratorState(unitless_type(0.0));  }
+
+	const unitless_type& getKp() const {  return kp;  }
+	const unitless_type& getKi() const {  return ki;  }
+	const unitless_type& getKd() const {  return kd;  }
+	const unitless_type& getIntegratorState() const {  return intError;  }
+
+	void attach(System* parent) {  parentSys = parent;  }
+	bool inputsValid() {  return true;  }
+	void setSamplePeriod(double timeStep) {  T_s = timeStep;  }
+
+	const output_type& eval(const input_type& error);
+
+protected:
+	System* parentSys;
+	double T_s;
+	InputType error_1;
+	unitless_type intError, intErrorLimit;
+	unitless_type kp, ki, kd;
+	OutputType controlSignal, controlSignalLimit;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(PID);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(MathTraits::RequiresAlignment)
+};
+
+
+/// Equivalent to systems::FirstOrderFilter.
+template<typename T, typename MathTraits = math::Traits<T> >
+class Filter : public math::FirstOrderFilter<T, MathTraits> {
+public:
+	typedef T input_type;
+	typedef T output_type;
+
+	Filter() {}
+
+	void attach(System* /*parent*/) {}
+	bool inputsValid() {  return true;  }
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(Filter);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(MathTraits::RequiresAlignment)
+};
+
+
+}
+
+
+namespace detail {
+
+template<typename Stage, typename Next> struct FusedChainNode;
+template<typename S1, typename S2, typename S3, typename S4, typename S5, typename S6> struct MakeFusedChain;
+template<typename Node, size_t N> struct FusedChainStage;
+
+}
+
+
+/** A linear chain of up to six stages (see the fusion namespace) that runs as a
+ * single System.
+ *
+ * Compared to connecting the equivalent Gain, Summer, PIDController and
+ * FirstOrderFilter Systems, a FusedChain has one virtual operate(), one update
+ * token check and one Output, and its stages are evaluated back to back with
+ * no Input/Output indirection between them. The output_type of each stage must
+ * match the input_type of the next; this is checked at compile time. The
+ * chain operates as a unit: if a strict Sum stage has an undefined side input,
+ * no stage operates and the output is undefined.
+ *
+ * Stages are default-constructed and configured through getStage<N>():
+ * @code
+ * typedef FusedChain<fusion::Sum<jv_type>, fusion::PID<jv_type, jt_type>, fusion::Filter<jt_type> > jv_controller_type;
+ * jv_controller_type jvController;
+ * jvController.getStage<0>().setPolarity("-");
+ * connect(wam.jvOutput, jvController.getStage<0>().getInput(0));
+ * jvController.getStage<1>().setFromConfig(setting["joint_velocity_control"][0]);
+ * jvController.getStage<2>().setFromConfig(setting["joint_velocity_control"][1]);
+ * @endcode
+ */
+template<typename S1,
+		 typename S2 = fusion::None, typename S3 = fusion::None,
+		 typename S4 = fusion::None, typename S5 = fusion::None,
+		 typename S6 = fusion::None>
+class FusedChain :
+		public SingleIO<typename S1::input_type,
+						typename detail::MakeFusedChain<S1, S2, S3, S4, S5, S6>::type::output_type> {
+public:
+	typedef typename detail::MakeFusedChain<S1, S2, S3, S4, S5, S6>::type chain_type;
+	typedef typename chain_type::input_type input_type;
+	typedef typename chain_type::output_type output_type;
+
+	explicit FusedChain(const std::string& sysName = "FusedChain");
+	virtual ~FusedChain() {  this->mandatoryCleanUp();  }
+
+	template<size_t N> typename detail::FusedChainStage<chain_type, N>::type& getStage() {
+		return detail::FusedChainStage<chain_type, N>::get(chain);
+	}
+
+protected:
+	virtual bool inputsValid();
+	virtual void operate();
+
+	virtual void onExecutionManagerChanged() {
+		SingleIO<input_type, output_type>::onExecutionManagerChanged();  // First, call super
+		getSamplePeriodFromEM();
+	}
+	void getSamplePeriodFromEM();
+
+	chain_type chain;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(FusedChain);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/systems/detail/fused_chain-inl.h>
+
+
+#endif /* BARRETT_SYSTEMS_FUSED_CHAIN_H_ */
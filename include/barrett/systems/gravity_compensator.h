@@ -37,7 +37,8 @@
 
 #include <barrett/detail/ca_macro.h>
 #include <barrett/units.h>
-#include <barrett/cdlbt/calgrav.h>
+#include <barrett/thread/abstract/mutex.h>
+#include <barrett/math/gravity.h>
 
 #include <barrett/systems/abstract/system.h>
 #include <barrett/systems/abstract/single_io.h>
@@ -58,28 +59,26 @@ class GravityCompensator : public System,
 public:
 	explicit GravityCompensator(const libconfig::Setting& setting,
 			const std::string& sysName = "GravityCompensator") :
-		System(sysName), KinematicsInput<DOF>(this), SingleOutput<jt_type>(this), impl(NULL), data()
+		System(sysName), KinematicsInput<DOF>(this), SingleOutput<jt_type>(this), grav(setting), data()
 	{
-		bt_calgrav_create(&impl, setting.getCSetting(), DOF);
 	}
 
 	bool setGravity(double new_grav) {
-		return(!bt_calgrav_update(impl, new_grav));
+		BARRETT_SCOPED_LOCK(getEmMutex());
+		grav.setGravity(new_grav);
+		return true;
 	}
 	virtual ~GravityCompensator() {
 		mandatoryCleanUp();
-
-		bt_calgrav_destroy(impl);
-		impl = NULL;
 	}
 
 protected:
 	virtual void operate() {
-		bt_calgrav_eval(impl, this->kinInput.getValue().impl, data.asGslType());
+		grav.eval(this->kinInput.getValue(), &data);
 		this->outputValue->setData(&data);
 	}
 
-	struct bt_calgrav* impl;
+	math::Gravity<DOF> grav;
 	jt_type data;
 
 private:
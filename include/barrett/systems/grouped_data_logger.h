@@ -0,0 +1,151 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file grouped_data_logger.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_GROUPED_DATA_LOGGER_H_
+#define BARRETT_SYSTEMS_GROUPED_DATA_LOGGER_H_
+
+
+#include <stdexcept>
+#include <string>
+
+#include <boost/thread.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/real_time_writer.h>
+#include <barrett/thread/abstract/mutex.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/detail/grouped_data_logger-helper.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** Logs the elements of a boost::tuple as separate signals, like a
+ * TupleGrouper feeding a PeriodicDataLogger, but without building a tuple.
+ *
+ * Each input is serialized by its own log::Traits straight from the
+ * connected Output's value into the log writer's buffer, at an offset
+ * computed once at construction. The records are byte-for-byte the ones a
+ * PeriodicDataLogger<tuple_type> would write, so the log is read the same
+ * way (e.g. with log::Reader<tuple_type> or, for column logs,
+ * log::ColumnReader).
+ *
+ * A record is logged once every periodMultiplier execution cycles (see
+ * System::setRateDivisor()), when all inputs have values.
+ */
+template<typename TupleType, typename LogWriterType = log::RealTimeWriter<TupleType> >
+class GroupedDataLogger : public System {
+public:
+	typedef TupleType tuple_type;
+	typedef LogWriterType log_writer_type;
+	static const size_t NUM_INPUTS = boost::tuples::length<tuple_type>::value;
+
+
+// IO
+private:	detail::FieldInputHolder<NUM_INPUTS, tuple_type> inputs;
+
+
+public:
+	// The GroupedDataLogger owns the logWriter pointer and will delete it when it is no longer needed.
+	GroupedDataLogger(ExecutionManager* em, log_writer_type* logWriter, size_t periodMultiplier = 10,
+			const std::string& sysName = "GroupedDataLogger") :
+		System(sysName), inputs(this), lw(logWriter), logging(true)
+	{
+		if (inputs.endOffset() != log::Traits<tuple_type>::serializedLength()) {
+			throw(std::logic_error("(systems::GroupedDataLogger::GroupedDataLogger()): "
+					"The inputs' lengths don't add up to the record length."));
+		}
+
+		setRateDivisor(periodMultiplier);
+		if (em != NULL) {
+			em->startManaging(*this);
+		}
+	}
+	virtual ~GroupedDataLogger() {
+		mandatoryCleanUp();
+
+		if (isLogging()) {
+			closeLog();
+		}
+	}
+
+	template<size_t N>
+	Input<typename boost::tuples::element<N, tuple_type>::type>& getInput() {
+		return inputs.template getInput<N>();
+	}
+
+	bool isLogging() {  return logging;  }
+	void closeLog();
+
+protected:
+	virtual bool inputsValid() {
+		return logging  &&  inputs.valuesDefined();
+	}
+	virtual void operate() {
+		inputs.serialize(lw->beginRecord());
+		lw->endRecord();
+	}
+
+	// Optimization: this System has no Outputs to invalidate.
+	virtual void invalidateOutputs() {}
+
+	log_writer_type* lw;
+	bool logging;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(GroupedDataLogger);
+};
+
+
+template<typename TupleType, typename LogWriterType>
+void GroupedDataLogger<TupleType, LogWriterType>::closeLog()
+{
+	if (isLogging()) {
+		// See PeriodicDataLogger::closeLog().
+		boost::this_thread::disable_interruption di;
+
+		thread::Mutex& emMutex = getEmMutex();
+		emMutex.lock();
+		logging = false;
+		emMutex.unlock();
+
+		lw->close();
+		delete lw;
+		lw = NULL;
+	}
+}
+
+
+}
+}
+
+
+#endif /* BARRETT_SYSTEMS_GROUPED_DATA_LOGGER_H_ */
@@ -68,29 +68,36 @@ public:
 	const cp_type& getCenter() const { return c; }
 	double getRadius() const { return r; }
 
-protected:
-	virtual void operate() {
-		error = input.getValue() - c;
-		double mag = error.norm();
+	/// The force computation behind operate(), also used by HapticScene::Ball.
+	/// *keepOutside is the ball's state from one cycle to the next.
+	static void evaluate(const cp_type& cp, const cp_type& center, double radius,
+			bool* keepOutside, double* depth, cf_type* direction) {
+		*direction = cp - center;
+		double mag = direction->norm();
 
-		bool outside = mag > r;
+		bool outside = mag > radius;
 
 		// if we are inside the ball and we shouldn't be, or we are outside the ball and we shouldn't be
-		if ((keepOutside && !outside)  ||  (!keepOutside && outside)) {
-			depth = r - mag;
-			if (math::abs(depth) > 0.02) {
-				keepOutside = !keepOutside;
+		if ((*keepOutside && !outside)  ||  (!*keepOutside && outside)) {
+			*depth = radius - mag;
+			if (math::abs(*depth) > ACTIVATION_DISTANCE) {
+				*keepOutside = !*keepOutside;
 
-				depth = 0.0;
-				error.setZero();
+				*depth = 0.0;
+				direction->setZero();
 			} else {
 				// unit vector pointing towards the surface of the ball
-				error /= mag;
+				*direction /= mag;
 			}
 		} else {
-			depth = 0.0;
-			error.setZero();
+			*depth = 0.0;
+			direction->setZero();
 		}
+	}
+
+protected:
+	virtual void operate() {
+		evaluate(input.getValue(), c, r, &keepOutside, &depth, &error);
 
 		depthOutputValue->setData(&depth);
 		directionOutputValue->setData(&error);
@@ -72,53 +72,61 @@ public:
 	const cp_type& getCenter() const { return c; }
 	math::Vector<3>::type getSize() const { return halfSize * 2.0; }
 
-protected:
-	virtual void operate() {
-		pos = input.getValue() - c;
+	/// The force computation behind operate(), also used by HapticScene::Box.
+	/// *inBox, *index and *keepOutside are the box's state from one cycle to
+	/// the next.
+	static void evaluate(const cp_type& cp, const cp_type& center, const math::Vector<3>::type& halfSize,
+			bool* inBox, int* index, bool* keepOutside, double* depth, cf_type* direction) {
+		cf_type pos = cp - center;
 
 		bool outside = (pos.array().abs() > halfSize.array()).any();
 
 		// if we are inside the box and we shouldn't be
-		if (keepOutside  &&  !outside) {
-			if ( !inBox ) {  // if we weren't in the box last time
+		if (*keepOutside  &&  !outside) {
+			if ( !*inBox ) {  // if we weren't in the box last time
 				// find out what side we entered on
-				(halfSize - pos.cwiseAbs()).minCoeff(&index);
+				(halfSize - pos.cwiseAbs()).minCoeff(index);
 			}
 
-			depth = halfSize[index] - math::abs(pos[index]);
-			if (depth > 0.02) {
-				keepOutside = !keepOutside;
+			*depth = halfSize[*index] - math::abs(pos[*index]);
+			if (*depth > ACTIVATION_DISTANCE) {
+				*keepOutside = !*keepOutside;
 
-				depth = 0.0;
-				dir.setZero();
+				*depth = 0.0;
+				direction->setZero();
 			} else {
-				dir = math::sign(pos[index]) * cf_type::Unit(index);
+				*direction = math::sign(pos[*index]) * cf_type::Unit(*index);
 
-				inBox = true;
+				*inBox = true;
 			}
 		} else {
-			inBox = false;
+			*inBox = false;
 
 			// if we are outside the box and we shouldn't be
-			if (!keepOutside  &&  outside) {
-				dir = halfSize - pos.cwiseAbs();
-				dir = (dir.array() * (dir.array() < 0.0).cast<double>()).matrix();
-				dir = (dir.array() * math::sign(pos).array()).matrix();
+			if (!*keepOutside  &&  outside) {
+				*direction = halfSize - pos.cwiseAbs();
+				*direction = (direction->array() * (direction->array() < 0.0).cast<double>()).matrix();
+				*direction = (direction->array() * math::sign(pos).array()).matrix();
 
-				depth = dir.norm();
-				if (depth > 0.02) {
-					keepOutside = !keepOutside;
+				*depth = direction->norm();
+				if (*depth > ACTIVATION_DISTANCE) {
+					*keepOutside = !*keepOutside;
 
-					depth = 0.0;
-					dir.setZero();
+					*depth = 0.0;
+					direction->setZero();
 				} else {
-					dir /= depth;
+					*direction /= *depth;
 				}
 			} else {
-				depth = 0.0;
-				dir.setZero();
+				*depth = 0.0;
+				direction->setZero();
 			}
 		}
+	}
+
+protected:
+	virtual void operate() {
+		evaluate(input.getValue(), c, halfSize, &inBox, &index, &keepOutside, &depth, &dir);
 
 		depthOutputValue->setData(&depth);
 		directionOutputValue->setData(&dir);
@@ -127,8 +135,7 @@ protected:
 	cp_type c;
 	math::Vector<3>::type halfSize;
 
-	// state & temporaries
-	cf_type pos;
+	// state
 	bool inBox;
 	int index;
 	bool keepOutside;
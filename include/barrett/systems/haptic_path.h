@@ -32,8 +32,6 @@
 #define BARRETT_SYSTEMS_HAPTIC_PATH_H_
 
 
-#include <cmath>
-#include <cassert>
 #include <vector>
 
 #define EIGEN_USE_NEW_STDVECTOR
@@ -43,6 +41,7 @@
 #include <barrett/detail/ca_macro.h>
 #include <barrett/units.h>
 #include <barrett/math.h>
+#include <barrett/math/aabb_tree.h>
 #include <barrett/systems/abstract/haptic_object.h>
 
 
@@ -50,82 +49,65 @@ namespace barrett {
 namespace systems {
 
 
+/** A haptic object that attracts the tool toward a path.
+ *
+ * The path is a spline through the given points. Each cycle the tool position
+ * is projected onto it by a few Newton steps that start from the previous
+ * cycle's projection, and then by a branch-and-bound search over an AabbTree
+ * of the spline's segments for anything closer. The local distance bounds the
+ * search, so it only looks at the segments near the tool, yet it still
+ * switches to another branch of the path as soon as that one becomes closer.
+ * If there is no previous projection, or if the tool jumped, the search is
+ * unbounded. Neither step depends on the length of the path.
+ */
 class HapticPath : public HapticObject {
 	BARRETT_UNITS_FIXED_SIZE_TYPEDEFS;
 
 	static constexpr double COARSE_STEP = 0.01;
-	static constexpr double FINE_STEP = 0.0001;
+
+	// Projection tuning
+	static const int MAX_NEWTON_ITERATIONS = 8;
+	static constexpr double NEWTON_TOLERANCE = 1e-9;  // in s (meters)
+	static const int SEGMENT_SAMPLES = 4;  // seeds per segment for a global search
 
 public:		System::Output<cp_type> tangentDirectionOutput;
 protected:	System::Output<cp_type>::Value* tangentDirectionOutputValue;
 
 public:
 	HapticPath(const std::vector<cp_type, Eigen::aligned_allocator<cp_type> >& path,
-			const std::string& sysName = "HapticPath") :
-		HapticObject(sysName),
-		tangentDirectionOutput(this, &tangentDirectionOutputValue),
-		nearestIndex(0), spline(NULL)
-	{
-		// Sample the path
-		cp_type prev = path[0];
-		for (size_t i = 0; i < path.size(); ++i) {
-			if ((path[i] - prev).norm() > COARSE_STEP) {
-				coarsePath.push_back(path[i]);
-				prev = path[i];
-			}
-		}
-		spline = new math::Spline<cp_type>(coarsePath);
-	}
-
-	virtual ~HapticPath() {
-		mandatoryCleanUp();
-		delete spline;
-	}
+			const std::string& sysName = "HapticPath");
+	virtual ~HapticPath();
+
+	/// The spline parameter (arc length) of the most recent projection.
+	double getNearestS() const {  return sNearest;  }
+	/// The number of cycles whose projection came from the tree search: the first cycle, jumps, and switches to a
+	/// closer branch of the path.
+	size_t getNumGlobalSearches() const {  return numGlobalSearches;  }
+
+	const math::Spline<cp_type>& getSpline() const {  return *spline;  }
 
 protected:
-	virtual void operate() {
-		const cp_type& cp = input.getValue();
-
-		// Coarse search
-		minDist = (coarsePath[nearestIndex] - cp).norm();
-		for (size_t i = 0; i < coarsePath.size(); ++i) {
-			double dist = (coarsePath[i] - cp).norm();
-			if (dist < minDist) {
-				minDist = dist;
-				nearestIndex = i;
-			}
-		}
-
-		// Fine search
-		// TODO(dc): Can we do this without relying on Spline's implementation?
-		double sNearest = spline->getImplementation()->ss[nearestIndex];
-		double sLow = sNearest - COARSE_STEP;
-		double sHigh = sNearest + COARSE_STEP;
-		for (double s = sLow; s <= sHigh; s += FINE_STEP) {
-			double dist = (spline->eval(s) - cp).norm();
-			if (dist < minDist) {
-				minDist = dist;
-				sNearest = s;
-			}
-		}
-
-		dir = (spline->eval(sNearest) - cp).normalized();
-		tangentDir = spline->evalDerivative(sNearest).normalized();
-
-		depthOutputValue->setData(&minDist);
-		directionOutputValue->setData(&dir);
-		tangentDirectionOutputValue->setData(&tangentDir);
-	}
+	virtual void operate();
+
+	bool project(const cp_type& cp, double sLow, double sHigh, double* s, double* dist) const;
+	double projectOntoSegment(size_t segment, const cp_type& cp, double* s) const;
 
 	double minDist;
-	size_t nearestIndex;
+	double sNearest;
+	bool tracking;
+	cp_type prevCp;
+	size_t numGlobalSearches;
+
 	cf_type dir;
 	cp_type tangentDir;
 
 	std::vector<cp_type, Eigen::aligned_allocator<cp_type> > coarsePath;
 	math::Spline<cp_type>* spline;
+	math::AabbTree segmentTree;
 
 private:
+	struct SegmentDistance;
+
 	DISALLOW_COPY_AND_ASSIGN(HapticPath);
 
 public:
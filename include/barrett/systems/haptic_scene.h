@@ -0,0 +1,204 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file haptic_scene.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_HAPTIC_SCENE_H_
+#define BARRETT_SYSTEMS_HAPTIC_SCENE_H_
+
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/units.h>
+#include <barrett/math.h>
+#include <barrett/math/aabb_tree.h>
+#include <barrett/systems/abstract/haptic_object.h>
+#include <barrett/systems/haptic_ball.h>
+#include <barrett/systems/haptic_box.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** A haptic object made of many shapes.
+ *
+ * Shapes are kept in an AabbTree of their bounds, so each cycle only the
+ * shapes near the tool are evaluated. The outputs combine the active shapes:
+ * the penetration vectors (depth * direction) are summed, and the scene
+ * reports the magnitude and direction of the sum. With a single active shape,
+ * the outputs are the same as that shape's.
+ *
+ * Shapes may be added and removed while the scene is running. The tree is
+ * rebuilt on the calling thread and swapped in under the ExecutionManager's
+ * mutex, so the realtime thread is only blocked for the swap.
+ *
+ * There is no HapticPath shape. A HapticPath pulls the tool toward its path
+ * from any distance, so it has no bounds to cull it by and would be evaluated
+ * every cycle anyway; sum its outputs with the scene's instead.
+ */
+class HapticScene : public HapticObject {
+	BARRETT_UNITS_FIXED_SIZE_TYPEDEFS;
+
+public:
+	/// A haptic primitive that can be placed in a HapticScene.
+	class Shape {
+	public:
+		virtual ~Shape() {}
+
+		/// A box outside of which the shape produces no force.
+		virtual math::AabbTree::box_type getBounds() const = 0;
+
+		/// Computes the penetration depth and the unit direction toward the
+		/// surface. Called from the realtime thread.
+		virtual void evaluate(const cp_type& cp, double* depth, cf_type* direction) = 0;
+
+		/// Called when the tool leaves the shape's bounds, instead of
+		/// evaluate(). Stateful shapes can reset themselves here.
+		virtual void culled() {}
+
+		Shape() : active(false) {}
+
+	private:
+		bool active;  // evaluated this cycle
+
+		friend class HapticScene;
+	};
+
+	class Ball;
+	class Box;
+
+
+	explicit HapticScene(const std::string& sysName = "HapticScene");
+	virtual ~HapticScene();
+
+	// add(), remove() and clear() must not be called concurrently with each
+	// other.
+
+	/// Takes ownership of shape.
+	void add(Shape* shape);
+	/// Removes and deletes shape. Returns false if it isn't in the scene.
+	bool remove(Shape* shape);
+	/// Removes and deletes every shape.
+	void clear();
+
+	size_t size() const {  return index.shapes.size();  }
+	/// The number of shapes evaluated during the last cycle.
+	size_t getNumActive() const {  return numActive;  }
+
+protected:
+	virtual void operate();
+
+	struct Index {
+		std::vector<Shape*> shapes;
+		math::AabbTree tree;
+		std::vector<Shape*> active, prevActive;
+
+		void build(const std::vector<Shape*>& newShapes);
+		void swap(Index& other);
+	};
+
+	void replaceIndex(const std::vector<Shape*>& shapes);
+
+	Index index;
+	size_t numActive;
+
+	cf_type penetration;
+	double depth;
+	cf_type dir;
+
+private:
+	struct Evaluator;
+
+	DISALLOW_COPY_AND_ASSIGN(HapticScene);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/// A sphere. It pushes exactly like a HapticBall.
+class HapticScene::Ball : public HapticScene::Shape {
+	BARRETT_UNITS_FIXED_SIZE_TYPEDEFS;
+
+public:
+	Ball(const cp_type& center, double radius) :
+		c(center), r(radius), keepOutside(true) {}
+
+	virtual math::AabbTree::box_type getBounds() const;
+	virtual void evaluate(const cp_type& cp, double* depth, cf_type* direction);
+	virtual void culled() {  keepOutside = true;  }
+
+	const cp_type& getCenter() const { return c; }
+	double getRadius() const { return r; }
+
+protected:
+	const cp_type c;
+	const double r;
+	bool keepOutside;
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/// An axis-aligned box. It pushes exactly like a HapticBox.
+class HapticScene::Box : public HapticScene::Shape {
+	BARRETT_UNITS_FIXED_SIZE_TYPEDEFS;
+
+public:
+	Box(const cp_type& center, const math::Vector<3>::type& size) :
+		c(center), halfSize(size / 2.0), inBox(false), index(-1), keepOutside(true) {}
+
+	virtual math::AabbTree::box_type getBounds() const;
+	virtual void evaluate(const cp_type& cp, double* depth, cf_type* direction);
+	virtual void culled() {  inBox = false;  keepOutside = true;  }
+
+	const cp_type& getCenter() const { return c; }
+	math::Vector<3>::type getSize() const { return halfSize * 2.0; }
+
+protected:
+	const cp_type c;
+	const math::Vector<3>::type halfSize;
+
+	bool inBox;
+	int index;
+	bool keepOutside;
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+}
+
+
+#endif /* BARRETT_SYSTEMS_HAPTIC_SCENE_H_ */
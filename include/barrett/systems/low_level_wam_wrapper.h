@@ -34,6 +34,7 @@
 
 #include <vector>
 
+#include <boost/scoped_ptr.hpp>
 #include <Eigen/Core>
 #include <libconfig.h++>
 
@@ -41,6 +42,7 @@
 #include <barrett/units.h>
 #include <barrett/products/puck.h>
 #include <barrett/products/low_level_wam.h>
+#include <barrett/products/simulated_low_level_wam.h>
 #include <barrett/products/safety_module.h>
 
 #include <barrett/systems/abstract/execution_manager.h>
@@ -52,6 +54,9 @@ namespace barrett {
 namespace systems {
 
 
+template<size_t DOF> class Wam;
+
+
 template<size_t DOF>
 class LowLevelWamWrapper {
 	BARRETT_UNITS_TEMPLATE_TYPEDEFS(DOF);
@@ -67,14 +72,34 @@ public:
 			SafetyModule* safetyModule, const libconfig::Setting& setting,
 			std::vector<int> torqueGroupIds = std::vector<int>(),
 			const std::string& sysName = "LowLevelWamWrapper");
+	// Runs against a simulated arm instead of Pucks. simulatedWam must outlive this object.
+	LowLevelWamWrapper(ExecutionManager* em, SimulatedLowLevelWam<DOF>* simulatedWam,
+			const std::string& sysName = "LowLevelWamWrapper");
 	~LowLevelWamWrapper() {}
 
-	LowLevelWam<DOF>& getLowLevelWam() { return llw; }
-	const LowLevelWam<DOF>& getLowLevelWam() const { return llw; }
+	bool isSimulated() const { return sim != NULL; }
+	// Throws std::logic_error if isSimulated()
+	LowLevelWam<DOF>& getLowLevelWam();
+	const LowLevelWam<DOF>& getLowLevelWam() const;
+	// NULL unless isSimulated()
+	SimulatedLowLevelWam<DOF>* getSimulatedLowLevelWam() const { return sim; }
+
+	// These work with either kind of arm.
+	const jp_type& getHomePosition() const;
+	const jp_type& getJointPositions() const;
+	const jv_type& getJointVelocities() const;
 
 	thread::Mutex& getEmMutex() const { return sink.getEmMutex(); }
 
 protected:
+	// Exactly one of genericPucks and simulatedWam is used.
+	LowLevelWamWrapper(ExecutionManager* em, const std::vector<Puck*>& genericPucks,
+			SafetyModule* safetyModule, const libconfig::Setting& setting,
+			std::vector<int> torqueGroupIds, SimulatedLowLevelWam<DOF>* simulatedWam,
+			const std::string& sysName);
+
+	friend class Wam<DOF>;
+
 	class Sink : public System, public SingleInput<jt_type> {
 	public:
 		Sink(LowLevelWamWrapper* parent, ExecutionManager* em,
@@ -137,7 +162,9 @@ protected:
 	};
 
 
-	LowLevelWam<DOF> llw;
+	// Declared before sink and source so that it outlives them
+	boost::scoped_ptr<LowLevelWam<DOF> > llw;
+	SimulatedLowLevelWam<DOF>* sim;
 
 	Sink sink;
 	Source source;
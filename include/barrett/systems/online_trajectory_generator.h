@@ -0,0 +1,159 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file online_trajectory_generator.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_ONLINE_TRAJECTORY_GENERATOR_H_
+#define BARRETT_SYSTEMS_ONLINE_TRAJECTORY_GENERATOR_H_
+
+
+#include <string>
+
+#include <boost/array.hpp>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/thread/mutex.hpp>
+#include <Eigen/Core>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/math/jerk_limited_profile.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/abstract/single_io.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** Moves its output to a target along a jerk-limited (S-curve) trajectory
+ * that is planned inside the execution cycle.
+ *
+ * Each coordinate follows a math::JerkLimitedProfile. Whenever a new target
+ * arrives, all coordinates are re-planned from their current position,
+ * velocity and acceleration, so the target can change at any time without a
+ * discontinuity. If synchronization is on, the faster coordinates are slowed
+ * down so that all of them arrive together (except for ones that only need to
+ * come to a stop, which can't be slowed down).
+ *
+ * setTarget() and reset() hand their commands to the execution thread
+ * through a lock-free queue. They never touch the ExecutionManager's mutex
+ * and may be called from any non-realtime thread. Planning takes a bounded
+ * amount of time and doesn't allocate.
+ *
+ * T must be a fixed-size column vector, such as units::JointPositions<DOF>::type.
+ */
+template<typename T>
+class OnlineTrajectoryGenerator : public System, public SingleOutput<T> {
+public:
+	typedef typename T::unitless_type limit_type;
+
+	static const size_t DIMENSION = T::RowsAtCompileTime;
+	static const size_t DEFAULT_CAPACITY = 16;
+
+
+	OnlineTrajectoryGenerator(const limit_type& velocity, const limit_type& acceleration, const limit_type& jerk,
+			bool synchronize = true, size_t capacity = DEFAULT_CAPACITY,
+			const std::string& sysName = "OnlineTrajectoryGenerator");
+	virtual ~OnlineTrajectoryGenerator() { this->mandatoryCleanUp(); }
+
+	/// The limits used for targets set after this call. All must be positive.
+	void setLimits(const limit_type& velocity, const limit_type& acceleration, const limit_type& jerk);
+
+	/** Starts moving towards target from the current state.
+	 *
+	 * If there is no current state (see reset()), the output starts at rest at
+	 * target. Returns false if capacity commands are already waiting for the
+	 * next execution cycle.
+	 */
+	bool setTarget(const T& target);
+
+	/** Puts the output at rest at position, abandoning any move in progress.
+	 *
+	 * This is also what happens (with no position) when the generator is
+	 * disconnected from its ExecutionManager.
+	 */
+	bool reset(const T& position);
+
+	/// True once the output has arrived at the most recent target.
+	bool isDone() const {
+		return numPending.load(boost::memory_order_acquire) == 0  &&  !moving.load(boost::memory_order_acquire);
+	}
+
+protected:
+	struct Command {
+		Command() : isTarget(false), value(), velocity(), acceleration(), jerk() {}
+
+		bool isTarget;  // Otherwise it's a reset
+		T value;
+		limit_type velocity, acceleration, jerk;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	virtual void onExecutionManagerChanged();
+	void getSamplePeriodFromEM();
+
+	virtual void operate();
+
+	bool push(Command& c);
+	void startAt(const T& position);
+	void plan(const Command& c);
+
+	bool sync;
+	double T_s;
+
+	// Serializes setTarget() and reset() callers. Never taken by the execution thread.
+	boost::mutex producerMutex;
+	limit_type velocity, acceleration, jerk;  // Protected by producerMutex
+
+	boost::lockfree::spsc_queue<Command, boost::lockfree::allocator<Eigen::aligned_allocator<Command> > > commands;
+	boost::atomic<size_t> numPending;  // Commands that haven't been processed yet
+	boost::atomic<bool> moving;
+
+	// Only accessed from operate() or while holding the ExecutionManager's mutex
+	boost::array<math::JerkLimitedProfile, DIMENSION> profiles;
+	bool stateDefined;
+	double t, finalT;
+	T y;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(OnlineTrajectoryGenerator);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/systems/detail/online_trajectory_generator-inl.h>
+
+
+#endif /* BARRETT_SYSTEMS_ONLINE_TRAJECTORY_GENERATOR_H_ */
@@ -49,6 +49,7 @@ template<typename T, typename LogWriterType = log::RealTimeWriter<T> >
 class PeriodicDataLogger : public System, public SingleInput<T> {
 public:
 	// The PeriodicDataLogger owns the logWriter pointer and will delete it when it is no longer needed.
+	// A record is logged once every periodMultiplier execution cycles (see System::setRateDivisor()).
 	PeriodicDataLogger(ExecutionManager* em, LogWriterType* logWriter, size_t periodMultiplier = 10,
 			const std::string& sysName = "PeriodicDataLogger");
 	virtual ~PeriodicDataLogger();
@@ -65,7 +66,6 @@ protected:
 
 	LogWriterType* lw;
 	bool logging;
-	size_t ecCount, ecCountRollover;
 
 private:
 	DISALLOW_COPY_AND_ASSIGN(PeriodicDataLogger);
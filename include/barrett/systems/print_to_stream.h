@@ -32,9 +32,15 @@
 #define BARRETT_SYSTEMS_PRINT_TO_STREAM_H_
 
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/thread.hpp>
+#include <Eigen/Core>
+
 #include <barrett/detail/ca_macro.h>
 #include <barrett/systems/abstract/system.h>
 #include <barrett/systems/abstract/single_io.h>
@@ -44,28 +50,68 @@ namespace barrett {
 namespace systems {
 
 
+/** Prints its input to a stream, one line per sample, without slowing down
+ * the execution cycle.
+ *
+ * operate() only copies the input into a preallocated queue. A background
+ * thread formats the queued values and writes them to the stream, so a slow
+ * terminal or a full pipe can never stall the realtime thread: if the
+ * queue fills up, samples are dropped and counted instead. Queued samples
+ * are printed before the destructor returns.
+ *
+ * To print less often, use setRateDivisor() to print every Nth sample, or
+ * setMaxRate() to cap the number of lines per second.
+ */
 template<typename T>
 class PrintToStream : public System, public SingleInput<T> {
 public:
+	struct Statistics {
+		unsigned long numPrinted;
+		unsigned long numDropped;  ///< Samples lost because the queue was full
+		unsigned long numRateLimited;  ///< Samples skipped because of setMaxRate()
+	};
+
+	static const size_t DEFAULT_CAPACITY = 1024;
+
 	explicit PrintToStream(ExecutionManager* em, const std::string& prependedLabel = "",
-			std::ostream& ostream = std::cout, const std::string& sysName = "PrintToStream") :
-		System(sysName), SingleInput<T>(this), label(prependedLabel), os(ostream)
-	{
-		if (em != NULL) {
-			em->startManaging(*this);
-		}
-	}
-	virtual ~PrintToStream() {
-		mandatoryCleanUp();
-	}
+			std::ostream& ostream = std::cout, const std::string& sysName = "PrintToStream",
+			size_t capacity = DEFAULT_CAPACITY);
+	virtual ~PrintToStream();
+
+	/** At most linesPerSecond samples are printed. Zero (the default) means
+	 * no limit. Rate limiting needs an ExecutionManager with a known period.
+	 */
+	void setMaxRate(double linesPerSecond);
+
+	Statistics getStatistics() const;
 
 protected:
+	virtual void onExecutionManagerChanged() {
+		System::onExecutionManagerChanged();  // First, call super
+		// Negative if the ExecutionManager's period is unknown
+		T_s = hasExecutionManager() ? std::max(getEffectivePeriod(), 0.0) : 0.0;
+	}
+
+	virtual void operate();
+
+	// Optimization: this System has no Outputs to invalidate.
+	virtual void invalidateOutputs() {}
+
+	void printEntryPoint();
+	void printQueued();
+
 	std::string label;
 	std::ostream& os;
 
-	virtual void operate() {
-		os << label << this->input.getValue() << std::endl;
-	}
+	double T_s;
+	double maxRate;
+	double credit;  // Lines that may be printed now, for rate limiting
+
+	boost::lockfree::spsc_queue<T, boost::lockfree::allocator<Eigen::aligned_allocator<T> > > queue;
+	boost::atomic<bool> stopping;
+	boost::thread thread;
+
+	boost::atomic<unsigned long> numPrinted, numDropped, numRateLimited;
 
 private:
 	DISALLOW_COPY_AND_ASSIGN(PrintToStream);
@@ -76,4 +122,8 @@ private:
 }
 
 
+// include template definitions
+#include <barrett/systems/detail/print_to_stream-inl.h>
+
+
 #endif /* BARRETT_SYSTEMS_PRINT_TO_STREAM_H_ */
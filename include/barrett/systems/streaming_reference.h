@@ -0,0 +1,168 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file streaming_reference.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_STREAMING_REFERENCE_H_
+#define BARRETT_SYSTEMS_STREAMING_REFERENCE_H_
+
+
+#include <string>
+
+#include <boost/array.hpp>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <Eigen/Core>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/math/traits.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/abstract/single_io.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** Turns a stream of timestamped setpoints from another thread into a smooth
+ * reference signal.
+ *
+ * A single producer thread (such as an external motion planner) calls push()
+ * at its own rate. push() is wait-free and never touches the
+ * ExecutionManager's mutex. Each execution cycle, the output is sampled from
+ * the stream at a playback time that runs delay seconds behind the first
+ * sample's timestamp, so there is normally a future sample to interpolate
+ * towards.
+ *
+ * If the stream runs dry, the output is extrapolated along the last segment
+ * for at most maxExtrapolation seconds and then held. If samples resume after
+ * the output has been held, playback is re-anchored to the new samples,
+ * starting from the held value.
+ *
+ * Timestamps are in seconds, on any clock, and must be strictly increasing.
+ */
+template<typename T, typename MathTraits = math::Traits<T> >
+class StreamingReference : public System, public SingleOutput<T> {
+public:
+	enum InterpolationMode {
+		HOLD,  ///< Step to each sample at its timestamp
+		LINEAR,  ///< Linear interpolation between samples
+		CUBIC  ///< Cubic Hermite interpolation with Catmull-Rom tangents
+	};
+
+	struct Statistics {
+		unsigned long numReceived;  ///< Samples accepted by push()
+		unsigned long numDropped;  ///< Samples rejected because the queue was full or the timestamp didn't increase
+		unsigned long numLate;  ///< Samples that arrived after their timestamp had already been played
+		unsigned long numUnderruns;  ///< Execution cycles with no future sample (output extrapolated or held)
+		unsigned long numResyncs;  ///< Times playback was re-anchored after the stream stalled
+	};
+
+	static const size_t DEFAULT_CAPACITY = 256;
+
+
+	explicit StreamingReference(ExecutionManager* em,
+			enum InterpolationMode mode = LINEAR,
+			double delay = 0.01, double maxExtrapolation = 0.02,
+			size_t capacity = DEFAULT_CAPACITY,
+			const std::string& sysName = "StreamingReference");
+	virtual ~StreamingReference() { this->mandatoryCleanUp(); }
+
+	/** Adds a setpoint to the stream. Must only be called from one thread.
+	 *
+	 * Returns false if the sample was dropped because the queue is full.
+	 */
+	bool push(double t, const T& setpoint);
+
+	Statistics getStatistics() const;
+
+	enum InterpolationMode getInterpolationMode() const { return mode; }
+	double getDelay() const { return delay; }
+	double getMaxExtrapolation() const { return maxExtrapolation; }
+
+protected:
+	struct Sample {
+		Sample() : t(0.0), value() {}
+		Sample(double t, const T& value) : t(t), value(value) {}
+
+		double t;
+		T value;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(MathTraits::RequiresAlignment)
+	};
+
+	static const size_t WINDOW_SIZE = 3;
+
+	virtual void onExecutionManagerChanged() {
+		System::onExecutionManagerChanged();  // First, call super
+		getSamplePeriodFromEM();
+	}
+	void getSamplePeriodFromEM();
+
+	virtual void operate();
+
+	void consumeSamples();
+	void anchor(double t);
+	void addToWindow(const Sample& sample);
+	void interpolate(size_t k);
+	void extrapolate();
+	T tangent(const Sample& prev, const Sample& next) const;
+
+	enum InterpolationMode mode;
+	double delay, maxExtrapolation;
+
+	double T_s;
+
+	boost::lockfree::spsc_queue<Sample, boost::lockfree::allocator<Eigen::aligned_allocator<Sample> > > queue;
+
+	// Only accessed from operate()
+	boost::array<Sample, WINDOW_SIZE> window;  // The most recent samples, oldest first
+	size_t windowCount;
+	double anchorTime;
+	unsigned long numCycles;
+	double playbackTime;
+	T y;
+
+	boost::atomic<unsigned long> numReceived, numDropped, numLate, numUnderruns, numResyncs;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(StreamingReference);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(MathTraits::RequiresAlignment)
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/systems/detail/streaming_reference-inl.h>
+
+
+#endif /* BARRETT_SYSTEMS_STREAMING_REFERENCE_H_ */
@@ -0,0 +1,106 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file telemetry_publisher.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_TELEMETRY_PUBLISHER_H_
+#define BARRETT_SYSTEMS_TELEMETRY_PUBLISHER_H_
+
+
+#include <string>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/traits.h>
+#include <barrett/log/telemetry.h>
+#include <barrett/log/detail/column_format.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/abstract/single_io.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** Publishes its input to other processes through a shared-memory
+ * log::TelemetryRing called shmName.
+ *
+ * Each execution cycle, the input is serialized with LogTraits (the same
+ * record layout a log of T would have) straight into the ring. This is
+ * wait-free and makes no system calls, so any number of dashboards,
+ * visualizers and monitors can follow the full-rate data (with
+ * log::TelemetryReader or python/barrett_telemetry.py) without adding
+ * jitter to the control loop. fieldNames names the fields of T, as for
+ * log::ColumnWriter.
+ *
+ * Use setRateDivisor() to publish less often; the ring's sample period
+ * follows.
+ */
+template<typename T, typename LogTraits = log::Traits<T> >
+class TelemetryPublisher : public System, public SingleInput<T> {
+public:
+	TelemetryPublisher(ExecutionManager* em, const std::string& shmName, const std::string& fieldNames = "",
+			size_t capacity = log::TelemetryRing::DEFAULT_CAPACITY,
+			const std::string& sysName = "TelemetryPublisher") :
+		System(sysName), SingleInput<T>(this),
+		ring(shmName, log::detail::describe<LogTraits>(fieldNames, 0.0), capacity)
+	{
+		if (em != NULL) {
+			em->startManaging(*this);
+		}
+	}
+	virtual ~TelemetryPublisher() {
+		mandatoryCleanUp();
+	}
+
+	const log::TelemetryRing& getRing() const {  return ring;  }
+
+protected:
+	virtual void onExecutionManagerChanged() {
+		System::onExecutionManagerChanged();  // First, call super
+		ring.setSamplePeriod(hasExecutionManager() ? getEffectivePeriod() : 0.0);
+	}
+
+	virtual void operate() {
+		LogTraits::serialize(this->input.getValue(), ring.beginWrite());
+		ring.endWrite();
+	}
+
+	// Optimization: this System has no Outputs to invalidate.
+	virtual void invalidateOutputs() {}
+
+	log::TelemetryRing ring;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(TelemetryPublisher);
+};
+
+
+}
+}
+
+
+#endif /* BARRETT_SYSTEMS_TELEMETRY_PUBLISHER_H_ */
@@ -66,7 +66,7 @@ protected:
 		// Multiply by the Jacobian-transpose at the tool
 		gsl_blas_dgemv(CblasTrans, 1.0,
 				this->kinInput.getValue().impl->tool_jacobian_linear,
-				this->input.getValue().asGslType(), 0.0, data.asGslType());
+				this->input.getValue().asGslType().get(), 0.0, data.asGslType().get());
 
 		this->outputValue->setData(&data);
 	}
@@ -102,7 +102,7 @@ protected:
 			ct = this->referenceInput.getValue().inverse() * (error.axis() * angle * kp);
 		}
 
-		gsl_blas_daxpy( -kd, this->kinInput.getValue().impl->tool_velocity_angular, ct.asGslType());
+		gsl_blas_daxpy( -kd, this->kinInput.getValue().impl->tool_velocity_angular, ct.asGslType().get());
 
 		this->controlOutputValue->setData(&ct);
 	}
@@ -0,0 +1,203 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file trajectory_executor.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_SYSTEMS_TRAJECTORY_EXECUTOR_H_
+#define BARRETT_SYSTEMS_TRAJECTORY_EXECUTOR_H_
+
+
+#include <vector>
+#include <string>
+
+#include <boost/atomic.hpp>
+#include <boost/circular_buffer.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/thread/mutex.hpp>
+
+#define EIGEN_USE_NEW_STDVECTOR
+#include <Eigen/StdVector>
+#include <Eigen/Core>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/math/spline.h>
+#include <barrett/math/trapezoidal_velocity_profile.h>
+#include <barrett/systems/abstract/system.h>
+#include <barrett/systems/abstract/single_io.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+/** A persistent source of reference trajectories.
+ *
+ * Segments are built by non-realtime threads and handed to the execution
+ * thread through a lock-free queue, so starting a new move never requires
+ * creating a thread or (once the executor is connected) touching the
+ * ExecutionManager's mutex. The switch to a new Segment happens at the start
+ * of an execution cycle. When there is nothing left to execute, the output
+ * holds the final value of the last Segment.
+ *
+ * Segments are always deleted outside of the execution cycle: finished
+ * Segments are passed back through a second queue and freed the next time a
+ * Segment is enqueued (or when the executor is destroyed).
+ */
+template<typename T>
+class TrajectoryExecutor : public System, public SingleOutput<T> {
+public:
+	/// A piece of trajectory, parameterized by time since its start.
+	class Segment {
+	public:
+		virtual ~Segment() {}
+
+		/// Duration of the Segment in seconds.
+		virtual double finalT() const = 0;
+		/// Called from the execution cycle with 0 <= t <= finalT().
+		virtual T eval(double t) const = 0;
+	};
+
+	enum Mode {
+		REPLACE,  ///< Abandon any running or queued Segments and start now.
+		QUEUE,  ///< Start when the previous Segment finishes.
+		BLEND  ///< Start blendDuration before the previous Segment finishes and cross-fade.
+	};
+
+	static const size_t DEFAULT_CAPACITY = 16;
+
+
+	explicit TrajectoryExecutor(size_t capacity = DEFAULT_CAPACITY,
+			const std::string& sysName = "TrajectoryExecutor");
+	virtual ~TrajectoryExecutor();
+
+	/** Takes ownership of segment and schedules it for execution.
+	 *
+	 * Returns false (and does not take ownership) if capacity Segments are
+	 * already outstanding. One extra slot is kept for REPLACE, so a REPLACE
+	 * only fails if another REPLACE is still waiting for the next execution
+	 * cycle. Safe to call from any non-realtime thread.
+	 */
+	bool enqueue(Segment* segment, enum Mode mode = REPLACE, double blendDuration = 0.0);
+
+	/** Copies the final value of the most recently enqueued Segment into *end.
+	 *
+	 * Returns false if there are no outstanding Segments.
+	 */
+	bool getEnd(T* end);
+
+	/// Number of Segments that have been enqueued but haven't finished.
+	size_t getNumOutstanding() const { return numOutstanding.load(boost::memory_order_acquire); }
+	bool isDone() const { return getNumOutstanding() == 0; }
+
+protected:
+	struct Command {
+		Command() : segment(NULL), mode(REPLACE), blendDuration(0.0) {}
+		Command(Segment* s, enum Mode m, double bd) : segment(s), mode(m), blendDuration(bd) {}
+
+		Segment* segment;
+		enum Mode mode;
+		double blendDuration;
+	};
+
+	virtual void onExecutionManagerChanged();
+	void getSamplePeriodFromEM();
+
+	virtual void operate();
+
+	void accept(const Command& c);
+	void retire(Segment* segment);
+	void retireAll();
+	void collectGarbage();
+
+	// The offset from the start of the current Segment to the start of next
+	double startOfNext(const Command& next) const;
+	double blendDurationOf(const Command& next) const;
+
+
+	double T_s;
+	size_t capacity;
+
+	// Serializes enqueue() callers. Never taken by the execution thread.
+	boost::mutex producerMutex;
+	boost::lockfree::spsc_queue<Command> commands;  // non-realtime -> execution thread
+	boost::lockfree::spsc_queue<Segment*> retired;  // execution thread -> non-realtime
+	boost::atomic<size_t> numOutstanding;
+	T end;  // Protected by producerMutex
+
+	// Only accessed from operate() or while holding the ExecutionManager's mutex
+	boost::circular_buffer<Command> pending;
+	Command current;
+	double t;
+	bool yDefined;
+	T y;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(TrajectoryExecutor);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/** A move between two points: a math::Spline timed by a
+ * math::TrapezoidalVelocityProfile.
+ *
+ * This is the Segment Wam::moveTo() uses.
+ */
+template<typename T>
+class ProfiledSplineSegment : public TrajectoryExecutor<T>::Segment {
+public:
+	ProfiledSplineSegment(const T& start, const T& end, double velocity, double acceleration);
+	virtual ~ProfiledSplineSegment() {}
+
+	virtual double finalT() const { return profile.finalT(); }
+	virtual T eval(double t) const { return spline.eval(profile.eval(t)); }
+
+protected:
+	typedef std::vector<T, Eigen::aligned_allocator<T> > point_vector_type;
+	static point_vector_type makePoints(const T& start, const T& end);
+
+	math::Spline<T> spline;
+	math::TrapezoidalVelocityProfile profile;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(ProfiledSplineSegment);
+
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+}
+}
+
+
+// include template definitions
+#include <barrett/systems/detail/trajectory_executor-inl.h>
+
+
+#endif /* BARRETT_SYSTEMS_TRAJECTORY_EXECUTOR_H_ */
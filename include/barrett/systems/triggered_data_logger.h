@@ -43,6 +43,8 @@ namespace systems {
 
 // TODO(dc): add a configuration file interface
 
+// Logs while triggerInput is true. To also keep what happened before the
+// trigger (without logging continuously), see FlightRecorder.
 template<typename T, typename LogWriterType = log::RealTimeWriter<T> >
 class TriggeredDataLogger : public PeriodicDataLogger<T, LogWriterType> {
 // IO
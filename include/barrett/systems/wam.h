@@ -37,6 +37,8 @@
 
 #include <vector>
 
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/thread.hpp>
 #include <Eigen/Core>
 #include <libconfig.h++>
@@ -44,9 +46,11 @@
 #include <barrett/detail/ca_macro.h>
 #include <barrett/units.h>
 #include <barrett/products/low_level_wam.h>
+#include <barrett/products/simulated_low_level_wam.h>
 #include <barrett/products/puck.h>
 #include <barrett/products/safety_module.h>
 #include <barrett/math/kinematics.h>
+#include <barrett/thread/seqlock.h>
 
 #include <barrett/systems/low_level_wam_wrapper.h>
 #include <barrett/systems/first_order_filter.h>
@@ -66,6 +70,8 @@
 #include <barrett/systems/tool_orientation_controller.h>
 #include <barrett/systems/tool_force_to_joint_torques.h>
 #include <barrett/systems/tool_torque_to_joint_torques.h>
+#include <barrett/systems/trajectory_executor.h>
+#include <barrett/systems/online_trajectory_generator.h>
 
 
 namespace barrett {
@@ -109,6 +115,97 @@ public:
 	Summer<jt_type, 3> jtSum;
 	enum {JT_INPUT = 0, GRAVITY_INPUT, SC_INPUT};
 
+	// reference trajectories for moveTo()
+	TrajectoryExecutor<jp_type> jpTrajectory;
+	TrajectoryExecutor<cp_type> tpTrajectory;
+	TrajectoryExecutor<Eigen::Quaterniond> toTrajectory;
+	TrajectoryExecutor<pose_type> tpoTrajectory;
+	// reference trajectory for moveToOnline()
+	OnlineTrajectoryGenerator<jp_type> jpOnlineTrajectory;
+
+
+	/** A consistent snapshot of the WAM's state, published by the execution
+	 *  thread at the end of every cycle. See getState().
+	 */
+	struct State {
+		jp_type jp;
+		jv_type jv;
+		jt_type jt;
+		cp_type toolPosition;
+		Eigen::Quaterniond toolOrientation;
+
+		/// Counts the execution cycles that have published a State. It stops advancing when the execution thread
+		/// stops (e.g. after an E-stop), so a reader can tell that the values above are stale.
+		boost::uint64_t cycle;
+		/// highResolutionSystemTime() when this State was published.
+		double time;
+
+		/// The most recent reading of the SafetyModule. Unlike the values above, it is not part of the published
+		/// snapshot: getState() fills it in, so it keeps tracking the pendant after the execution thread stops.
+		/// ACTIVE if there is no SafetyModule.
+		enum SafetyModule::SafetyMode safetyMode;
+		/// highResolutionSystemTime() when safetyMode was read, or 0.0 if it has never been read.
+		double safetyModeTime;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+protected:
+	class StatePublisher : public System {
+	// IO
+	public:		Input<jp_type> jpInput;
+	public:		Input<jv_type> jvInput;
+	public:		Input<jt_type> jtInput;
+	public:		Input<cp_type> toolPositionInput;
+	public:		Input<Eigen::Quaterniond> toolOrientationInput;
+
+
+	public:
+		// Reading the SafetyModule requires a round trip on the CAN bus
+		// (holding the bus mutex that the execution thread also needs), so it
+		// is never read in operate(). A non-realtime thread reads it at most
+		// once every this many seconds, and only while getState() is being
+		// called.
+		static const double SAFETY_MODE_PERIOD;
+
+		StatePublisher(ExecutionManager* em, SafetyModule* safetyModule,
+				const std::string& sysName = "Wam::StatePublisher");
+		virtual ~StatePublisher();
+
+		const thread::SeqLock<State>& getPublishedState() const { return published; }
+		/// Sets state->safetyMode and state->safetyModeTime, and asks for a fresh reading.
+		void getSafetyMode(State* state) const;
+
+	protected:
+		virtual void operate();
+
+		struct SafetyModeReading {
+			enum SafetyModule::SafetyMode mode;
+			double time;
+		};
+
+		bool readSafetyMode(bool logFailure);
+		void pollSafetyModeEntryPoint();
+
+		SafetyModule* sm;
+		thread::SeqLock<SafetyModeReading> safetyMode;
+		mutable boost::atomic<bool> safetyModeWanted;
+		boost::atomic<bool> stopping;
+		boost::thread smThread;
+		State state;
+		thread::SeqLock<State> published;
+
+	private:
+		DISALLOW_COPY_AND_ASSIGN(StatePublisher);
+
+	public:
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	StatePublisher statePublisher;
+
+public:
+
 
 /** Input/Output Interface definitions available to developers.
  *
@@ -128,6 +225,13 @@ public:
 			SafetyModule* safetyModule, const libconfig::Setting& setting,
 			std::vector<int> torqueGroupIds = std::vector<int>(),
 			const std::string& sysName = "Wam");
+   /** Constructor for a Wam that drives a simulated arm instead of Pucks
+    *
+    *	The control loop is exactly the same as on the hardware. simulatedWam must not be NULL, must outlive the Wam
+    *	and is usually built from the same setting. getLowLevelWam() throws.
+    */
+	Wam(ExecutionManager* em, SimulatedLowLevelWam<DOF>* simulatedWam,
+			const libconfig::Setting& setting, const std::string& sysName = "Wam");
 	/** Destructor for Wam
 	 */
 	~Wam();
@@ -135,6 +239,16 @@ public:
      */
 	template<typename T>
 	void trackReferenceSignal(System::Output<T>& referenceSignal);  //NOLINT: non-const reference for syntax
+	/** getState() copies the most recent State published by the execution
+	 *  thread into *state and returns true. Returns false (leaving *state
+	 *  untouched) if no State has been published yet. Compare State::cycle or
+	 *  State::time between calls to notice that the execution thread stopped.
+	 *
+	 *  This never blocks the execution thread and never takes the
+	 *  ExecutionManager's mutex, so it is safe to call at a high rate from
+	 *  non-realtime threads.
+	 */
+	bool getState(State* state) const;
 	/** getHomePosition() returns home postion of individual joints in Radians
      */
 	const jp_type& getHomePosition() const;
@@ -196,6 +310,24 @@ public:
 	void moveTo(const Eigen::Quaterniond& destination, bool blocking = true, double velocity = 0.5, double acceleration = 0.5);
 	void moveTo(const pose_type& destination, bool blocking = true, double velocity = 0.1, double acceleration = 0.2);
 	template<typename T> void moveTo(const T& currentPos, /*const typename T::unitless_type& currentVel,*/ const T& destination, bool blocking, double velocity, double acceleration);
+	/** queueMoveTo() method appends a move to the end of the current non-blocking moveTo() (or queueMoveTo()) instead of replacing it.
+	 *
+	 *  The new move starts from the destination of the previous one. If blendDuration is positive, the new move starts that many
+	 *  seconds before the previous one finishes and the two are blended, so the WAM doesn't come to a stop in between.
+	 *  If no move of the same type is in progress, this behaves like a non-blocking moveTo(). Never blocks.
+	 */
+	void queueMoveTo(const jp_type& destination, double blendDuration = 0.0, double velocity = 0.5, double acceleration = 0.5);
+	void queueMoveTo(const cp_type& destination, double blendDuration = 0.0, double velocity = 0.1, double acceleration = 0.2);
+	void queueMoveTo(const Eigen::Quaterniond& destination, double blendDuration = 0.0, double velocity = 0.5, double acceleration = 0.5);
+	void queueMoveTo(const pose_type& destination, double blendDuration = 0.0, double velocity = 0.1, double acceleration = 0.2);
+	template<typename T> void queueMoveTo(const T& currentPos, const T& destination, double blendDuration, double velocity, double acceleration);
+	/** moveToOnline() method sends the WAM to destination along a jerk-limited joint trajectory that is planned inside the control loop.
+	 *
+	 *  Calling it again before the move is done re-plans from the current position, velocity and acceleration, so the destination
+	 *  can be changed at any rate without a discontinuity. All joints arrive together. Never blocks and never creates a thread.
+	 *  velocity, acceleration and jerk are per-joint limits in radians per second (squared, cubed).
+	 */
+	void moveToOnline(const jp_type& destination, double velocity = 0.5, double acceleration = 0.5, double jerk = 5.0);
 	/** moveIsDone() method returns false while the trajectory controller for the most recent moveTo() command is still active. 
 	 *
 	 *  Only useful if the moveTo() is non-blocking. 
@@ -210,17 +342,24 @@ public:
 	/** getEmMutex() method allows access to ExecutionManagers Mutex in LowLevelWam Class.
 	 */
 	thread::Mutex& getEmMutex() const { return llww.getEmMutex(); }
-	/** getLowLevelWam() method allows access to methods in LowLevelWam Class.
+	/** getLowLevelWam() method allows access to methods in LowLevelWam Class. Throws std::logic_error for a simulated Wam.
 	 */
 	LowLevelWam<DOF>& getLowLevelWam() { return llww.getLowLevelWam(); }
 	const LowLevelWam<DOF>& getLowLevelWam() const { return llww.getLowLevelWam(); }
 
 protected:
+	Wam(ExecutionManager* em, const std::vector<Puck*>& genericPucks,
+			SafetyModule* safetyModule, SimulatedLowLevelWam<DOF>* simulatedWam,
+			const libconfig::Setting& setting, std::vector<int> torqueGroupIds,
+			const std::string& sysName);
+
 	template<typename T> T currentPosHelper(const T& currentPos);
-	template<typename T> void moveToThread(const T& currentPos, const T& destination, double velocity, double acceleration, bool* started, boost::shared_future<boost::thread*> threadPtrFuture);
+	template<typename T> void startMove(TrajectoryExecutor<T>& te, typename TrajectoryExecutor<T>::Segment* segment, enum TrajectoryExecutor<T>::Mode mode, double blendDuration);
 
-	bool doneMoving;
-	boost::thread_group mtThreadGroup;
+	TrajectoryExecutor<jp_type>& getTrajectoryExecutor(const jp_type& /*tag*/) { return jpTrajectory; }
+	TrajectoryExecutor<cp_type>& getTrajectoryExecutor(const cp_type& /*tag*/) { return tpTrajectory; }
+	TrajectoryExecutor<Eigen::Quaterniond>& getTrajectoryExecutor(const Eigen::Quaterniond& /*tag*/) { return toTrajectory; }
+	TrajectoryExecutor<pose_type>& getTrajectoryExecutor(const pose_type& /*tag*/) { return tpoTrajectory; }
 
 	// Used to calculate TP and TO if the values aren't already being calculated in the control loop.
 	mutable math::Kinematics<DOF> kin;
@@ -0,0 +1,110 @@
+/*
+	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/**
+ * @file seqlock.h
+ * @date 10/19/2026
+ */
+
+#ifndef BARRETT_THREAD_SEQLOCK_H_
+#define BARRETT_THREAD_SEQLOCK_H_
+
+
+#include <boost/atomic.hpp>
+
+#include <barrett/detail/ca_macro.h>
+
+
+namespace barrett {
+namespace thread {
+
+
+/** A sequence lock that lets one writer publish a value to any number of
+ * readers without either side taking a lock.
+ *
+ * The writer never waits, so it is safe to call write() from the realtime
+ * thread. A reader that overlaps a write simply copies the value again, so
+ * readers can never delay the writer (no priority inversion). T must be
+ * copy-assignable and must not own resources: a torn copy is discarded, but it
+ * is still made.
+ *
+ * Only one thread may call write(). Any number of threads may call read().
+ */
+template<typename T>
+class SeqLock {
+public:
+	SeqLock() : seq(0), data() {}
+	explicit SeqLock(const T& initialValue) : seq(0), data(initialValue) {}
+
+	/// Publishes a new value. Must only be called from a single writer thread.
+	void write(const T& value) {
+		const unsigned int s = seq.load(boost::memory_order_relaxed);
+
+		seq.store(s + 1, boost::memory_order_relaxed);  // odd: write in progress
+		boost::atomic_thread_fence(boost::memory_order_release);
+		data = value;
+		seq.store(s + 2, boost::memory_order_release);
+	}
+
+	/// Copies the most recently published value into *value.
+	void read(T* value) const {
+		unsigned int s0, s1;
+		do {
+			s0 = seq.load(boost::memory_order_acquire);
+			while (s0 & 1) {
+				s0 = seq.load(boost::memory_order_acquire);
+			}
+
+			*value = data;
+
+			boost::atomic_thread_fence(boost::memory_order_acquire);
+			s1 = seq.load(boost::memory_order_relaxed);
+		} while (s0 != s1);
+	}
+	T read() const {
+		T value;
+		read(&value);
+		return value;
+	}
+
+	/// The number of times write() has completed.
+	unsigned int getNumWrites() const {
+		return seq.load(boost::memory_order_acquire) / 2;
+	}
+	bool hasBeenWritten() const { return getNumWrites() != 0; }
+
+protected:
+	boost::atomic<unsigned int> seq;
+	T data;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(SeqLock);
+};
+
+
+}
+}
+
+
+#endif /* BARRETT_THREAD_SEQLOCK_H_ */
@@ -350,8 +350,8 @@ int wam_main(int argc, char** argv, ProductManager& pm, systems::Wam<DOF>& wam)
 		mvprintw(6, 0, "     Torque:");
 		for (j = 0; j < n; j++) {
 			mvprintw(4, 13 + 9 * j, " Joint %d ", j + 1);
-			mvprintw(5, 13 + 9 * j, "% 08.5f ", gsl_vector_get(wam.getJointPositions().asGslType(), j));
-			mvprintw(6, 13 + 9 * j, "% 08.4f ", gsl_vector_get(wam.llww.input.getValue().asGslType(), j));
+			mvprintw(5, 13 + 9 * j, "% 08.5f ", gsl_vector_get(wam.getJointPositions().asGslType().get(), j));
+			mvprintw(6, 13 + 9 * j, "% 08.4f ", gsl_vector_get(wam.llww.input.getValue().asGslType().get(), j));
 		}
 
 		/* Line 9 - Status Updates */
@@ -0,0 +1,165 @@
+/*
+	Copyright 2009, 2010, 2011, 2012 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/*
+ * log_align.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/align.h>
+
+
+using namespace barrett;
+
+
+void printUsage(const char* argv0)
+{
+	printf("Usage: %s [options] <output log> <input>...\n", argv0);
+	printf("Resamples logs onto one time base and writes them to a single column log.\n\n");
+	printf("Each input is [name=]file[:format[:field names]]. Its channels are called\n");
+	printf("<name>.<channel>; the name defaults to the file's name without its extension.\n");
+	printf("With a format (see bt-log-export --raw) the file is read as a raw log.\n");
+	printf("Segmented logs are given by their base name.\n\n");
+	printf("  -p <seconds>     Output sample period (default: a record at every input\n");
+	printf("                   timestamp)\n");
+	printf("  -m <method>      hold, linear (default) or cubic\n");
+	printf("  -t <channel>     Time channel of the inputs (default: time)\n");
+	printf("  -u               Span the union of the inputs, with NaNs where a log has\n");
+	printf("                   no data (default: the time they all cover)\n");
+	printf("  -j <threads>     Resample on this many threads (default: one per core)\n");
+	printf("  -b <records>     Output records per block (default: 4096)\n");
+}
+
+int main(int argc, char** argv)
+{
+	log::AlignOptions options;
+	std::string timeChannel = "time";
+	const char* outputFile = NULL;
+	std::vector<const char*> specs;
+
+	for (int i = 1; i < argc; ++i) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "-p") == 0  &&  hasValue) {
+			options.period = atof(argv[++i]);
+		} else if (strcmp(argv[i], "-m") == 0  &&  hasValue) {
+			++i;
+			if (strcmp(argv[i], "hold") == 0) {
+				options.method = log::AlignOptions::HOLD;
+			} else if (strcmp(argv[i], "linear") == 0) {
+				options.method = log::AlignOptions::LINEAR;
+			} else if (strcmp(argv[i], "cubic") == 0) {
+				options.method = log::AlignOptions::CUBIC;
+			} else {
+				printUsage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "-t") == 0  &&  hasValue) {
+			timeChannel = argv[++i];
+		} else if (strcmp(argv[i], "-u") == 0) {
+			options.unionOfSpans = true;
+		} else if (strcmp(argv[i], "-j") == 0  &&  hasValue) {
+			options.numThreads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-b") == 0  &&  hasValue) {
+			options.recordsPerBlock = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-h") == 0  ||  strcmp(argv[i], "--help") == 0) {
+			printUsage(argv[0]);
+			return 0;
+		} else if (argv[i][0] != '-') {
+			if (outputFile == NULL) {
+				outputFile = argv[i];
+			} else {
+				specs.push_back(argv[i]);
+			}
+		} else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if (outputFile == NULL  ||  specs.empty()  ||  options.period < 0.0  ||  options.recordsPerBlock == 0) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try {
+		std::vector<boost::shared_ptr<log::AlignInput> > inputs;
+		std::vector<log::AlignSource> sources;
+		for (size_t i = 0; i < specs.size(); ++i) {
+			std::string spec = specs[i];
+			std::string name;
+			std::string::size_type equals = spec.find('=');
+			if (equals != std::string::npos) {
+				name = spec.substr(0, equals);
+				spec.erase(0, equals + 1);
+			}
+
+			std::string file = spec, format, fieldNames;
+			std::string::size_type colon = spec.find(':');
+			if (colon != std::string::npos) {
+				file = spec.substr(0, colon);
+				format = spec.substr(colon + 1);
+				colon = format.find(':');
+				if (colon != std::string::npos) {
+					fieldNames = format.substr(colon + 1);
+					format.erase(colon);
+				}
+			}
+			if (equals == std::string::npos) {
+				name = file.substr(file.find_last_of('/') + 1);
+				std::string::size_type dot = name.rfind('.');
+				if (dot != std::string::npos  &&  dot != 0) {
+					name.erase(dot);
+				}
+			}
+
+			if ( !format.empty() ) {
+				inputs.push_back(boost::shared_ptr<log::AlignInput>(
+						new log::RawLogInput(file.c_str(), log::Schema::fromFormat(format, fieldNames))));
+			} else if (access((file + ".index").c_str(), F_OK) == 0) {
+				inputs.push_back(boost::shared_ptr<log::AlignInput>(new log::SegmentedLogInput(file.c_str())));
+			} else {
+				inputs.push_back(boost::shared_ptr<log::AlignInput>(new log::ColumnLogInput(file.c_str())));
+			}
+			sources.push_back(log::AlignSource(inputs.back().get(), name, timeChannel));
+		}
+
+		size_t n = log::align(sources, outputFile, options);
+		printf("Wrote %lu records to %s\n", (unsigned long) n, outputFile);
+	} catch (const std::exception& e) {
+		std::cerr << argv[0] << ": " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
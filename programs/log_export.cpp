@@ -0,0 +1,99 @@
+/*
+	Copyright 2009, 2010, 2011, 2012 Barrett Technology <support@barrett.com>
+
+	This file is part of libbarrett.
+
+	This version of libbarrett is free software: you can redistribute it
+	and/or modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation, either version 3 of the
+	License, or (at your option) any later version.
+
+	This version of libbarrett is distributed in the hope that it will be
+	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License along
+	with this version of libbarrett.  If not, see
+	<http://www.gnu.org/licenses/>.
+
+	Further, non-binding information about licensing is available at:
+	<http://wiki.barrett.com/libbarrett/wiki/LicenseNotes>
+*/
+
+/*
+ * log_export.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/csv_export.h>
+
+
+using namespace barrett;
+
+
+void printUsage(const char* argv0)
+{
+	printf("Usage: %s [options] <log file> <csv file>\n", argv0);
+	printf("Converts a log to CSV. Column logs are recognized automatically.\n\n");
+	printf("  -j <threads>     Format on this many threads (default: one per core)\n");
+	printf("  -p <digits>      Significant digits per value (default: 10)\n");
+	printf("  --no-header      Don't start with a line of column names\n");
+	printf("  --raw <format>   Read a raw log whose records are laid out as format, a\n");
+	printf("                   sequence of Python struct codes with optional counts\n");
+	printf("                   (e.g. \"d7d7d\" for time, jp and jt of a 7-DOF WAM)\n");
+}
+
+int main(int argc, char** argv)
+{
+	log::CSVOptions options;
+	const char* rawFormat = NULL;
+	const char* files[2] = { NULL, NULL };
+	int numFiles = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "-j") == 0  &&  hasValue) {
+			options.numThreads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-p") == 0  &&  hasValue) {
+			options.precision = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--no-header") == 0) {
+			options.header = false;
+		} else if (strcmp(argv[i], "--raw") == 0  &&  hasValue) {
+			rawFormat = argv[++i];
+		} else if (strcmp(argv[i], "-h") == 0  ||  strcmp(argv[i], "--help") == 0) {
+			printUsage(argv[0]);
+			return 0;
+		} else if (argv[i][0] != '-'  &&  numFiles < 2) {
+			files[numFiles++] = argv[i];
+		} else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if (numFiles != 2  ||  options.precision < 1  ||  options.precision > 17) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try {
+		if (rawFormat != NULL) {
+			log::exportRawCSV(files[0], log::Schema::fromFormat(rawFormat), files[1], options);
+		} else {
+			log::exportCSV(files[0], files[1], options);
+		}
+	} catch (const std::exception& e) {
+		std::cerr << argv[0] << ": " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,240 @@
+#!/usr/bin/python3
+#
+# Reads the shared-memory telemetry rings written by
+# barrett::log::TelemetryRing (and so by systems::TelemetryPublisher).
+#
+# Usage, as a module:
+#     import barrett_telemetry
+#     reader = barrett_telemetry.TelemetryReader("wam")
+#     while True:
+#         for record in reader.read_all():
+#             ...
+#
+# or, to print a ring's records:
+#     python3 barrett_telemetry.py <ring name>
+#
+# The layout of the segment is described in include/barrett/log/telemetry.h.
+# Only the standard library is needed. Linux only (rings live in /dev/shm).
+
+import mmap, os, struct, sys, time
+from collections import namedtuple
+
+
+MAGIC = b"BTTELEM\0"
+VERSION = 2
+HEADER = struct.Struct("=8s6Id")  # magic ... samplePeriod
+HEADER_LENGTH = 64
+WRITE_COUNT_OFFSET = 40
+OPEN_OFFSET = 48
+SEQ = struct.Struct("=Q")
+U64 = struct.Struct("=Q")
+U32 = struct.Struct("=I")
+
+Field = namedtuple("Field", "name type element_size rows cols units")
+
+
+def _shm_path(name):
+	return "/dev/shm/" + name.lstrip("/")
+
+
+def parse_schema(data, offset=0):
+	"""Reads a barrett::log::Schema. Returns (fields, sample period)."""
+	def get(fmt):
+		nonlocal offset
+		s = struct.Struct("=" + fmt)
+		values = s.unpack_from(data, offset)
+		offset += s.size
+		return values if len(values) > 1 else values[0]
+
+	def get_string():
+		nonlocal offset
+		n = get("H")
+		value = bytes(data[offset:offset + n]).decode("utf-8", "replace")
+		offset += n
+		return value
+
+	num_fields, sample_period = get("Id")
+	fields = []
+	for _ in range(num_fields):
+		name = get_string()
+		type_code = get("c").decode()
+		element_size, rows, cols = get("3I")
+		units = get_string()
+		fields.append(Field(name, type_code, element_size, rows, cols, units))
+	return fields, sample_period
+
+
+def record_format(fields):
+	"""A struct format for records with these fields. Opaque fields become bytes."""
+	fmt = "="
+	for f in fields:
+		n = f.rows * f.cols
+		if f.type == "x":
+			fmt += "%ds" % (f.element_size * n)
+		else:
+			fmt += "%d%s" % (n, f.type)
+	return fmt
+
+
+def channel_names(fields):
+	"""Names for the values of a record, e.g. "jt[3]"; see Schema::channelName()."""
+	names = []
+	for f in fields:
+		n = f.rows * f.cols
+		if n == 1 or f.type == "x":
+			names.append(f.name)
+		else:
+			names.extend("%s[%d]" % (f.name, i) for i in range(n))
+	return names
+
+
+class TelemetryReader(object):
+	"""Follows a telemetry ring, like barrett::log::TelemetryReader.
+
+	Records are returned as tuples with one value per channel (see
+	channel_names). A reader starts with the next record to be written.
+	"""
+
+	def __init__(self, name=None):
+		self._map = None
+		self.fields = []
+		self.channel_names = []
+		self.num_lost = 0
+		if name is not None and not self.attach(name):
+			raise RuntimeError("There is no telemetry ring called '%s'." % name)
+
+	def attach(self, name):
+		"""Returns False if there's no such ring (yet)."""
+		self.detach()
+		try:
+			with open(_shm_path(name), "rb") as f:
+				size = os.fstat(f.fileno()).st_size
+				if size < HEADER_LENGTH:
+					return False
+				m = mmap.mmap(f.fileno(), size, access=mmap.ACCESS_READ)
+		except FileNotFoundError:
+			return False
+
+		(magic, version, header_length, schema_length, record_length,
+				slot_length, capacity, _) = HEADER.unpack_from(m, 0)
+		if magic != MAGIC:
+			m.close()
+			return False  # Still being created
+		if version != VERSION:
+			m.close()
+			raise RuntimeError("'%s' uses an unsupported version of the telemetry format." % name)
+
+		self.fields, _ = parse_schema(m, HEADER_LENGTH)
+		self._record = struct.Struct(record_format(self.fields))
+		if self._record.size != record_length or size < header_length + capacity * slot_length:
+			m.close()
+			raise RuntimeError("'%s' is not a valid telemetry ring." % name)
+
+		self._map = m
+		self._slots = header_length
+		self._slot_length = slot_length
+		self.capacity = capacity
+		self.channel_names = channel_names(self.fields)
+		self.num_lost = 0
+		self._next = self._write_count()
+		return True
+
+	def detach(self):
+		if self._map is not None:
+			self._map.close()
+			self._map = None
+
+	@property
+	def attached(self):
+		return self._map is not None
+
+	@property
+	def publisher_open(self):
+		"""False once the writer is gone. Call attach() again to follow its replacement."""
+		return self.attached and U32.unpack_from(self._map, OPEN_OFFSET)[0] != 0
+
+	@property
+	def sample_period(self):
+		return HEADER.unpack_from(self._map, 0)[7] if self.attached else 0.0
+
+	def _write_count(self):
+		return U64.unpack_from(self._map, WRITE_COUNT_OFFSET)[0]
+
+	def _copy(self, n):
+		"""Record n, or None if it has been overwritten.
+
+		This relies on loads not being reordered with each other, which holds
+		on x86.
+		"""
+		offset = self._slots + (n & (self.capacity - 1)) * self._slot_length
+		expected = 2 * n + 2
+		if SEQ.unpack_from(self._map, offset)[0] != expected:
+			return None
+		record = self._record.unpack_from(self._map, offset + SEQ.size)
+		if SEQ.unpack_from(self._map, offset)[0] != expected:
+			return None
+		return record
+
+	def read(self):
+		"""The next record, or None if no new record has been written."""
+		if not self.attached:
+			return None
+		while True:
+			written = self._write_count()
+			if self._next >= written:
+				return None
+			if written - self._next > self.capacity:
+				self.num_lost += written - self._next - self.capacity
+				self._next = written - self.capacity
+
+			record = self._copy(self._next)
+			if record is not None:
+				self._next += 1
+				return record
+
+			# Lapped by the writer: skip to the middle of the ring.
+			resume = max(self._next + 1, self._write_count() - self.capacity // 2)
+			self.num_lost += resume - self._next
+			self._next = resume
+
+	def read_all(self):
+		"""All the records that are available, oldest first."""
+		records = []
+		record = self.read()
+		while record is not None:
+			records.append(record)
+			record = self.read()
+		return records
+
+	def read_latest(self):
+		"""The newest record, skipping older unread ones, or None if there's nothing new."""
+		if not self.attached:
+			return None
+		while True:
+			written = self._write_count()
+			if self._next >= written:
+				return None
+			record = self._copy(written - 1)
+			if record is not None:
+				self._next = written
+				return record
+
+
+def main(argv):
+	if len(argv) != 2:
+		print("Usage: %s <ring name>" % argv[0])
+		return 1
+
+	reader = TelemetryReader()
+	while True:
+		for record in reader.read_all():
+			print(",".join(str(v) for v in record))
+		if not reader.publisher_open:
+			while not reader.attach(argv[1]):
+				time.sleep(0.5)
+			print(",".join(reader.channel_names))
+		time.sleep(0.01)
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
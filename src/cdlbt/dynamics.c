@@ -417,6 +417,15 @@ int bt_dynamics_create(struct bt_dynamics ** dynptr,
       bt_dynamics_destroy(dyn);
       return -1;
    }
+   
+   /* Make the JSIM */
+   dyn->jsim = gsl_matrix_calloc(dyn->dof,dyn->dof);
+   if (!dyn->jsim)
+   {
+      syslog(LOG_ERR,"%s: Out of memory.",__func__);
+      bt_dynamics_destroy(dyn);
+      return -1;
+   }
 
    (*dynptr) = dyn;
    return 0;
@@ -437,6 +446,8 @@ int bt_dynamics_destroy( struct bt_dynamics * dyn )
       gsl_matrix_free(dyn->temp3x3_2);
    if (dyn->temp3xn_1)
       gsl_matrix_free(dyn->temp3xn_1);
+   if (dyn->jsim)
+      gsl_matrix_free(dyn->jsim);
    
    for (i=0; i<dyn->nlinks; i++)
    if (dyn->link_array[i])
@@ -571,29 +582,33 @@ static int eval_inverse_forward( struct bt_dynamics * dyn,
    
    /* STEP 3: Calculate a (linear acceleration of origin of frame) */
    
-   /* First, copy the previous link's acceleration
-    * a^(j-1) = a_(j-1) */
-   gsl_vector_memcpy( dyn->temp1_v3, link->prev->a );
+   /* The previous frame's origin lies on my joint's axis, so my origin
+    * moves with my own angular velocity and acceleration. */
    
-   /* Next, copy in the acc due to the previous angular acceleration
-    * a^(j-1) += alpha_(j-1) x r^(j-1)_j */
-   bt_gsl_cross( link->prev->alpha, kin_link->prev_origin_pos,
-                 dyn->temp1_v3 );
+   /* First, bring the previous link's acceleration into my frame
+    * a_j = (R^(j-1)_j)^T a_(j-1) */
+   gsl_blas_dgemv( CblasTrans, 1.0, kin_link->rot_to_prev,
+                   link->prev->a,
+                   0.0, link->a );
    
-   /* Next, copy in the weird velocity components
-    * t2 = omega_(j-1) x r^(j-1)_j */
+   /* Bring r^(j-1)_j into my frame too */
+   gsl_blas_dgemv( CblasTrans, 1.0, kin_link->rot_to_prev,
+                   kin_link->prev_origin_pos,
+                   0.0, dyn->temp1_v3 );
+   
+   /* Next, add in the acc due to my angular acceleration
+    * a_j += alpha_j x r */
+   bt_gsl_cross( link->alpha, dyn->temp1_v3,
+                 link->a );
+   
+   /* Last, add in the weird velocity components
+    * t2 = omega_j x r
+    * a_j += omega_j x t2 */
    gsl_vector_set_zero( dyn->temp2_v3 );
-   bt_gsl_cross( link->prev->omega, kin_link->prev_origin_pos,
+   bt_gsl_cross( link->omega, dyn->temp1_v3,
                  dyn->temp2_v3 ); 
-   /* a^(j-1) += omega_(j-1) x t2 */
-   bt_gsl_cross( link->prev->omega, dyn->temp2_v3,
-                 dyn->temp1_v3 );
-   
-   /* Last, bring it into my coordimate frame
-    * a^j = (R^(j-1)_j)^T a^(j-1) */
-   gsl_blas_dgemv( CblasTrans, 1.0, kin_link->rot_to_prev,
-                   dyn->temp1_v3,
-                   0.0, link->a );
+   bt_gsl_cross( link->omega, dyn->temp2_v3,
+                 link->a );
    
    return 0;
 }
@@ -673,8 +688,17 @@ static int eval_inverse_backward( struct bt_dynamics * dyn,
                     link->t );
    }
    
-   /* Get the component of the torque in the axis direction */
-   gsl_blas_ddot( kin_link->prev_axis_z, link->t,
+   /* Get the component of the torque in the axis direction.
+    * link->t is about my origin, but my joint's axis passes through the
+    * previous frame's origin, so first move it there:
+    * t2 = t + r x f, with r = r^(j-1)_j in my frame */
+   gsl_blas_dgemv( CblasTrans, 1.0, kin_link->rot_to_prev,
+                   kin_link->prev_origin_pos,
+                   0.0, dyn->temp1_v3 );
+   gsl_vector_memcpy( dyn->temp2_v3, link->t );
+   bt_gsl_cross( dyn->temp1_v3, link->f,
+                 dyn->temp2_v3 );
+   gsl_blas_ddot( kin_link->prev_axis_z, dyn->temp2_v3,
                   torque );
    
    return 0;
@@ -808,6 +832,8 @@ int bt_dynamics_eval_jsim(struct bt_dynamics * dyn, struct bt_kinematics * kin)
       gsl_blas_dgemv( CblasNoTrans, 1.0, kin_link->rot_to_world,
                       link->com,
                       0.0, dyn->temp1_v3 );
+      gsl_blas_daxpy( 1.0, kin_link->origin_pos,
+                      dyn->temp1_v3 );
       
       /* Evaluate the jacobian at the link's COM point */
       bt_kinematics_eval_jacobian( kin, j+1, dyn->temp1_v3,
@@ -0,0 +1,486 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file align.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/bind.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/align.h>
+#include <barrett/log/detail/column_format.h>
+#include <barrett/log/detail/task_pool.h>
+
+
+namespace barrett {
+namespace log {
+
+
+RawLogInput::RawLogInput(const char* fileName, const Schema& schema_) :
+	schema(schema_), data(NULL), size(0), recordCount(0)
+{
+	if (schema.recordLength() == 0) {
+		throw(std::logic_error("(log::RawLogInput::RawLogInput()): The schema is empty."));
+	}
+
+	int fd = open(fileName, O_RDONLY);
+	if (fd == -1) {
+		throw(std::runtime_error(std::string("(log::RawLogInput::RawLogInput()): Couldn't open the file '") + fileName + "'."));
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0  ||  st.st_size % schema.recordLength() != 0) {
+		::close(fd);
+		throw(std::runtime_error(std::string("(log::RawLogInput::RawLogInput()): The file '") + fileName +
+				"' is corrupted or does not contain this type of data. Its size is not evenly divisible by the record length."));
+	}
+
+	if (st.st_size != 0) {
+		void* p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED) {
+			::close(fd);
+			throw(std::runtime_error(std::string("(log::RawLogInput::RawLogInput()): Couldn't map the file '") + fileName + "'."));
+		}
+		data = static_cast<char*>(p);
+		size = st.st_size;
+		recordCount = size / schema.recordLength();
+	}
+	::close(fd);
+}
+
+RawLogInput::~RawLogInput()
+{
+	if (data != NULL) {
+		munmap(data, size);
+	}
+}
+
+void RawLogInput::readChannel(size_t channel, double* dest, size_t first, size_t count) const
+{
+	if (first > recordCount  ||  count > recordCount - first) {
+		throw(std::out_of_range("(log::RawLogInput::readChannel()): Those records aren't in the file."));
+	}
+
+	const Schema::Channel& ch = schema.channel(channel);
+	const char* src = data + first * schema.recordLength() + ch.offset;
+	for (size_t i = 0; i < count; ++i) {
+		dest[i] = Schema::toDouble(ch.type, src);
+		src += schema.recordLength();
+	}
+}
+
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+
+// Reads an input's timestamps on demand, a few thousand at a time.
+class TimeCursor {
+public:
+	static const size_t CACHE_LENGTH = 4096;
+
+	TimeCursor(const AlignInput& input_, size_t channel_) :
+		input(&input_), channel(channel_), n(input_.numRecords()), first(0), cache() {}
+
+	size_t size() const {  return n;  }
+
+	double operator[] (size_t i) {
+		if (i < first  ||  i >= first + cache.size()) {
+			first = i;
+			cache.resize(std::min(CACHE_LENGTH, n - i));
+			input->readChannel(channel, &cache[0], first, cache.size());
+		}
+		return cache[i - first];
+	}
+
+	/** The number of records before time t (or at it, if inclusive). The
+	 * answer must be at least hint. Gallops forward from hint, so a series of
+	 * increasing searches reads each part of the log about once.
+	 */
+	size_t search(double t, bool inclusive, size_t hint) {
+		size_t lo = hint, hi = hint, step = 1;
+		while (hi < n  &&  before(hi, t, inclusive)) {
+			lo = hi + 1;
+			hi = lo + step;
+			step *= 2;
+		}
+		hi = std::min(hi, n);
+
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			if (before(mid, t, inclusive)) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		return lo;
+	}
+
+protected:
+	bool before(size_t i, double t, bool inclusive) {
+		double ti = (*this)[i];
+		return inclusive ? ti <= t : ti < t;
+	}
+
+	const AlignInput* input;
+	size_t channel;
+	size_t n;
+	size_t first;
+	std::vector<double> cache;
+};
+const size_t TimeCursor::CACHE_LENGTH;
+
+
+struct SourceState {
+	SourceState(const AlignInput& input_, size_t timeChannel_) :
+		input(&input_), timeChannel(timeChannel_), channels(), hold(), outputChannels(),
+		times(input_, timeChannel_), mergeTimes(input_, timeChannel_), start(0.0), end(0.0),
+		hint(0), mergeNext(0), window(0), windowTimes(), windowValues(), sample() {}
+
+	const AlignInput* input;
+	size_t timeChannel;
+	std::vector<size_t> channels;  // Of the input, to be resampled
+	std::vector<bool> hold;  // Integer channels aren't interpolated
+	std::vector<size_t> outputChannels;
+
+	TimeCursor times, mergeTimes;
+	double start, end;
+	size_t hint;
+	size_t mergeNext;
+
+	// The records around the current block: window is the first one.
+	size_t window;
+	std::vector<double> windowTimes;
+	std::vector<std::vector<double> > windowValues;
+	// For each output record, the last sample (in the window) at or before it, or -1.
+	std::vector<long> sample;
+};
+
+
+class Aligner {
+public:
+	Aligner(const std::vector<AlignSource>& sources, const AlignOptions& options_) :
+		options(options_), blockLength(options_.recordsPerBlock), states(), schema(options_.period),
+		tStart(0.0), tEnd(0.0), numOutput(0), emitted(0), lastTime(0.0), merge(), rows(), times()
+	{
+		if (sources.empty()) {
+			throw(std::logic_error("(log::align()): There are no logs to align."));
+		}
+		if (blockLength == 0) {
+			throw(std::logic_error("(log::align()): recordsPerBlock cannot be zero."));
+		}
+		if (options.period < 0.0) {
+			throw(std::logic_error("(log::align()): The period cannot be negative."));
+		}
+
+		schema.addField("time", Schema::FLOAT64, sizeof(double));
+		std::set<std::string> names;
+		names.insert("time");
+		for (size_t i = 0; i < sources.size(); ++i) {
+			addSource(sources[i], &names);
+		}
+
+		tStart = states[0].start;
+		tEnd = states[0].end;
+		for (size_t i = 1; i < states.size(); ++i) {
+			if (options.unionOfSpans) {
+				tStart = std::min(tStart, states[i].start);
+				tEnd = std::max(tEnd, states[i].end);
+			} else {
+				tStart = std::max(tStart, states[i].start);
+				tEnd = std::min(tEnd, states[i].end);
+			}
+		}
+
+		if (tStart > tEnd) {
+			numOutput = 0;
+		} else if (options.period > 0.0) {
+			numOutput = static_cast<size_t>(std::floor((tEnd - tStart) / options.period + 1e-9)) + 1;
+		} else {
+			numOutput = std::numeric_limits<size_t>::max();  // Until the merge runs out
+			for (size_t i = 0; i < states.size(); ++i) {
+				SourceState& s = states[i];
+				s.mergeNext = s.mergeTimes.search(tStart, false, 0);
+				if (s.mergeNext < s.mergeTimes.size()) {
+					merge.push(std::make_pair(s.mergeTimes[s.mergeNext], i));
+				}
+			}
+		}
+
+		rows.resize(blockLength * schema.recordLength());
+		times.reserve(blockLength);
+	}
+
+	size_t write(const char* outputFile) {
+		std::ofstream file(outputFile, std::ios_base::binary);
+		if ( !file ) {
+			throw(std::runtime_error(std::string("(log::align()): Couldn't create the file '") + outputFile + "'."));
+		}
+
+		detail::BlockEncoder encoder(schema, options.columnOptions, blockLength);
+		std::vector<char> header;
+		encoder.writeHeader(&header);
+		file.write(&header[0], header.size());
+
+		detail::TaskPool pool(options.numThreads);
+
+		std::vector<std::pair<size_t, size_t> > tasks;  // (source, channel)
+		for (size_t i = 0; i < states.size(); ++i) {
+			for (size_t c = 0; c < states[i].channels.size(); ++c) {
+				tasks.push_back(std::make_pair(i, c));
+			}
+		}
+
+		while (nextTimes()) {
+			for (size_t i = 0; i < states.size(); ++i) {
+				loadWindow(&states[i]);
+			}
+
+			const Schema::Channel& timeChannel = schema.channel(0);
+			for (size_t k = 0; k < times.size(); ++k) {
+				std::memcpy(&rows[k * schema.recordLength() + timeChannel.offset], &times[k], sizeof(double));
+			}
+			pool.run(boost::bind(&Aligner::resample, this, boost::cref(tasks), _1), tasks.size());
+
+			file.write(encoder.data(), encoder.encode(&rows[0], times.size()));
+			emitted += times.size();
+		}
+
+		file.close();
+		if (file.fail()) {
+			throw(std::runtime_error(std::string("(log::align()): Couldn't write the file '") + outputFile + "'."));
+		}
+		return emitted;
+	}
+
+protected:
+	void addSource(const AlignSource& source, std::set<std::string>* names) {
+		const AlignInput& input = *source.input;
+		const Schema& in = input.getSchema();
+		size_t timeChannel;
+		try {
+			timeChannel = in.findChannel(source.timeChannel);
+		} catch (const std::out_of_range&) {
+			throw(std::logic_error("(log::align()): The log '" + source.name +
+					"' doesn't have a channel called '" + source.timeChannel + "'."));
+		}
+		if (in.channel(timeChannel).type == Schema::OPAQUE) {
+			throw(std::logic_error("(log::align()): The time channel of '" + source.name + "' is not a number."));
+		}
+		if (input.numRecords() == 0) {
+			throw(std::runtime_error("(log::align()): The log '" + source.name + "' is empty."));
+		}
+
+		states.push_back(SourceState(input, timeChannel));
+		SourceState& s = states.back();
+		s.start = s.times[0];
+		s.end = s.times[input.numRecords() - 1];
+
+		const std::string prefix = source.name.empty() ? "" : source.name + ".";
+		for (size_t f = 0; f < in.numFields(); ++f) {
+			const Schema::Field& field = in.field(f);
+			if (field.type == Schema::OPAQUE  ||
+					(field.numElements() == 1  &&  field.firstChannel == timeChannel)) {
+				continue;
+			}
+
+			const std::string name = prefix + field.name;
+			if ( !names->insert(name).second ) {
+				throw(std::logic_error("(log::align()): There is more than one field called '" + name + "'."));
+			}
+			schema.addField(name, Schema::FLOAT64, sizeof(double), field.rows, field.cols, field.units);
+
+			for (size_t e = 0; e < field.numElements(); ++e) {
+				s.channels.push_back(field.firstChannel + e);
+				s.hold.push_back(field.type != Schema::FLOAT64  &&  field.type != Schema::FLOAT32);
+				s.outputChannels.push_back(schema.numChannels() - field.numElements() + e);
+			}
+		}
+		s.windowValues.resize(s.channels.size());
+	}
+
+	// Fills times with the timestamps of the next block. Returns false at the end.
+	bool nextTimes() {
+		times.clear();
+		if (options.period > 0.0) {
+			for (size_t k = emitted; k < numOutput  &&  times.size() < blockLength; ++k) {
+				times.push_back(tStart + k * options.period);
+			}
+		} else {
+			// k-way merge of the inputs' timestamps
+			while ( !merge.empty()  &&  times.size() < blockLength) {
+				double t = merge.top().first;
+				SourceState& s = states[merge.top().second];
+				size_t i = merge.top().second;
+				merge.pop();
+				if (t > tEnd) {
+					merge = MergeQueue();
+					break;
+				}
+
+				if (++s.mergeNext < s.mergeTimes.size()) {
+					merge.push(std::make_pair(s.mergeTimes[s.mergeNext], i));
+				}
+				if (emitted + times.size() == 0  ||  t != lastTime) {
+					times.push_back(t);
+					lastTime = t;
+				}
+			}
+		}
+		return !times.empty();
+	}
+
+	// Reads the records around the block (two on either side, for CUBIC) and
+	// finds the sample before each output record.
+	void loadWindow(SourceState* s) {
+		const size_t n = s->input->numRecords();
+		size_t a = s->times.search(times.front(), true, s->hint);
+		size_t b = s->times.search(times.back(), true, a);
+		s->hint = a;
+
+		s->window = (a >= 2) ? a - 2 : 0;
+		const size_t count = std::min(n, b + 2) - s->window;
+		s->windowTimes.resize(count);
+		s->input->readChannel(s->timeChannel, &s->windowTimes[0], s->window, count);
+		for (size_t c = 0; c < s->channels.size(); ++c) {
+			s->windowValues[c].resize(count);
+			s->input->readChannel(s->channels[c], &s->windowValues[c][0], s->window, count);
+		}
+
+		s->sample.resize(times.size());
+		size_t j = 0;
+		for (size_t k = 0; k < times.size(); ++k) {
+			const double t = times[k];
+			if (t < s->start  ||  t > s->end) {
+				s->sample[k] = -1;
+				continue;
+			}
+			while (j + 1 < count  &&  s->windowTimes[j + 1] <= t) {
+				++j;
+			}
+			s->sample[k] = j;
+		}
+	}
+
+	void resample(const std::vector<std::pair<size_t, size_t> >& tasks, size_t task) const {
+		const SourceState& s = states[tasks[task].first];
+		const size_t c = tasks[task].second;
+		const std::vector<double>& tt = s.windowTimes;
+		const std::vector<double>& v = s.windowValues[c];
+		const long last = static_cast<long>(tt.size()) - 1;
+		const AlignOptions::Method method = s.hold[c] ? AlignOptions::HOLD : options.method;
+
+		char* dest = &rows[schema.channel(s.outputChannels[c]).offset];
+		for (size_t k = 0; k < times.size(); ++k, dest += schema.recordLength()) {
+			const long j = s.sample[k];
+			double value;
+			if (j < 0) {
+				value = NaN;
+			} else if (method == AlignOptions::HOLD  ||  j == last  ||  times[k] == tt[j]) {
+				value = v[j];
+			} else {
+				const double h = tt[j + 1] - tt[j];
+				const double u = (times[k] - tt[j]) / h;
+				if (method == AlignOptions::LINEAR) {
+					value = v[j] + u * (v[j + 1] - v[j]);
+				} else {
+					// Cubic Hermite with Catmull-Rom tangents
+					const double m0 = slope(tt, v, j);
+					const double m1 = slope(tt, v, j + 1);
+					const double u2 = u * u, u3 = u2 * u;
+					value = (2*u3 - 3*u2 + 1) * v[j] + (u3 - 2*u2 + u) * h * m0 +
+							(-2*u3 + 3*u2) * v[j + 1] + (u3 - u2) * h * m1;
+				}
+			}
+			std::memcpy(dest, &value, sizeof(double));
+		}
+	}
+
+	// The tangent at sample i: central differences inside the window, one-sided at its ends.
+	static double slope(const std::vector<double>& tt, const std::vector<double>& v, long i) {
+		const long last = static_cast<long>(tt.size()) - 1;
+		const long lo = (i > 0) ? i - 1 : i;
+		const long hi = (i < last) ? i + 1 : i;
+		return (v[hi] - v[lo]) / (tt[hi] - tt[lo]);
+	}
+
+	typedef std::priority_queue<std::pair<double, size_t>, std::vector<std::pair<double, size_t> >,
+			std::greater<std::pair<double, size_t> > > MergeQueue;
+
+	const AlignOptions& options;
+	const size_t blockLength;
+	std::vector<SourceState> states;
+	Schema schema;
+
+	double tStart, tEnd;
+	size_t numOutput;  // If period > 0
+	size_t emitted;
+	double lastTime;
+	MergeQueue merge;
+
+	mutable std::vector<char> rows;
+	std::vector<double> times;
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(Aligner);
+};
+
+}
+
+
+size_t align(const std::vector<AlignSource>& sources, const char* outputFile, const AlignOptions& options)
+{
+	Aligner aligner(sources, options);
+	return aligner.write(outputFile);
+}
+
+
+}
+}
@@ -0,0 +1,507 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file column_format.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace log {
+namespace detail {
+
+
+BOOST_STATIC_ASSERT(sizeof(BlockHeader) == BLOCK_HEADER_LENGTH);
+BOOST_STATIC_ASSERT(sizeof(PackedChannelHeader) == PACKED_CHANNEL_HEADER_LENGTH);
+
+
+namespace {
+const size_t PREAMBLE_LENGTH = COLUMN_LOG_MAGIC_LENGTH + 3 * sizeof(boost::uint32_t);
+
+void putUint32(std::vector<char>* buffer, boost::uint32_t value)
+{
+	const char* p = reinterpret_cast<const char*>(&value);
+	buffer->insert(buffer->end(), p, p + sizeof(value));
+}
+
+boost::uint32_t getUint32(const char* source)
+{
+	boost::uint32_t value;
+	std::memcpy(&value, source, sizeof(value));
+	return value;
+}
+}
+
+
+void writeColumnLogHeader(const Schema& schema, size_t recordsPerBlock, std::vector<char>* buffer)
+{
+	std::vector<char> s;
+	schema.serialize(&s);
+
+	buffer->insert(buffer->end(), COLUMN_LOG_MAGIC, COLUMN_LOG_MAGIC + COLUMN_LOG_MAGIC_LENGTH);
+	putUint32(buffer, COLUMN_LOG_VERSION);
+	putUint32(buffer, recordsPerBlock);
+	putUint32(buffer, s.size());
+	buffer->insert(buffer->end(), s.begin(), s.end());
+}
+
+bool isColumnLog(const char* source, size_t size)
+{
+	return size >= COLUMN_LOG_MAGIC_LENGTH  &&  std::memcmp(source, COLUMN_LOG_MAGIC, COLUMN_LOG_MAGIC_LENGTH) == 0;
+}
+
+size_t readColumnLogHeader(const char* source, size_t size, Schema* schema, size_t* recordsPerBlock)
+{
+	if ( !isColumnLog(source, size) ) {
+		throw std::runtime_error("(log::detail::readColumnLogHeader()): This is not a column log.");
+	}
+	if (size < PREAMBLE_LENGTH) {
+		throw std::runtime_error("(log::detail::readColumnLogHeader()): The header is truncated.");
+	}
+
+	const char* p = source + COLUMN_LOG_MAGIC_LENGTH;
+	boost::uint32_t version = getUint32(p);
+	if (version != COLUMN_LOG_VERSION) {
+		std::stringstream ss;
+		ss << "(log::detail::readColumnLogHeader()): Unsupported column log version (" << version << ").";
+		throw std::runtime_error(ss.str());
+	}
+	*recordsPerBlock = getUint32(p + sizeof(boost::uint32_t));
+	size_t schemaLength = getUint32(p + 2 * sizeof(boost::uint32_t));
+
+	if (size - PREAMBLE_LENGTH < schemaLength  ||
+			schema->unserialize(source + PREAMBLE_LENGTH, schemaLength) != schemaLength) {
+		throw std::runtime_error("(log::detail::readColumnLogHeader()): The schema is corrupt.");
+	}
+	return PREAMBLE_LENGTH + schemaLength;
+}
+
+
+void rowsToColumns(const Schema& schema, const char* rows, size_t n, char* payload)
+{
+	const size_t recordLength = schema.recordLength();
+	for (size_t c = 0; c < schema.numChannels(); ++c) {
+		const Schema::Channel& ch = schema.channel(c);
+		const char* src = rows + ch.offset;
+
+		switch (ch.size) {  // Let the compiler inline the common sizes
+		case 8:
+			for (size_t i = 0; i < n; ++i) {
+				std::memcpy(payload, src, 8);
+				payload += 8;
+				src += recordLength;
+			}
+			break;
+		case 4:
+			for (size_t i = 0; i < n; ++i) {
+				std::memcpy(payload, src, 4);
+				payload += 4;
+				src += recordLength;
+			}
+			break;
+		default:
+			for (size_t i = 0; i < n; ++i) {
+				std::memcpy(payload, src, ch.size);
+				payload += ch.size;
+				src += recordLength;
+			}
+			break;
+		}
+	}
+}
+
+void columnsToRow(const Schema& schema, const char* payload, size_t n, size_t i, char* row)
+{
+	for (size_t c = 0; c < schema.numChannels(); ++c) {
+		const Schema::Channel& ch = schema.channel(c);
+		std::memcpy(row + ch.offset, payload + n * ch.offset + i * ch.size, ch.size);
+	}
+}
+
+
+
+
+namespace {
+const size_t MAX_VARINT_LENGTH = 10;
+// Values further than this from zero (in multiples of the resolution) aren't quantized.
+const double MAX_QUANTUM = 4.0e18;
+
+// Returns NULL instead of writing past limit.
+inline char* putVarint(char* dest, const char* limit, boost::uint64_t value)
+{
+	if (dest == NULL) {
+		return NULL;
+	}
+	if (limit - dest < static_cast<ptrdiff_t>(MAX_VARINT_LENGTH)) {
+		size_t length = 1;
+		for (boost::uint64_t v = value >> 7; v != 0; v >>= 7) {
+			++length;
+		}
+		if (static_cast<size_t>(limit - dest) < length) {
+			return NULL;
+		}
+	}
+
+	while (value >= 0x80) {
+		*dest++ = static_cast<char>((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	*dest++ = static_cast<char>(value);
+	return dest;
+}
+
+inline const char* getVarint(const char* source, const char* end, boost::uint64_t* value)
+{
+	boost::uint64_t v = 0;
+	for (int shift = 0; shift < 64  &&  source != end; shift += 7) {
+		boost::uint8_t b = *source++;
+		v |= static_cast<boost::uint64_t>(b & 0x7f) << shift;
+		if ((b & 0x80) == 0) {
+			*value = v;
+			return source;
+		}
+	}
+	throw std::runtime_error("(log::detail::unpackChannel()): A varint is truncated or too long.");
+}
+
+inline boost::uint64_t zigzag(boost::uint64_t delta)
+{
+	return (delta << 1) ^ static_cast<boost::uint64_t>(static_cast<boost::int64_t>(delta) >> 63);
+}
+
+inline boost::uint64_t unzigzag(boost::uint64_t z)
+{
+	return (z >> 1) ^ (~(z & 1) + 1);
+}
+
+template<typename T> inline T load(const char* source)
+{
+	T value;
+	std::memcpy(&value, source, sizeof(T));
+	return value;
+}
+
+template<typename T> inline void store(char* dest, T value)
+{
+	std::memcpy(dest, &value, sizeof(T));
+}
+
+// Integers are widened (sign-extended if signed) so that small negative
+// deltas stay small.
+boost::uint64_t loadInteger(Schema::ScalarType type, const char* source)
+{
+	switch (type) {
+	case Schema::INT8:  return static_cast<boost::int64_t>(load<boost::int8_t>(source));
+	case Schema::UINT8:  return load<boost::uint8_t>(source);
+	case Schema::INT16:  return static_cast<boost::int64_t>(load<boost::int16_t>(source));
+	case Schema::UINT16:  return load<boost::uint16_t>(source);
+	case Schema::INT32:  return static_cast<boost::int64_t>(load<boost::int32_t>(source));
+	case Schema::UINT32:  return load<boost::uint32_t>(source);
+	default:  return load<boost::uint64_t>(source);
+	}
+}
+
+void storeInteger(Schema::ScalarType type, boost::uint64_t value, char* dest)
+{
+	switch (type) {
+	case Schema::INT8:
+	case Schema::UINT8:
+		store(dest, static_cast<boost::uint8_t>(value));
+		break;
+	case Schema::INT16:
+	case Schema::UINT16:
+		store(dest, static_cast<boost::uint16_t>(value));
+		break;
+	case Schema::INT32:
+	case Schema::UINT32:
+		store(dest, static_cast<boost::uint32_t>(value));
+		break;
+	default:
+		store(dest, value);
+		break;
+	}
+}
+
+inline double loadFloat(const Schema::Channel& c, const char* source)
+{
+	return (c.type == Schema::FLOAT32) ? load<float>(source) : load<double>(source);
+}
+
+inline boost::uint64_t loadBits(const Schema::Channel& c, const char* source)
+{
+	return (c.size == 4) ? load<boost::uint32_t>(source) : load<boost::uint64_t>(source);
+}
+
+inline bool isInteger(Schema::ScalarType type)
+{
+	return type != Schema::OPAQUE  &&  type != Schema::BOOL  &&  type != Schema::FLOAT32  &&  type != Schema::FLOAT64;
+}
+
+inline bool isFloat(Schema::ScalarType type)
+{
+	return type == Schema::FLOAT32  ||  type == Schema::FLOAT64;
+}
+
+// Each of these returns the end of the coded data, or NULL if it would
+// reach limit (or the values can't be coded this way).
+
+char* packDelta(const Schema::Channel& c, const char* src, size_t stride, size_t n, char* dest, const char* limit)
+{
+	boost::uint64_t prev = 0;
+	for (size_t i = 0; i < n; ++i, src += stride) {
+		boost::uint64_t v = loadInteger(c.type, src);
+		dest = putVarint(dest, limit, zigzag(v - prev));
+		prev = v;
+	}
+	return dest;
+}
+
+char* packXor(const Schema::Channel& c, const char* src, size_t stride, size_t n, char* dest, const char* limit)
+{
+	boost::uint64_t prev = 0;
+	for (size_t i = 0; i < n; ++i, src += stride) {
+		boost::uint64_t v = loadBits(c, src);
+		dest = putVarint(dest, limit, v ^ prev);
+		prev = v;
+	}
+	return dest;
+}
+
+char* packQuantized(const Schema::Channel& c, double r, const char* src, size_t stride, size_t n, char* dest, const char* limit)
+{
+	if (limit - dest < static_cast<ptrdiff_t>(sizeof(double))) {
+		return NULL;
+	}
+	store(dest, r);
+	dest += sizeof(double);
+
+	boost::int64_t prev = 0;
+	for (size_t i = 0; i < n; ++i, src += stride) {
+		double q = std::floor(loadFloat(c, src) / r + 0.5);
+		if ( !(std::abs(q) < MAX_QUANTUM) ) {  // Also catches NaN and inf
+			return NULL;
+		}
+		boost::int64_t qi = static_cast<boost::int64_t>(q);
+		dest = putVarint(dest, limit, zigzag(static_cast<boost::uint64_t>(qi) - static_cast<boost::uint64_t>(prev)));
+		prev = qi;
+	}
+	return dest;
+}
+}
+
+
+size_t maxPackedLength(const Schema& schema, size_t n)
+{
+	return schema.numChannels() * PACKED_CHANNEL_HEADER_LENGTH + n * schema.recordLength();
+}
+
+size_t packRows(const Schema& schema, const double* resolutions, const char* rows, size_t n, char* payload)
+{
+	const size_t stride = schema.recordLength();
+	char* dest = payload + schema.numChannels() * PACKED_CHANNEL_HEADER_LENGTH;
+
+	for (size_t ci = 0; ci < schema.numChannels(); ++ci) {
+		const Schema::Channel& c = schema.channel(ci);
+		const char* src = rows + c.offset;
+		// Coded data is only kept if it's shorter than the raw data.
+		const char* limit = dest + n * c.size;
+
+		PackedChannelHeader ch;
+		std::memset(&ch, 0, sizeof(ch));
+
+		char* end = NULL;
+		if (isInteger(c.type)) {
+			ch.coding = DELTA_CODING;
+			end = packDelta(c, src, stride, n, dest, limit);
+		} else if (isFloat(c.type)) {
+			if (resolutions[ci] > 0.0) {
+				ch.coding = QUANTIZED_CODING;
+				end = packQuantized(c, resolutions[ci], src, stride, n, dest, limit);
+			}
+			if (end == NULL) {
+				ch.coding = XOR_CODING;
+				end = packXor(c, src, stride, n, dest, limit);
+			}
+		}
+
+		if (end == NULL) {
+			ch.coding = RAW_CODING;
+			end = dest;
+			for (size_t i = 0; i < n; ++i, src += stride) {
+				std::memcpy(end, src, c.size);
+				end += c.size;
+			}
+		}
+		ch.length = end - dest;
+		dest = end;
+
+		std::memcpy(payload + ci * PACKED_CHANNEL_HEADER_LENGTH, &ch, PACKED_CHANNEL_HEADER_LENGTH);
+	}
+
+	return dest - payload;
+}
+
+void unpackChannel(const Schema& schema, const char* payload, size_t length, size_t n, size_t ci, char* dest)
+{
+	const size_t tableLength = schema.numChannels() * PACKED_CHANNEL_HEADER_LENGTH;
+	if (length < tableLength) {
+		throw std::runtime_error("(log::detail::unpackChannel()): The payload is truncated.");
+	}
+
+	PackedChannelHeader ch;
+	size_t offset = tableLength;
+	for (size_t i = 0; i <= ci; ++i) {
+		std::memcpy(&ch, payload + i * PACKED_CHANNEL_HEADER_LENGTH, PACKED_CHANNEL_HEADER_LENGTH);
+		if (i != ci) {
+			offset += ch.length;
+		}
+	}
+	if (offset > length  ||  ch.length > length - offset) {
+		throw std::runtime_error("(log::detail::unpackChannel()): The payload is truncated.");
+	}
+
+	const Schema::Channel& c = schema.channel(ci);
+	const char* src = payload + offset;
+	const char* end = src + ch.length;
+
+	switch (ch.coding) {
+	case RAW_CODING:
+		if (ch.length != n * c.size) {
+			throw std::runtime_error("(log::detail::unpackChannel()): The payload is corrupt.");
+		}
+		std::memcpy(dest, src, ch.length);
+		break;
+
+	case DELTA_CODING:
+		if (isInteger(c.type)) {
+			boost::uint64_t v = 0, z;
+			for (size_t i = 0; i < n; ++i) {
+				src = getVarint(src, end, &z);
+				v += unzigzag(z);
+				storeInteger(c.type, v, dest + i * c.size);
+			}
+			break;
+		}
+		throw std::runtime_error("(log::detail::unpackChannel()): The payload is corrupt.");
+
+	case XOR_CODING:
+		if (isFloat(c.type)) {
+			boost::uint64_t v = 0, x;
+			for (size_t i = 0; i < n; ++i) {
+				src = getVarint(src, end, &x);
+				v ^= x;
+				if (c.size == 4) {
+					store(dest + i * c.size, static_cast<boost::uint32_t>(v));
+				} else {
+					store(dest + i * c.size, v);
+				}
+			}
+			break;
+		}
+		throw std::runtime_error("(log::detail::unpackChannel()): The payload is corrupt.");
+
+	case QUANTIZED_CODING:
+		if (isFloat(c.type)  &&  ch.length >= sizeof(double)) {
+			const double r = load<double>(src);
+			src += sizeof(double);
+
+			boost::uint64_t q = 0, z;
+			for (size_t i = 0; i < n; ++i) {
+				src = getVarint(src, end, &z);
+				q += unzigzag(z);
+				double value = static_cast<boost::int64_t>(q) * r;
+				if (c.type == Schema::FLOAT32) {
+					store(dest + i * c.size, static_cast<float>(value));
+				} else {
+					store(dest + i * c.size, value);
+				}
+			}
+			break;
+		}
+		throw std::runtime_error("(log::detail::unpackChannel()): The payload is corrupt.");
+
+	default:
+		throw std::runtime_error("(log::detail::unpackChannel()): Unknown channel coding.");
+	}
+}
+
+
+
+BlockEncoder::BlockEncoder(const Schema& schema_, const ColumnOptions& options, size_t maxRecords_) :
+	schema(schema_), compress(options.compress), resolutions(options.channelResolutions(schema_)),
+	maxRecords(maxRecords_), block(BLOCK_HEADER_LENGTH + maxPackedLength(schema_, maxRecords_))
+{
+	if (maxRecords == 0) {
+		throw std::logic_error("(log::detail::BlockEncoder::BlockEncoder()): maxRecords cannot be zero.");
+	}
+}
+
+void BlockEncoder::writeHeader(std::vector<char>* buffer) const
+{
+	writeColumnLogHeader(schema, maxRecords, buffer);
+}
+
+size_t BlockEncoder::encode(const char* rows, size_t n)
+{
+	assert(n <= maxRecords);
+
+	BlockHeader bh;
+	std::memset(&bh, 0, sizeof(bh));
+	bh.numRecords = n;
+	if (compress) {
+		bh.encoding = PACKED_ENCODING;
+		bh.payloadLength = packRows(schema, &resolutions[0], rows, n, &block[BLOCK_HEADER_LENGTH]);
+	} else {
+		bh.encoding = RAW_ENCODING;
+		bh.payloadLength = n * schema.recordLength();
+		rowsToColumns(schema, rows, n, &block[BLOCK_HEADER_LENGTH]);
+	}
+
+	std::memcpy(&block[0], &bh, BLOCK_HEADER_LENGTH);
+	return BLOCK_HEADER_LENGTH + bh.payloadLength;
+}
+
+
+}
+}
+}
@@ -0,0 +1,259 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file column_reader.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/detail/column_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+ColumnReader::ColumnReader(const char* fileName) :
+	fd(-1), data(NULL), size(0), schema(), blocks(), recordCount(0), row(),
+	channelBuffer(), blockBuffer(), bufferedBlock(NULL)
+{
+	fd = open(fileName, O_RDONLY);
+	if (fd == -1) {
+		throw(std::runtime_error(std::string("(log::ColumnReader::ColumnReader): Couldn't open the file '") + fileName + "'."));
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0  ||  st.st_size == 0) {
+		close();
+		throw(std::runtime_error(std::string("(log::ColumnReader::ColumnReader): The file '") + fileName + "' is empty."));
+	}
+	size = st.st_size;
+
+	void* p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED) {
+		close();
+		throw(std::runtime_error(std::string("(log::ColumnReader::ColumnReader): Couldn't map the file '") + fileName + "'."));
+	}
+	data = static_cast<char*>(p);
+
+	size_t recordsPerBlock;
+	size_t pos;
+	try {
+		pos = detail::readColumnLogHeader(data, size, &schema, &recordsPerBlock);
+	} catch (...) {
+		close();
+		throw;
+	}
+	row.resize(schema.recordLength());
+
+	// Index the blocks
+	while (size - pos >= detail::BLOCK_HEADER_LENGTH) {
+		detail::BlockHeader bh;
+		std::memcpy(&bh, data + pos, detail::BLOCK_HEADER_LENGTH);
+		pos += detail::BLOCK_HEADER_LENGTH;
+
+		if (bh.numRecords == 0  ||  bh.payloadLength > size - pos) {
+			break;  // Truncated
+		}
+		bool valid = false;
+		switch (bh.encoding) {
+		case detail::RAW_ENCODING:
+			valid = bh.payloadLength == bh.numRecords * schema.recordLength();
+			break;
+		case detail::PACKED_ENCODING:
+			valid = bh.payloadLength >= schema.numChannels() * detail::PACKED_CHANNEL_HEADER_LENGTH;
+			break;
+		}
+		if ( !valid ) {
+			close();
+			std::stringstream ss;
+			ss << "(log::ColumnReader::ColumnReader): The file '" << fileName
+					<< "' is corrupted or uses an unsupported block encoding (" << (int) bh.encoding << ").";
+			throw(std::runtime_error(ss.str()));
+		}
+
+		Block b;
+		b.firstRecord = recordCount;
+		b.numRecords = bh.numRecords;
+		b.encoding = bh.encoding;
+		b.payload = data + pos;
+		b.payloadLength = bh.payloadLength;
+		blocks.push_back(b);
+
+		recordCount += bh.numRecords;
+		pos += bh.payloadLength;
+	}
+}
+
+ColumnReader::~ColumnReader()
+{
+	close();
+}
+
+void ColumnReader::readChannel(size_t channel, std::vector<double>* dest, size_t first, size_t count) const
+{
+	if (first > recordCount  ||  count > recordCount - first) {
+		throw(std::out_of_range("(log::ColumnReader::readChannel()): Those records aren't in the file."));
+	}
+	if (count == 0) {
+		return;
+	}
+
+	const size_t oldSize = dest->size();
+	dest->resize(oldSize + count);
+	readChannel(channel, &(*dest)[oldSize], first, count);
+}
+
+void ColumnReader::readChannel(size_t channel, double* dest, size_t first, size_t count) const
+{
+	if (first > recordCount  ||  count > recordCount - first) {
+		throw(std::out_of_range("(log::ColumnReader::readChannel()): Those records aren't in the file."));
+	}
+	if (count == 0) {
+		return;
+	}
+
+	const Schema::Channel& ch = schema.channel(channel);
+	size_t end = first + count;
+	for (const Block* b = &findBlock(first); first < end; ++b) {
+		const char* src = channelData(*b, channel);
+		size_t i = first - b->firstRecord;
+		size_t n = std::min(b->numRecords, end - b->firstRecord);
+
+		if (ch.type == Schema::FLOAT64) {
+			std::memcpy(dest, src + i * ch.size, (n - i) * ch.size);
+			dest += n - i;
+		} else {
+			for ( ; i < n; ++i) {
+				*dest++ = Schema::toDouble(ch.type, src + i * ch.size);
+			}
+		}
+		first = b->firstRecord + n;
+	}
+}
+
+void ColumnReader::readRecord(size_t i, char* dest) const
+{
+	if (i >= recordCount) {
+		throw(std::out_of_range("(log::ColumnReader::readRecord()): That record isn't in the file."));
+	}
+
+	const Block& b = findBlock(i);
+	detail::columnsToRow(schema, rawPayload(b), b.numRecords, i - b.firstRecord, dest);
+}
+
+void ColumnReader::close()
+{
+	if (data != NULL) {
+		munmap(data, size);
+		data = NULL;
+	}
+	if (fd != -1) {
+		::close(fd);
+		fd = -1;
+	}
+	blocks.clear();
+	recordCount = 0;
+	bufferedBlock = NULL;
+}
+
+const ColumnReader::Block& ColumnReader::findBlock(size_t record) const
+{
+	size_t lo = 0, hi = blocks.size();
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+		if (blocks[mid].firstRecord <= record) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	return blocks[lo];
+}
+
+
+const char* ColumnReader::channelData(const Block& b, size_t c) const
+{
+	const Schema::Channel& ch = schema.channel(c);
+	if (b.encoding == detail::RAW_ENCODING) {
+		return b.payload + b.numRecords * ch.offset;
+	} else if (&b == bufferedBlock) {
+		return &blockBuffer[b.numRecords * ch.offset];
+	}
+
+	channelBuffer.resize(b.numRecords * ch.size);
+	detail::unpackChannel(schema, b.payload, b.payloadLength, b.numRecords, c, &channelBuffer[0]);
+	return &channelBuffer[0];
+}
+
+const char* ColumnReader::rawPayload(const Block& b) const
+{
+	if (b.encoding == detail::RAW_ENCODING) {
+		return b.payload;
+	}
+
+	if (&b != bufferedBlock) {
+		bufferedBlock = NULL;
+		readBlock(&b - &blocks[0], &blockBuffer);
+		bufferedBlock = &b;
+	}
+	return &blockBuffer[0];
+}
+
+const char* ColumnReader::readBlock(size_t i, std::vector<char>* buffer) const
+{
+	const Block& b = blocks.at(i);
+	if (b.encoding == detail::RAW_ENCODING) {
+		return b.payload;
+	}
+
+	buffer->resize(b.numRecords * schema.recordLength());
+	for (size_t c = 0; c < schema.numChannels(); ++c) {
+		detail::unpackChannel(schema, b.payload, b.payloadLength, b.numRecords, c,
+				&(*buffer)[b.numRecords * schema.channel(c).offset]);
+	}
+	return &(*buffer)[0];
+}
+
+
+}
+}
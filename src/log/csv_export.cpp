@@ -0,0 +1,544 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file csv_export.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/math/special_functions/sign.hpp>
+#include <boost/thread.hpp>
+
+#include <barrett/detail/ca_macro.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/csv_export.h>
+#include <barrett/log/detail/task_pool.h>
+
+
+namespace barrett {
+namespace log {
+
+
+namespace {
+const int MAX_EXACT_POW10 = 22;
+const double POW10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Largest precision for which all the digits fit exactly in a double.
+const int MAX_FAST_PRECISION = 15;
+
+inline char* putDigits(boost::uint64_t value, char* dest)
+{
+	char tmp[20];
+	int n = 0;
+	do {
+		tmp[n++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+	while (n > 0) {
+		*dest++ = tmp[--n];
+	}
+	return dest;
+}
+
+size_t formatWithPrintf(double x, int precision, char* dest)
+{
+	char buf[40];
+	int n = snprintf(buf, sizeof(buf), "%.*g", precision, x);
+	std::memcpy(dest, buf, n);
+	return n;
+}
+}
+
+namespace detail {
+
+size_t formatDouble(double x, int precision, char* dest)
+{
+	if (precision <= 0) {
+		precision = 1;
+	} else if (precision > MAX_FAST_PRECISION) {
+		return formatWithPrintf(x, std::min(precision, 17), dest);
+	}
+
+	if ( !(x == x)  ||  x - x != 0.0 ) {  // NaN or inf
+		return formatWithPrintf(x, precision, dest);
+	}
+
+	char* p = dest;
+	if ((boost::math::signbit)(x)) {
+		*p++ = '-';
+		x = -x;
+	}
+	if (x == 0.0) {
+		*p++ = '0';
+		return p - dest;
+	}
+
+	// Find the digits, and the exponent of the first one, as %e would.
+	int e = static_cast<int>(std::floor(std::log10(x)));
+	boost::uint64_t digits = 0;
+	bool found = false;
+	for (int attempt = 0; attempt < 3  &&  !found; ++attempt) {
+		const int k = precision - 1 - e;
+		if (k > MAX_EXACT_POW10  ||  k < -MAX_EXACT_POW10) {
+			break;
+		}
+
+		// A single rounding error, so the result is within an ulp of exact...
+		const double m = (k >= 0) ? x * POW10[k] : x / POW10[-k];
+		const double r = std::floor(m + 0.5);
+		// ...which could only change the outcome near a tie.
+		if (std::abs(std::abs(m - std::floor(m)) - 0.5) <= m * 4e-16) {
+			break;
+		}
+
+		if (r >= POW10[precision]) {
+			++e;
+		} else if (r < POW10[precision - 1]) {
+			--e;
+		} else {
+			digits = static_cast<boost::uint64_t>(r);
+			found = true;
+		}
+	}
+	if ( !found ) {
+		return (p - dest) + formatWithPrintf(x, precision, p);
+	}
+
+	// %g drops trailing zeros.
+	int numDigits = precision;
+	while (numDigits > 1  &&  digits % 10 == 0) {
+		digits /= 10;
+		--numDigits;
+	}
+	char d[20];
+	putDigits(digits, d);
+
+	if (e < -4  ||  e >= precision) {
+		*p++ = d[0];
+		if (numDigits > 1) {
+			*p++ = '.';
+			std::memcpy(p, d + 1, numDigits - 1);
+			p += numDigits - 1;
+		}
+		*p++ = 'e';
+		*p++ = (e < 0) ? '-' : '+';
+		int ae = std::abs(e);
+		if (ae < 10) {
+			*p++ = '0';
+		}
+		p = putDigits(ae, p);
+	} else if (e >= 0) {
+		for (int i = 0; i <= e; ++i) {
+			*p++ = (i < numDigits) ? d[i] : '0';
+		}
+		if (numDigits > e + 1) {
+			*p++ = '.';
+			std::memcpy(p, d + e + 1, numDigits - e - 1);
+			p += numDigits - e - 1;
+		}
+	} else {
+		*p++ = '0';
+		*p++ = '.';
+		for (int i = 0; i < -e - 1; ++i) {
+			*p++ = '0';
+		}
+		std::memcpy(p, d, numDigits);
+		p += numDigits;
+	}
+
+	return p - dest;
+}
+
+}
+
+
+namespace {
+
+template<typename T> inline T load(const char* source)
+{
+	T value;
+	std::memcpy(&value, source, sizeof(T));
+	return value;
+}
+
+inline char* putInteger(boost::int64_t value, char* dest)
+{
+	if (value < 0) {
+		*dest++ = '-';
+		return putDigits(static_cast<boost::uint64_t>(0) - static_cast<boost::uint64_t>(value), dest);
+	}
+	return putDigits(value, dest);
+}
+
+char* formatValue(Schema::ScalarType type, size_t size, const char* src, int precision, char* dest)
+{
+	switch (type) {
+	case Schema::FLOAT64:
+		return dest + detail::formatDouble(load<double>(src), precision, dest);
+	case Schema::FLOAT32:
+		return dest + detail::formatDouble(load<float>(src), precision, dest);
+	case Schema::BOOL:
+		*dest++ = load<bool>(src) ? '1' : '0';
+		return dest;
+	case Schema::INT8:
+		return putInteger(load<boost::int8_t>(src), dest);
+	case Schema::UINT8:
+		return putDigits(load<boost::uint8_t>(src), dest);
+	case Schema::INT16:
+		return putInteger(load<boost::int16_t>(src), dest);
+	case Schema::UINT16:
+		return putDigits(load<boost::uint16_t>(src), dest);
+	case Schema::INT32:
+		return putInteger(load<boost::int32_t>(src), dest);
+	case Schema::UINT32:
+		return putDigits(load<boost::uint32_t>(src), dest);
+	case Schema::INT64:
+		return putInteger(load<boost::int64_t>(src), dest);
+	case Schema::UINT64:
+		return putDigits(load<boost::uint64_t>(src), dest);
+	default: {  // OPAQUE, as hex
+		static const char HEX[] = "0123456789abcdef";
+		*dest++ = '0';
+		*dest++ = 'x';
+		for (size_t i = 0; i < size; ++i) {
+			boost::uint8_t b = src[i];
+			*dest++ = HEX[b >> 4];
+			*dest++ = HEX[b & 0xf];
+		}
+		return dest;
+	}
+	}
+}
+
+size_t maxLineLength(const Schema& schema)
+{
+	size_t length = 1;  // The newline
+	for (size_t c = 0; c < schema.numChannels(); ++c) {
+		// formatDouble() and 64-bit integers are shorter than 32 characters.
+		length += std::max(static_cast<size_t>(32), 2 + 2 * schema.channel(c).size) + 1;
+	}
+	return length;
+}
+
+
+// Where the values of a chunk of records are. The value of channel c in
+// record i is at start[c] + i * step[c].
+struct ChunkLayout {
+	size_t numRecords;
+	std::vector<const char*> start;
+	std::vector<size_t> step;
+};
+
+class ChunkSource {
+public:
+	virtual ~ChunkSource() {}
+	virtual size_t numChunks() const = 0;
+	virtual size_t maxChunkRecords() const = 0;
+	// Must be safe to call from several threads at once.
+	virtual void getChunk(size_t i, ChunkLayout* layout, std::vector<char>* scratch) const = 0;
+};
+
+class ColumnLogSource : public ChunkSource {
+public:
+	explicit ColumnLogSource(const ColumnReader& reader_) : reader(reader_), maxRecords(0) {
+		for (size_t b = 0; b < reader.numBlocks(); ++b) {
+			maxRecords = std::max(maxRecords, reader.blockNumRecords(b));
+		}
+	}
+
+	virtual size_t numChunks() const {  return reader.numBlocks();  }
+	virtual size_t maxChunkRecords() const {  return maxRecords;  }
+
+	virtual void getChunk(size_t i, ChunkLayout* layout, std::vector<char>* scratch) const {
+		const Schema& schema = reader.getSchema();
+		const char* payload = reader.readBlock(i, scratch);
+		const size_t n = reader.blockNumRecords(i);
+
+		layout->numRecords = n;
+		for (size_t c = 0; c < schema.numChannels(); ++c) {
+			layout->start[c] = payload + n * schema.channel(c).offset;
+			layout->step[c] = schema.channel(c).size;
+		}
+	}
+
+protected:
+	const ColumnReader& reader;
+	size_t maxRecords;
+};
+
+class RawLogSource : public ChunkSource {
+public:
+	RawLogSource(const char* data_, size_t numRecords_, const Schema& schema_, size_t recordsPerChunk_) :
+		data(data_), numRecords(numRecords_), schema(schema_), recordsPerChunk(recordsPerChunk_) {}
+
+	virtual size_t numChunks() const {  return (numRecords + recordsPerChunk - 1) / recordsPerChunk;  }
+	virtual size_t maxChunkRecords() const {  return std::min(numRecords, recordsPerChunk);  }
+
+	virtual void getChunk(size_t i, ChunkLayout* layout, std::vector<char>* /*scratch*/) const {
+		const size_t first = i * recordsPerChunk;
+		const char* rows = data + first * schema.recordLength();
+
+		layout->numRecords = std::min(recordsPerChunk, numRecords - first);
+		for (size_t c = 0; c < schema.numChannels(); ++c) {
+			layout->start[c] = rows + schema.channel(c).offset;
+			layout->step[c] = schema.recordLength();
+		}
+	}
+
+protected:
+	const char* data;
+	size_t numRecords;
+	const Schema& schema;
+	size_t recordsPerChunk;
+};
+
+
+void writeAll(int fd, const char* buffer, size_t length)
+{
+	while (length != 0) {
+		ssize_t n = ::write(fd, buffer, length);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error(std::string("(log::exportCSV()): Couldn't write the CSV file: ") + std::strerror(errno));
+		}
+		buffer += n;
+		length -= n;
+	}
+}
+
+// Formats chunks in a TaskPool and writes them in order from the calling
+// thread, a batch of pool.numThreads() chunks at a time. While one batch is
+// written, the next is formatted into the other half of the slots.
+class Exporter {
+public:
+	Exporter(const ChunkSource& source_, const Schema& schema_, const CSVOptions& options_) :
+		source(source_), schema(schema_), options(options_), lineLength(maxLineLength(schema_)),
+		slots(), pool(numThreadsFor(options_, source_))
+	{
+		slots.resize(2 * pool.numThreads());
+		for (size_t i = 0; i < slots.size(); ++i) {
+			slots[i].layout.start.resize(schema.numChannels());
+			slots[i].layout.step.resize(schema.numChannels());
+			slots[i].length = 0;
+		}
+	}
+
+	void write(int fd) {
+		if (options.header) {
+			std::string header;
+			for (size_t c = 0; c < schema.numChannels(); ++c) {
+				header += (c == 0 ? "" : ",") + schema.channelName(c);
+			}
+			header += '\n';
+			writeAll(fd, header.data(), header.size());
+		}
+
+		const size_t numChunks = source.numChunks();
+		const size_t batch = pool.numThreads();
+		if (numChunks == 0) {
+			return;
+		}
+
+		pool.start(boost::bind(&Exporter::formatChunk, this, 0, _1), std::min(batch, numChunks));
+		for (size_t first = 0; first < numChunks; first += batch) {
+			pool.wait();
+
+			const size_t next = first + batch;
+			if (next < numChunks) {
+				pool.start(boost::bind(&Exporter::formatChunk, this, next, _1), std::min(batch, numChunks - next));
+			}
+			for (size_t i = first; i < std::min(next, numChunks); ++i) {
+				const Slot& s = slots[i % slots.size()];
+				writeAll(fd, &s.text[0], s.length);
+			}
+		}
+	}
+
+protected:
+	struct Slot {
+		ChunkLayout layout;
+		std::vector<char> scratch;
+		std::vector<char> text;
+		size_t length;
+	};
+
+	static size_t numThreadsFor(const CSVOptions& options, const ChunkSource& source) {
+		size_t numThreads = options.numThreads;
+		if (numThreads == 0) {
+			numThreads = std::max(1u, boost::thread::hardware_concurrency());
+		}
+		return std::max(static_cast<size_t>(1), std::min(numThreads, source.numChunks()));
+	}
+
+	void formatChunk(size_t first, size_t k) {
+		const size_t i = first + k;
+		Slot& s = slots[i % slots.size()];
+		source.getChunk(i, &s.layout, &s.scratch);
+		s.length = format(s.layout, &s.text);
+	}
+
+	size_t format(const ChunkLayout& layout, std::vector<char>* text) const {
+		if (text->size() < layout.numRecords * lineLength) {
+			text->resize(layout.numRecords * lineLength);
+		}
+
+		const size_t numChannels = schema.numChannels();
+		char* p = &(*text)[0];
+		for (size_t i = 0; i < layout.numRecords; ++i) {
+			for (size_t c = 0; c < numChannels; ++c) {
+				const Schema::Channel& ch = schema.channel(c);
+				p = formatValue(ch.type, ch.size, layout.start[c] + i * layout.step[c], options.precision, p);
+				*p++ = ',';
+			}
+			p[-1] = '\n';
+		}
+		return p - &(*text)[0];
+	}
+
+	const ChunkSource& source;
+	const Schema& schema;
+	const CSVOptions& options;
+	const size_t lineLength;
+
+	std::vector<Slot> slots;
+	detail::TaskPool pool;  // Last, so the workers stop before the slots go away
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(Exporter);
+};
+
+
+void exportChunks(const ChunkSource& source, const Schema& schema, const char* csvFile, const CSVOptions& options)
+{
+	int fd = open(csvFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd == -1) {
+		throw std::runtime_error(std::string("(log::exportCSV()): Couldn't open the file '") + csvFile + "'.");
+	}
+
+	try {
+		Exporter e(source, schema, options);
+		e.write(fd);
+	} catch (...) {
+		::close(fd);
+		throw;
+	}
+
+	if (::close(fd) != 0) {
+		throw std::runtime_error(std::string("(log::exportCSV()): Couldn't write the file '") + csvFile + "'.");
+	}
+}
+
+}
+
+
+void exportCSV(const ColumnReader& reader, const char* csvFile, const CSVOptions& options)
+{
+	ColumnLogSource source(reader);
+	exportChunks(source, reader.getSchema(), csvFile, options);
+}
+
+void exportCSV(const char* columnLogFile, const char* csvFile, const CSVOptions& options)
+{
+	ColumnReader reader(columnLogFile);
+	exportCSV(reader, csvFile, options);
+}
+
+void exportRawCSV(const char* rawLogFile, const Schema& schema, const char* csvFile, const CSVOptions& options)
+{
+	if (schema.recordLength() == 0) {
+		throw std::logic_error("(log::exportRawCSV()): The schema is empty.");
+	}
+	if (options.recordsPerChunk == 0) {
+		throw std::logic_error("(log::exportRawCSV()): recordsPerChunk cannot be zero.");
+	}
+
+	int fd = open(rawLogFile, O_RDONLY);
+	if (fd == -1) {
+		throw std::runtime_error(std::string("(log::exportRawCSV()): Couldn't open the file '") + rawLogFile + "'.");
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		::close(fd);
+		throw std::runtime_error(std::string("(log::exportRawCSV()): Couldn't read the file '") + rawLogFile + "'.");
+	}
+	const size_t size = st.st_size;
+	if (size % schema.recordLength() != 0) {
+		::close(fd);
+		throw std::runtime_error(std::string("(log::exportRawCSV()): The file '") + rawLogFile +
+				"' is corrupted or does not contain this type of data. Its size is not evenly divisible by the record length.");
+	}
+
+	void* data = NULL;
+	if (size != 0) {
+		data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (data == MAP_FAILED) {
+			::close(fd);
+			throw std::runtime_error(std::string("(log::exportRawCSV()): Couldn't map the file '") + rawLogFile + "'.");
+		}
+	}
+	::close(fd);
+
+	try {
+		RawLogSource source(static_cast<const char*>(data), size / schema.recordLength(), schema, options.recordsPerChunk);
+		exportChunks(source, schema, csvFile, options);
+	} catch (...) {
+		if (data != NULL) {
+			munmap(data, size);
+		}
+		throw;
+	}
+	if (data != NULL) {
+		munmap(data, size);
+	}
+}
+
+
+}
+}
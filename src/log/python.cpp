@@ -0,0 +1,184 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ */
+
+/**
+ * @file python.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <string>
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/python.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/segmented_reader.h>
+
+#include "../python.h"
+
+
+using namespace barrett;
+using namespace boost::python;
+
+
+// A record description that numpy.dtype() accepts: a (name, type[, count])
+// tuple per field. Multi-element fields become flat arrays whose elements
+// are in channel order ("jt[0]", "jt[1]", ...).
+list dtype(const log::Schema& schema) {
+	list fields;
+	for (size_t i = 0; i < schema.numFields(); ++i) {
+		const log::Schema::Field& f = schema.field(i);
+		std::string type;
+		if (f.type == log::Schema::OPAQUE) {
+			type = "V" + boost::lexical_cast<std::string>(f.elementSize);
+		} else {
+			type = std::string(1, static_cast<char>(f.type));  // The codes match NumPy's
+		}
+
+		if (f.numElements() == 1) {
+			fields.append(boost::python::make_tuple(f.name, type));
+		} else {
+			fields.append(boost::python::make_tuple(f.name, type, f.numElements()));
+		}
+	}
+	return fields;
+}
+
+list channelNames(const log::Schema& schema) {
+	list names;
+	for (size_t i = 0; i < schema.numChannels(); ++i) {
+		names.append(schema.channelName(i));
+	}
+	return names;
+}
+
+// Maps a raw log (as written by log::Writer or log::RealTimeWriter) as a
+// read-only structured array. Nothing is copied: the array's memory is the
+// file's page cache.
+object mapRawLog(const std::string& fileName, const log::Schema& schema) {
+	object numpy = import("numpy");
+	return numpy.attr("memmap")(fileName, numpy.attr("dtype")(dtype(schema)), "r");
+}
+
+
+template<typename ReaderType>
+size_t channelIndex(const ReaderType& reader, object channel) {
+	extract<std::string> name(channel);
+	if (name.check()) {
+		return reader.getSchema().findChannel(name());
+	}
+	return extract<size_t>(channel);
+}
+
+// Decodes a channel straight into a new float64 array, without creating a
+// Python object per value. count defaults to the rest of the log.
+template<typename ReaderType>
+object readChannel(const ReaderType& reader, object channel, size_t first, object count) {
+	size_t c = channelIndex(reader, channel);
+	size_t n = count.is_none() ? reader.numRecords() - std::min(first, reader.numRecords()) : extract<size_t>(count)();
+
+	object array = import("numpy").attr("empty")(n, "d");
+	Py_buffer view;
+	if (PyObject_GetBuffer(array.ptr(), &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0) {
+		throw_error_already_set();
+	}
+	try {
+		reader.readChannel(c, static_cast<double*>(view.buf), first, n);
+	} catch (...) {
+		PyBuffer_Release(&view);
+		throw;
+	}
+	PyBuffer_Release(&view);
+	return array;
+}
+
+// A dict of every channel, by name.
+template<typename ReaderType>
+dict readChannels(const ReaderType& reader, size_t first, object count) {
+	dict channels;
+	for (size_t i = 0; i < reader.getSchema().numChannels(); ++i) {
+		channels[reader.getSchema().channelName(i)] = readChannel(reader, object(i), first, count);
+	}
+	return channels;
+}
+
+tuple findTimeRange(const log::SegmentedReader& reader, double t0, double t1) {
+	size_t first, count;
+	reader.findTimeRange(t0, t1, &first, &count);
+	return boost::python::make_tuple(first, count);
+}
+
+
+void pythonLogInterface() {
+	class_<log::Schema>("Schema", init<optional<double> >())
+		.def("fromFormat", &log::Schema::fromFormat,
+				(arg("format"), arg("fieldNames") = "", arg("samplePeriod") = 0.0))
+		.staticmethod("fromFormat")
+
+		.def("numFields", &log::Schema::numFields)
+		.def("numChannels", &log::Schema::numChannels)
+		.def("channelName", &log::Schema::channelName)
+		.def("channelNames", &channelNames)
+		.def("findChannel", &log::Schema::findChannel)
+		.def("recordLength", &log::Schema::recordLength)
+		.def("getSamplePeriod", &log::Schema::getSamplePeriod)
+		.def("setSamplePeriod", &log::Schema::setSamplePeriod)
+		.def("dtype", &dtype)
+		.def(self == self)
+		.def(self != self)
+	;
+
+	def("mapRawLog", &mapRawLog);
+
+	class_<log::ColumnReader, boost::noncopyable>("ColumnReader", init<const char*>())
+		.def("getSchema", &log::ColumnReader::getSchema, return_internal_reference<>())
+		.def("numRecords", &log::ColumnReader::numRecords)
+		.def("readChannel", &readChannel<log::ColumnReader>,
+				(arg("channel"), arg("first") = 0, arg("count") = object()))
+		.def("readChannels", &readChannels<log::ColumnReader>,
+				(arg("first") = 0, arg("count") = object()))
+		.def("close", &log::ColumnReader::close)
+	;
+
+	class_<log::SegmentedReader, boost::noncopyable>("SegmentedReader", init<const char*>())
+		.def("getSchema", &log::SegmentedReader::getSchema, return_internal_reference<>())
+		.def("numRecords", &log::SegmentedReader::numRecords)
+		.def("numSegments", &log::SegmentedReader::numSegments)
+		.def("startTime", &log::SegmentedReader::startTime)
+		.def("endTime", &log::SegmentedReader::endTime)
+		.def("recordTime", &log::SegmentedReader::recordTime)
+		.def("findTime", &log::SegmentedReader::findTime)
+		.def("findTimeRange", &findTimeRange)
+		.def("readChannel", &readChannel<log::SegmentedReader>,
+				(arg("channel"), arg("first") = 0, arg("count") = object()))
+		.def("readChannels", &readChannels<log::SegmentedReader>,
+				(arg("first") = 0, arg("count") = object()))
+		.def("close", &log::SegmentedReader::close)
+	;
+}
@@ -0,0 +1,442 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file schema.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+
+#include <boost/cstdint.hpp>
+
+#include <barrett/log/schema.h>
+
+
+namespace barrett {
+namespace log {
+
+
+namespace {
+
+template<typename T> void put(std::vector<char>* buffer, T value)
+{
+	const char* p = reinterpret_cast<const char*>(&value);
+	buffer->insert(buffer->end(), p, p + sizeof(T));
+}
+
+void putString(std::vector<char>* buffer, const std::string& str)
+{
+	if (str.size() > std::numeric_limits<boost::uint16_t>::max()) {
+		throw std::logic_error("(log::Schema::serialize()): Field names and units must be shorter than 64 KB.");
+	}
+	put(buffer, static_cast<boost::uint16_t>(str.size()));
+	buffer->insert(buffer->end(), str.begin(), str.end());
+}
+
+// Reads from a bounds-checked region of memory.
+class Source {
+public:
+	Source(const char* begin_, size_t size) : begin(begin_), pos(begin_), end(begin_ + size) {}
+
+	template<typename T> T get() {
+		T value;
+		std::memcpy(&value, take(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	std::string getString() {
+		size_t n = get<boost::uint16_t>();
+		return std::string(take(n), n);
+	}
+
+	size_t consumed() const {  return pos - begin;  }
+
+private:
+	const char* take(size_t n) {
+		if (static_cast<size_t>(end - pos) < n) {
+			throw std::runtime_error("(log::Schema::unserialize()): The schema is truncated.");
+		}
+		const char* p = pos;
+		pos += n;
+		return p;
+	}
+
+	const char* begin;
+	const char* pos;
+	const char* end;
+};
+
+bool isValidType(char c)
+{
+	switch (c) {
+	case Schema::OPAQUE:
+	case Schema::BOOL:
+	case Schema::INT8:
+	case Schema::UINT8:
+	case Schema::INT16:
+	case Schema::UINT16:
+	case Schema::INT32:
+	case Schema::UINT32:
+	case Schema::INT64:
+	case Schema::UINT64:
+	case Schema::FLOAT32:
+	case Schema::FLOAT64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+}
+
+
+Schema::Schema(double samplePeriod_) :
+	samplePeriod(samplePeriod_), fields(), channels(), length(0)
+{
+}
+
+void Schema::addField(const std::string& name, ScalarType type, size_t elementSize,
+		size_t rows, size_t cols, const std::string& units)
+{
+	if (elementSize == 0  ||  rows == 0  ||  cols == 0) {
+		throw std::logic_error("(log::Schema::addField()): Fields can't be empty.");
+	}
+	if (type != OPAQUE  &&  elementSize != scalarSize(type)) {
+		throw std::logic_error("(log::Schema::addField()): elementSize doesn't match the type.");
+	}
+
+	Field f;
+	f.name = name;
+	f.type = type;
+	f.elementSize = elementSize;
+	f.rows = rows;
+	f.cols = cols;
+	f.units = units;
+	f.offset = 0;
+	f.firstChannel = 0;
+	fields.push_back(f);
+
+	updateLayout();
+}
+
+void Schema::groupFields(size_t first, const std::string& name, size_t rows, size_t cols)
+{
+	if (first >= fields.size()  ||  fields.size() - first != rows * cols) {
+		return;
+	}
+	for (size_t i = first; i < fields.size(); ++i) {
+		const Field& f = fields[i];
+		if (f.numElements() != 1  ||  f.type == OPAQUE  ||  f.type != fields[first].type  ||  f.units != fields[first].units) {
+			return;
+		}
+	}
+
+	Field f = fields[first];
+	f.name = name;
+	f.rows = rows;
+	f.cols = cols;
+	fields.resize(first);
+	fields.push_back(f);
+
+	updateLayout();
+}
+
+std::string Schema::elementName(const std::string& names, size_t index)
+{
+	std::stringstream ss;
+	if (names.find(',') != std::string::npos) {
+		size_t begin = 0;
+		for (size_t i = 0; i < index  &&  begin != std::string::npos; ++i) {
+			begin = names.find(',', begin);
+			if (begin != std::string::npos) {
+				++begin;
+			}
+		}
+		if (begin != std::string::npos) {
+			std::string name = names.substr(begin, names.find(',', begin) - begin);
+			if ( !name.empty() ) {
+				return name;
+			}
+		}
+		ss << "field" << index;
+	} else if (names.empty()) {
+		ss << "field" << index;
+	} else {
+		ss << names << "." << index;
+	}
+	return ss.str();
+}
+
+Schema Schema::fromFormat(const std::string& format, const std::string& fieldNames, double samplePeriod)
+{
+	Schema schema(samplePeriod);
+	const char* p = format.c_str();
+	while (*p != '\0') {
+		size_t count = 1;
+		if (*p >= '0'  &&  *p <= '9') {
+			char* end;
+			count = std::strtoul(p, &end, 10);
+			p = end;
+		}
+
+		ScalarType type = static_cast<ScalarType>(*p);
+		size_t size = scalarSize(type);
+		if (*p == '\0'  ||  size == 0  ||  count == 0) {
+			throw(std::runtime_error("(log::Schema::fromFormat()): Invalid format: '" + format + "'."));
+		}
+		schema.addField(elementName(fieldNames, schema.numFields()), type, size, count);
+		++p;
+	}
+
+	if (schema.numFields() == 0) {
+		throw(std::runtime_error("(log::Schema::fromFormat()): The format is empty."));
+	}
+	return schema;
+}
+
+size_t Schema::findField(const std::string& name) const
+{
+	for (size_t i = 0; i < fields.size(); ++i) {
+		if (fields[i].name == name) {
+			return i;
+		}
+	}
+	throw std::out_of_range("(log::Schema::findField()): There is no field called '" + name + "'.");
+}
+
+std::string Schema::channelName(size_t i) const
+{
+	const Channel& c = channels.at(i);
+	const Field& f = fields[c.field];
+	if (f.numElements() == 1) {
+		return f.name;
+	}
+
+	std::stringstream ss;
+	ss << f.name << "[" << c.element << "]";
+	return ss.str();
+}
+
+size_t Schema::findChannel(const std::string& name) const
+{
+	size_t bracket = name.rfind('[');
+	if (bracket != std::string::npos  &&  bracket > 0  &&  name[name.size() - 1] == ']') {
+		std::stringstream ss(name.substr(bracket + 1, name.size() - bracket - 2));
+		size_t element;
+		if ((ss >> element)  &&  ss.eof()) {
+			size_t i = findField(name.substr(0, bracket));
+			if (element < fields[i].numElements()) {
+				return fields[i].firstChannel + element;
+			}
+			throw std::out_of_range("(log::Schema::findChannel()): The index in '" + name + "' is out of range.");
+		}
+	}
+
+	size_t i = findField(name);
+	if (fields[i].numElements() != 1) {
+		throw std::out_of_range("(log::Schema::findChannel()): The field '" + name + "' has more than one element. Give an index (e.g. '" + name + "[0]').");
+	}
+	return fields[i].firstChannel;
+}
+
+void Schema::serialize(std::vector<char>* buffer) const
+{
+	put(buffer, static_cast<boost::uint32_t>(fields.size()));
+	put(buffer, samplePeriod);
+	for (size_t i = 0; i < fields.size(); ++i) {
+		const Field& f = fields[i];
+		putString(buffer, f.name);
+		put(buffer, static_cast<char>(f.type));
+		put(buffer, static_cast<boost::uint32_t>(f.elementSize));
+		put(buffer, static_cast<boost::uint32_t>(f.rows));
+		put(buffer, static_cast<boost::uint32_t>(f.cols));
+		putString(buffer, f.units);
+	}
+}
+
+size_t Schema::unserialize(const char* source, size_t size)
+{
+	Source s(source, size);
+
+	size_t n = s.get<boost::uint32_t>();
+	double sp = s.get<double>();
+
+	std::vector<Field> fs;
+	for (size_t i = 0; i < n; ++i) {
+		Field f;
+		f.name = s.getString();
+		char type = s.get<char>();
+		f.elementSize = s.get<boost::uint32_t>();
+		f.rows = s.get<boost::uint32_t>();
+		f.cols = s.get<boost::uint32_t>();
+		f.units = s.getString();
+		f.offset = 0;
+		f.firstChannel = 0;
+
+		if ( !isValidType(type)  ||  f.elementSize == 0  ||  f.rows == 0  ||  f.cols == 0
+				||  (type != OPAQUE  &&  f.elementSize != scalarSize(static_cast<ScalarType>(type))) ) {
+			throw std::runtime_error("(log::Schema::unserialize()): The schema is corrupt.");
+		}
+		f.type = static_cast<ScalarType>(type);
+		fs.push_back(f);
+	}
+
+	samplePeriod = sp;
+	fields.swap(fs);
+	updateLayout();
+
+	return s.consumed();
+}
+
+bool Schema::operator== (const Schema& other) const
+{
+	if (samplePeriod != other.samplePeriod  ||  fields.size() != other.fields.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < fields.size(); ++i) {
+		const Field& a = fields[i];
+		const Field& b = other.fields[i];
+		if (a.name != b.name  ||  a.type != b.type  ||  a.elementSize != b.elementSize
+				||  a.rows != b.rows  ||  a.cols != b.cols  ||  a.units != b.units) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Schema::ScalarType Schema::integerType(bool isSigned, size_t size)
+{
+	switch (size) {
+	case 1:
+		return isSigned ? INT8 : UINT8;
+	case 2:
+		return isSigned ? INT16 : UINT16;
+	case 4:
+		return isSigned ? INT32 : UINT32;
+	case 8:
+		return isSigned ? INT64 : UINT64;
+	default:
+		return OPAQUE;
+	}
+}
+
+size_t Schema::scalarSize(ScalarType type)
+{
+	switch (type) {
+	case BOOL:
+		return sizeof(bool);
+	case INT8:
+	case UINT8:
+		return 1;
+	case INT16:
+	case UINT16:
+		return 2;
+	case INT32:
+	case UINT32:
+	case FLOAT32:
+		return 4;
+	case INT64:
+	case UINT64:
+	case FLOAT64:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+namespace {
+template<typename T> double convert(const char* source)
+{
+	T value;
+	std::memcpy(&value, source, sizeof(T));
+	return static_cast<double>(value);
+}
+}
+
+double Schema::toDouble(ScalarType type, const char* source)
+{
+	switch (type) {
+	case BOOL:
+		return convert<bool>(source);
+	case INT8:
+		return convert<boost::int8_t>(source);
+	case UINT8:
+		return convert<boost::uint8_t>(source);
+	case INT16:
+		return convert<boost::int16_t>(source);
+	case UINT16:
+		return convert<boost::uint16_t>(source);
+	case INT32:
+		return convert<boost::int32_t>(source);
+	case UINT32:
+		return convert<boost::uint32_t>(source);
+	case INT64:
+		return convert<boost::int64_t>(source);
+	case UINT64:
+		return convert<boost::uint64_t>(source);
+	case FLOAT32:
+		return convert<float>(source);
+	case FLOAT64:
+		return convert<double>(source);
+	default:
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+}
+
+void Schema::updateLayout()
+{
+	channels.clear();
+	length = 0;
+	for (size_t i = 0; i < fields.size(); ++i) {
+		Field& f = fields[i];
+		f.offset = length;
+		f.firstChannel = channels.size();
+
+		for (size_t j = 0; j < f.numElements(); ++j) {
+			Channel c;
+			c.field = i;
+			c.element = j;
+			c.type = f.type;
+			c.size = f.elementSize;
+			c.offset = length;
+			channels.push_back(c);
+
+			length += f.elementSize;
+		}
+	}
+}
+
+
+}
+}
@@ -0,0 +1,235 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file segmented_format.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/segmented_writer.h>
+#include <barrett/log/detail/column_format.h>
+#include <barrett/log/detail/segmented_format.h>
+
+
+namespace barrett {
+namespace log {
+namespace detail {
+
+
+BOOST_STATIC_ASSERT(sizeof(SegmentIndexEntry) == SEGMENT_INDEX_ENTRY_LENGTH);
+
+
+namespace {
+bool writeAll(int fd, const char* data, size_t length)
+{
+	while (length != 0) {
+		ssize_t n = ::write(fd, data, length);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += n;
+		length -= n;
+	}
+	return true;
+}
+}
+
+
+std::string segmentFileName(const std::string& baseName, size_t segment)
+{
+	char suffix[32];
+	std::snprintf(suffix, sizeof(suffix), ".%06lu.log", static_cast<unsigned long>(segment));
+	return baseName + suffix;
+}
+
+std::string segmentIndexFileName(const std::string& baseName)
+{
+	return baseName + ".index";
+}
+
+
+SegmentedLogFiles::SegmentedLogFiles(const std::string& baseName_, const Schema& schema, const SegmentOptions& options, size_t maxRecords) :
+	baseName(baseName_), timeChannel(-1), recordLength(schema.recordLength()),
+	maxSegmentBytes(options.maxSegmentBytes), maxSegmentDuration(options.maxSegmentDuration),
+	encoder(schema, options.columnOptions, maxRecords), header(),
+	indexFd(-1), segmentFd(-1), segment(0), segmentBytes(0), segmentBlocks(0), segmentStartTime(0.0), recordCount(0)
+{
+	if (options.timeChannel.empty()) {
+		if (schema.getSamplePeriod() <= 0.0) {
+			throw(std::logic_error("(log::detail::SegmentedLogFiles::SegmentedLogFiles()): The sample period is unknown, "
+					"so the records must be timed by a channel (see SegmentOptions::timeChannel)."));
+		}
+	} else {
+		size_t c = schema.findChannel(options.timeChannel);
+		if (schema.channel(c).type == Schema::OPAQUE) {
+			throw(std::logic_error("(log::detail::SegmentedLogFiles::SegmentedLogFiles()): The time channel '" +
+					options.timeChannel + "' is not a number."));
+		}
+		timeChannel = static_cast<int>(c);
+	}
+	encoder.writeHeader(&header);
+
+	std::string indexName = segmentIndexFileName(baseName);
+	indexFd = open(indexName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (indexFd == -1) {
+		throw(std::runtime_error("(log::detail::SegmentedLogFiles::SegmentedLogFiles()): Couldn't create the file '" + indexName + "'."));
+	}
+
+	char indexHeader[SEGMENT_INDEX_HEADER_LENGTH];
+	boost::uint32_t version = SEGMENT_INDEX_VERSION;
+	boost::int32_t tc = timeChannel;
+	std::memcpy(indexHeader, SEGMENT_INDEX_MAGIC, SEGMENT_INDEX_MAGIC_LENGTH);
+	std::memcpy(indexHeader + 8, &version, sizeof(version));
+	std::memcpy(indexHeader + 12, &tc, sizeof(tc));
+
+	openSegment();
+	if ( !writeAll(indexFd, indexHeader, sizeof(indexHeader))  ||  segmentFd == -1) {
+		close();
+		throw(std::runtime_error("(log::detail::SegmentedLogFiles::SegmentedLogFiles()): Couldn't start the log '" + baseName + "'."));
+	}
+}
+
+SegmentedLogFiles::~SegmentedLogFiles()
+{
+	close();
+}
+
+void SegmentedLogFiles::writeBlock(const char* rows, size_t n)
+{
+	if (n == 0) {
+		return;
+	}
+
+	double firstTime = recordTime(rows, recordCount);
+	double lastTime = recordTime(rows + (n - 1) * recordLength, recordCount + n - 1);
+
+	// Segments only end at block boundaries. If the last write failed, try a new segment.
+	bool full = (maxSegmentBytes != 0  &&  segmentBytes >= maxSegmentBytes)  ||
+			(maxSegmentDuration > 0.0  &&  firstTime - segmentStartTime >= maxSegmentDuration);
+	if (segmentFd == -1  ||  (segmentBlocks != 0  &&  full)) {
+		closeSegment();
+		if (segmentBlocks != 0) {
+			++segment;
+		}
+		openSegment();
+		if (segmentFd == -1) {
+			return;  // The records are lost
+		}
+	}
+	if (segmentBlocks == 0) {
+		segmentStartTime = firstTime;
+	}
+
+	size_t length = encoder.encode(rows, n);
+	if ( !writeAll(segmentFd, encoder.data(), length)) {
+		::close(segmentFd);
+		segmentFd = -1;
+		return;
+	}
+
+	SegmentIndexEntry entry;
+	entry.segment = segment;
+	entry.numRecords = n;
+	entry.offset = segmentBytes;
+	entry.firstRecord = recordCount;
+	entry.firstTime = firstTime;
+	entry.lastTime = lastTime;
+	writeAll(indexFd, reinterpret_cast<const char*>(&entry), SEGMENT_INDEX_ENTRY_LENGTH);
+
+	segmentBytes += length;
+	++segmentBlocks;
+	recordCount += n;
+}
+
+void SegmentedLogFiles::close()
+{
+	closeSegment();
+	if (indexFd != -1) {
+		::close(indexFd);
+		indexFd = -1;
+	}
+}
+
+double SegmentedLogFiles::recordTime(const char* row, boost::uint64_t record) const
+{
+	if (timeChannel < 0) {
+		return record * getSchema().getSamplePeriod();
+	}
+	const Schema::Channel& c = getSchema().channel(timeChannel);
+	return Schema::toDouble(c.type, row + c.offset);
+}
+
+void SegmentedLogFiles::openSegment()
+{
+	segmentBytes = 0;
+	segmentBlocks = 0;
+
+	std::string fileName = segmentFileName(baseName, segment);
+	segmentFd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (segmentFd != -1  &&  !writeAll(segmentFd, &header[0], header.size())) {
+		::close(segmentFd);
+		segmentFd = -1;
+	}
+	segmentBytes = header.size();
+}
+
+void SegmentedLogFiles::closeSegment()
+{
+	// The segment must reach the disk before any entry that refers to the next one.
+	if (segmentFd != -1) {
+		fdatasync(segmentFd);
+		::close(segmentFd);
+		segmentFd = -1;
+	}
+	if (indexFd != -1) {
+		fdatasync(indexFd);
+	}
+}
+
+
+}
+}
+}
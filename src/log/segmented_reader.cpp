@@ -0,0 +1,276 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file segmented_reader.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/segmented_reader.h>
+#include <barrett/log/detail/segmented_format.h>
+
+
+namespace barrett {
+namespace log {
+
+
+SegmentedReader::SegmentedReader(const char* baseName_) :
+	baseName(baseName_), timeChannel(-1), entries(), segments(), recordCount(0),
+	schema(), row(), times()
+{
+	std::string indexName = detail::segmentIndexFileName(baseName);
+	std::ifstream ifs(indexName.c_str(), std::ios_base::binary);
+	if ( !ifs) {
+		throw(std::runtime_error("(log::SegmentedReader::SegmentedReader()): Couldn't open the file '" + indexName + "'."));
+	}
+
+	char header[detail::SEGMENT_INDEX_HEADER_LENGTH];
+	if ( !ifs.read(header, sizeof(header))  ||
+			std::memcmp(header, detail::SEGMENT_INDEX_MAGIC, detail::SEGMENT_INDEX_MAGIC_LENGTH) != 0) {
+		throw(std::runtime_error("(log::SegmentedReader::SegmentedReader()): The file '" + indexName + "' is not a segmented log index."));
+	}
+	boost::uint32_t version;
+	boost::int32_t tc;
+	std::memcpy(&version, header + 8, sizeof(version));
+	std::memcpy(&tc, header + 12, sizeof(tc));
+	if (version != detail::SEGMENT_INDEX_VERSION) {
+		throw(std::runtime_error("(log::SegmentedReader::SegmentedReader()): The file '" + indexName +
+				"' uses an unsupported version of the segmented log format."));
+	}
+	timeChannel = tc;
+
+	// Stop at a truncated entry, or at anything that doesn't follow on from the previous one.
+	detail::SegmentIndexEntry e;
+	while (ifs.read(reinterpret_cast<char*>(&e), detail::SEGMENT_INDEX_ENTRY_LENGTH)) {
+		if (e.numRecords == 0  ||  e.firstRecord != recordCount  ||
+				(!entries.empty()  &&  e.segment < entries.back().segment)) {
+			break;
+		}
+
+		if (e.segment >= segments.size()) {
+			Segment s = { recordCount, 0, NULL };
+			segments.resize(e.segment + 1, s);
+		}
+		segments[e.segment].numRecords += e.numRecords;
+		entries.push_back(e);
+		recordCount += e.numRecords;
+	}
+	if (segments.empty()) {
+		Segment s = { 0, 0, NULL };
+		segments.push_back(s);
+	}
+
+	// Only the last segment can be missing blocks that made it into the
+	// index; the others were synced before it was started.
+	const size_t lastSegment = segments.size() - 1;
+	Segment& last = segments.back();
+	try {
+		last.reader = new ColumnReader(detail::segmentFileName(baseName, lastSegment).c_str());
+	} catch (const std::runtime_error&) {
+		if (lastSegment == 0) {
+			throw;
+		}
+	}
+	size_t available = (last.reader == NULL) ? 0 : last.reader->numRecords();
+	while ( !entries.empty()  &&  entries.back().segment == lastSegment  &&  last.numRecords > available) {
+		last.numRecords -= entries.back().numRecords;
+		recordCount -= entries.back().numRecords;
+		entries.pop_back();
+	}
+
+	// Every segment has the same schema.
+	try {
+		schema = segmentReader(entries.empty() ? lastSegment : entries.front().segment).getSchema();
+	} catch (...) {
+		close();
+		throw;
+	}
+	if (timeChannel >= static_cast<int>(schema.numChannels())) {
+		close();
+		throw(std::runtime_error("(log::SegmentedReader::SegmentedReader()): The file '" + indexName + "' is corrupted."));
+	}
+	row.resize(schema.recordLength());
+}
+
+SegmentedReader::~SegmentedReader()
+{
+	close();
+}
+
+double SegmentedReader::recordTime(size_t i) const
+{
+	if (i >= recordCount) {
+		throw(std::out_of_range("(log::SegmentedReader::recordTime()): That record isn't in the log."));
+	}
+	if (timeChannel < 0) {
+		return static_cast<double>(i) * schema.getSamplePeriod();
+	}
+
+	const detail::SegmentIndexEntry& e = findEntry(i);
+	times.clear();
+	segmentReader(e.segment).readChannel(timeChannel, &times, i - segments[e.segment].firstRecord, 1);
+	return times[0];
+}
+
+size_t SegmentedReader::findTime(double t) const
+{
+	// The first block that ends at or after t
+	size_t lo = 0, hi = entries.size();
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (entries[mid].lastTime < t) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo == entries.size()) {
+		return recordCount;
+	}
+
+	const detail::SegmentIndexEntry& e = entries[lo];
+	if (e.firstTime >= t) {
+		return e.firstRecord;
+	}
+	blockTimes(e, &times);
+	return e.firstRecord + (std::lower_bound(times.begin(), times.end(), t) - times.begin());
+}
+
+void SegmentedReader::findTimeRange(double t0, double t1, size_t* first, size_t* count) const
+{
+	*first = findTime(t0);
+	size_t end = (t1 > t0) ? findTime(t1) : *first;
+	*count = end - *first;
+}
+
+void SegmentedReader::readChannel(size_t channel, std::vector<double>* dest, size_t first, size_t count) const
+{
+	if (first > recordCount  ||  count > recordCount - first) {
+		throw(std::out_of_range("(log::SegmentedReader::readChannel()): Those records aren't in the log."));
+	}
+	if (count == 0) {
+		return;
+	}
+
+	const size_t oldSize = dest->size();
+	dest->resize(oldSize + count);
+	readChannel(channel, &(*dest)[oldSize], first, count);
+}
+
+void SegmentedReader::readChannel(size_t channel, double* dest, size_t first, size_t count) const
+{
+	if (first > recordCount  ||  count > recordCount - first) {
+		throw(std::out_of_range("(log::SegmentedReader::readChannel()): Those records aren't in the log."));
+	}
+
+	const size_t end = first + count;
+	while (first < end) {
+		const Segment& s = segments[findEntry(first).segment];
+		size_t n = std::min(end, s.firstRecord + s.numRecords) - first;
+		segmentReader(&s - &segments[0]).readChannel(channel, dest, first - s.firstRecord, n);
+		dest += n;
+		first += n;
+	}
+}
+
+void SegmentedReader::readRecord(size_t i, char* dest) const
+{
+	if (i >= recordCount) {
+		throw(std::out_of_range("(log::SegmentedReader::readRecord()): That record isn't in the log."));
+	}
+
+	const detail::SegmentIndexEntry& e = findEntry(i);
+	segmentReader(e.segment).readRecord(i - segments[e.segment].firstRecord, dest);
+}
+
+void SegmentedReader::close()
+{
+	for (size_t i = 0; i < segments.size(); ++i) {
+		delete segments[i].reader;
+	}
+	segments.clear();
+	entries.clear();
+	recordCount = 0;
+}
+
+const detail::SegmentIndexEntry& SegmentedReader::findEntry(size_t record) const
+{
+	size_t lo = 0, hi = entries.size();
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+		if (entries[mid].firstRecord <= record) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	return entries[lo];
+}
+
+const ColumnReader& SegmentedReader::segmentReader(size_t s) const
+{
+	Segment& seg = segments[s];
+	if (seg.reader == NULL) {
+		std::string fileName = detail::segmentFileName(baseName, s);
+		seg.reader = new ColumnReader(fileName.c_str());
+		if (seg.reader->numRecords() < seg.numRecords  ||
+				(schema.numFields() != 0  &&  seg.reader->getSchema() != schema)) {
+			delete seg.reader;
+			seg.reader = NULL;
+			throw(std::runtime_error("(log::SegmentedReader::segmentReader()): The segment '" + fileName +
+					"' doesn't match the index."));
+		}
+	}
+	return *seg.reader;
+}
+
+void SegmentedReader::blockTimes(const detail::SegmentIndexEntry& e, std::vector<double>* dest) const
+{
+	dest->clear();
+	if (timeChannel < 0) {
+		for (size_t i = 0; i < e.numRecords; ++i) {
+			dest->push_back(static_cast<double>(e.firstRecord + i) * schema.getSamplePeriod());
+		}
+	} else {
+		segmentReader(e.segment).readChannel(timeChannel, dest, e.firstRecord - segments[e.segment].firstRecord, e.numRecords);
+	}
+}
+
+
+}
+}
@@ -0,0 +1,158 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file task_pool.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+#include <barrett/log/detail/task_pool.h>
+
+
+namespace barrett {
+namespace log {
+namespace detail {
+
+
+TaskPool::TaskPool(size_t numThreads) :
+	task(), numTasks(0), nextTask(0), unfinished(0), generation(0), stopping(false), error()
+{
+	if (numThreads == 0) {
+		numThreads = std::max(1u, boost::thread::hardware_concurrency());
+	}
+	for (size_t i = 1; i < numThreads; ++i) {
+		workers.create_thread(boost::bind(&TaskPool::workerEntryPoint, this));
+	}
+}
+
+TaskPool::~TaskPool()
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		stopping = true;
+		nextTask = numTasks;  // Skips whatever a failed caller didn't wait() for
+	}
+	cond.notify_all();
+	workers.join_all();
+}
+
+void TaskPool::start(const boost::function<void (size_t)>& f, size_t n)
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		task = f;
+		numTasks = n;
+		nextTask = 0;
+		unfinished = n;
+		error = boost::exception_ptr();
+		++generation;
+	}
+	cond.notify_all();
+}
+
+void TaskPool::wait()
+{
+	work();
+
+	boost::exception_ptr e;
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		while (unfinished != 0) {
+			done.wait(lock);
+		}
+		e = error;
+		error = boost::exception_ptr();
+	}
+	if (e) {
+		boost::rethrow_exception(e);
+	}
+}
+
+void TaskPool::workerEntryPoint()
+{
+	size_t seen = 0;
+	for (;;) {
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			while (generation == seen  &&  !stopping) {
+				cond.wait(lock);
+			}
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+		work();
+	}
+}
+
+void TaskPool::work()
+{
+	for (;;) {
+		size_t i;
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			if (nextTask >= numTasks) {
+				return;
+			}
+			i = nextTask++;
+		}
+
+		boost::exception_ptr e;
+		try {
+			task(i);
+		} catch (...) {
+			e = boost::current_exception();
+		}
+
+		boost::unique_lock<boost::mutex> lock(mutex);
+		--unfinished;
+		if (e) {
+			if ( !error ) {
+				error = e;
+			}
+			// Skip the tasks that haven't started.
+			unfinished -= numTasks - nextTask;
+			nextTask = numTasks;
+		}
+		if (unfinished == 0) {
+			done.notify_all();
+		}
+	}
+}
+
+
+}
+}
+}
@@ -0,0 +1,432 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file telemetry.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <new>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/telemetry.h>
+
+
+namespace barrett {
+namespace log {
+
+
+namespace detail {
+
+// See the layout in telemetry.h.
+struct TelemetryHeader {
+	char magic[8];
+	boost::uint32_t version;
+	boost::uint32_t headerLength;
+	boost::uint32_t schemaLength;
+	boost::uint32_t recordLength;
+	boost::uint32_t slotLength;
+	boost::uint32_t capacity;
+	boost::atomic<boost::uint64_t> samplePeriod;  // The bits of a double. It can change while readers are attached.
+	boost::atomic<boost::uint64_t> writeCount;
+	boost::atomic<boost::uint32_t> open;
+	boost::uint32_t reserved[3];
+};
+
+}
+
+
+namespace {
+
+using detail::TelemetryHeader;
+
+const char MAGIC[8] = "BTTELEM";
+const boost::uint32_t VERSION = 2;
+const size_t HEADER_LENGTH = 64;
+const size_t SEQ_LENGTH = sizeof(boost::uint64_t);
+
+BOOST_STATIC_ASSERT(sizeof(TelemetryHeader) == HEADER_LENGTH);
+BOOST_STATIC_ASSERT(sizeof(boost::atomic<boost::uint64_t>) == sizeof(boost::uint64_t));
+
+std::string shmName(const std::string& name)
+{
+	if (name.empty()  ||  name[0] != '/') {
+		return "/" + name;
+	}
+	return name;
+}
+
+size_t roundUp(size_t n, size_t multiple)
+{
+	return (n + multiple - 1) / multiple * multiple;
+}
+
+inline boost::uint64_t doubleToBits(double d)
+{
+	boost::uint64_t bits;
+	std::memcpy(&bits, &d, sizeof(bits));
+	return bits;
+}
+inline double bitsToDouble(boost::uint64_t bits)
+{
+	double d;
+	std::memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+inline boost::atomic<boost::uint64_t>& seqOf(char* slot)
+{
+	return *reinterpret_cast<boost::atomic<boost::uint64_t>*>(slot);
+}
+inline const boost::atomic<boost::uint64_t>& seqOf(const char* slot)
+{
+	return *reinterpret_cast<const boost::atomic<boost::uint64_t>*>(slot);
+}
+
+}
+
+
+TelemetryRing::TelemetryRing(const std::string& name_, const Schema& schema_, size_t capacity_) :
+	name(shmName(name_)), schema(schema_), capacity(1), slotLength(0),
+	fd(-1), data(NULL), size(0), header(NULL), slots(NULL), count(0), slot(NULL)
+{
+	if (schema.recordLength() == 0) {
+		throw(std::logic_error("(log::TelemetryRing::TelemetryRing()): The schema is empty."));
+	}
+	if ( !boost::atomic<boost::uint64_t>().is_lock_free() ) {
+		throw(std::logic_error("(log::TelemetryRing::TelemetryRing()): 64-bit atomics are not lock-free on this platform."));
+	}
+	while (capacity < capacity_) {
+		capacity *= 2;
+	}
+
+	std::vector<char> schemaBytes;
+	schema.serialize(&schemaBytes);
+	size_t headerLength = roundUp(HEADER_LENGTH + schemaBytes.size(), HEADER_LENGTH);
+	slotLength = roundUp(SEQ_LENGTH + schema.recordLength(), SEQ_LENGTH);
+	size = headerLength + capacity * slotLength;
+
+	// Replace any segment left behind by a previous writer. Its readers keep
+	// their mapping of the old one.
+	shm_unlink(name.c_str());
+	fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd == -1) {
+		throw(std::runtime_error("(log::TelemetryRing::TelemetryRing()): Couldn't create the shared-memory segment '" + name + "': " + std::strerror(errno)));
+	}
+	void* p = MAP_FAILED;
+	if (ftruncate(fd, size) == 0) {
+		p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (p == MAP_FAILED) {
+		int error = errno;
+		::close(fd);
+		shm_unlink(name.c_str());
+		throw(std::runtime_error("(log::TelemetryRing::TelemetryRing()): Couldn't map the shared-memory segment '" + name + "': " + std::strerror(error)));
+	}
+	data = static_cast<char*>(p);
+
+	// Touch every page now so that writing never faults. Locking them is
+	// best-effort: it needs privileges that a user process might not have.
+	std::memset(data, 0, size);
+	mlock(data, size);
+
+	header = new (data) TelemetryHeader;
+	header->version = VERSION;
+	header->headerLength = headerLength;
+	header->schemaLength = schemaBytes.size();
+	header->recordLength = schema.recordLength();
+	header->slotLength = slotLength;
+	header->capacity = capacity;
+	header->samplePeriod.store(doubleToBits(schema.getSamplePeriod()), boost::memory_order_relaxed);
+	header->writeCount.store(0, boost::memory_order_relaxed);
+	header->open.store(1, boost::memory_order_relaxed);
+	std::memcpy(data + HEADER_LENGTH, &schemaBytes[0], schemaBytes.size());
+
+	slots = data + headerLength;
+	for (size_t i = 0; i < capacity; ++i) {
+		new (slots + i * slotLength) boost::atomic<boost::uint64_t>(0);
+	}
+
+	// Readers ignore the segment until the magic number appears.
+	boost::atomic_thread_fence(boost::memory_order_release);
+	std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+}
+
+TelemetryRing::~TelemetryRing()
+{
+	header->open.store(0, boost::memory_order_release);
+
+	// Only unlink the name if it still refers to our segment.
+	struct stat ours, current;
+	int currentFd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (currentFd != -1) {
+		if (fstat(fd, &ours) == 0  &&  fstat(currentFd, &current) == 0  &&  ours.st_ino == current.st_ino) {
+			shm_unlink(name.c_str());
+		}
+		::close(currentFd);
+	}
+
+	munmap(data, size);
+	::close(fd);
+}
+
+void TelemetryRing::setSamplePeriod(double samplePeriod)
+{
+	schema.setSamplePeriod(samplePeriod);
+	header->samplePeriod.store(doubleToBits(samplePeriod), boost::memory_order_relaxed);
+}
+
+char* TelemetryRing::beginWrite()
+{
+	slot = slots + (count & (capacity - 1)) * slotLength;
+	seqOf(slot).store(2 * count + 1, boost::memory_order_relaxed);
+	boost::atomic_thread_fence(boost::memory_order_release);
+	return slot + SEQ_LENGTH;
+}
+
+void TelemetryRing::endWrite()
+{
+	seqOf(slot).store(2 * count + 2, boost::memory_order_release);
+	++count;
+	header->writeCount.store(count, boost::memory_order_release);
+}
+
+void TelemetryRing::write(const char* record)
+{
+	std::memcpy(beginWrite(), record, schema.recordLength());
+	endWrite();
+}
+
+
+TelemetryReader::TelemetryReader() :
+	fd(-1), data(NULL), size(0), header(NULL), slots(NULL),
+	schema(), capacity(0), slotLength(0), next(0), numLost(0), buffer()
+{
+}
+
+TelemetryReader::TelemetryReader(const std::string& name) :
+	fd(-1), data(NULL), size(0), header(NULL), slots(NULL),
+	schema(), capacity(0), slotLength(0), next(0), numLost(0), buffer()
+{
+	if ( !attach(name) ) {
+		throw(std::runtime_error("(log::TelemetryReader::TelemetryReader()): There is no telemetry ring called '" + shmName(name) + "'."));
+	}
+}
+
+TelemetryReader::~TelemetryReader()
+{
+	detach();
+}
+
+bool TelemetryReader::attach(const std::string& name_)
+{
+	detach();
+
+	std::string name = shmName(name_);
+	fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd == -1) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0  ||  static_cast<size_t>(st.st_size) < HEADER_LENGTH) {
+		detach();
+		return false;  // Still being created
+	}
+	size = st.st_size;
+
+	void* p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED) {
+		size = 0;
+		detach();
+		throw(std::runtime_error("(log::TelemetryReader::attach()): Couldn't map the shared-memory segment '" + name + "'."));
+	}
+	data = static_cast<const char*>(p);
+	header = reinterpret_cast<const detail::TelemetryHeader*>(data);
+
+	if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+		detach();
+		return false;  // Still being created
+	}
+	boost::atomic_thread_fence(boost::memory_order_acquire);
+
+	try {
+		if (header->version != VERSION) {
+			throw(std::runtime_error("(log::TelemetryReader::attach()): The segment '" + name + "' uses an unsupported version of the telemetry format."));
+		}
+		capacity = header->capacity;
+		slotLength = header->slotLength;
+		if (capacity == 0  ||  (capacity & (capacity - 1)) != 0
+				||  header->headerLength < HEADER_LENGTH + header->schemaLength
+				||  size < header->headerLength + capacity * slotLength
+				||  schema.unserialize(data + HEADER_LENGTH, header->schemaLength) != header->schemaLength
+				||  schema.recordLength() != header->recordLength
+				||  slotLength < SEQ_LENGTH + schema.recordLength()) {
+			throw(std::runtime_error("(log::TelemetryReader::attach()): The segment '" + name + "' is not a valid telemetry ring."));
+		}
+	} catch (...) {
+		detach();
+		throw;
+	}
+	slots = data + header->headerLength;
+
+	next = writeCount();
+	numLost = 0;
+	return true;
+}
+
+void TelemetryReader::detach()
+{
+	if (data != NULL) {
+		munmap(const_cast<char*>(data), size);
+		data = NULL;
+	}
+	if (fd != -1) {
+		::close(fd);
+		fd = -1;
+	}
+	header = NULL;
+	slots = NULL;
+	size = 0;
+	capacity = 0;
+	slotLength = 0;
+	schema = Schema();
+}
+
+bool TelemetryReader::isPublisherOpen() const
+{
+	return isAttached()  &&  header->open.load(boost::memory_order_acquire) != 0;
+}
+
+Schema TelemetryReader::getSchema() const
+{
+	Schema s(schema);
+	if (isAttached()) {
+		s.setSamplePeriod(bitsToDouble(header->samplePeriod.load(boost::memory_order_relaxed)));
+	}
+	return s;
+}
+
+size_t TelemetryReader::numAvailable() const
+{
+	if ( !isAttached() ) {
+		return 0;
+	}
+	boost::uint64_t n = writeCount() - next;
+	return n < capacity ? n : capacity;
+}
+
+bool TelemetryReader::read(char* dest)
+{
+	if ( !isAttached() ) {
+		return false;
+	}
+
+	while (true) {
+		boost::uint64_t written = writeCount();
+		if (next >= written) {
+			return false;
+		}
+		if (written - next > capacity) {
+			numLost += written - next - capacity;
+			next = written - capacity;
+		}
+
+		if (copyRecord(next, dest)) {
+			++next;
+			return true;
+		}
+
+		// The writer lapped us while we were copying. Skip to the middle of
+		// the ring so there's room to catch up.
+		written = writeCount();
+		boost::uint64_t resume = written - capacity / 2;
+		if (written > capacity / 2  &&  resume > next) {
+			numLost += resume - next;
+			next = resume;
+		} else {
+			numLost += 1;
+			next += 1;
+		}
+	}
+}
+
+bool TelemetryReader::readLatest(char* dest)
+{
+	if ( !isAttached() ) {
+		return false;
+	}
+
+	while (true) {
+		boost::uint64_t written = writeCount();
+		if (next >= written) {
+			return false;
+		}
+		if (copyRecord(written - 1, dest)) {
+			// Records skipped on purpose aren't lost.
+			next = written;
+			return true;
+		}
+	}
+}
+
+boost::uint64_t TelemetryReader::writeCount() const
+{
+	return header->writeCount.load(boost::memory_order_acquire);
+}
+
+bool TelemetryReader::copyRecord(boost::uint64_t n, char* dest) const
+{
+	const char* slot = slots + (n & (capacity - 1)) * slotLength;
+	const boost::uint64_t expected = 2 * n + 2;
+
+	if (seqOf(slot).load(boost::memory_order_acquire) != expected) {
+		return false;
+	}
+	std::memcpy(dest, slot + SEQ_LENGTH, schema.recordLength());
+	boost::atomic_thread_fence(boost::memory_order_acquire);
+	return seqOf(slot).load(boost::memory_order_relaxed) == expected;
+}
+
+
+}
+}
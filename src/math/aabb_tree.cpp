@@ -0,0 +1,135 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file aabb_tree.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <algorithm>
+#include <cassert>
+
+#include <barrett/math/aabb_tree.h>
+
+
+namespace barrett {
+namespace math {
+
+
+const size_t AabbTree::NONE;
+const size_t AabbTree::MAX_LEAF_SIZE;
+const size_t AabbTree::MAX_DEPTH;
+
+
+namespace {
+struct CentroidLess {
+	CentroidLess(const AabbTree::box_vector& b, int a) : boxes(b), axis(a) {}
+
+	bool operator() (size_t i, size_t j) const {
+		return boxes[i].center()[axis] < boxes[j].center()[axis];
+	}
+
+	const AabbTree::box_vector& boxes;
+	int axis;
+};
+}
+
+
+void AabbTree::build(const box_vector& newBoxes)
+{
+	clear();
+
+	boxes = newBoxes;
+	if (boxes.empty()) {
+		return;
+	}
+
+	items.resize(boxes.size());
+	for (size_t i = 0; i < items.size(); ++i) {
+		items[i] = i;
+	}
+
+	// A binary tree with at most MAX_LEAF_SIZE items per leaf
+	nodes.reserve(2 * boxes.size());
+	buildNode(0, items.size(), 0);
+}
+
+void AabbTree::clear()
+{
+	boxes.clear();
+	nodes.clear();
+	items.clear();
+}
+
+void AabbTree::swap(AabbTree& other)
+{
+	boxes.swap(other.boxes);
+	nodes.swap(other.nodes);
+	items.swap(other.items);
+}
+
+size_t AabbTree::buildNode(size_t first, size_t count, size_t depth)
+{
+	const size_t index = nodes.size();
+	nodes.push_back(Node());
+
+	box_type box, centroids;
+	box.setEmpty();
+	centroids.setEmpty();
+	for (size_t i = first; i < first + count; ++i) {
+		box.extend(boxes[items[i]]);
+		centroids.extend(boxes[items[i]].center());
+	}
+	nodes[index].box = box;
+
+	if (count <= MAX_LEAF_SIZE  ||  depth >= MAX_DEPTH - 1) {
+		nodes[index].left = nodes[index].right = NONE;
+		nodes[index].first = first;
+		nodes[index].count = count;
+		return index;
+	}
+
+	// Median split along the longest axis of the centroids
+	int axis;
+	centroids.sizes().maxCoeff(&axis);
+	const size_t half = count / 2;
+	std::nth_element(items.begin() + first, items.begin() + first + half,
+			items.begin() + first + count, CentroidLess(boxes, axis));
+
+	// (Recursion may reallocate nodes, so don't hold a reference across it.)
+	size_t left = buildNode(first, half, depth + 1);
+	size_t right = buildNode(first + half, count - half, depth + 1);
+	nodes[index].left = left;
+	nodes[index].right = right;
+	nodes[index].first = first;
+	nodes[index].count = count;
+	return index;
+}
+
+
+}
+}
@@ -0,0 +1,297 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file jerk_limited_profile.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <cmath>
+#include <cassert>
+
+#include <barrett/math/utils.h>
+#include <barrett/math/jerk_limited_profile.h>
+
+
+namespace barrett {
+namespace math {
+
+
+namespace {
+// Enough to shrink any bracket to the resolution of a double.
+const int NUM_BISECTIONS = 64;
+}
+
+
+JerkLimitedProfile::JerkLimitedProfile(double p) :
+	p0(p), v0(0.0), a0(0.0), pf(p), vMax(1.0), aMax(1.0), jMax(1.0),
+	dir(0.0), vPeak(0.0), phases(), tStart(), pStart(), vStart(), aStart(), tf(0.0)
+{
+	build(0.0, 0.0, &phases);
+	setPhases(phases);
+}
+
+void JerkLimitedProfile::plan(double p0_, double v0_, double a0_, double pf_, double vMax_, double aMax_, double jMax_)
+{
+	assert(vMax_ > 0.0  &&  aMax_ > 0.0  &&  jMax_ > 0.0);
+
+	p0 = p0_;
+	v0 = v0_;
+	a0 = a0_;
+	pf = pf_;
+	vMax = vMax_;
+	aMax = aMax_;
+	jMax = jMax_;
+
+	phase_array ph;
+
+	// Where would we end up if we just stopped?
+	build(0.0, 0.0, &ph);
+	const double remaining = (pf - p0) - distance(ph);
+	if (std::abs(remaining) <= 1e-12 * math::max(1.0, std::abs(pf - p0))) {
+		dir = 0.0;
+		vPeak = 0.0;
+		setPhases(ph);
+		return;
+	}
+	dir = math::sign(remaining);
+
+	// Is there time to cruise at full speed?
+	double tc = cruiseTime(dir * vMax);
+	if (tc >= 0.0) {
+		vPeak = vMax;
+		build(dir * vPeak, tc, &ph);
+		setPhases(ph);
+		return;
+	}
+
+	// Find the peak that lands on pf without cruising. The distance covered
+	// grows with the peak velocity from the current speed up, but not below
+	// it: slowing down and then stopping can cover more ground than stopping
+	// right away. So if there is room to cruise at the current speed, no
+	// slower peak can be faster and the search starts there. Otherwise it
+	// starts at 0.0, where the move just stops and falls short.
+	double lo = 0.0, hi = vMax;
+	const double speed = dir * v0;
+	if (speed > 0.0  &&  speed < vMax  &&  cruiseTime(dir * speed) >= 0.0) {
+		lo = speed;
+	}
+	for (int i = 0; i < NUM_BISECTIONS; ++i) {
+		double mid = 0.5 * (lo + hi);
+		build(dir * mid, 0.0, &ph);
+		if (dir * (distance(ph) - (pf - p0)) < 0.0) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	// Make up the shortfall by cruising.
+	if (lo > 0.0) {
+		vPeak = lo;
+		tc = math::max(0.0, cruiseTime(dir * vPeak));
+	} else {
+		vPeak = hi;
+		tc = 0.0;
+	}
+	build(dir * vPeak, tc, &ph);
+	setPhases(ph);
+}
+
+bool JerkLimitedProfile::stretch(double T)
+{
+	if (T < tf) {
+		return false;
+	} else if (T == tf) {
+		return true;
+	} else if (dir == 0.0) {
+		return false;
+	}
+
+	// The duration shrinks as the peak velocity grows, and is unbounded as it
+	// approaches zero. It needn't be monotonic across the current speed,
+	// though (see plan()), so search only the side of it that T is on. Below
+	// the current speed, some peaks overshoot pf even without cruising.
+	phase_array ph;
+	double lo = 0.0, hi = vPeak;
+	const double speed = dir * v0;
+	if (speed > 0.0  &&  speed < vPeak) {
+		double tc = cruiseTime(dir * speed);
+		if (tc >= 0.0) {
+			build(dir * speed, tc, &ph);
+			if (duration(ph) >= T) {
+				lo = speed;
+			} else {
+				hi = speed;
+			}
+		}
+	}
+	bool hiOvershoots = false;
+	for (int i = 0; i < NUM_BISECTIONS; ++i) {
+		double mid = 0.5 * (lo + hi);
+		double tc = cruiseTime(dir * mid);
+		build(dir * mid, math::max(0.0, tc), &ph);
+		if (tc >= 0.0  &&  duration(ph) > T) {
+			lo = mid;
+		} else {
+			hi = mid;
+			hiOvershoots = tc < 0.0;
+		}
+	}
+	if (hiOvershoots) {
+		// T falls between the durations of peaks that land on pf.
+		return false;
+	}
+
+	vPeak = hi;
+	build(dir * vPeak, math::max(0.0, cruiseTime(dir * vPeak)), &ph);
+	setPhases(ph);
+	return true;
+}
+
+void JerkLimitedProfile::eval(double t, double* p, double* v, double* a) const
+{
+	if (t >= tf) {
+		if (p != NULL) {
+			*p = pf;
+		}
+		if (v != NULL) {
+			*v = 0.0;
+		}
+		if (a != NULL) {
+			*a = 0.0;
+		}
+		return;
+	}
+
+	size_t i = 0;
+	while (i + 1 < MAX_PHASES  &&  tStart[i + 1] <= t) {
+		++i;
+	}
+
+	const double dt = math::max(0.0, t - tStart[i]);
+	const double j = phases[i].j;
+	if (p != NULL) {
+		*p = pStart[i] + dt * (vStart[i] + dt * (aStart[i] / 2.0 + dt * j / 6.0));
+	}
+	if (v != NULL) {
+		*v = vStart[i] + dt * (aStart[i] + dt * j / 2.0);
+	}
+	if (a != NULL) {
+		*a = aStart[i] + dt * j;
+	}
+}
+
+void JerkLimitedProfile::velocityChange(double v, double a, double v1, Phase* ph) const
+{
+	// The velocity reached by ramping the acceleration straight to zero
+	// decides which way the acceleration has to go.
+	const double s = (v1 >= v + a * std::abs(a) / (2.0 * jMax)) ? 1.0 : -1.0;
+
+	// In the direction of the change, ramp the acceleration to alpha, hold it,
+	// then ramp it to zero.
+	const double dv = s * (v1 - v);
+	const double as = s * a;
+	const double alpha = math::min(aMax, std::sqrt(math::max(0.0, jMax * dv + as * as / 2.0)));
+
+	ph[0].j = s * math::sign(alpha - as) * jMax;
+	ph[0].duration = std::abs(alpha - as) / jMax;
+
+	ph[1].j = 0.0;
+	ph[1].duration = 0.0;
+	if (alpha > 0.0) {
+		double rampDv = (alpha + as) * std::abs(alpha - as) / (2.0 * jMax) + alpha * alpha / (2.0 * jMax);
+		ph[1].duration = math::max(0.0, (dv - rampDv) / alpha);
+	}
+
+	ph[2].j = -s * jMax;
+	ph[2].duration = alpha / jMax;
+}
+
+void JerkLimitedProfile::build(double peak, double cruiseT, phase_array* ph) const
+{
+	velocityChange(v0, a0, peak, &(*ph)[0]);
+
+	(*ph)[3].j = 0.0;
+	(*ph)[3].duration = cruiseT;
+
+	velocityChange(peak, 0.0, 0.0, &(*ph)[4]);
+}
+
+double JerkLimitedProfile::distance(const phase_array& ph) const
+{
+	double x = 0.0, v = v0, a = a0;
+	for (size_t i = 0; i < MAX_PHASES; ++i) {
+		const double d = ph[i].duration;
+		const double j = ph[i].j;
+		x += d * (v + d * (a / 2.0 + d * j / 6.0));
+		v += d * (a + d * j / 2.0);
+		a += d * j;
+	}
+	return x;
+}
+
+double JerkLimitedProfile::duration(const phase_array& ph) const
+{
+	double sum = 0.0;
+	for (size_t i = 0; i < MAX_PHASES; ++i) {
+		sum += ph[i].duration;
+	}
+	return sum;
+}
+
+double JerkLimitedProfile::cruiseTime(double peak) const
+{
+	phase_array ph;
+	build(peak, 0.0, &ph);
+	return ((pf - p0) - distance(ph)) / peak;
+}
+
+void JerkLimitedProfile::setPhases(const phase_array& ph)
+{
+	phases = ph;
+
+	double t = 0.0, x = p0, v = v0, a = a0;
+	for (size_t i = 0; i < MAX_PHASES; ++i) {
+		tStart[i] = t;
+		pStart[i] = x;
+		vStart[i] = v;
+		aStart[i] = a;
+
+		const double d = phases[i].duration;
+		const double j = phases[i].j;
+		t += d;
+		x += d * (v + d * (a / 2.0 + d * j / 6.0));
+		v += d * (a + d * j / 2.0);
+		a += d * j;
+	}
+	tf = t;
+}
+
+
+}
+}
@@ -32,6 +32,7 @@
 
 
 #include <string>
+#include <cstring>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/python.hpp>
@@ -62,6 +63,82 @@ bool isWamActivated(ProductManager& pm) {
 }
 
 
+// NumPy arrays of the state that a Wam publishes every cycle (see
+// Wam::getState()). update() copies the latest snapshot into a bytearray,
+// and state is a structured array over that bytearray, so its fields (e.g.
+// state["jp"]) are views that stay current without converting anything.
+template<size_t DOF>
+class WamStateView {
+public:
+	static const size_t NUM_DOUBLES = 3 * DOF + 3 + 4 + 2;
+	static const size_t LENGTH = NUM_DOUBLES * sizeof(double) + sizeof(boost::uint64_t) + sizeof(int);
+
+	explicit WamStateView(const systems::Wam<DOF>& wam_) :
+		wam(wam_), buffer(handle<>(PyByteArray_FromStringAndSize(NULL, LENGTH))), state()
+	{
+		std::memset(PyByteArray_AS_STRING(buffer.ptr()), 0, LENGTH);
+
+		object numpy = import("numpy");
+		state = numpy.attr("frombuffer")(buffer, numpy.attr("dtype")(dtype())).attr("reshape")(tuple());
+	}
+
+	// Returns false if the Wam hasn't published anything yet.
+	bool update() {
+		typename systems::Wam<DOF>::State s;
+		if ( !wam.getState(&s) ) {
+			return false;
+		}
+
+		double d[NUM_DOUBLES];
+		std::memcpy(d, s.jp.data(), DOF * sizeof(double));
+		std::memcpy(d + DOF, s.jv.data(), DOF * sizeof(double));
+		std::memcpy(d + 2*DOF, s.jt.data(), DOF * sizeof(double));
+		std::memcpy(d + 3*DOF, s.toolPosition.data(), 3 * sizeof(double));
+		d[3*DOF + 3] = s.toolOrientation.w();
+		d[3*DOF + 4] = s.toolOrientation.x();
+		d[3*DOF + 5] = s.toolOrientation.y();
+		d[3*DOF + 6] = s.toolOrientation.z();
+		d[3*DOF + 7] = s.time;
+		d[3*DOF + 8] = s.safetyModeTime;
+		boost::uint64_t cycle = s.cycle;
+		int safetyMode = s.safetyMode;
+
+		char* p = PyByteArray_AS_STRING(buffer.ptr());
+		std::memcpy(p, d, sizeof(d));
+		std::memcpy(p + sizeof(d), &cycle, sizeof(cycle));
+		std::memcpy(p + sizeof(d) + sizeof(cycle), &safetyMode, sizeof(safetyMode));
+		return true;
+	}
+
+	static list dtype() {
+		list fields;
+		fields.append(make_tuple("jp", "d", DOF));
+		fields.append(make_tuple("jv", "d", DOF));
+		fields.append(make_tuple("jt", "d", DOF));
+		fields.append(make_tuple("toolPosition", "d", 3));
+		fields.append(make_tuple("toolOrientation", "d", 4));  // w, x, y, z
+		fields.append(make_tuple("time", "d"));
+		fields.append(make_tuple("safetyModeTime", "d"));
+		fields.append(make_tuple("cycle", "u8"));
+		fields.append(make_tuple("safetyMode", "i"));
+		return fields;
+	}
+
+	object getBuffer() const {  return buffer;  }
+	object getState() const {  return state;  }
+
+protected:
+	const systems::Wam<DOF>& wam;
+	object buffer;
+	object state;
+};
+
+template<size_t DOF>
+WamStateView<DOF>* getStateView(const systems::Wam<DOF>& wam) {
+	return new WamStateView<DOF>(wam);
+}
+
+
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Wam_gravityCompensate_overloads, gravityCompensate, 0, 1)
 template<size_t DOF>
 void wrapWam() {
@@ -69,6 +146,16 @@ void wrapWam() {
 	class_<systems::Wam<DOF>, boost::noncopyable>(name.c_str(), no_init)
 		.def("gravityCompensate", &systems::Wam<DOF>::gravityCompensate,
 				Wam_gravityCompensate_overloads())
+		.def("getStateView", &getStateView<DOF>,
+				with_custodian_and_ward_postcall<0, 1, return_value_policy<manage_new_object> >())
+	;
+
+	class_<WamStateView<DOF>, boost::noncopyable>((name + "StateView").c_str(), no_init)
+		.def("update", &WamStateView<DOF>::update)
+		.def("dtype", &WamStateView<DOF>::dtype)
+		.staticmethod("dtype")
+		.add_property("buffer", &WamStateView<DOF>::getBuffer)
+		.add_property("state", &WamStateView<DOF>::getState)
 	;
 }
 
@@ -76,6 +163,7 @@ void wrapWam() {
 BOOST_PYTHON_MODULE(libbarrett)
 {
 	makeNamespace("bus", pythonBusInterface);
+	makeNamespace("log", pythonLogInterface);
 	pythonProductsInterface();  // The products sub-folder doesn't correspond to a namespace
 
 
@@ -35,6 +35,7 @@
 // These functions do the work of building the python wrappers.
 void pythonBusInterface();
 void pythonProductsInterface();
+void pythonLogInterface();
 
 
 class Namespace {};
@@ -0,0 +1,217 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file haptic_path.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+#include <barrett/math/utils.h>
+#include <barrett/systems/haptic_path.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+HapticPath::HapticPath(const std::vector<cp_type, Eigen::aligned_allocator<cp_type> >& path,
+		const std::string& sysName) :
+	HapticObject(sysName),
+	tangentDirectionOutput(this, &tangentDirectionOutputValue),
+	minDist(0.0), sNearest(0.0), tracking(false), prevCp(0.0),
+	numGlobalSearches(0), spline(NULL)
+{
+	// Sample the path
+	cp_type prev = path[0];
+	for (size_t i = 0; i < path.size(); ++i) {
+		if ((path[i] - prev).norm() > COARSE_STEP) {
+			coarsePath.push_back(path[i]);
+			prev = path[i];
+		}
+	}
+	spline = new math::Spline<cp_type>(coarsePath);
+
+	// Bound each segment by the convex hull of its Bezier control points.
+	math::AabbTree::box_vector boxes(spline->numKnots() - 1);
+	cp_type p0, v0, p1, v1;
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		double s0 = spline->getKnot(i);
+		double s1 = spline->getKnot(i + 1);
+		double third = (s1 - s0) / 3.0;
+		spline->eval(s0, &p0, &v0);
+		spline->eval(s1, &p1, &v1);
+
+		boxes[i].setEmpty();
+		boxes[i].extend(p0);
+		boxes[i].extend(p1);
+		boxes[i].extend(Eigen::Vector3d(p0 + third * v0));
+		boxes[i].extend(Eigen::Vector3d(p1 - third * v1));
+	}
+	segmentTree.build(boxes);
+}
+
+HapticPath::~HapticPath()
+{
+	mandatoryCleanUp();
+	delete spline;
+}
+
+struct HapticPath::SegmentDistance {
+	SegmentDistance(const HapticPath& hp) :
+		parent(hp), s(0.0), best(std::numeric_limits<double>::infinity()) {}
+
+	double operator() (size_t segment, const Eigen::Vector3d& p) {
+		double sSeg;
+		double dist = parent.projectOntoSegment(segment, cp_type(p), &sSeg);
+
+		// The tree only keeps the closest item, but we also need to know
+		// where on it the closest point was. Closer candidates always
+		// overwrite farther ones.
+		if (dist * dist < best) {
+			best = dist * dist;
+			s = sSeg;
+		}
+		return dist * dist;
+	}
+
+	const HapticPath& parent;
+	double s;
+	double best;
+};
+
+void HapticPath::operate()
+{
+	const cp_type& cp = input.getValue();
+
+	// Start from the previous projection. The branch being tracked may no
+	// longer be the closest one, though: its distance also grows by at most
+	// the distance the tool moved, so no bound on the local result can tell a
+	// local minimum from the global one. Instead, the local distance bounds a
+	// search of the segment tree. That prunes everything but the segments
+	// near the tool, but still finds any segment that is closer.
+	double bound = std::numeric_limits<double>::infinity();
+	if (tracking  &&  (cp - prevCp).norm() < COARSE_STEP) {
+		double s = sNearest, dist;
+		if (project(cp, spline->initialS(), spline->finalS(), &s, &dist)) {
+			sNearest = s;
+			minDist = dist;
+			bound = std::max(dist - NEWTON_TOLERANCE, 0.0);
+		}
+	}
+
+	SegmentDistance sd(*this);
+	double dist;
+	if (segmentTree.nearest(cp, sd, &dist, bound) != math::AabbTree::NONE) {
+		sNearest = sd.s;
+		minDist = dist;
+		++numGlobalSearches;
+	}
+
+	tracking = true;
+	prevCp = cp;
+
+	cp_type p, v;
+	spline->eval(sNearest, &p, &v);
+	dir = (p - cp).normalized();
+	tangentDir = v.normalized();
+
+	depthOutputValue->setData(&minDist);
+	directionOutputValue->setData(&dir);
+	tangentDirectionOutputValue->setData(&tangentDir);
+}
+
+// Newton's method on f(s) = (p(s) - cp) . p'(s), starting from *s and
+// restricted to [sLow, sHigh]. Returns true if it converged.
+bool HapticPath::project(const cp_type& cp, double sLow, double sHigh, double* s, double* dist) const
+{
+	cp_type p, v, a, r;
+	double sCur = *s;
+	bool converged = false;
+
+	for (int i = 0; i < MAX_NEWTON_ITERATIONS; ++i) {
+		spline->eval(sCur, &p, &v, &a);
+		r = p - cp;
+
+		double f = r.dot(v);
+		double df = v.dot(v) + r.dot(a);
+		if (df <= 0.0) {
+			// Not locally convex; fall back to a Gauss-Newton step.
+			df = v.dot(v);
+		}
+		if (df <= 0.0) {
+			break;
+		}
+
+		double sNext = math::saturate(sCur - f / df, sLow, sHigh);
+		if (std::fabs(sNext - sCur) < NEWTON_TOLERANCE) {
+			converged = true;
+			break;
+		}
+		sCur = sNext;
+	}
+
+	*s = sCur;
+	*dist = (spline->eval(sCur) - cp).norm();
+	return converged;
+}
+
+double HapticPath::projectOntoSegment(size_t segment, const cp_type& cp, double* s) const
+{
+	const double sLow = spline->getKnot(segment);
+	const double sHigh = spline->getKnot(segment + 1);
+
+	// Seed Newton's method with the best of a few samples
+	double bestS = sLow;
+	double bestDist = (spline->eval(sLow) - cp).norm();
+	for (int i = 1; i <= SEGMENT_SAMPLES; ++i) {
+		double sSample = sLow + (sHigh - sLow) * i / SEGMENT_SAMPLES;
+		double dist = (spline->eval(sSample) - cp).norm();
+		if (dist < bestDist) {
+			bestDist = dist;
+			bestS = sSample;
+		}
+	}
+
+	double sNewton = bestS, dist;
+	project(cp, sLow, sHigh, &sNewton, &dist);
+	if (dist < bestDist) {
+		*s = sNewton;
+		return dist;
+	} else {
+		*s = bestS;
+		return bestDist;
+	}
+}
+
+
+}
+}
@@ -0,0 +1,226 @@
+/**
+ *	Copyright 2009-2014 Barrett Technology <support@barrett.com>
+ *
+ *	This file is part of libbarrett.
+ *
+ *	This version of libbarrett is free software: you can redistribute it
+ *	and/or modify it under the terms of the GNU General Public License as
+ *	published by the Free Software Foundation, either version 3 of the
+ *	License, or (at your option) any later version.
+ *
+ *	This version of libbarrett is distributed in the hope that it will be
+ *	useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with this version of libbarrett.  If not, see
+ *	<http://www.gnu.org/licenses/>.
+ *
+ *
+ *	Barrett Technology Inc.
+ *	73 Chapel Street
+ *	Newton, MA 02458
+ *
+ */
+/*
+ * @file haptic_scene.cpp
+ * @date 10/19/2026
+ *
+ */
+
+
+#include <algorithm>
+#include <vector>
+
+#include <barrett/math/utils.h>
+#include <barrett/thread/abstract/mutex.h>
+#include <barrett/systems/haptic_scene.h>
+
+
+namespace barrett {
+namespace systems {
+
+
+// HapticObject is header-only, so its constant is defined here.
+constexpr double HapticObject::ACTIVATION_DISTANCE;
+
+
+HapticScene::HapticScene(const std::string& sysName) :
+	HapticObject(sysName), index(), numActive(0),
+	penetration(0.0), depth(0.0), dir(0.0)
+{
+}
+
+HapticScene::~HapticScene()
+{
+	mandatoryCleanUp();
+
+	for (size_t i = 0; i < index.shapes.size(); ++i) {
+		delete index.shapes[i];
+	}
+}
+
+void HapticScene::add(Shape* shape)
+{
+	std::vector<Shape*> shapes(index.shapes);
+	shapes.push_back(shape);
+	replaceIndex(shapes);
+}
+
+bool HapticScene::remove(Shape* shape)
+{
+	std::vector<Shape*> shapes(index.shapes);
+	std::vector<Shape*>::iterator i = std::find(shapes.begin(), shapes.end(), shape);
+	if (i == shapes.end()) {
+		return false;
+	}
+
+	shapes.erase(i);
+	replaceIndex(shapes);
+	delete shape;
+	return true;
+}
+
+void HapticScene::clear()
+{
+	std::vector<Shape*> shapes(index.shapes);
+	replaceIndex(std::vector<Shape*>());
+	for (size_t i = 0; i < shapes.size(); ++i) {
+		delete shapes[i];
+	}
+}
+
+void HapticScene::replaceIndex(const std::vector<Shape*>& shapes)
+{
+	// Do the expensive work outside of the critical section.
+	Index newIndex;
+	newIndex.build(shapes);
+
+	std::vector<Shape*> sorted(shapes);
+	std::sort(sorted.begin(), sorted.end());
+
+	{
+		BARRETT_SCOPED_LOCK(getEmMutex());
+
+		// Shapes that are still in the scene must still be told if they get
+		// culled next cycle.
+		for (size_t i = 0; i < index.prevActive.size(); ++i) {
+			if (std::binary_search(sorted.begin(), sorted.end(), index.prevActive[i])) {
+				newIndex.prevActive.push_back(index.prevActive[i]);
+			}
+		}
+
+		index.swap(newIndex);
+	}
+
+	// newIndex now holds the old index, which is freed here.
+}
+
+void HapticScene::Index::build(const std::vector<Shape*>& newShapes)
+{
+	shapes = newShapes;
+
+	math::AabbTree::box_vector boxes(shapes.size());
+	for (size_t i = 0; i < shapes.size(); ++i) {
+		boxes[i] = shapes[i]->getBounds();
+	}
+	tree.build(boxes);
+
+	// Never allocate in operate()
+	active.clear();
+	active.reserve(shapes.size());
+	prevActive.clear();
+	prevActive.reserve(shapes.size());
+}
+
+void HapticScene::Index::swap(Index& other)
+{
+	shapes.swap(other.shapes);
+	tree.swap(other.tree);
+	active.swap(other.active);
+	prevActive.swap(other.prevActive);
+}
+
+
+struct HapticScene::Evaluator {
+	Evaluator(Index& i, const cp_type& toolPosition, cf_type* p) :
+		index(i), cp(toolPosition), penetration(p), depth(0.0), dir(0.0) {}
+
+	void operator() (size_t item) {
+		Shape* shape = index.shapes[item];
+		shape->evaluate(cp, &depth, &dir);
+		shape->active = true;
+		index.active.push_back(shape);
+
+		*penetration += depth * dir;
+	}
+
+	Index& index;
+	const cp_type& cp;
+	cf_type* penetration;
+
+	double depth;
+	cf_type dir;
+};
+
+void HapticScene::operate()
+{
+	const cp_type& cp = input.getValue();
+
+	for (size_t i = 0; i < index.prevActive.size(); ++i) {
+		index.prevActive[i]->active = false;
+	}
+	index.active.clear();
+
+	// Broad phase: only evaluate shapes whose bounds contain the tool.
+	penetration.setZero();
+	Evaluator evaluator(index, cp, &penetration);
+	index.tree.query(cp, 0.0, evaluator);
+	numActive = index.active.size();
+
+	for (size_t i = 0; i < index.prevActive.size(); ++i) {
+		if ( !index.prevActive[i]->active ) {
+			index.prevActive[i]->culled();
+		}
+	}
+	index.active.swap(index.prevActive);
+
+	depth = penetration.norm();
+	if (depth > 0.0) {
+		dir = penetration / depth;
+	} else {
+		dir.setZero();
+	}
+
+	depthOutputValue->setData(&depth);
+	directionOutputValue->setData(&dir);
+}
+
+
+math::AabbTree::box_type HapticScene::Ball::getBounds() const
+{
+	Eigen::Vector3d extent = Eigen::Vector3d::Constant(r + HapticObject::ACTIVATION_DISTANCE);
+	return math::AabbTree::box_type(c - extent, c + extent);
+}
+
+void HapticScene::Ball::evaluate(const cp_type& cp, double* depth, cf_type* direction)
+{
+	HapticBall::evaluate(cp, c, r, &keepOutside, depth, direction);
+}
+
+
+math::AabbTree::box_type HapticScene::Box::getBounds() const
+{
+	Eigen::Vector3d extent = halfSize + Eigen::Vector3d::Constant(HapticObject::ACTIVATION_DISTANCE);
+	return math::AabbTree::box_type(c - extent, c + extent);
+}
+
+void HapticScene::Box::evaluate(const cp_type& cp, double* depth, cf_type* direction)
+{
+	HapticBox::evaluate(cp, c, halfSize, &inBox, &index, &keepOutside, depth, direction);
+}
+
+
+}
+}
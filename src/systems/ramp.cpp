@@ -80,7 +80,7 @@ void Ramp::getSamplePeriodFromEM()
 {
 	if (this->hasExecutionManager()) {
 		assert(this->getExecutionManager()->getPeriod() > 0.0);
-		T_s = this->getExecutionManager()->getPeriod();
+		T_s = this->getEffectivePeriod();
 	} else {
 		T_s = 0.0;
 	}
@@ -31,6 +31,8 @@
  */
 
 
+#include <stdexcept>
+
 #include <barrett/systems/abstract/execution_manager.h>
 #include <barrett/systems/abstract/system.h>
 
@@ -55,6 +57,25 @@ void System::mandatoryCleanUp()
 	}
 }
 
+void System::setRateDivisor(size_t divisor, size_t phase)
+{
+	if (divisor == 0  ||  phase >= divisor) {
+		throw std::invalid_argument("(systems::System::setRateDivisor): "
+				"divisor must be positive and phase must be less than divisor.");
+	}
+
+	BARRETT_SCOPED_LOCK(getEmMutex());
+
+	rateDivisor = divisor;
+	ratePhase = phase;
+	rateStarted = false;
+
+	// The effective sample period has changed.
+	if (hasExecutionManager()) {
+		onExecutionManagerChanged();
+	}
+}
+
 void System::update(update_token_type updateToken)
 {
 	// Check if an update is needed
@@ -64,6 +85,15 @@ void System::update(update_token_type updateToken)
 		return;
 	}
 
+	// Between scheduled cycles, leave the Outputs holding their last values.
+	// (Update tokens count execution cycles starting from 1.)
+	if (rateDivisor != 1) {
+		if (rateStarted  &&  (updateToken - 1) % rateDivisor != ratePhase) {
+			return;
+		}
+		rateStarted = true;
+	}
+
 	if (inputsValid()) {
 		operate();
 	} else {
@@ -98,6 +128,7 @@ void System::setExecutionManager(ExecutionManager* newEm)
 			assert(getExecutionManager() == newEm);
 		} else {
 			em = newEm;
+			rateStarted = false;
 			onExecutionManagerChanged();
 
 			child_input_list_type::iterator i(inputs.begin()), iEnd(inputs.end());
@@ -141,6 +172,7 @@ void System::unsetExecutionManager()
 	}
 
 	// if no EM found...
+	rateStarted = false;
 	onExecutionManagerChanged();
 
 	child_input_list_type::iterator i(inputs.begin()), iEnd(inputs.end());
@@ -0,0 +1,307 @@
+/*
+ * align.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <set>
+#include <cstdio>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/writer.h>
+#include <barrett/log/column_writer.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/align.h>
+
+#include "./tmp_file.h"
+
+
+namespace {
+using namespace barrett;
+
+
+typedef boost::tuple<double, double, int> tuple_type;
+
+
+class AlignTest : public ::testing::Test {
+public:
+	AlignTest() {
+		makeTmpFile(aFile);
+		makeTmpFile(bFile);
+		makeTmpFile(outFile);
+	}
+	~AlignTest() {
+		std::remove(aFile);
+		std::remove(bFile);
+		std::remove(outFile);
+	}
+
+	// n records at t = t0 + i*dt with x = f(t) and count = i
+	static void writeLog(const char* file, size_t n, double t0, double dt, double (*f)(double)) {
+		log::ColumnWriter<tuple_type> lw(file, "time,x,count", dt, 100);
+		for (size_t i = 0; i < n; ++i) {
+			double t = t0 + i * dt;
+			lw.putRecord(tuple_type(t, f(t), i));
+		}
+	}
+
+	static double linear(double t) {  return 2.0 * t + 1.0;  }
+	static double triple(double t) {  return 3.0 * t;  }
+	static double square(double t) {  return t * t;  }
+
+	static std::string readFile(const char* name) {
+		std::ifstream ifs(name, std::ios_base::binary);
+		return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	}
+
+	// The number of samples at or before t
+	static size_t countAtOrBefore(double t, size_t n, double t0, double dt) {
+		size_t i = 0;
+		while (i < n  &&  t0 + i * dt <= t) {
+			++i;
+		}
+		return i;
+	}
+
+protected:
+	char aFile[14];
+	char bFile[14];
+	char outFile[14];
+};
+
+
+TEST_F(AlignTest, LinearOnPeriod) {
+	writeLog(aFile, 1000, 0.0, 0.001, linear);
+	writeLog(bFile, 400, 0.0005, 0.0025, triple);
+
+	log::ColumnLogInput a(aFile), b(bFile);
+	std::vector<log::AlignSource> sources;
+	sources.push_back(log::AlignSource(&a, "a"));
+	sources.push_back(log::AlignSource(&b, "b"));
+	log::AlignOptions options;
+	options.period = 0.002;
+	options.recordsPerBlock = 64;
+	EXPECT_EQ(499u, log::align(sources, outFile, options));
+
+	log::ColumnReader out(outFile);
+	ASSERT_EQ(499u, out.numRecords());
+	ASSERT_EQ(5u, out.getSchema().numChannels());  // The time and two fields of each log
+	EXPECT_EQ(0u, out.getSchema().findChannel("time"));
+
+	std::vector<double> time, ax, acount, bx;
+	out.readChannel("time", &time);
+	out.readChannel("a.x", &ax);
+	out.readChannel("a.count", &acount);
+	out.readChannel("b.x", &bx);
+	for (size_t k = 0; k < out.numRecords(); ++k) {
+		double t = 0.0005 + k * 0.002;
+		ASSERT_DOUBLE_EQ(t, time[k]);
+		EXPECT_NEAR(linear(t), ax[k], 1e-12);
+		EXPECT_NEAR(triple(t), bx[k], 1e-12);
+		// Integer channels are held
+		EXPECT_EQ(countAtOrBefore(time[k], 1000, 0.0, 0.001) - 1, acount[k]);
+	}
+}
+
+TEST_F(AlignTest, MergesTimestamps) {
+	writeLog(aFile, 300, 0.0, 0.01, linear);
+	writeLog(bFile, 250, 0.005, 0.008, triple);
+
+	std::set<double> expected;
+	for (size_t i = 0; i < 300; ++i) {
+		expected.insert(0.0 + i * 0.01);
+	}
+	for (size_t i = 0; i < 250; ++i) {
+		expected.insert(0.005 + i * 0.008);
+	}
+	const double end = 0.005 + 249 * 0.008;
+	expected.erase(expected.begin(), expected.lower_bound(0.005));
+	expected.erase(expected.upper_bound(end), expected.end());
+
+	log::ColumnLogInput a(aFile), b(bFile);
+	std::vector<log::AlignSource> sources;
+	sources.push_back(log::AlignSource(&a, "a"));
+	sources.push_back(log::AlignSource(&b, "b"));
+	log::AlignOptions options;
+	options.recordsPerBlock = 50;
+	EXPECT_EQ(expected.size(), log::align(sources, outFile, options));
+
+	log::ColumnReader out(outFile);
+	std::vector<double> time, ax, bx;
+	out.readChannel("time", &time);
+	out.readChannel("a.x", &ax);
+	out.readChannel("b.x", &bx);
+	ASSERT_EQ(expected.size(), time.size());
+	EXPECT_TRUE(std::equal(expected.begin(), expected.end(), time.begin()));
+	for (size_t k = 0; k < time.size(); ++k) {
+		EXPECT_NEAR(linear(time[k]), ax[k], 1e-12);
+		EXPECT_NEAR(triple(time[k]), bx[k], 1e-12);
+	}
+}
+
+TEST_F(AlignTest, HoldAndCubic) {
+	writeLog(aFile, 200, 0.0, 0.01, square);
+
+	log::ColumnLogInput a(aFile);
+	std::vector<log::AlignSource> sources(1, log::AlignSource(&a, ""));
+	log::AlignOptions options;
+	options.period = 0.003;
+	options.method = log::AlignOptions::CUBIC;
+	log::align(sources, outFile, options);
+
+	std::vector<double> time, x;
+	{
+		log::ColumnReader out(outFile);
+		out.readChannel("time", &time);
+		out.readChannel("x", &x);  // No prefix
+	}
+	for (size_t k = 0; k < time.size(); ++k) {
+		// With central-difference tangents, the spline is exact for
+		// quadratics away from the ends of the log.
+		if (time[k] > 0.01  &&  time[k] < 1.98) {
+			EXPECT_NEAR(square(time[k]), x[k], 1e-12) << "t = " << time[k];
+		}
+	}
+
+	options.method = log::AlignOptions::HOLD;
+	log::align(sources, outFile, options);
+	log::ColumnReader out(outFile);
+	x.clear();
+	out.readChannel("x", &x);
+	for (size_t k = 0; k < time.size(); ++k) {
+		double held = 0.01 * (countAtOrBefore(time[k], 200, 0.0, 0.01) - 1);
+		EXPECT_DOUBLE_EQ(square(held), x[k]);
+	}
+}
+
+TEST_F(AlignTest, UnionOfSpans) {
+	writeLog(aFile, 100, 0.0, 0.01, linear);
+	writeLog(bFile, 100, 0.5, 0.01, triple);
+
+	log::ColumnLogInput a(aFile), b(bFile);
+	std::vector<log::AlignSource> sources;
+	sources.push_back(log::AlignSource(&a, "a"));
+	sources.push_back(log::AlignSource(&b, "b"));
+	log::AlignOptions options;
+	options.period = 0.01;
+	options.unionOfSpans = true;
+	EXPECT_EQ(150u, log::align(sources, outFile, options));
+
+	log::ColumnReader out(outFile);
+	std::vector<double> time, ax, bx;
+	out.readChannel("time", &time);
+	out.readChannel("a.x", &ax);
+	out.readChannel("b.x", &bx);
+	for (size_t k = 0; k < time.size(); ++k) {
+		if (time[k] <= 0.99) {
+			EXPECT_NEAR(linear(time[k]), ax[k], 1e-12);
+		} else {
+			EXPECT_TRUE(ax[k] != ax[k]) << "t = " << time[k];  // NaN
+		}
+		if (time[k] >= 0.5) {
+			EXPECT_NEAR(triple(time[k]), bx[k], 1e-12);
+		} else {
+			EXPECT_TRUE(bx[k] != bx[k]) << "t = " << time[k];
+		}
+	}
+
+	// Without the union, the logs only overlap for half a second.
+	options.unionOfSpans = false;
+	EXPECT_EQ(50u, log::align(sources, outFile, options));
+}
+
+TEST_F(AlignTest, RawLog) {
+	{
+		log::Writer<tuple_type> lw(aFile);
+		for (int i = 0; i < 50; ++i) {
+			lw.putRecord(tuple_type(0.02 * i, linear(0.02 * i), i));
+		}
+	}
+	writeLog(bFile, 100, 0.0, 0.01, triple);
+
+	log::RawLogInput a(aFile, log::Schema::fromFormat("ddi", "t,x,count"));
+	log::ColumnLogInput b(bFile);
+	std::vector<log::AlignSource> sources;
+	sources.push_back(log::AlignSource(&a, "a", "t"));
+	sources.push_back(log::AlignSource(&b, "b"));
+	log::AlignOptions options;
+	options.period = 0.005;
+	EXPECT_EQ(197u, log::align(sources, outFile, options));
+
+	log::ColumnReader out(outFile);
+	std::vector<double> time, ax;
+	out.readChannel("time", &time);
+	out.readChannel("a.x", &ax);
+	for (size_t k = 0; k < time.size(); ++k) {
+		EXPECT_NEAR(linear(time[k]), ax[k], 1e-12);
+	}
+}
+
+TEST_F(AlignTest, BlocksAndThreadsDontMatter) {
+	writeLog(aFile, 5000, 0.0, 0.001, square);
+	writeLog(bFile, 3000, 0.0003, 0.0017, triple);
+
+	log::ColumnLogInput a(aFile), b(bFile);
+	std::vector<log::AlignSource> sources;
+	sources.push_back(log::AlignSource(&a, "a"));
+	sources.push_back(log::AlignSource(&b, "b"));
+	log::AlignOptions options;
+	options.method = log::AlignOptions::CUBIC;
+	options.numThreads = 1;
+	log::align(sources, outFile, options);
+	std::string serial = readFile(outFile);
+
+	options.numThreads = 4;
+	log::align(sources, outFile, options);
+	EXPECT_TRUE(serial == readFile(outFile));
+
+	std::vector<std::vector<double> > expected(5);
+	{
+		log::ColumnReader out(outFile);
+		ASSERT_EQ(5u, out.getSchema().numChannels());
+		for (size_t c = 0; c < expected.size(); ++c) {
+			out.readChannel(c, &expected[c]);
+		}
+	}
+
+	options.recordsPerBlock = 7;
+	log::align(sources, outFile, options);
+	log::ColumnReader out(outFile);
+	for (size_t c = 0; c < expected.size(); ++c) {
+		std::vector<double> values;
+		out.readChannel(c, &values);
+		EXPECT_TRUE(expected[c] == values) << out.getSchema().channelName(c);
+	}
+}
+
+TEST_F(AlignTest, Errors) {
+	writeLog(aFile, 10, 0.0, 0.01, linear);
+	log::ColumnLogInput a(aFile);
+
+	std::vector<log::AlignSource> sources;
+	EXPECT_THROW(log::align(sources, outFile), std::logic_error);
+
+	sources.push_back(log::AlignSource(&a, "a", "t"));
+	EXPECT_THROW(log::align(sources, outFile), std::logic_error);
+
+	sources[0].timeChannel = "time";
+	sources.push_back(log::AlignSource(&a, "a"));
+	EXPECT_THROW(log::align(sources, outFile), std::logic_error);
+
+	sources.pop_back();
+	EXPECT_EQ(10u, log::align(sources, outFile));
+}
+
+
+}
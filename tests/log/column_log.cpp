@@ -0,0 +1,352 @@
+/*
+ * column_log.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <stdexcept>
+#include <fstream>
+#include <vector>
+#include <iterator>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <boost/array.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+#include <Eigen/Geometry>
+
+#include <barrett/math/matrix.h>
+#include <barrett/os.h>
+#include <barrett/units.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/writer.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/column_writer.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/real_time_writer.h>
+
+
+namespace {
+using namespace barrett;
+
+
+typedef units::JointTorques<3>::type jt_type;
+typedef boost::tuple<double, jt_type, int> tuple_type;
+
+
+class ColumnLogTest : public ::testing::Test {
+public:
+	ColumnLogTest() {
+		std::strcpy(tmpFile, "/tmp/btXXXXXX");
+		int fd = mkstemp(tmpFile);
+		EXPECT_TRUE(fd != -1);
+		close(fd);
+	}
+	~ColumnLogTest() {
+		std::remove(tmpFile);
+	}
+
+	tuple_type record(int i) {
+		jt_type jt;
+		jt << i, -2.0 * i, 0.5 * i;
+		return tuple_type(0.002 * i, jt, 3 * i);
+	}
+
+	void writeRecords(int n, size_t recordsPerBlock) {
+		log::ColumnWriter<tuple_type> lw(tmpFile, "time,jt,count", 0.002, recordsPerBlock);
+		for (int i = 0; i < n; ++i) {
+			lw.putRecord(record(i));
+		}
+		lw.close();
+	}
+
+	long fileSize() {
+		std::ifstream ifs(tmpFile, std::ios_base::binary | std::ios_base::ate);
+		return ifs.tellg();
+	}
+
+protected:
+	char tmpFile[14];
+};
+
+
+TEST(LogSchemaTest, DescribeTuple) {
+	log::Schema s;
+	log::Traits<tuple_type>::describe("time,jt", &s);
+
+	ASSERT_EQ(3u, s.numFields());
+	EXPECT_EQ("time", s.field(0).name);
+	EXPECT_EQ(log::Schema::FLOAT64, s.field(0).type);
+	EXPECT_EQ(0u, s.field(0).offset);
+
+	EXPECT_EQ("jt", s.field(1).name);
+	EXPECT_EQ(3u, s.field(1).rows);
+	EXPECT_EQ(1u, s.field(1).cols);
+	EXPECT_EQ("JointTorques<3>", s.field(1).units);
+	EXPECT_EQ(8u, s.field(1).offset);
+
+	EXPECT_EQ("field2", s.field(2).name);
+	EXPECT_EQ(log::Schema::INT32, s.field(2).type);
+
+	EXPECT_EQ(log::Traits<tuple_type>::serializedLength(), s.recordLength());
+	ASSERT_EQ(5u, s.numChannels());
+	EXPECT_EQ("jt[2]", s.channelName(3));
+	EXPECT_EQ(3u, s.findChannel("jt[2]"));
+	EXPECT_EQ(24u, s.channel(3).offset);
+	EXPECT_EQ(4u, s.findChannel("field2"));
+	EXPECT_THROW(s.findChannel("jt"), std::out_of_range);
+	EXPECT_THROW(s.findChannel("jt[3]"), std::out_of_range);
+	EXPECT_THROW(s.findChannel("tau"), std::out_of_range);
+}
+
+TEST(LogSchemaTest, DescribeContainers) {
+	typedef boost::tuple<boost::array<float, 4>, Eigen::Quaterniond, boost::tuple<double, bool> > nested_type;
+
+	log::Schema s;
+	log::Traits<nested_type>::describe("a,q,pose", &s);
+
+	ASSERT_EQ(4u, s.numFields());
+	EXPECT_EQ("a", s.field(0).name);
+	EXPECT_EQ(log::Schema::FLOAT32, s.field(0).type);
+	EXPECT_EQ(4u, s.field(0).rows);
+	EXPECT_EQ("q", s.field(1).name);
+	EXPECT_EQ(4u, s.field(1).numElements());
+	EXPECT_EQ("pose.0", s.field(2).name);
+	EXPECT_EQ("pose.1", s.field(3).name);
+	EXPECT_EQ(log::Schema::BOOL, s.field(3).type);
+	EXPECT_EQ(log::Traits<nested_type>::serializedLength(), s.recordLength());
+}
+
+TEST(LogSchemaTest, ArraysOfArraysArentGrouped) {
+	log::Schema s;
+	log::Traits<boost::array<jt_type, 2> >::describe("x", &s);
+
+	ASSERT_EQ(2u, s.numFields());
+	EXPECT_EQ("x[0]", s.field(0).name);
+	EXPECT_EQ("x[1]", s.field(1).name);
+	EXPECT_EQ(3u, s.field(1).firstChannel);
+}
+
+TEST(LogSchemaTest, SerializeRoundTrip) {
+	log::Schema s(0.002);
+	log::Traits<tuple_type>::describe("time,jt,count", &s);
+
+	std::vector<char> buffer;
+	s.serialize(&buffer);
+
+	log::Schema s2;
+	EXPECT_EQ(buffer.size(), s2.unserialize(&buffer[0], buffer.size()));
+	EXPECT_EQ(s, s2);
+	EXPECT_EQ(0.002, s2.getSamplePeriod());
+	EXPECT_EQ(s.recordLength(), s2.recordLength());
+
+	EXPECT_THROW(s2.unserialize(&buffer[0], buffer.size() - 1), std::runtime_error);
+}
+
+TEST(LogSchemaTest, FromFormat) {
+	log::Schema s(0.002);
+	log::Traits<tuple_type>::describe("time,jt,count", &s);
+	log::Schema f = log::Schema::fromFormat("d3di", "time,jt,count", 0.002);
+	EXPECT_EQ(0.002, f.getSamplePeriod());
+	ASSERT_EQ(s.numChannels(), f.numChannels());
+	for (size_t i = 0; i < s.numChannels(); ++i) {
+		EXPECT_EQ(s.channelName(i), f.channelName(i));
+		EXPECT_EQ(s.channel(i).type, f.channel(i).type);
+		EXPECT_EQ(s.channel(i).offset, f.channel(i).offset);
+	}
+
+	log::Schema unnamed = log::Schema::fromFormat("2BQ");
+	ASSERT_EQ(2u, unnamed.numFields());
+	EXPECT_EQ("field0[1]", unnamed.channelName(1));
+	EXPECT_EQ(10u, unnamed.recordLength());
+
+	EXPECT_THROW(log::Schema::fromFormat(""), std::runtime_error);
+	EXPECT_THROW(log::Schema::fromFormat("d3"), std::runtime_error);
+	EXPECT_THROW(log::Schema::fromFormat("0d"), std::runtime_error);
+	EXPECT_THROW(log::Schema::fromFormat("dz"), std::runtime_error);
+}
+
+
+TEST_F(ColumnLogTest, RoundTrip) {
+	const int N = 10;
+	writeRecords(N, 4);  // Two full blocks and a short one
+
+	log::ColumnReader lr(tmpFile);
+	EXPECT_EQ(0.002, lr.getSchema().getSamplePeriod());
+	ASSERT_EQ(N, lr.numRecords());
+	for (int i = 0; i < N; ++i) {
+		EXPECT_EQ(record(i), lr.getRecord<tuple_type>(i));
+	}
+	EXPECT_THROW(lr.getRecord<tuple_type>(N), std::out_of_range);
+	EXPECT_THROW(lr.getRecord<double>(0), std::logic_error);
+}
+
+TEST_F(ColumnLogTest, ReadChannel) {
+	const int N = 10;
+	writeRecords(N, 4);
+
+	log::ColumnReader lr(tmpFile);
+	std::vector<double> jt1, count;
+	lr.readChannel("jt[1]", &jt1);
+	lr.readChannel("count", &count);
+	ASSERT_EQ(N, jt1.size());
+	ASSERT_EQ(N, count.size());
+	for (int i = 0; i < N; ++i) {
+		EXPECT_EQ(-2.0 * i, jt1[i]);
+		EXPECT_EQ(3.0 * i, count[i]);
+	}
+
+	// A range that spans blocks
+	std::vector<double> t;
+	lr.readChannel(lr.getSchema().findChannel("time"), &t, 3, 6);
+	ASSERT_EQ(6u, t.size());
+	for (int i = 0; i < 6; ++i) {
+		EXPECT_EQ(0.002 * (i + 3), t[i]);
+	}
+	EXPECT_THROW(lr.readChannel(0, &t, 5, 6), std::out_of_range);
+
+	// Straight into an array
+	double count2[7] = { 0.0 };
+	lr.readChannel(lr.getSchema().findChannel("count"), count2 + 1, 2, 6);
+	EXPECT_EQ(0.0, count2[0]);
+	for (int i = 0; i < 6; ++i) {
+		EXPECT_EQ(3.0 * (i + 2), count2[i + 1]);
+	}
+}
+
+TEST_F(ColumnLogTest, TruncatedBlockIsIgnored) {
+	writeRecords(10, 4);
+
+	std::ifstream ifs(tmpFile, std::ios_base::binary);
+	std::vector<char> contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	ifs.close();
+
+	std::ofstream ofs(tmpFile, std::ios_base::binary | std::ios_base::trunc);
+	ofs.write(&contents[0], contents.size() - 5);
+	ofs.close();
+
+	log::ColumnReader lr(tmpFile);
+	EXPECT_EQ(8u, lr.numRecords());
+	EXPECT_EQ(record(7), lr.getRecord<tuple_type>(7));
+}
+
+TEST_F(ColumnLogTest, RejectsOtherFiles) {
+	log::Writer<double> lw(tmpFile);
+	lw.putRecord(1.0);
+	lw.close();
+
+	EXPECT_THROW(log::ColumnReader lr(tmpFile), std::runtime_error);
+	EXPECT_THROW(log::ColumnReader lr("/tmp/this/file/does/not/exist"), std::runtime_error);
+}
+
+
+TEST_F(ColumnLogTest, CompressedRoundTripIsExact) {
+	const int N = 1000;
+	{
+		log::ColumnWriter<tuple_type> lw(tmpFile, log::ColumnOptions("time,jt,count"), 0.002, 256);
+		for (int i = 0; i < N; ++i) {
+			tuple_type r = record(i);
+			r.get<1>()[2] = std::sin(0.01 * i);
+			r.get<2>() = -i;  // Negative deltas
+			lw.putRecord(r);
+		}
+	}
+
+	log::ColumnReader lr(tmpFile);
+	ASSERT_EQ(N, lr.numRecords());
+	for (int i = 0; i < N; ++i) {
+		tuple_type r = lr.getRecord<tuple_type>(i);
+		EXPECT_EQ(0.002 * i, r.get<0>());
+		EXPECT_EQ(-2.0 * i, r.get<1>()[1]);
+		EXPECT_EQ(std::sin(0.01 * i), r.get<1>()[2]);
+		EXPECT_EQ(-i, r.get<2>());
+	}
+
+	std::vector<double> count;
+	lr.readChannel("count", &count, 250, 10);
+	ASSERT_EQ(10u, count.size());
+	EXPECT_EQ(-250.0, count[0]);
+	EXPECT_EQ(-259.0, count[9]);
+}
+
+TEST_F(ColumnLogTest, QuantizedRoundTrip) {
+	typedef boost::tuple<double, units::JointPositions<2>::type> sample_type;
+	const int N = 2000;
+	const double resolution = 1e-6;
+
+	units::JointPositions<2>::type jp;
+	{
+		log::ColumnWriter<sample_type> lw(tmpFile,
+				log::ColumnOptions("time,jp", true, resolution).setResolution("jp", resolution / 10.0), 0.002);
+		for (int i = 0; i < N; ++i) {
+			jp << std::sin(0.002 * i), 0.3 * std::cos(0.004 * i);
+			lw.putRecord(sample_type(0.002 * i, jp));
+		}
+	}
+	// Raw records would take 24 bytes each. Each delta here fits in 2 or 3 bytes.
+	EXPECT_LT(fileSize(), 24 * N / 3);
+
+	log::ColumnReader lr(tmpFile);
+	ASSERT_EQ(N, lr.numRecords());
+	std::vector<double> t, jp0, jp1;
+	lr.readChannel("time", &t);
+	lr.readChannel("jp[0]", &jp0);
+	lr.readChannel("jp[1]", &jp1);
+	for (int i = 0; i < N; ++i) {
+		EXPECT_NEAR(0.002 * i, t[i], resolution / 2.0);
+		EXPECT_NEAR(std::sin(0.002 * i), jp0[i], resolution / 20.0);
+		EXPECT_NEAR(0.3 * std::cos(0.004 * i), jp1[i], resolution / 20.0);
+	}
+}
+
+TEST_F(ColumnLogTest, UnquantizableValuesAreKept) {
+	const double values[] = { 1.0, std::numeric_limits<double>::quiet_NaN(), 1e30, -std::numeric_limits<double>::infinity() };
+	const size_t N = sizeof(values) / sizeof(values[0]);
+	{
+		log::ColumnWriter<double> lw(tmpFile, log::ColumnOptions("x", true, 0.001));
+		for (size_t i = 0; i < N; ++i) {
+			lw.putRecord(values[i]);
+		}
+	}
+
+	log::ColumnReader lr(tmpFile);
+	std::vector<double> x;
+	lr.readChannel("x", &x);
+	ASSERT_EQ(N, x.size());
+	EXPECT_EQ(1.0, x[0]);
+	EXPECT_TRUE(x[1] != x[1]);  // NaN
+	EXPECT_EQ(1e30, x[2]);
+	EXPECT_EQ(values[3], x[3]);
+}
+
+TEST_F(ColumnLogTest, CompressedRealTimeWriter) {
+	const size_t N = 1234;
+	{
+		log::RealTimeWriter<tuple_type> lw(tmpFile, 0.01, 100, log::ColumnOptions("time,jt,count", true, 1e-9));
+		for (size_t i = 0; i < N; ++i) {
+			lw.putRecord(record(i));
+			if (i % 50 == 0) {
+				btsleep(0.02);  // Let the disk thread keep up
+			}
+		}
+		lw.close();
+	}
+
+	log::ColumnReader lr(tmpFile);
+	ASSERT_EQ(N, lr.numRecords());
+	for (size_t i = 0; i < N; ++i) {
+		tuple_type r = lr.getRecord<tuple_type>(i);
+		EXPECT_NEAR(0.002 * i, r.get<0>(), 1e-9);
+		EXPECT_EQ(record(i).get<2>(), r.get<2>());
+	}
+}
+
+
+}
@@ -0,0 +1,167 @@
+/*
+ * csv_export.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <string>
+#include <cstdio>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/math/matrix.h>
+#include <barrett/log/schema.h>
+#include <barrett/log/writer.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/column_writer.h>
+#include <barrett/log/csv_export.h>
+
+#include "./verify_file_contents.h"
+#include "./tmp_file.h"
+
+
+namespace {
+using namespace barrett;
+
+
+typedef boost::tuple<double, math::Vector<2>::type, int> tuple_type;
+
+
+class CSVExportTest : public ::testing::Test {
+public:
+	CSVExportTest() {
+		makeTmpFile(logFile);
+		makeTmpFile(csvFile);
+	}
+	~CSVExportTest() {
+		std::remove(logFile);
+		std::remove(csvFile);
+	}
+
+	static tuple_type record(int i) {
+		math::Vector<2>::type v;
+		v << 0.5 * i, -1.0 / (i + 1);
+		return tuple_type(i * 1e-3, v, -i);
+	}
+
+	static std::string readFile(const char* name) {
+		std::ifstream ifs(name, std::ios_base::binary);
+		return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	}
+
+protected:
+	char logFile[14];
+	char csvFile[14];
+};
+
+
+TEST(FormatDoubleTest, MatchesPrintf) {
+	const double special[] = { 0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 0.125, 2.5, 1e-5, 1e-4, 9.9999999999, 99999.95,
+			123456789.0, 1e15, 1e16, 1e22, 1e23, 1e-300, 1.7976931348623157e308, 5e-324,
+			3e7, -44.2, 8.888, 1.0 / 3.0 };
+	const size_t numSpecial = sizeof(special) / sizeof(special[0]);
+
+	char buf[64], expected[64];
+	std::srand(5);
+	for (int precision = 1; precision <= 17; ++precision) {
+		for (int i = 0; i < 20000; ++i) {
+			double x;
+			if (static_cast<size_t>(i) < numSpecial) {
+				x = special[i];
+			} else {
+				// Random mantissas over a wide range of exponents
+				x = (std::rand() / (double) RAND_MAX - 0.5) * std::pow(10.0, std::rand() % 40 - 20);
+			}
+
+			size_t n = log::detail::formatDouble(x, precision, buf);
+			buf[n] = '\0';
+			snprintf(expected, sizeof(expected), "%.*g", precision, x);
+			ASSERT_STREQ(expected, buf) << "precision = " << precision;
+		}
+	}
+}
+
+TEST(FormatDoubleTest, NonFinite) {
+	char buf[64];
+	size_t n = log::detail::formatDouble(-1.0 / 0.0, 10, buf);
+	EXPECT_EQ("-inf", std::string(buf, n));
+}
+
+
+TEST_F(CSVExportTest, ColumnLog) {
+	{
+		log::ColumnWriter<tuple_type> lw(logFile, "time,v,count", 0.001, 2);
+		for (int i = 0; i < 3; ++i) {
+			lw.putRecord(record(i));
+		}
+	}
+
+	log::exportCSV(logFile, csvFile);
+
+	const char contents[] = "time,v[0],v[1],count\n"
+			"0,0,-1,0\n"
+			"0.001,0.5,-0.5,-1\n"
+			"0.002,1,-0.3333333333,-2\n";
+	verifyFileContents(csvFile, contents, sizeof(contents) - 1);
+}
+
+TEST_F(CSVExportTest, RawLog) {
+	{
+		log::Writer<tuple_type> lw(logFile);
+		for (int i = 0; i < 3; ++i) {
+			lw.putRecord(record(i));
+		}
+	}
+
+	log::Schema schema;
+	log::Traits<tuple_type>::describe("", &schema);
+	log::CSVOptions options;
+	options.header = false;
+	options.precision = 3;
+	options.recordsPerChunk = 2;
+	log::exportRawCSV(logFile, schema, csvFile, options);
+
+	const char contents[] = "0,0,-1,0\n"
+			"0.001,0.5,-0.5,-1\n"
+			"0.002,1,-0.333,-2\n";
+	verifyFileContents(csvFile, contents, sizeof(contents) - 1);
+
+	// A record length that doesn't divide the file
+	log::Schema wrong;
+	log::Traits<double>::describe("x", &wrong);
+	wrong.addField("y", log::Schema::INT32, 4, 4);
+	EXPECT_THROW(log::exportRawCSV(logFile, wrong, csvFile, options), std::runtime_error);
+}
+
+TEST_F(CSVExportTest, ParallelMatchesSerial) {
+	const int N = 20000;
+	{
+		log::ColumnWriter<tuple_type> lw(logFile, log::ColumnOptions("time,v,count"), 0.001, 512);
+		for (int i = 0; i < N; ++i) {
+			lw.putRecord(record(i));
+		}
+	}
+
+	log::CSVOptions options;
+	options.numThreads = 1;
+	log::exportCSV(logFile, csvFile, options);
+	std::string serial = readFile(csvFile);
+
+	options.numThreads = 4;
+	log::exportCSV(logFile, csvFile, options);
+	std::string parallel = readFile(csvFile);
+
+	EXPECT_EQ(N + 1, std::count(serial.begin(), serial.end(), '\n'));
+	EXPECT_TRUE(serial == parallel);
+}
+
+
+}
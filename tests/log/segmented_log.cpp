@@ -0,0 +1,199 @@
+/*
+ * segmented_log.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/os.h>
+#include <barrett/units.h>
+#include <barrett/log/column_options.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/log/segmented_writer.h>
+#include <barrett/log/segmented_reader.h>
+
+
+namespace {
+using namespace barrett;
+
+
+typedef units::JointTorques<3>::type jt_type;
+typedef boost::tuple<double, jt_type, int> tuple_type;
+
+const size_t BUFFER_RECORDS = 100;
+
+
+class SegmentedLogTest : public ::testing::Test {
+public:
+	SegmentedLogTest() {
+		std::strcpy(tmpDir, "/tmp/btXXXXXX");
+		EXPECT_TRUE(mkdtemp(tmpDir) != NULL);
+		baseName = std::string(tmpDir) + "/log";
+	}
+	~SegmentedLogTest() {
+		for (size_t i = 0; i < 100; ++i) {
+			std::remove(log::detail::segmentFileName(baseName, i).c_str());
+		}
+		std::remove(log::detail::segmentIndexFileName(baseName).c_str());
+		rmdir(tmpDir);
+	}
+
+	tuple_type record(size_t i) {
+		jt_type jt;
+		jt << i, -2.0 * i, 0.5 * i;
+		return tuple_type(0.002 * i, jt, 3 * i);
+	}
+
+	void writeRecords(size_t n, const log::SegmentOptions& options) {
+		log::SegmentedWriter<tuple_type> lw(baseName.c_str(), 0.01, BUFFER_RECORDS, options);
+		for (size_t i = 0; i < n; ++i) {
+			lw.putRecord(record(i));
+			if (i % 50 == 0) {
+				btsleep(0.02);  // Let the disk thread keep up
+			}
+		}
+		lw.close();
+	}
+
+protected:
+	char tmpDir[14];
+	std::string baseName;
+};
+
+
+TEST_F(SegmentedLogTest, RoundTripAcrossSegments) {
+	const size_t N = 1234;
+	log::SegmentOptions options(log::ColumnOptions("time,jt,count"));
+	options.maxSegmentDuration = 0.5;
+	writeRecords(N, options);
+
+	log::SegmentedReader lr(baseName.c_str());
+	EXPECT_EQ(5u, lr.numSegments());
+	ASSERT_EQ(N, lr.numRecords());
+	EXPECT_EQ(0.0, lr.startTime());
+	EXPECT_EQ(0.002 * (N - 1), lr.endTime());
+
+	for (size_t i = 0; i < N; ++i) {
+		tuple_type r = lr.getRecord<tuple_type>(i);
+		EXPECT_EQ(record(i).get<0>(), r.get<0>());
+		EXPECT_EQ(record(i).get<1>(), r.get<1>());
+		EXPECT_EQ(record(i).get<2>(), r.get<2>());
+	}
+
+	std::vector<double> count;
+	lr.readChannel("count", &count, 250, 700);
+	ASSERT_EQ(700u, count.size());
+	for (size_t i = 0; i < count.size(); ++i) {
+		EXPECT_EQ(3.0 * (250 + i), count[i]);
+	}
+	EXPECT_THROW(lr.readChannel("count", &count, N - 1, 2), std::out_of_range);
+
+	// Each segment is a column log in its own right.
+	log::ColumnReader segment(log::detail::segmentFileName(baseName, 1).c_str());
+	EXPECT_EQ(lr.getSchema(), segment.getSchema());
+	EXPECT_EQ(record(300).get<2>(), segment.getRecord<tuple_type>(0).get<2>());
+}
+
+TEST_F(SegmentedLogTest, FindTime) {
+	const size_t N = 1234;
+	log::SegmentOptions options(log::ColumnOptions("time,jt,count"));
+	options.maxSegmentDuration = 0.5;
+	writeRecords(N, options);
+
+	log::SegmentedReader lr(baseName.c_str());
+	EXPECT_EQ(0u, lr.findTime(-1.0));
+	EXPECT_EQ(0u, lr.findTime(0.0));
+	EXPECT_EQ(250u, lr.findTime(0.4999));
+	EXPECT_EQ(251u, lr.findTime(0.5001));
+	EXPECT_EQ(1001u, lr.findTime(2.0001));
+	EXPECT_EQ(N - 1, lr.findTime(lr.endTime()));
+	EXPECT_EQ(N, lr.findTime(100.0));
+
+	size_t first, count;
+	lr.findTimeRange(0.9999, 1.0999, &first, &count);
+	EXPECT_EQ(500u, first);
+	EXPECT_EQ(50u, count);
+	EXPECT_EQ(0.002 * first, lr.recordTime(first));
+
+	lr.findTimeRange(1.0, 0.5, &first, &count);
+	EXPECT_EQ(0u, count);
+}
+
+TEST_F(SegmentedLogTest, TimedBySamplePeriod) {
+	const size_t N = 1000;
+	log::SegmentOptions options(log::ColumnOptions("time,jt,count"), "");
+	options.maxSegmentDuration = 0.5;
+	{
+		log::SegmentedWriter<tuple_type> lw(baseName.c_str(), 0.002, options);
+		for (size_t i = 0; i < N; ++i) {
+			lw.putRecord(record(i));
+			if (i % 50 == 0) {
+				btsleep(0.02);
+			}
+		}
+	}
+
+	log::SegmentedReader lr(baseName.c_str());
+	ASSERT_EQ(N, lr.numRecords());
+	EXPECT_LT(1u, lr.numSegments());
+	EXPECT_EQ(0.002, lr.getSchema().getSamplePeriod());
+	EXPECT_EQ(0.002 * 10, lr.recordTime(10));
+	EXPECT_EQ(601u, lr.findTime(1.2001));
+
+	// Without a sample period, there's no way to time the records.
+	EXPECT_THROW(log::SegmentedWriter<tuple_type>(baseName.c_str(), 0.01, BUFFER_RECORDS, options), std::logic_error);
+}
+
+TEST_F(SegmentedLogTest, RotatesBySize) {
+	log::SegmentOptions options(log::ColumnOptions("time,jt,count"));
+	options.maxSegmentBytes = 1;
+	options.maxSegmentDuration = 0.0;
+	writeRecords(450, options);
+
+	log::SegmentedReader lr(baseName.c_str());
+	EXPECT_EQ(5u, lr.numSegments());
+	ASSERT_EQ(450u, lr.numRecords());
+	EXPECT_EQ(record(449).get<2>(), lr.getRecord<tuple_type>(449).get<2>());
+}
+
+TEST_F(SegmentedLogTest, CrashLosesOnlyTheTail) {
+	log::SegmentOptions options(log::ColumnOptions("time,jt,count"));
+	options.maxSegmentBytes = 1;
+	options.maxSegmentDuration = 0.0;
+	writeRecords(450, options);
+
+	// As if the last block never made it to the disk
+	std::string last = log::detail::segmentFileName(baseName, 4);
+	FILE* fp = std::fopen(last.c_str(), "r+b");
+	ASSERT_TRUE(fp != NULL);
+	std::fseek(fp, 0, SEEK_END);
+	EXPECT_EQ(0, ftruncate(fileno(fp), std::ftell(fp) - 10));
+	std::fclose(fp);
+
+	log::SegmentedReader lr(baseName.c_str());
+	ASSERT_EQ(400u, lr.numRecords());
+	EXPECT_EQ(0.002 * 399, lr.endTime());
+	EXPECT_EQ(400u, lr.findTime(10.0));
+	EXPECT_EQ(record(399).get<2>(), lr.getRecord<tuple_type>(399).get<2>());
+}
+
+TEST_F(SegmentedLogTest, Throws) {
+	EXPECT_THROW(log::SegmentedReader(baseName.c_str()), std::runtime_error);
+
+	log::SegmentOptions options(log::ColumnOptions("t,jt,count"));
+	EXPECT_THROW(log::SegmentedWriter<tuple_type>(baseName.c_str(), 0.01, BUFFER_RECORDS, options), std::out_of_range);
+}
+
+
+}
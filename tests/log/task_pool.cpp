@@ -0,0 +1,70 @@
+/*
+ * task_pool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+
+#include <barrett/log/detail/task_pool.h>
+
+
+namespace {
+using namespace barrett;
+
+
+void square(std::vector<size_t>* results, size_t i) {
+	(*results)[i] = i * i;
+}
+
+void failAt(size_t bad, std::vector<size_t>* results, size_t i) {
+	if (i == bad) {
+		throw std::out_of_range("bad task");
+	}
+	(*results)[i] = 1;
+}
+
+
+TEST(TaskPoolTest, RunsEveryTask) {
+	log::detail::TaskPool pool(4);
+	EXPECT_EQ(4u, pool.numThreads());
+
+	for (size_t n = 0; n < 50; n += 7) {
+		std::vector<size_t> results(n, 0);
+		pool.run(boost::bind(square, &results, _1), n);
+		for (size_t i = 0; i < n; ++i) {
+			EXPECT_EQ(i * i, results[i]);
+		}
+	}
+}
+
+TEST(TaskPoolTest, ForwardsExceptions) {
+	log::detail::TaskPool pool(3);
+	std::vector<size_t> results(1000, 0);
+
+	EXPECT_THROW(pool.run(boost::bind(failAt, 10, &results, _1), results.size()), std::out_of_range);
+	EXPECT_EQ(0u, results[10]);
+
+	// The pool is still usable afterwards.
+	pool.run(boost::bind(square, &results, _1), results.size());
+	EXPECT_EQ(100u, results[10]);
+}
+
+TEST(TaskPoolTest, OverlapsWithTheCaller) {
+	log::detail::TaskPool pool(1);  // No workers: everything runs in wait()
+	std::vector<size_t> results(10, 0);
+
+	pool.start(boost::bind(square, &results, _1), results.size());
+	EXPECT_EQ(0u, results[3]);
+	pool.wait();
+	EXPECT_EQ(9u, results[3]);
+}
+
+
+}
@@ -0,0 +1,205 @@
+/*
+ * telemetry.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/log/schema.h>
+#include <barrett/log/telemetry.h>
+
+
+namespace {
+using namespace barrett;
+
+
+typedef boost::tuple<double, int> tuple_type;
+
+
+class TelemetryTest : public ::testing::Test {
+public:
+	TelemetryTest() :
+		name("bt-telemetry-test-" + boost::lexical_cast<std::string>(getpid())), schema(0.002)
+	{
+		log::Traits<tuple_type>::describe("time,count", &schema);
+	}
+
+	static void put(log::TelemetryRing* ring, int i) {
+		log::Traits<tuple_type>::serialize(tuple_type(i * 0.002, i), ring->beginWrite());
+		ring->endWrite();
+	}
+
+protected:
+	std::string name;
+	log::Schema schema;
+};
+
+
+TEST_F(TelemetryTest, AttachToMissingRing) {
+	log::TelemetryReader tr;
+	EXPECT_FALSE(tr.attach(name));
+	EXPECT_FALSE(tr.isAttached());
+	EXPECT_FALSE(tr.isPublisherOpen());
+
+	char buffer[64];
+	EXPECT_FALSE(tr.read(buffer));
+	EXPECT_THROW(log::TelemetryReader r(name), std::runtime_error);
+}
+
+TEST_F(TelemetryTest, ReadsInOrder) {
+	log::TelemetryRing ring(name, schema, 10);
+	EXPECT_EQ(16u, ring.getCapacity());
+	EXPECT_EQ("/" + name, ring.getName());
+
+	put(&ring, -1);  // Written before the reader attached
+
+	log::TelemetryReader tr(name);
+	EXPECT_TRUE(tr.isPublisherOpen());
+	EXPECT_TRUE(tr.getSchema() == schema);
+	EXPECT_EQ(16u, tr.getCapacity());
+
+	tuple_type t;
+	EXPECT_FALSE(tr.read(&t));
+
+	for (int i = 0; i < 40; ++i) {
+		put(&ring, i);
+		if (i % 3 == 2) {
+			EXPECT_EQ(3u, tr.numAvailable());
+			for (int j = i - 2; j <= i; ++j) {
+				ASSERT_TRUE(tr.read(&t));
+				EXPECT_EQ(j, t.get<1>());
+				EXPECT_EQ(j * 0.002, t.get<0>());
+			}
+			EXPECT_FALSE(tr.read(&t));
+		}
+	}
+	EXPECT_EQ(0u, tr.getNumLost());
+
+	boost::tuple<double, double> wrong;
+	EXPECT_THROW(tr.read(&wrong), std::logic_error);
+}
+
+TEST_F(TelemetryTest, SlowReaderLosesRecords) {
+	log::TelemetryRing ring(name, schema, 8);
+	log::TelemetryReader tr(name);
+
+	for (int i = 0; i < 20; ++i) {
+		put(&ring, i);
+	}
+	EXPECT_EQ(8u, tr.numAvailable());
+
+	tuple_type t;
+	for (int i = 12; i < 20; ++i) {
+		ASSERT_TRUE(tr.read(&t));
+		EXPECT_EQ(i, t.get<1>());
+	}
+	EXPECT_FALSE(tr.read(&t));
+	EXPECT_EQ(12u, tr.getNumLost());
+}
+
+TEST_F(TelemetryTest, ReadLatest) {
+	log::TelemetryRing ring(name, schema);
+	log::TelemetryReader tr(name);
+
+	std::vector<char> buffer(tr.recordLength());
+	EXPECT_FALSE(tr.readLatest(&buffer[0]));
+
+	for (int i = 0; i < 5; ++i) {
+		put(&ring, i);
+	}
+	ASSERT_TRUE(tr.readLatest(&buffer[0]));
+	EXPECT_EQ(4, log::Traits<tuple_type>::unserialize(&buffer[0]).get<1>());
+	EXPECT_FALSE(tr.readLatest(&buffer[0]));
+	EXPECT_EQ(0u, tr.getNumLost());
+}
+
+TEST_F(TelemetryTest, ReattachAfterPublisherRestarts) {
+	log::TelemetryReader tr;
+	tuple_type t;
+
+	{
+		log::TelemetryRing ring(name, schema);
+		ASSERT_TRUE(tr.attach(name));
+		put(&ring, 1);
+		ring.setSamplePeriod(0.004);
+		EXPECT_EQ(0.004, tr.getSchema().getSamplePeriod());
+	}
+	EXPECT_TRUE(tr.isAttached());
+	EXPECT_FALSE(tr.isPublisherOpen());
+	ASSERT_TRUE(tr.read(&t));  // The old segment is still readable
+	EXPECT_EQ(1, t.get<1>());
+	EXPECT_FALSE(tr.attach(name));  // ...but it's gone
+
+	log::TelemetryRing ring(name, schema);
+	ASSERT_TRUE(tr.attach(name));
+	EXPECT_TRUE(tr.isPublisherOpen());
+	put(&ring, 2);
+	ASSERT_TRUE(tr.read(&t));
+	EXPECT_EQ(2, t.get<1>());
+
+	tr.detach();
+	EXPECT_FALSE(tr.isAttached());
+	EXPECT_FALSE(tr.read(&t));
+}
+
+TEST_F(TelemetryTest, NewRingReplacesStaleSegment) {
+	log::TelemetryRing* first = new log::TelemetryRing(name, schema);
+	log::TelemetryReader tr(name);
+
+	{
+		log::TelemetryRing second(name, schema);
+
+		// Destroying the first ring mustn't unlink the second one's segment.
+		delete first;
+		EXPECT_FALSE(tr.isPublisherOpen());
+		EXPECT_TRUE(tr.attach(name));
+		EXPECT_TRUE(tr.isPublisherOpen());
+	}
+	EXPECT_FALSE(tr.isPublisherOpen());
+	EXPECT_FALSE(log::TelemetryReader().attach(name));
+}
+
+void writeRecords(log::TelemetryRing* ring, int n) {
+	for (int i = 0; i < n; ++i) {
+		TelemetryTest::put(ring, i);
+	}
+}
+
+TEST_F(TelemetryTest, ConcurrentReaderSeesConsistentRecords) {
+	const int N = 200000;
+	log::TelemetryRing ring(name, schema, 64);
+	log::TelemetryReader tr(name);
+
+	boost::thread writer(writeRecords, &ring, N);
+
+	int last = -1;
+	size_t numRead = 0;
+	tuple_type t;
+	while (last != N - 1) {
+		if (tr.read(&t)) {
+			ASSERT_GT(t.get<1>(), last);
+			ASSERT_EQ(t.get<1>() * 0.002, t.get<0>());  // Not torn
+			last = t.get<1>();
+			++numRead;
+		}
+	}
+	writer.join();
+
+	EXPECT_EQ(N, numRead + tr.getNumLost());
+}
+
+
+}
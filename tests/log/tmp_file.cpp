@@ -0,0 +1,22 @@
+/*
+ * tmp_file.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include "./tmp_file.h"
+
+
+void makeTmpFile(char* name)
+{
+	std::strcpy(name, "/tmp/btXXXXXX");
+	int fd = mkstemp(name);
+	EXPECT_TRUE(fd != -1);
+	close(fd);
+}
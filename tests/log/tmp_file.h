@@ -0,0 +1,16 @@
+/*
+ * tmp_file.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef TMP_FILE_H_
+#define TMP_FILE_H_
+
+
+// Creates an empty file and puts its name in name, which must have room for
+// 14 characters.
+void makeTmpFile(char* name);
+
+
+#endif /* TMP_FILE_H_ */
@@ -0,0 +1,118 @@
+/*
+ * aabb_tree.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+#include <barrett/math/aabb_tree.h>
+
+
+namespace {
+using namespace barrett;
+
+
+typedef math::AabbTree::box_type box_type;
+
+
+// Squared distance to an item's box
+struct BoxDistance {
+	explicit BoxDistance(const math::AabbTree& t) : tree(t), numCalls(0) {}
+
+	double operator() (size_t item, const Eigen::Vector3d& p) {
+		++numCalls;
+		return tree.getBox(item).squaredExteriorDistance(p);
+	}
+
+	const math::AabbTree& tree;
+	size_t numCalls;
+};
+
+struct CollectItems {
+	void operator() (size_t item) {  items.push_back(item);  }
+	std::vector<size_t> items;
+};
+
+
+class AabbTreeTest : public ::testing::Test {
+public:
+	AabbTreeTest() {
+		srand(1);
+		for (size_t i = 0; i < 500; ++i) {
+			Eigen::Vector3d c = Eigen::Vector3d::Random() * 10.0;
+			Eigen::Vector3d half = (Eigen::Vector3d::Random().array().abs() * 0.2).matrix();
+			boxes.push_back(box_type(c - half, c + half));
+		}
+		tree.build(boxes);
+	}
+
+protected:
+	math::AabbTree::box_vector boxes;
+	math::AabbTree tree;
+};
+
+
+TEST_F(AabbTreeTest, NearestMatchesBruteForce) {
+	for (int n = 0; n < 100; ++n) {
+		Eigen::Vector3d p = Eigen::Vector3d::Random() * 12.0;
+
+		double bestSq = 1e300;
+		for (size_t i = 0; i < boxes.size(); ++i) {
+			bestSq = std::min(bestSq, boxes[i].squaredExteriorDistance(p));
+		}
+
+		BoxDistance bd(tree);
+		double dist;
+		size_t item = tree.nearest(p, bd, &dist);
+		ASSERT_NE(math::AabbTree::NONE, item);
+		EXPECT_DOUBLE_EQ(bestSq, boxes[item].squaredExteriorDistance(p));
+		EXPECT_NEAR(std::sqrt(bestSq), dist, 1e-12);
+		EXPECT_LT(bd.numCalls, boxes.size() / 4) << "not pruning";
+	}
+}
+
+TEST_F(AabbTreeTest, NearestRespectsMaxDistance) {
+	BoxDistance bd(tree);
+	double dist;
+	EXPECT_EQ(math::AabbTree::NONE, tree.nearest(Eigen::Vector3d(100, 0, 0), bd, &dist, 1.0));
+	EXPECT_EQ(1.0, dist);
+}
+
+TEST_F(AabbTreeTest, QueryMatchesBruteForce) {
+	const double radius = 1.5;
+	for (int n = 0; n < 50; ++n) {
+		Eigen::Vector3d p = Eigen::Vector3d::Random() * 10.0;
+
+		std::vector<size_t> expected;
+		for (size_t i = 0; i < boxes.size(); ++i) {
+			if (boxes[i].squaredExteriorDistance(p) <= radius * radius) {
+				expected.push_back(i);
+			}
+		}
+
+		CollectItems ci;
+		tree.query(p, radius, ci);
+		std::sort(ci.items.begin(), ci.items.end());
+		EXPECT_EQ(expected, ci.items);
+	}
+}
+
+TEST(AabbTreeEmptyTest, Empty) {
+	math::AabbTree tree;
+	BoxDistance bd(tree);
+	CollectItems ci;
+
+	EXPECT_TRUE(tree.empty());
+	EXPECT_EQ(math::AabbTree::NONE, tree.nearest(Eigen::Vector3d::Zero(), bd));
+	tree.query(Eigen::Vector3d::Zero(), 1.0, ci);
+	EXPECT_TRUE(ci.items.empty());
+}
+
+
+}
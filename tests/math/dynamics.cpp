@@ -0,0 +1,268 @@
+/*
+ * dynamics.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstdlib>
+
+#include <libconfig.h++>
+#include <Eigen/Eigenvalues>
+#include <gtest/gtest.h>
+
+#include <barrett/units.h>
+#include <barrett/cdlbt/kinematics.h>
+#include <barrett/cdlbt/dynamics.h>
+#include <barrett/math/kinematics.h>
+#include <barrett/math/dynamics.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const size_t DOF = 7;
+BARRETT_UNITS_TYPEDEFS(DOF);
+
+
+class ExposedDynamics : public math::Dynamics<DOF> {
+public:
+	explicit ExposedDynamics(const libconfig::Setting& setting) :
+		math::Dynamics<DOF>(setting) {}
+
+	struct bt_dynamics* getImpl() { return impl; }
+
+	// Potential energy of the links in the current configuration
+	double potentialEnergy(const math::Kinematics<DOF>& kin, double gravity) const {
+		double v = 0.0;
+		for (size_t j = 0; j < DOF; ++j) {
+			const struct bt_kinematics_link* link = kin.impl->link[j];
+			double z = gsl_vector_get(link->origin_pos, 2);
+			for (size_t i = 0; i < 3; ++i) {
+				z += gsl_matrix_get(link->rot_to_world, 2, i) * com[j][i];
+			}
+			v -= mass[j] * gravity * z;
+		}
+		return v;
+	}
+};
+
+
+class DynamicsTest : public ::testing::Test {
+public:
+	DynamicsTest() :
+		kin(NULL), dyn(NULL)
+	{
+		libconfig::Config config;
+		config.readFile("test.config");
+		kin = new math::Kinematics<DOF>(config.lookup("wam.kinematics"));
+		dyn = new ExposedDynamics(config.lookup("wam.dynamics"));
+
+		std::srand(0);
+	}
+
+	~DynamicsTest() {
+		delete dyn;
+		delete kin;
+	}
+
+	template<typename T> T random(double scale) {
+		T x;
+		for (size_t i = 0; i < DOF; ++i) {
+			x[i] = scale * (2.0 * std::rand() / RAND_MAX - 1.0);
+		}
+		return x;
+	}
+
+	void evalKinematics(const jp_type& jp, const jv_type& jv) {
+		kin->eval(jp, jv);
+	}
+
+protected:
+	math::Kinematics<DOF>* kin;
+	ExposedDynamics* dyn;
+};
+
+
+// Joint positions, velocities and accelerations, and the torques they need.
+// The torques come from the Euler-Lagrange equations,
+//     jt = M ja + dM/dt jv - 1/2 d/dq (jv^T M jv),
+// with M built from the link Jacobians of the test.config WAM and its
+// derivatives taken by complex-step differentiation, independently of the
+// recursive Newton-Euler code under test.
+const double INVERSE_REFERENCE[][4][DOF] = {
+	{
+		{ 0.0, -1.94, 0.0, 3.14, 0.0, 1.57, 0.0 },
+		{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 0.725951264979, 0.00184997448949, -0.0923123062707, 2.46626580796e-06, 0.00108707326343, 0.0, -0.000931750235289 }
+	},
+	{
+		{ 0.3, -0.8, 0.5, 1.2, -0.4, 0.6, 0.2 },
+		{ 0.5, -0.4, 0.3, 0.8, -0.6, 0.2, 0.1 },
+		{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+		{ 0.21821316332, -0.124046215296, -0.0642328145609, 0.00383273826664, -0.00185883470359, -0.00102524546144, -0.000585938718396 }
+	},
+	{
+		{ -1.1, 0.6, -0.9, 2.0, 1.3, -1.0, 0.7 },
+		{ -1.2, 0.9, 0.4, -0.7, 1.5, -0.3, 0.8 },
+		{ 2.0, -1.5, 3.0, 0.5, -2.5, 1.0, -0.5 },
+		{ 1.36956635301, -0.403475653783, 0.82082063377, 0.515423514646, -0.0126088070074, 0.00924460549827, -0.000737101387723 }
+	}
+};
+
+
+TEST_F(DynamicsTest, InverseMatchesReference) {
+	const size_t numPoses = sizeof(INVERSE_REFERENCE) / sizeof(INVERSE_REFERENCE[0]);
+	for (size_t n = 0; n < numPoses; ++n) {
+		jp_type jp(INVERSE_REFERENCE[n][0]);
+		jv_type jv(INVERSE_REFERENCE[n][1]);
+		ja_type ja(INVERSE_REFERENCE[n][2]);
+		jt_type expected(INVERSE_REFERENCE[n][3]);
+
+		evalKinematics(jp, jv);
+		jt_type jt = dyn->evalInverse(*kin, jv, ja);
+		for (size_t i = 0; i < DOF; ++i) {
+			EXPECT_NEAR(expected[i], jt[i], 1e-10) << "pose " << n << ", joint " << i;
+		}
+	}
+}
+
+TEST_F(DynamicsTest, JsimMatchesInverse) {
+	// With no velocity, the inverse dynamics of a unit joint acceleration is
+	// a column of the joint-space inertia matrix.
+	evalKinematics(jp_type(INVERSE_REFERENCE[2][0]), jv_type(0.0));
+	ASSERT_EQ(0, bt_dynamics_eval_jsim(dyn->getImpl(), kin->impl));
+	sqm_type jsim(dyn->getImpl()->jsim);
+
+	for (size_t i = 0; i < DOF; ++i) {
+		ja_type ja(0.0);
+		ja[i] = 1.0;
+		jt_type expected = dyn->evalInverse(*kin, jv_type(0.0), ja);
+		for (size_t j = 0; j < DOF; ++j) {
+			EXPECT_NEAR(expected[j], jsim(j,i), 1e-12) << "(" << j << ", " << i << ")";
+		}
+	}
+}
+
+TEST_F(DynamicsTest, MassMatrixMatchesRnea) {
+	for (int n = 0; n < 20; ++n) {
+		evalKinematics(random<jp_type>(2.0), jv_type(0.0));
+		sqm_type M = dyn->evalMassMatrix(*kin);
+
+		// With no velocity, the RNEA gives M * ja.
+		for (size_t i = 0; i < DOF; ++i) {
+			ja_type ja(0.0);
+			ja[i] = 1.0;
+			jt_type expected = dyn->evalInverse(*kin, jv_type(0.0), ja);
+			EXPECT_TRUE(expected.isApprox(M.col(i), 1e-10) || (expected - M.col(i)).norm() < 1e-12)
+					<< "column " << i << ":\n" << expected << "\n" << M.col(i).transpose();
+		}
+	}
+}
+
+TEST_F(DynamicsTest, MassMatrixMatchesJsim) {
+	evalKinematics(random<jp_type>(2.0), jv_type(0.0));
+	sqm_type M = dyn->evalMassMatrix(*kin);
+
+	bt_dynamics_eval_jsim(dyn->getImpl(), kin->impl);
+	sqm_type jsim(dyn->getImpl()->jsim);
+	EXPECT_TRUE(jsim.isApprox(M, 1e-12)) << jsim << "\n\n" << M;
+}
+
+TEST_F(DynamicsTest, MassMatrixIsSymmetricPositiveDefinite) {
+	for (int n = 0; n < 20; ++n) {
+		evalKinematics(random<jp_type>(3.0), jv_type(0.0));
+		sqm_type M = dyn->evalMassMatrix(*kin);
+
+		EXPECT_TRUE(M.isApprox(M.transpose(), 1e-12));
+		Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, DOF,DOF> > es(M);
+		EXPECT_GT(es.eigenvalues().minCoeff(), 0.0);
+	}
+}
+
+TEST_F(DynamicsTest, InverseMatchesCdlbt) {
+	// C code still calls bt_dynamics_eval_inverse() directly.
+	for (int n = 0; n < 20; ++n) {
+		jv_type jv = random<jv_type>(2.0);
+		ja_type ja = random<ja_type>(3.0);
+		evalKinematics(random<jp_type>(2.0), jv);
+
+		jt_type expected;
+		bt_dynamics_eval_inverse(dyn->getImpl(), kin->impl, jv.asGslType().get(), ja.asGslType().get(), expected.asGslType().get());
+		jt_type jt = dyn->evalInverse(*kin, jv, ja);
+		EXPECT_TRUE(expected.isApprox(jt, 1e-10)) << expected << "\n" << jt;
+	}
+}
+
+TEST_F(DynamicsTest, BiasMatchesMassMatrixDerivative) {
+	// h = dM/dt qd - 1/2 d/dq (qd^T M qd), with dM/dq from central differences
+	const double eps = 1e-6;
+	jp_type jp = random<jp_type>(2.0);
+	jv_type jv = random<jv_type>(2.0);
+
+	sqm_type dM[DOF];
+	for (size_t k = 0; k < DOF; ++k) {
+		jp_type jpPlus(jp), jpMinus(jp);
+		jpPlus[k] += eps;
+		jpMinus[k] -= eps;
+
+		evalKinematics(jpPlus, jv);
+		sqm_type Mplus = dyn->evalMassMatrix(*kin);
+		evalKinematics(jpMinus, jv);
+		dM[k] = (Mplus - dyn->evalMassMatrix(*kin)) / (2.0 * eps);
+	}
+
+	sqm_type Mdot(0.0);
+	for (size_t k = 0; k < DOF; ++k) {
+		Mdot += jv[k] * dM[k];
+	}
+	jt_type expected = Mdot * jv;
+	for (size_t i = 0; i < DOF; ++i) {
+		expected[i] -= 0.5 * jv.dot(dM[i] * jv);
+	}
+
+	evalKinematics(jp, jv);
+	jt_type h = dyn->evalBias(*kin, jv);
+	EXPECT_TRUE(expected.isApprox(h, 1e-6)) << expected << "\n" << h;
+}
+
+TEST_F(DynamicsTest, GravityIsPotentialEnergyGradient) {
+	const double g = -9.805;
+	const double eps = 1e-6;
+
+	for (int n = 0; n < 20; ++n) {
+		jp_type jp = random<jp_type>(2.0);
+
+		jt_type expected;
+		for (size_t k = 0; k < DOF; ++k) {
+			jp_type jpPlus(jp), jpMinus(jp);
+			jpPlus[k] += eps;
+			jpMinus[k] -= eps;
+
+			evalKinematics(jpPlus, jv_type(0.0));
+			double vPlus = dyn->potentialEnergy(*kin, g);
+			evalKinematics(jpMinus, jv_type(0.0));
+			expected[k] = (vPlus - dyn->potentialEnergy(*kin, g)) / (2.0 * eps);
+		}
+
+		evalKinematics(jp, jv_type(0.0));
+		jt_type jt = dyn->evalGravity(*kin, g);
+		EXPECT_TRUE(expected.isApprox(jt, 1e-6)) << expected << "\n" << jt;
+	}
+}
+
+TEST_F(DynamicsTest, ForwardInvertsInverse) {
+	for (int n = 0; n < 20; ++n) {
+		jv_type jv = random<jv_type>(2.0);
+		ja_type ja = random<ja_type>(5.0);
+		evalKinematics(random<jp_type>(2.0), jv);
+
+		jt_type jt = dyn->evalInverse(*kin, jv, ja);
+		ja_type result = dyn->evalForward(*kin, jv, jt);
+		EXPECT_TRUE(ja.isApprox(result, 1e-8)) << ja << "\n" << result;
+	}
+}
+
+
+}
@@ -0,0 +1,106 @@
+/*
+ * gravity.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstring>
+#include <cstdlib>
+
+#include <libconfig.h++>
+#include <gtest/gtest.h>
+
+#include <barrett/units.h>
+#include <barrett/cdlbt/calgrav.h>
+#include <barrett/math/kinematics.h>
+#include <barrett/math/gravity.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const size_t DOF = 7;
+BARRETT_UNITS_TYPEDEFS(DOF);
+
+
+class GravityTest : public ::testing::Test {
+public:
+	GravityTest() :
+		kin(NULL), grav(NULL), calgrav(NULL)
+	{
+		config.readFile("test.config");
+		kin = new math::Kinematics<DOF>(config.lookup("wam.kinematics"));
+		grav = new math::Gravity<DOF>(config.lookup("wam.gravity_compensation"));
+		bt_calgrav_create(&calgrav, config.lookup("wam.gravity_compensation").getCSetting(), DOF);
+	}
+
+	~GravityTest() {
+		bt_calgrav_destroy(calgrav);
+		delete grav;
+		delete kin;
+	}
+
+	// Returns true if the two paths give bit-for-bit identical torques.
+	bool evalBoth(const jp_type& jp, jt_type* expected, jt_type* actual) {
+		kin->eval(jp, jv_type(0.0));
+		bt_calgrav_eval(calgrav, kin->impl, expected->asGslType().get());
+		grav->eval(*kin, actual);
+		return std::memcmp(expected->data(), actual->data(), sizeof(double) * DOF) == 0;
+	}
+
+protected:
+	libconfig::Config config;
+	math::Kinematics<DOF>* kin;
+	math::Gravity<DOF>* grav;
+	struct bt_calgrav* calgrav;
+};
+
+
+TEST_F(GravityTest, ReadsMus) {
+	const libconfig::Setting& mus = config.lookup("wam.gravity_compensation.mus");
+	for (size_t j = 0; j < DOF; ++j) {
+		EXPECT_EQ(math::Vector<3>::type(mus[j]), grav->getMu(j));
+	}
+	EXPECT_EQ(math::Gravity<DOF>::DEFAULT_GRAVITY, grav->getGravity());
+}
+
+TEST_F(GravityTest, MatchesCalgravExactly) {
+	jt_type expected, actual;
+
+	jp_type jp(0.0);
+	EXPECT_TRUE(evalBoth(jp, &expected, &actual)) << expected << "\n" << actual;
+
+	jp << 7.30467e-05, -1.96708, -0.000456121, 3.04257, -0.0461776, 1.54314, -0.0226513;
+	EXPECT_TRUE(evalBoth(jp, &expected, &actual)) << expected << "\n" << actual;
+
+	std::srand(0);
+	for (int i = 0; i < 1000; ++i) {
+		for (size_t j = 0; j < DOF; ++j) {
+			jp[j] = 6.0 * (std::rand() / (double)RAND_MAX - 0.5);
+		}
+		ASSERT_TRUE(evalBoth(jp, &expected, &actual)) << "jp = " << jp;
+	}
+}
+
+TEST_F(GravityTest, SetGravity) {
+	jt_type expected, actual;
+	jp_type jp;
+	jp << 0.1, -1.2, 0.3, 2.0, -0.5, 0.6, -0.7;
+
+	grav->setGravity(-1.62);
+	bt_calgrav_update(calgrav, -1.62);
+	EXPECT_EQ(-1.62, grav->getGravity());
+	EXPECT_TRUE(evalBoth(jp, &expected, &actual)) << expected << "\n" << actual;
+
+	grav->setGravity(0.0);
+	kin->eval(jp, jv_type(0.0));
+	EXPECT_EQ(jt_type(0.0), grav->eval(*kin));
+}
+
+TEST_F(GravityTest, WrongNumberOfMusThrows) {
+	EXPECT_THROW(math::Gravity<4> g(config.lookup("wam.gravity_compensation")), std::runtime_error);
+}
+
+
+}
@@ -0,0 +1,168 @@
+/*
+ * inverse_kinematics.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include <libconfig.h++>
+#include <Eigen/Geometry>
+#include <gtest/gtest.h>
+
+#include <barrett/units.h>
+#include <barrett/math/kinematics.h>
+#include <barrett/math/inverse_kinematics.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const size_t DOF = 7;
+BARRETT_UNITS_TYPEDEFS(DOF);
+
+
+class InverseKinematicsTest : public ::testing::Test {
+public:
+	InverseKinematicsTest() :
+		fk(NULL), ik(NULL), lower(), upper()
+	{
+		libconfig::Config config;
+		config.readFile("test.config");
+		fk = new math::Kinematics<DOF>(config.lookup("wam.kinematics"));
+
+		lower << -2.6, -2.0, -2.8, -0.9, -4.76, -1.6, -3.0;
+		upper <<  2.6,  2.0,  2.8,  3.1,  1.24,  1.6,  3.0;
+		ik = new math::InverseKinematics<DOF>(config.lookup("wam.kinematics"), lower, upper);
+
+		std::srand(0);
+	}
+
+	~InverseKinematicsTest() {
+		delete ik;
+		delete fk;
+	}
+
+	// A random configuration away from the joint limits
+	jp_type randomJp() {
+		jp_type jp;
+		for (size_t i = 0; i < DOF; ++i) {
+			double r = std::rand() / (double)RAND_MAX;
+			jp[i] = lower[i] + (0.15 + 0.7 * r) * (upper[i] - lower[i]);
+		}
+		return jp;
+	}
+
+	cp_type toolPosition(const jp_type& jp) {
+		fk->eval(jp, jv_type(0.0));
+		return cp_type(fk->impl->tool->origin_pos);
+	}
+
+	Eigen::Quaterniond toolOrientation(const jp_type& jp) {
+		fk->eval(jp, jv_type(0.0));
+		return Eigen::Quaterniond(math::Matrix<3,3>(fk->impl->tool->rot_to_world));
+	}
+
+protected:
+	math::Kinematics<DOF>* fk;
+	math::InverseKinematics<DOF>* ik;
+	jp_type lower, upper;
+};
+
+
+TEST_F(InverseKinematicsTest, Position) {
+	for (int i = 0; i < 50; ++i) {
+		jp_type target = randomJp();
+		cp_type cp = toolPosition(target);
+
+		jp_type jp = target + jp_type(0.1);  // nearby initial guess
+		math::InverseKinematics<DOF>::Result r = ik->solve(cp, &jp);
+
+		ASSERT_TRUE(r.converged) << "i = " << i << ", error = " << r.positionError;
+		EXPECT_LT((toolPosition(jp) - cp).norm(), 1e-5);
+		EXPECT_TRUE((jp.array() >= lower.array()).all() && (jp.array() <= upper.array()).all());
+	}
+}
+
+TEST_F(InverseKinematicsTest, Pose) {
+	for (int i = 0; i < 50; ++i) {
+		jp_type target = randomJp();
+		pose_type pose = boost::make_tuple(toolPosition(target), toolOrientation(target));
+
+		jp_type jp = target + jp_type(0.05);
+		math::InverseKinematics<DOF>::Result r = ik->solve(pose, &jp);
+
+		ASSERT_TRUE(r.converged) << "i = " << i << ", errors = " << r.positionError << ", " << r.orientationError;
+		EXPECT_LT((toolPosition(jp) - boost::get<0>(pose)).norm(), 1e-5);
+		EXPECT_LT(toolOrientation(jp).angularDistance(boost::get<1>(pose)), 1e-4);
+	}
+}
+
+TEST_F(InverseKinematicsTest, WarmStartFromSolution) {
+	jp_type jp = randomJp();
+	cp_type cp = toolPosition(jp);
+
+	math::InverseKinematics<DOF>::Result r = ik->solve(cp, &jp);
+	EXPECT_TRUE(r.converged);
+	EXPECT_EQ(0u, r.iterations);
+}
+
+TEST_F(InverseKinematicsTest, UnreachableTargetIsBounded) {
+	ik->setMaxIterations(20);
+
+	jp_type jp = randomJp();
+	math::InverseKinematics<DOF>::Result r = ik->solve(cp_type(3.0, 0.0, 0.0), &jp);
+
+	EXPECT_FALSE(r.converged);
+	EXPECT_EQ(20u, r.iterations);
+	EXPECT_GT(r.positionError, 1.0);
+	EXPECT_TRUE((jp.array() >= lower.array()).all() && (jp.array() <= upper.array()).all());
+}
+
+TEST_F(InverseKinematicsTest, RestPositionUsesNullspace) {
+	jp_type target = randomJp();
+	cp_type cp = toolPosition(target);
+
+	jp_type rest = target;
+	rest[2] += 0.3;  // J3 twist can move without moving the tool much
+	ik->setJointLimitGain(0.0);
+	ik->setRestPosition(rest, 0.5);
+	ik->setMaxIterations(500);
+
+	jp_type withoutRest = target;
+	jp_type withRest = target;
+	ik->setRestPosition(rest, 0.0);
+	ik->solve(cp, &withoutRest);
+	ik->setRestPosition(rest, 0.5);
+	math::InverseKinematics<DOF>::Result r = ik->solve(cp + cp_type(1e-3, 0.0, 0.0), &withRest);
+
+	// The secondary objective mustn't stop the primary one from converging.
+	ASSERT_TRUE(r.converged);
+	EXPECT_LT((withRest - rest).norm(), (withoutRest - rest).norm());
+}
+
+TEST_F(InverseKinematicsTest, Path) {
+	jp_type start = randomJp();
+	cp_type cp0 = toolPosition(start);
+
+	std::vector<cp_type> path;
+	for (int i = 0; i < 200; ++i) {
+		path.push_back(cp0 + cp_type(0.0005 * i, -0.0003 * i, 0.0002 * i));
+	}
+
+	std::vector<jp_type, Eigen::aligned_allocator<jp_type> > result(path.size());
+	EXPECT_EQ(path.size(), ik->solvePath(path.begin(), path.end(), start, result.begin()));
+
+	for (size_t i = 0; i < path.size(); ++i) {
+		EXPECT_LT((toolPosition(result[i]) - path[i]).norm(), 1e-5) << "i = " << i;
+		if (i > 0) {
+			// Warm starting keeps the joint path continuous.
+			EXPECT_LT((result[i] - result[i-1]).norm(), 0.05) << "i = " << i;
+		}
+	}
+}
+
+
+}
@@ -0,0 +1,264 @@
+/*
+ * jerk_limited_profile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <cmath>
+#include <limits>
+#include <gtest/gtest.h>
+
+#include <barrett/math/utils.h>
+#include <barrett/math/jerk_limited_profile.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const double V = 1.0, A = 2.0, J = 10.0;
+const double T_s = 0.0005;
+
+// Samples the profile and checks that it respects the limits and is
+// continuous in position, velocity and acceleration. An initial state that
+// is over the limits, or that is accelerating while at the velocity limit,
+// can't help but exceed them at first.
+void expectFeasible(const math::JerkLimitedProfile& prof, double v0, double a0) {
+	const double tol = 1e-9;
+	const double vLimit = math::max(V, math::max(std::abs(v0), std::abs(v0 + a0 * std::abs(a0) / (2.0 * J))));
+	double p, v, a, pPrev, vPrev, aPrev;
+	prof.eval(0.0, &pPrev, &vPrev, &aPrev);
+
+	for (double t = T_s; t < prof.finalT() + 2*T_s; t += T_s) {
+		prof.eval(t, &p, &v, &a);
+
+		EXPECT_LE(std::abs(v), vLimit + tol) << "t = " << t;
+		EXPECT_LE(std::abs(a), math::max(A, std::abs(a0)) + tol) << "t = " << t;
+		EXPECT_LE(std::abs(a - aPrev), J * T_s + tol) << "t = " << t;
+		EXPECT_NEAR(vPrev + T_s * (aPrev + a) / 2.0, v, J * T_s*T_s) << "t = " << t;
+		EXPECT_NEAR(pPrev + T_s * (vPrev + v) / 2.0, p, J * T_s*T_s*T_s) << "t = " << t;
+
+		pPrev = p;
+		vPrev = v;
+		aPrev = a;
+	}
+}
+
+
+TEST(JerkLimitedProfileTest, CtorIsAtRest) {
+	math::JerkLimitedProfile prof(3.0);
+	EXPECT_EQ(0.0, prof.finalT());
+	EXPECT_EQ(3.0, prof.finalValue());
+	EXPECT_EQ(3.0, prof.eval(1.0));
+}
+
+TEST(JerkLimitedProfileTest, RestToRestWithCruise) {
+	math::JerkLimitedProfile prof;
+	prof.plan(0.0, 0.0, 0.0, 2.0, V, A, J);
+
+	// Jerk for A/J, hold A until reaching V, jerk back to zero, and the
+	// same to stop: 2*(V/A + A/J) plus cruising for the rest of the distance.
+	const double expectedT = 2.0 * (V/A + A/J) / 2.0 + (2.0 - V * (V/A + A/J)) / V + (V/A + A/J);
+	EXPECT_NEAR(expectedT, prof.finalT(), 1e-9);
+
+	double p, v, a;
+	prof.eval(prof.finalT() / 2.0, &p, &v, &a);
+	EXPECT_NEAR(1.0, p, 1e-9);
+	EXPECT_NEAR(V, v, 1e-9);
+	EXPECT_NEAR(0.0, a, 1e-9);
+
+	prof.eval(prof.finalT(), &p, &v, &a);
+	EXPECT_EQ(2.0, p);
+	EXPECT_EQ(0.0, v);
+	EXPECT_EQ(0.0, a);
+
+	expectFeasible(prof, 0.0, 0.0);
+}
+
+TEST(JerkLimitedProfileTest, ShortMoveDoesntReachLimits) {
+	math::JerkLimitedProfile prof;
+	prof.plan(1.0, 0.0, 0.0, 0.99, V, A, J);
+
+	// Four jerk phases of equal length: d = 2 J tau^3
+	const double tau = std::pow(0.01 / (2.0 * J), 1.0/3.0);
+	EXPECT_NEAR(4.0 * tau, prof.finalT(), 1e-9);
+	EXPECT_NEAR(0.995, prof.eval(2.0 * tau), 1e-9);
+	EXPECT_EQ(0.99, prof.eval(prof.finalT()));
+
+	expectFeasible(prof, 0.0, 0.0);
+}
+
+TEST(JerkLimitedProfileTest, FromMovingState) {
+	const double states[][3] = {
+		{ 0.5, 1.0, 1.0 },  // Heading towards the target
+		{ -1.0, 0.0, 0.2 },  // Heading away from it
+		{ 0.9, 1.5, 0.05 },  // Too fast to stop in time
+		{ 1.5, -3.0, 3.0 },  // Beyond the limits
+	};
+
+	for (size_t i = 0; i < sizeof(states) / sizeof(states[0]); ++i) {
+		SCOPED_TRACE(i);
+		const double v0 = states[i][0], a0 = states[i][1], pf = states[i][2];
+
+		math::JerkLimitedProfile prof;
+		prof.plan(0.0, v0, a0, pf, V, A, J);
+
+		double p, v, a;
+		prof.eval(0.0, &p, &v, &a);
+		EXPECT_EQ(0.0, p);
+		EXPECT_DOUBLE_EQ(v0, v);
+		EXPECT_DOUBLE_EQ(a0, a);
+
+		// Lands on the target without a jump
+		prof.eval(prof.finalT() - 1e-9, &p, &v, &a);
+		EXPECT_NEAR(pf, p, 1e-8);
+		EXPECT_NEAR(0.0, v, 1e-6);
+		EXPECT_NEAR(0.0, a, 1e-6);
+
+		expectFeasible(prof, v0, a0);
+	}
+}
+
+// Checks that the velocity rises (or falls) to a single peak and then stops,
+// without dipping along the way.
+void expectSinglePeak(const math::JerkLimitedProfile& prof, double dir) {
+	const double tol = 1e-12;
+	bool stopping = false;
+	double v, vPrev;
+	prof.eval(0.0, NULL, &vPrev, NULL);
+	vPrev *= dir;
+	for (double t = T_s; t < prof.finalT() + 2*T_s; t += T_s) {
+		prof.eval(t, NULL, &v, NULL);
+		v *= dir;
+		if (v < vPrev - tol) {
+			stopping = true;
+		} else if (stopping) {
+			EXPECT_LE(v, vPrev + tol) << "t = " << t;
+		}
+		vPrev = v;
+	}
+}
+
+class ExposedProfile : public math::JerkLimitedProfile {
+public:
+	// The duration of the move that peaks at peak and cruises to land on the
+	// target, or infinity if even the move that doesn't cruise overshoots.
+	double durationAt(double peak) const {
+		double tc = cruiseTime(peak);
+		if (tc < 0.0) {
+			return std::numeric_limits<double>::infinity();
+		}
+		phase_array ph;
+		build(peak, tc, &ph);
+		return duration(ph);
+	}
+};
+
+TEST(JerkLimitedProfileTest, DoesntSlowDownToSpeedUpAgain) {
+	// With a gentle jerk limit, slowing down and then stopping covers more
+	// ground than stopping right away. That mustn't tempt the planner when
+	// it could just hold its speed a bit longer.
+	const double v0 = 0.9, j = 1.0;
+	const double tStop = 2.0 * std::sqrt(v0 / j);
+	const double dStop = v0 * tStop / 2.0;
+	const double tHold = 0.05;
+
+	math::JerkLimitedProfile prof;
+	prof.plan(0.0, v0, 0.0, dStop + v0 * tHold, 1.0, 100.0, j);
+	EXPECT_LE(prof.finalT(), tStop + tHold + 1e-9);
+	EXPECT_NEAR(dStop + v0 * tHold, prof.eval(prof.finalT() - 1e-9), 1e-8);
+	expectSinglePeak(prof, 1.0);
+
+	// Any slower and it has to slow down so much that it can creep the rest
+	// of the way. In between, every profile overshoots.
+	const double t = prof.finalT();
+	EXPECT_FALSE(prof.stretch(t + 0.1));
+	EXPECT_EQ(t, prof.finalT());
+
+	EXPECT_TRUE(prof.stretch(3.0));
+	EXPECT_NEAR(3.0, prof.finalT(), 1e-9);
+	EXPECT_NEAR(dStop + v0 * tHold, prof.eval(prof.finalT() - 1e-9), 1e-8);
+}
+
+TEST(JerkLimitedProfileTest, NoPeakIsFasterFromAMovingStart) {
+	const double states[][3] = {
+		{ 0.5, 0.0, 1.0 },
+		{ 0.5, 1.0, 1.0 },
+		{ 0.5, -1.0, 0.5 },  // Already slowing down
+		{ 0.8, 0.0, 0.5 },
+		{ -0.5, 0.0, -0.4 },
+		{ -1.0, 0.0, 0.2 },
+	};
+
+	for (size_t i = 0; i < sizeof(states) / sizeof(states[0]); ++i) {
+		SCOPED_TRACE(i);
+		const double v0 = states[i][0], a0 = states[i][1], pf = states[i][2];
+
+		ExposedProfile prof;
+		prof.plan(0.0, v0, a0, pf, V, A, J);
+		EXPECT_NEAR(pf, prof.eval(prof.finalT() - 1e-9), 1e-8);
+		if (a0 * pf >= 0.0) {
+			expectSinglePeak(prof, math::sign(pf));
+		}
+
+		for (double peak = 0.01; peak <= V; peak += 0.01) {
+			EXPECT_GE(prof.durationAt(math::sign(pf) * peak), prof.finalT() - 1e-9) << "peak = " << peak;
+		}
+	}
+}
+
+TEST(JerkLimitedProfileTest, StretchFromAMovingStart) {
+	const double v0 = 0.5, pf = 1.0;
+	math::JerkLimitedProfile prof;
+	prof.plan(0.0, v0, 0.0, pf, V, A, J);
+	const double t = prof.finalT();
+
+	// Both faster and slower than holding the current speed
+	const double durations[] = { 1.2 * t, 2.0 * t, 4.0 * t };
+	for (size_t i = 0; i < sizeof(durations) / sizeof(durations[0]); ++i) {
+		SCOPED_TRACE(i);
+		prof.plan(0.0, v0, 0.0, pf, V, A, J);
+		EXPECT_TRUE(prof.stretch(durations[i]));
+		EXPECT_NEAR(durations[i], prof.finalT(), 1e-9);
+		EXPECT_NEAR(pf, prof.eval(prof.finalT() - 1e-9), 1e-8);
+		expectFeasible(prof, v0, 0.0);
+	}
+}
+
+TEST(JerkLimitedProfileTest, Replan) {
+	math::JerkLimitedProfile prof;
+	prof.plan(0.0, 0.0, 0.0, 2.0, V, A, J);
+
+	double p, v, a;
+	prof.eval(0.4, &p, &v, &a);
+	prof.plan(p, v, a, -1.0, V, A, J);
+	EXPECT_EQ(p, prof.eval(0.0));
+	EXPECT_EQ(-1.0, prof.eval(prof.finalT()));
+	expectFeasible(prof, 0.0, 0.0);
+}
+
+TEST(JerkLimitedProfileTest, Stretch) {
+	math::JerkLimitedProfile prof;
+	prof.plan(0.0, 0.0, 0.0, 0.3, V, A, J);
+	const double t = prof.finalT();
+
+	EXPECT_FALSE(prof.stretch(t / 2.0));
+	EXPECT_EQ(t, prof.finalT());
+
+	EXPECT_TRUE(prof.stretch(3.0 * t));
+	EXPECT_NEAR(3.0 * t, prof.finalT(), 1e-9);
+	EXPECT_EQ(0.3, prof.eval(prof.finalT()));
+	EXPECT_NEAR(0.3, prof.eval(prof.finalT() - 1e-9), 1e-8);
+	expectFeasible(prof, 0.0, 0.0);
+}
+
+TEST(JerkLimitedProfileTest, CantStretchAStop) {
+	math::JerkLimitedProfile prof;
+	prof.plan(0.0, 0.0, 0.0, 0.0, V, A, J);
+	EXPECT_EQ(0.0, prof.finalT());
+	EXPECT_FALSE(prof.stretch(1.0));
+}
+
+
+}
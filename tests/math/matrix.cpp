@@ -316,7 +316,7 @@ TYPED_TEST(MatrixTypedTest, CopyCtor) {
 		for (int j = 0; j < a.cols(); ++j) {
 			EXPECT_EQ(2.0, a(i,j));
 			EXPECT_EQ(-487.9, b(i,j));
-			EXPECT_EQ(b(i,j), gsl_matrix_get(b.asGslType(), i,j));
+			EXPECT_EQ(b(i,j), gsl_matrix_get(b.asGslType().get(), i,j));
 		}
 	}
 }
@@ -459,7 +459,7 @@ TYPED_TEST(MatrixTypedTest, CopyFromConfigThrows) {
 }
 
 TYPED_TEST(MatrixTypedTest, AsGslMatrix) {
-	gsl_matrix* gslMat = this->a.asGslType();
+	typename TypeParam::gsl_view_type gslMat = this->a.asGslType();
 
 	EXPECT_EQ(this->a.rows(), gslMat->size1);
 	EXPECT_EQ(this->a.cols(), gslMat->size2);
@@ -469,15 +469,29 @@ TYPED_TEST(MatrixTypedTest, AsGslMatrix) {
 	this->a << 5, 42.8, 37, -12, 1.4, -3e-3;
 	for (int i = 0; i < this->a.rows(); ++i) {
 		for (int j = 0; j < this->a.cols(); ++j) {
-			EXPECT_EQ(this->a(i,j), gsl_matrix_get(gslMat, i,j));
+			EXPECT_EQ(this->a(i,j), gsl_matrix_get(gslMat.get(), i,j));
 		}
 	}
 
-	gsl_matrix_set(gslMat, 2,1, 8.9);
+	gsl_matrix_set(gslMat.get(), 2,1, 8.9);
 	EXPECT_EQ(8.9, this->a(2,1));
 
 	this->a(1,0) = -3.2;
-	EXPECT_EQ(-3.2, gsl_matrix_get(gslMat, 1,0));
+	EXPECT_EQ(-3.2, gsl_matrix_get(gslMat.get(), 1,0));
+}
+
+TYPED_TEST(MatrixTypedTest, AsConstGslMatrix) {
+	this->a << 5, 42.8, 37, -12, 1.4, -3e-3;
+	const TypeParam& ca = this->a;
+	typename TypeParam::const_gsl_view_type gslMat = ca.asGslType();
+
+	EXPECT_EQ(this->a.data(), gslMat->data);
+	EXPECT_EQ(-12, gsl_matrix_get(gslMat.get(), 1,1));
+}
+
+TYPED_TEST(FixedMatrixTypedTest, NoLargerThanEigenMatrix) {
+	EXPECT_EQ(sizeof(typename TypeParam::Base), sizeof(TypeParam));
+	EXPECT_EQ(ROWS*COLS * sizeof(double), sizeof(TypeParam));
 }
 
 /*
@@ -500,7 +514,7 @@ TYPED_TEST(MatrixTypedTest, CopyFromTypeParam) {
 
 	this->a.setConstant(20.2);
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType(), i));
+		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType().get(), i));
 	}
 }
 
@@ -513,7 +527,7 @@ TYPED_TEST(MatrixTypedTest, AssignFromTypeParam) {
 
 	this->a.setConstant(20.2);
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType(), i));
+		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType().get(), i));
 	}
 }
 
@@ -526,7 +540,7 @@ TYPED_TEST(MatrixTypedTest, CopyFromVector) {
 
 	vec.setConstant(20.2);
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType(), i));
+		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType().get(), i));
 	}
 }
 
@@ -540,7 +554,7 @@ TYPED_TEST(MatrixTypedTest, AssignFromVector) {
 
 	vec.setConstant(20.2);
 	for (int i = 0; i < vec_copy.size(); ++i) {
-		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType(), i));
+		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType().get(), i));
 	}
 }
 
@@ -7,11 +7,13 @@
 
 
 #include <iostream>
+#include <cmath>
 #include <vector>
 #include <boost/tuple/tuple.hpp>
 
 #define EIGEN_USE_NEW_STDVECTOR
 #include <Eigen/StdVector>
+#include <Eigen/Geometry>
 
 #include <gtest/gtest.h>
 
@@ -172,4 +174,176 @@ TEST(SplineTest, NoSaturateCtor) {
 }
 
 
+class SplineSamplesTest : public ::testing::Test {
+public:
+	typedef math::Spline<jp_type>::tuple_type tuple_type;
+
+	SplineSamplesTest() {
+		// Unevenly spaced knots
+		const double s[] = { 0.0, 0.3, 0.5, 1.4, 1.5, 2.7 };
+		for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); ++i) {
+			tuple_type sample;
+			sample.get<0>() = s[i];
+			for (size_t j = 0; j < DOF; ++j) {
+				sample.get<1>()[j] = std::sin(3.0 * s[i] + j) + 0.1 * j;
+			}
+			samples.push_back(sample);
+		}
+	}
+
+protected:
+	std::vector<tuple_type, Eigen::aligned_allocator<tuple_type> > samples;
+};
+
+TEST_F(SplineSamplesTest, InterpolatesKnots) {
+	math::Spline<jp_type> spline(samples);
+
+	ASSERT_EQ(samples.size(), spline.numKnots());
+	for (size_t i = 0; i < samples.size(); ++i) {
+		EXPECT_EQ(samples[i].get<0>(), spline.getKnot(i));
+		EXPECT_TRUE(spline.eval(samples[i].get<0>()).isApprox(samples[i].get<1>(), 1e-12));
+	}
+}
+
+TEST_F(SplineSamplesTest, ContinuousSecondDerivative) {
+	math::Spline<jp_type> spline(samples);
+	const double eps = 1e-9;
+	jp_type pl, vl, al, pr, vr, ar;
+
+	for (size_t i = 1; i < samples.size() - 1; ++i) {
+		double s = samples[i].get<0>();
+		spline.eval(s - eps, &pl, &vl, &al);
+		spline.eval(s + eps, &pr, &vr, &ar);
+		EXPECT_LT((pl - pr).norm(), 1e-6);
+		EXPECT_LT((vl - vr).norm(), 1e-6);
+		EXPECT_LT((al - ar).norm(), 1e-6);
+	}
+
+	// Natural end conditions
+	spline.eval(spline.initialS(), NULL, NULL, &al);
+	spline.eval(spline.finalS(), NULL, NULL, &ar);
+	EXPECT_LT(al.norm(), 1e-9);
+	EXPECT_LT(ar.norm(), 1e-9);
+}
+
+TEST_F(SplineSamplesTest, DerivativesMatchFiniteDifferences) {
+	math::Spline<jp_type> spline(samples);
+	const double h = 1e-6;
+	jp_type p, v, a;
+
+	for (double s = 0.05; s < 2.7; s += 0.1) {
+		spline.eval(s, &p, &v, &a);
+
+		EXPECT_EQ(spline.eval(s), p);
+		EXPECT_EQ(spline.evalDerivative(s), v);
+		EXPECT_LT((v - (spline.eval(s + h) - spline.eval(s - h)) / (2*h)).norm(), 1e-6);
+		EXPECT_LT((a - (spline.evalDerivative(s + h) - spline.evalDerivative(s - h)) / (2*h)).norm(), 1e-5);
+	}
+}
+
+TEST(SplineTest, CoincidentPoints) {
+	jp_type jp;
+	std::vector<jp_type, Eigen::aligned_allocator<jp_type> > points;
+
+	jp.setConstant(0);
+	points.push_back(jp);
+	points.push_back(jp);
+	jp.setConstant(1);
+	points.push_back(jp);
+
+	math::Spline<jp_type> spline(points);
+	EXPECT_LT(spline.getKnot(0), spline.getKnot(1));
+	EXPECT_TRUE(spline.eval(spline.finalS()).isApprox(jp));
+}
+
+
+class QuaternionSplineTest : public ::testing::Test {
+public:
+	typedef Eigen::Quaterniond quaternion_type;
+	typedef math::Spline<quaternion_type>::tuple_type tuple_type;
+
+	QuaternionSplineTest() {
+		points.push_back(quaternion_type::Identity());
+		points.push_back(quaternion_type(Eigen::AngleAxisd(0.5, Eigen::Vector3d::UnitX())));
+		points.push_back(quaternion_type(Eigen::AngleAxisd(1.0, Eigen::Vector3d(0, 1, 1).normalized())));
+		points.push_back(quaternion_type(Eigen::AngleAxisd(1.4, Eigen::Vector3d::UnitZ())));
+		points.push_back(quaternion_type(Eigen::AngleAxisd(0.2, Eigen::Vector3d(1, -1, 0).normalized())));
+
+		// Same orientation, opposite sign
+		points[3].coeffs() = -points[3].coeffs();
+	}
+
+protected:
+	std::vector<quaternion_type, Eigen::aligned_allocator<quaternion_type> > points;
+};
+
+TEST_F(QuaternionSplineTest, InterpolatesKnots) {
+	math::Spline<quaternion_type> spline(points);
+
+	EXPECT_EQ(0.0, spline.initialS());
+	ASSERT_EQ(points.size(), spline.numKnots());
+	for (size_t i = 0; i < points.size(); ++i) {
+		EXPECT_NEAR(0.0, spline.eval(spline.getKnot(i)).angularDistance(points[i]), 1e-9);
+	}
+
+	// Saturates
+	EXPECT_NEAR(0.0, spline.eval(-1.0).angularDistance(points.front()), 1e-9);
+	EXPECT_NEAR(0.0, spline.eval(spline.finalS() + 1.0).angularDistance(points.back()), 1e-9);
+}
+
+TEST_F(QuaternionSplineTest, TwoPointsIsSlerp) {
+	points.resize(2);
+	math::Spline<quaternion_type> spline(points);
+
+	for (double t = 0.0; t <= 1.0; t += 0.1) {
+		EXPECT_NEAR(0.0, spline.eval(t * spline.finalS()).angularDistance(points[0].slerp(t, points[1])), 1e-9);
+	}
+}
+
+TEST_F(QuaternionSplineTest, ContinuousFirstDerivative) {
+	// Unevenly spaced knots
+	const double s[] = { 0.0, 0.3, 0.5, 1.4, 1.5 };
+	std::vector<tuple_type, Eigen::aligned_allocator<tuple_type> > samples;
+	for (size_t i = 0; i < points.size(); ++i) {
+		samples.push_back(tuple_type(s[i], points[i]));
+	}
+	math::Spline<quaternion_type> spline(samples);
+	EXPECT_FALSE(spline.hasUniformKnots());
+
+	const double h = 1e-6;
+	for (size_t i = 1; i < samples.size() - 1; ++i) {
+		quaternion_type q = spline.eval(s[i]);
+		quaternion_type before = spline.eval(s[i] - h);
+		quaternion_type after = spline.eval(s[i] + h);
+
+		// Angular velocity in the body frame, from either side of the knot
+		Eigen::Vector3d wl = (before.conjugate() * q).vec() * (2.0 / h);
+		Eigen::Vector3d wr = (q.conjugate() * after).vec() * (2.0 / h);
+		EXPECT_LT((wl - wr).norm(), 1e-3);
+	}
+}
+
+TEST_F(QuaternionSplineTest, UniformKnots) {
+	std::vector<tuple_type, Eigen::aligned_allocator<tuple_type> > samples;
+	for (size_t i = 0; i < points.size(); ++i) {
+		samples.push_back(tuple_type(0.1 * i + 2.0, points[i]));
+	}
+	math::Spline<quaternion_type> spline(samples);
+	EXPECT_TRUE(spline.hasUniformKnots());
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		EXPECT_NEAR(0.0, spline.eval(samples[i].get<0>()).angularDistance(points[i]), 1e-9);
+	}
+
+	// Agrees with the search used for uneven knots on the segments that
+	// don't depend on the moved knot
+	samples.back().get<0>() += 0.05;
+	math::Spline<quaternion_type> uneven(samples);
+	EXPECT_FALSE(uneven.hasUniformKnots());
+	for (double x = 2.0; x < 2.2; x += 0.013) {
+		EXPECT_NEAR(0.0, spline.eval(x).angularDistance(uneven.eval(x)), 1e-12);
+	}
+}
+
+
 }
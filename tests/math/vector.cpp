@@ -192,7 +192,7 @@ TYPED_TEST(VectorTypedTest, CopyCtor) {
 	for (int i = 0; i < a.size(); ++i) {
 		EXPECT_EQ(2.0, a[i]);
 		EXPECT_EQ(-487.9, b[i]);
-		EXPECT_EQ(b[i], gsl_vector_get(b.asGslType(), i));
+		EXPECT_EQ(b[i], gsl_vector_get(b.asGslType().get(), i));
 	}
 }
 
@@ -264,7 +264,7 @@ TYPED_TEST(VectorTypedTest, CopyFromConfigThrows) {
 }
 
 TYPED_TEST(VectorTypedTest, AsGslVector) {
-	gsl_vector* gslVec = this->a.asGslType();
+	typename TypeParam::gsl_view_type gslVec = this->a.asGslType();
 
 	EXPECT_EQ(this->a.size(), gslVec->size);
 	EXPECT_EQ(NULL, gslVec->block);
@@ -272,14 +272,14 @@ TYPED_TEST(VectorTypedTest, AsGslVector) {
 
 	this->a << 5, 42.8, 37, -12, 1.4;
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(this->a[i], gsl_vector_get(gslVec, i));
+		EXPECT_EQ(this->a[i], gsl_vector_get(gslVec.get(), i));
 	}
 
-	gsl_vector_set(gslVec, 2, 8.9);
+	gsl_vector_set(gslVec.get(), 2, 8.9);
 	EXPECT_EQ(8.9, this->a[2]);
 
 	this->a[4] = -3.2;
-	EXPECT_EQ(-3.2, gsl_vector_get(gslVec, 4));
+	EXPECT_EQ(-3.2, gsl_vector_get(gslVec.get(), 4));
 }
 
 TYPED_TEST(VectorTypedTest, IsZero) {
@@ -301,7 +301,7 @@ TYPED_TEST(VectorTypedTest, CopyFromTypeParam) {
 
 	this->a.setConstant(20.2);
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType(), i));
+		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType().get(), i));
 	}
 }
 
@@ -314,7 +314,7 @@ TYPED_TEST(VectorTypedTest, AssignFromTypeParam) {
 
 	this->a.setConstant(20.2);
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType(), i));
+		EXPECT_EQ(a_copy[i], gsl_vector_get(a_copy.asGslType().get(), i));
 	}
 }
 
@@ -327,7 +327,7 @@ TYPED_TEST(VectorTypedTest, CopyFromVector) {
 
 	vec.setConstant(20.2);
 	for (int i = 0; i < this->a.size(); ++i) {
-		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType(), i));
+		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType().get(), i));
 	}
 }
 
@@ -341,7 +341,7 @@ TYPED_TEST(VectorTypedTest, AssignFromVector) {
 
 	vec.setConstant(20.2);
 	for (int i = 0; i < vec_copy.size(); ++i) {
-		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType(), i));
+		EXPECT_EQ(vec_copy[i], gsl_vector_get(vec_copy.asGslType().get(), i));
 	}
 }
 
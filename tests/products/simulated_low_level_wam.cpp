@@ -0,0 +1,240 @@
+/*
+ * simulated_low_level_wam.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <cmath>
+#include <libconfig.h++>
+#include <gtest/gtest.h>
+
+#include <barrett/units.h>
+#include <barrett/products/safety_module.h>
+#include <barrett/products/simulated_low_level_wam.h>
+#include <barrett/math/kinematics.h>
+#include <barrett/math/dynamics.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/wam.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const size_t DOF = 7;
+BARRETT_UNITS_TYPEDEFS(DOF);
+const double T_s = 0.002;
+
+
+class SimulatedLowLevelWamTest : public ::testing::Test {
+public:
+	SimulatedLowLevelWamTest() :
+		config(), sim(NULL)
+	{
+		config.readFile("test.config");
+		sim = new SimulatedLowLevelWam<DOF>(config.lookup("wam"), T_s);
+	}
+	~SimulatedLowLevelWamTest() {
+		delete sim;
+	}
+
+	jt_type gravityTorques(const jp_type& jp) {
+		math::Kinematics<DOF> kin(config.lookup("wam.kinematics"));
+		math::Dynamics<DOF> dyn(config.lookup("wam.dynamics"));
+		kin.eval(jp, jv_type(0.0));
+		return dyn.evalGravity(kin, sim->getGravity());
+	}
+
+protected:
+	libconfig::Config config;
+	SimulatedLowLevelWam<DOF>* sim;
+};
+
+
+TEST_F(SimulatedLowLevelWamTest, StartsAtHome) {
+	EXPECT_EQ(SafetyModule::ACTIVE, sim->getSafetyMode());
+	EXPECT_FALSE(sim->hasVelocityFault());
+	EXPECT_EQ(0.0, sim->getTime());
+
+	EXPECT_TRUE(sim->getTrueJointPositions() == sim->getHomePosition());
+	EXPECT_TRUE(sim->getJointPositions().isApprox(sim->getHomePosition(), 1e-3));
+	EXPECT_TRUE(sim->getJointVelocities() == jv_type(0.0));
+}
+
+TEST_F(SimulatedLowLevelWamTest, QuantizesPositions) {
+	jp_type jp(0.3);
+	sim->definePosition(jp);
+
+	// The motors see whole encoder counts...
+	v_type counts = sim->getJointToMotorPositionTransform() * sim->getJointPositions() * (4096 / (2*M_PI));
+	for (size_t i = 0; i < DOF; ++i) {
+		EXPECT_NEAR(std::floor(counts[i] + 0.5), counts[i], 1e-6);
+	}
+
+	// ...within one count of the truth.
+	v_type err = sim->getJointToMotorPositionTransform() * (sim->getTrueJointPositions() - sim->getJointPositions());
+	for (size_t i = 0; i < DOF; ++i) {
+		EXPECT_GE(err[i], 0.0);
+		EXPECT_LT(err[i], 2*M_PI / 4096);
+	}
+}
+
+TEST_F(SimulatedLowLevelWamTest, FallsWithoutTorque) {
+	jp_type jp(0.0);
+	jp[1] = 0.5;
+	jp[3] = 0.5;
+	sim->definePosition(jp);
+
+	for (int i = 0; i < 50; ++i) {
+		sim->update();
+	}
+
+	EXPECT_NEAR(50 * T_s, sim->getTime(), 1e-12);
+	EXPECT_GT((sim->getTrueJointPositions() - jp).norm(), 1e-2);
+	EXPECT_GT(sim->getJointVelocities().norm(), 1e-2);
+}
+
+TEST_F(SimulatedLowLevelWamTest, HoldsStillWithoutGravity) {
+	jp_type jp(0.5);
+	sim->definePosition(jp);
+	sim->setGravity(0.0);
+
+	for (int i = 0; i < 50; ++i) {
+		sim->update();
+	}
+
+	EXPECT_TRUE(sim->getTrueJointPositions() == jp);
+	EXPECT_TRUE(sim->getJointVelocities() == jv_type(0.0));
+}
+
+TEST_F(SimulatedLowLevelWamTest, GravityTorquesHoldTheArm) {
+	jp_type jp(0.0);
+	jp[1] = 0.5;
+	jp[3] = 0.5;
+	sim->definePosition(jp);
+
+	jt_type jt = gravityTorques(jp);
+	for (int i = 0; i < 50; ++i) {
+		sim->setTorques(jt);
+		sim->update();
+	}
+
+	EXPECT_TRUE(sim->getAppliedTorques().isApprox(jt));
+	EXPECT_LT((sim->getTrueJointPositions() - jp).norm(), 1e-9);
+}
+
+TEST_F(SimulatedLowLevelWamTest, SaturatesMotorTorques) {
+	jt_type jt(1000.0);
+	sim->setTorques(jt);
+
+	v_type mt = sim->getJointToMotorTorqueTransform() * sim->getAppliedTorques();
+	EXPECT_NEAR(2.0, std::abs(mt[0]), 1e-9);
+	EXPECT_NEAR(2.0, std::abs(mt[3]), 1e-9);
+	EXPECT_NEAR(0.6, std::abs(mt[6]), 1e-9);
+
+	// Torques within the limits pass through untouched.
+	jt.setConstant(1.0);
+	sim->setTorques(jt);
+	EXPECT_TRUE(sim->getAppliedTorques().isApprox(jt));
+}
+
+TEST_F(SimulatedLowLevelWamTest, VelocityFaultIdles) {
+	// Reach out so that turning the base moves the tool.
+	jp_type jp(0.0);
+	jp[1] = M_PI/2;
+	jv_type jv(0.0);
+	jv[0] = 0.5;
+	sim->setState(jp, jv);
+	sim->update();
+	EXPECT_FALSE(sim->hasVelocityFault());
+
+	jv[0] = 5.0;
+	sim->setState(jp, jv);
+	sim->update();
+	EXPECT_TRUE(sim->hasVelocityFault());
+	EXPECT_EQ(SafetyModule::IDLE, sim->getSafetyMode());
+
+	jt_type jt(1.0);
+	sim->setTorques(jt);
+	EXPECT_TRUE(sim->getAppliedTorques() == jt_type(0.0));
+
+	sim->activate();
+	EXPECT_FALSE(sim->hasVelocityFault());
+	EXPECT_EQ(SafetyModule::ACTIVE, sim->getSafetyMode());
+	EXPECT_TRUE(sim->getAppliedTorques().isApprox(jt));
+}
+
+
+TEST(SimulatedWamTest, RunsTheStandardControlLoop) {
+	libconfig::Config config;
+	config.readFile("test.config");
+
+	systems::ManualExecutionManager mem(T_s);
+	SimulatedLowLevelWam<DOF> sim(config.lookup("wam"), mem.getPeriod());
+	systems::Wam<DOF> wam(&mem, &sim, config.lookup("wam"));
+	EXPECT_TRUE(wam.getHomePosition() == sim.getHomePosition());
+	EXPECT_THROW(wam.getLowLevelWam(), std::logic_error);
+
+	wam.gravityCompensate();
+	mem.runExecutionCycle();
+
+	jp_type dest(0.0);
+	dest[1] = -1.0;
+	dest[3] = 1.5;
+	wam.moveTo(dest, false, 1.0, 1.0);
+
+	// Let the move finish and settle
+	int n = 0;
+	while ( !wam.moveIsDone() ) {
+		mem.runExecutionCycle();
+		ASSERT_LT(++n, 10000);
+	}
+	for (int i = 0; i < 1000; ++i) {
+		mem.runExecutionCycle();
+	}
+
+	EXPECT_FALSE(sim.hasVelocityFault());
+	EXPECT_TRUE(wam.getJointPositions().isApprox(dest, 0.02)) << wam.getJointPositions();
+	// (The light wrist links keep hunting by an encoder count or so.)
+	EXPECT_LT(sim.getTrueJointVelocities().head<4>().norm(), 1e-3) << sim.getTrueJointVelocities();
+}
+
+
+
+TEST(SimulatedWamTest, StateShowsWhenTheLoopStops) {
+	libconfig::Config config;
+	config.readFile("test.config");
+
+	systems::ManualExecutionManager mem(T_s);
+	SimulatedLowLevelWam<DOF> sim(config.lookup("wam"), mem.getPeriod());
+	systems::Wam<DOF> wam(&mem, &sim, config.lookup("wam"));
+
+	systems::Wam<DOF>::State state;
+	EXPECT_FALSE(wam.getState(&state));
+
+	mem.runExecutionCycle();
+	ASSERT_TRUE(wam.getState(&state));
+	EXPECT_EQ(1u, state.cycle);
+	const double t1 = state.time;
+
+	for (int i = 0; i < 9; ++i) {
+		mem.runExecutionCycle();
+	}
+	ASSERT_TRUE(wam.getState(&state));
+	EXPECT_EQ(10u, state.cycle);
+	EXPECT_GE(state.time, t1);
+
+	// No cycles: the snapshot doesn't change.
+	systems::Wam<DOF>::State later;
+	ASSERT_TRUE(wam.getState(&later));
+	EXPECT_EQ(state.cycle, later.cycle);
+	EXPECT_EQ(state.time, later.time);
+
+	// Without a SafetyModule, the mode is ACTIVE and was never read.
+	EXPECT_EQ(SafetyModule::ACTIVE, later.safetyMode);
+	EXPECT_EQ(0.0, later.safetyModeTime);
+}
+
+
+}
@@ -7,9 +7,11 @@
 
 #include <vector>
 #include <iostream>
+#include <stdexcept>
 #include <gtest/gtest.h>
 #include <barrett/systems/abstract/system.h>
 #include <barrett/systems/helpers.h>
+#include <barrett/systems/gain.h>
 #include <barrett/systems/manual_execution_manager.h>
 #include "../exposed_io_system.h"
 
@@ -209,6 +211,86 @@ TEST_F(SystemTest, OutputUndelegatePropagatesEm) {
 	EXPECT_EQ(NULL, d2.getExecutionManager());
 }
 
+TEST_F(SystemTest, RateDivisorHoldsOutputsBetweenCycles) {
+	systems::connect(out.output, in.input);
+	out.setRateDivisor(4, 1);
+	EXPECT_EQ(4u, out.getRateDivisor());
+	EXPECT_EQ(1u, out.getRatePhase());
+
+	// Always operates on the first cycle, then on cycles 2, 6, 10, ...
+	const bool expected[] = { true, true, false, false, false, true, false, false, false, true };
+	for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+		out.operateCalled = false;
+		out.setOutputValue(i);
+		mem.runExecutionCycle();
+
+		ASSERT_TRUE(in.inputValueDefined());
+		EXPECT_EQ(expected[i], out.operateCalled) << "cycle " << i + 1;
+	}
+
+	out.setRateDivisor(1);
+	out.operateCalled = false;
+	mem.runExecutionCycle();
+	in.inputValueDefined();
+	EXPECT_TRUE(out.operateCalled);
+}
+
+TEST_F(SystemTest, RateDivisorAppliesToUpstreamSubgraph) {
+	systems::Gain<double> gain(2.0);
+	systems::connect(out.output, gain.input);
+	systems::connect(gain.output, in.input);
+	gain.setRateDivisor(3);
+
+	// out is only pulled when gain operates
+	const double expected[] = { 0.0, 0.0, 0.0, 6.0, 6.0, 6.0, 12.0, 12.0, 12.0 };
+	for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+		out.operateCalled = false;
+		out.setOutputValue(i);
+		mem.runExecutionCycle();
+
+		ASSERT_TRUE(in.inputValueDefined());
+		EXPECT_EQ(expected[i], in.getInputValue()) << "cycle " << i + 1;
+		EXPECT_EQ(i % 3 == 0, out.operateCalled) << "cycle " << i + 1;
+	}
+}
+
+TEST_F(SystemTest, RateDivisorRestartsWithNewExecutionManager) {
+	systems::connect(out.output, in.input);
+	out.setRateDivisor(5, 3);
+	out.setOutputValue(1.0);
+
+	mem.runExecutionCycle();
+	in.inputValueDefined();
+	EXPECT_TRUE(out.operateCalled);
+
+	mem.stopManaging(in);
+	mem.startManaging(in);
+
+	// Operates immediately instead of waiting for its phase
+	out.operateCalled = false;
+	mem.runExecutionCycle();
+	in.inputValueDefined();
+	EXPECT_TRUE(out.operateCalled);
+}
+
+TEST_F(SystemTest, RateDivisorScalesEffectivePeriod) {
+	systems::ManualExecutionManager localMem(0.002);
+	localMem.startManaging(out);
+	out.executionManagerChanged = false;
+
+	EXPECT_DOUBLE_EQ(0.002, out.getEffectivePeriod());
+	out.setRateDivisor(5);
+	EXPECT_DOUBLE_EQ(0.01, out.getEffectivePeriod());
+	EXPECT_TRUE(out.executionManagerChanged)
+		<< "sample period change not reported through onExecutionManagerChanged()";
+}
+
+TEST_F(SystemTest, RateDivisorThrowsOnBadArgs) {
+	EXPECT_THROW(out.setRateDivisor(0), std::invalid_argument);
+	EXPECT_THROW(out.setRateDivisor(3, 3), std::invalid_argument);
+	EXPECT_EQ(1u, out.getRateDivisor());
+}
+
 
 // death tests
 typedef SystemTest SystemDeathTest;
@@ -0,0 +1,197 @@
+/*
+ * flight_recorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <barrett/log/column_options.h>
+#include <barrett/log/column_reader.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/flight_recorder.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const double T_s = 0.01;
+typedef systems::FlightRecorder<double> fr_type;
+
+
+class FlightRecorderTest : public ::testing::Test {
+public:
+	FlightRecorderTest() :
+		mem(T_s), eo(), trigger(false), i(0), dumps()
+	{
+		std::strcpy(dir, "/tmp/btXXXXXX");
+		EXPECT_TRUE(mkdtemp(dir) != NULL);
+		prefix = std::string(dir) + "/fault";
+	}
+	~FlightRecorderTest() {
+		for (size_t j = 0; j < dumps.size(); ++j) {
+			std::remove(dumps[j].fileName.c_str());
+		}
+		rmdir(dir);
+	}
+
+	void connect(fr_type* fr) {
+		systems::connect(eo.output, fr->input);
+		systems::connect(trigger.output, fr->triggerInput);
+		fr->setDumpCallback(boost::bind(&FlightRecorderTest::onDump, this, _1));
+	}
+
+	void onDump(const fr_type::Dump& d) {
+		boost::lock_guard<boost::mutex> lock(mutex);
+		dumps.push_back(d);
+	}
+
+	void run(size_t n) {
+		for (size_t j = 0; j < n; ++j) {
+			eo.setValue(i++);
+			mem.runExecutionCycle();
+		}
+	}
+
+	size_t waitForDumps(fr_type* fr, size_t n) {
+		for (int j = 0; j < 200  &&  fr->getNumDumps() < n; ++j) {
+			usleep(10000);
+		}
+		return fr->getNumDumps();
+	}
+
+	std::vector<double> readDump(size_t j) {
+		std::vector<double> values;
+		log::ColumnReader lr(dumps.at(j).fileName.c_str());
+		EXPECT_EQ(T_s, lr.getSchema().getSamplePeriod());
+		lr.readChannel(0, &values);
+		return values;
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	systems::ExposedOutput<double> eo;
+	systems::ExposedOutput<bool> trigger;
+	int i;
+
+	char dir[14];
+	std::string prefix;
+	boost::mutex mutex;
+	std::vector<fr_type::Dump> dumps;
+};
+
+
+TEST_F(FlightRecorderTest, Windows) {
+	fr_type fr(&mem, prefix, 0.05, 0.03, log::ColumnOptions("x"));
+	EXPECT_EQ(5u, fr.getPreTriggerRecords());
+	EXPECT_EQ(3u, fr.getPostTriggerRecords());
+	EXPECT_THROW(fr_type(NULL, prefix, 0.05, 0.03), std::invalid_argument);
+
+	// Without a period, the windows can't be converted into records.
+	systems::ManualExecutionManager noPeriod;
+	EXPECT_THROW(fr_type(&noPeriod, prefix, 0.05, 0.03), std::invalid_argument);
+}
+
+TEST_F(FlightRecorderTest, WindowsFollowTheRateDivisor) {
+	fr_type fr(&mem, prefix, 0.06, 0.04);
+	connect(&fr);
+	fr.setRateDivisor(2);
+	EXPECT_EQ(3u, fr.getPreTriggerRecords());
+	EXPECT_EQ(2u, fr.getPostTriggerRecords());
+
+	run(20);
+	fr.trigger();
+	run(4);
+
+	ASSERT_EQ(1u, waitForDumps(&fr, 1));
+	EXPECT_EQ(5u, dumps[0].numRecords);
+	EXPECT_EQ(3u, dumps[0].triggerRecord);
+
+	std::vector<double> values;
+	log::ColumnReader lr(dumps[0].fileName.c_str());
+	EXPECT_EQ(2.0 * T_s, lr.getSchema().getSamplePeriod());
+	lr.readChannel(0, &values);
+	ASSERT_EQ(5u, values.size());
+	for (size_t j = 1; j < values.size(); ++j) {
+		EXPECT_EQ(2.0, values[j] - values[j-1]);
+	}
+}
+
+TEST_F(FlightRecorderTest, DumpsAroundTheTrigger) {
+	fr_type fr(&mem, prefix, 0.05, 0.03);
+	connect(&fr);
+
+	run(20);
+	usleep(100000);
+	EXPECT_EQ(0u, fr.getNumDumps());
+
+	trigger.setValue(true);  // At record 20
+	run(10);
+	trigger.setValue(false);
+	run(5);
+
+	ASSERT_EQ(1u, waitForDumps(&fr, 1));
+	EXPECT_EQ(8u, dumps[0].numRecords);
+	EXPECT_EQ(5u, dumps[0].triggerRecord);
+	std::vector<double> values = readDump(0);
+	ASSERT_EQ(8u, values.size());
+	for (size_t j = 0; j < values.size(); ++j) {
+		EXPECT_EQ(15.0 + j, values[j]);
+	}
+
+	// A second trigger, from another thread this time
+	fr.trigger();
+	run(3);
+	ASSERT_EQ(2u, waitForDumps(&fr, 2));
+	EXPECT_NE(dumps[0].fileName, dumps[1].fileName);
+	values = readDump(1);
+	ASSERT_EQ(8u, values.size());
+	EXPECT_EQ(30.0, values[0]);
+	EXPECT_EQ(5u, dumps[1].triggerRecord);
+	EXPECT_EQ(0u, fr.getNumMissedTriggers());
+}
+
+TEST_F(FlightRecorderTest, ShortHistory) {
+	fr_type fr(&mem, prefix, 0.05, 0.03);
+	connect(&fr);
+
+	run(2);
+	fr.trigger();
+	run(3);
+
+	ASSERT_EQ(1u, waitForDumps(&fr, 1));
+	EXPECT_EQ(5u, dumps[0].numRecords);
+	EXPECT_EQ(2u, dumps[0].triggerRecord);
+	EXPECT_EQ(0.0, readDump(0)[0]);
+}
+
+TEST_F(FlightRecorderTest, PartialCaptureIsWrittenOnDestruction) {
+	{
+		fr_type fr(&mem, prefix, 0.05, 0.03);
+		connect(&fr);
+		run(10);
+		fr.trigger();
+		run(1);
+	}
+
+	ASSERT_EQ(1u, dumps.size());
+	EXPECT_EQ(6u, dumps[0].numRecords);
+	EXPECT_EQ(5u, dumps[0].triggerRecord);
+	EXPECT_EQ(10.0, readDump(0).back());
+}
+
+
+}
@@ -0,0 +1,153 @@
+/*
+ * fused_chain.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <cmath>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+#include <barrett/math/matrix.h>
+#include <barrett/systems/helpers.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/constant.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/gain.h>
+#include <barrett/systems/summer.h>
+#include <barrett/systems/pid_controller.h>
+#include <barrett/systems/first_order_filter.h>
+#include <barrett/systems/fused_chain.h>
+
+#include "./exposed_io_system.h"
+
+
+namespace {
+using namespace barrett;
+
+
+typedef math::Vector<3>::type v_type;
+const double T_s = 0.002;
+
+typedef systems::FusedChain<
+		systems::fusion::Gain<v_type, double>,
+		systems::fusion::Sum<v_type, 2>,
+		systems::fusion::PID<v_type, v_type>,
+		systems::fusion::Filter<v_type>,
+		systems::fusion::Sum<v_type> > fused_type;
+
+
+class FusedChainTest : public ::testing::Test {
+public:
+	FusedChainTest() :
+		mem(T_s), x(), a(), b(), c(), eios()
+	{
+		mem.startManaging(eios);
+		systems::connect(fused.output, eios.input);
+		systems::connect(x.output, fused.input);
+
+		systems::connect(a.output, fused.getStage<1>().getInput(0));
+		systems::connect(b.output, fused.getStage<1>().getInput(1));
+		systems::connect(c.output, fused.getStage<4>().getInput(0));
+
+		fused.getStage<0>().setGain(2.0);
+		fused.getStage<1>().setPolarity("+-");
+		fused.getStage<2>().setKp(v_type(1.5));
+		fused.getStage<2>().setKi(v_type(0.7));
+		fused.getStage<2>().setKd(v_type(0.01));
+		fused.getStage<3>().setLowPass(v_type(20.0));
+	}
+
+	void setInputs(double t) {
+		x.setValue(v_type(std::sin(t)));
+		a.setValue(v_type(std::cos(3.0 * t)));
+		b.setValue(v_type(0.5 * t));
+		c.setValue(v_type(-1.0));
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	fused_type fused;
+	systems::ExposedOutput<v_type> x, a, b, c;
+	ExposedIOSystem<v_type> eios;
+};
+
+
+TEST_F(FusedChainTest, MatchesEquivalentSystems) {
+	systems::Gain<v_type, double> gain(2.0);
+	systems::Summer<v_type, 3> errorSum("++-");
+	systems::PIDController<v_type, v_type> pid;
+	systems::Constant<v_type> zero(v_type(0.0));
+	systems::FirstOrderFilter<v_type> filter;
+	systems::Summer<v_type, 2> outputSum;
+	ExposedIOSystem<v_type> reference;
+
+	pid.setKp(v_type(1.5));
+	pid.setKi(v_type(0.7));
+	pid.setKd(v_type(0.01));
+	filter.setLowPass(v_type(20.0));
+
+	mem.startManaging(reference);
+	systems::connect(x.output, gain.input);
+	systems::connect(gain.output, errorSum.getInput(0));
+	systems::connect(a.output, errorSum.getInput(1));
+	systems::connect(b.output, errorSum.getInput(2));
+	systems::connect(errorSum.output, pid.referenceInput);
+	systems::connect(zero.output, pid.feedbackInput);
+	systems::connect(pid.controlOutput, filter.input);
+	systems::connect(filter.output, outputSum.getInput(0));
+	systems::connect(c.output, outputSum.getInput(1));
+	systems::connect(outputSum.output, reference.input);
+
+	for (int i = 0; i < 500; ++i) {
+		setInputs(i * T_s);
+		mem.runExecutionCycle();
+
+		ASSERT_TRUE(eios.inputValueDefined());
+		ASSERT_TRUE(reference.inputValueDefined());
+		EXPECT_TRUE(eios.getInputValue().isApprox(reference.getInputValue(), 1e-12))
+			<< "cycle " << i << ": " << eios.getInputValue().transpose()
+			<< " != " << reference.getInputValue().transpose();
+	}
+}
+
+TEST_F(FusedChainTest, UndefinedSideInput) {
+	setInputs(0.0);
+	mem.runExecutionCycle();
+	EXPECT_TRUE(eios.inputValueDefined());
+
+	// By default, Sum stages are strict, like Summer.
+	b.setValueUndefined();
+	mem.runExecutionCycle();
+	EXPECT_FALSE(eios.inputValueDefined());
+
+	fused.getStage<1>().setUndefinedIsZero(true);
+	mem.runExecutionCycle();
+	EXPECT_TRUE(eios.inputValueDefined());
+
+	x.setValueUndefined();
+	mem.runExecutionCycle();
+	EXPECT_FALSE(eios.inputValueDefined());
+}
+
+TEST_F(FusedChainTest, GainOnlyChain) {
+	systems::FusedChain<systems::fusion::Gain<v_type, double> > g;
+	g.getStage<0>().setGain(-3.0);
+	systems::disconnect(eios.input);
+	systems::connect(x.output, g.input);
+	systems::connect(g.output, eios.input);
+
+	x.setValue(v_type(2.0));
+	mem.runExecutionCycle();
+	EXPECT_EQ(v_type(-6.0), eios.getInputValue());
+}
+
+TEST_F(FusedChainTest, SetPolarityThrows) {
+	EXPECT_THROW(fused.getStage<1>().setPolarity("+"), std::invalid_argument);
+	EXPECT_THROW(fused.getStage<1>().setPolarity("+*"), std::invalid_argument);
+	EXPECT_NO_THROW(fused.getStage<1>().setPolarity("--"));
+}
+
+
+}
@@ -0,0 +1,150 @@
+/*
+ * grouped_data_logger.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <boost/tuple/tuple.hpp>
+
+#include <barrett/math/matrix.h>
+#include <barrett/log/real_time_writer.h>
+#include <barrett/log/reader.h>
+#include <barrett/log/segmented_writer.h>
+#include <barrett/log/segmented_reader.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/tuple_grouper.h>
+#include <barrett/systems/periodic_data_logger.h>
+#include <barrett/systems/grouped_data_logger.h>
+
+#include "../log/tmp_file.h"
+
+
+namespace {
+using namespace barrett;
+
+
+const double T_s = 0.002;
+const size_t BUFFER_RECORDS = 10000;
+typedef math::Vector<3>::type v_type;
+typedef boost::tuple<double, v_type, int> tuple_type;
+typedef systems::GroupedDataLogger<tuple_type> gdl_type;
+
+
+class GroupedDataLoggerTest : public ::testing::Test {
+public:
+	GroupedDataLoggerTest() :
+		mem(T_s)
+	{
+		makeTmpFile(fileA);
+		makeTmpFile(fileB);
+	}
+	~GroupedDataLoggerTest() {
+		std::remove(fileA);
+		std::remove(fileB);
+	}
+
+	static std::string readFile(const char* name) {
+		std::ifstream ifs(name, std::ios_base::binary);
+		return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	}
+
+	void run(size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			time.setValue(i * T_s);
+			v.setValue(v_type(1.0 * i, 2.0 * i, -1.0 * i));
+			count.setValue(i);
+			mem.runExecutionCycle();
+		}
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	systems::ExposedOutput<double> time;
+	systems::ExposedOutput<v_type> v;
+	systems::ExposedOutput<int> count;
+
+	char fileA[14];
+	char fileB[14];
+};
+
+
+TEST_F(GroupedDataLoggerTest, SameRecordsAsTupleGrouper) {
+	systems::TupleGrouper<double, v_type, int> tg;
+	systems::PeriodicDataLogger<tuple_type> pdl(&mem, new log::RealTimeWriter<tuple_type>(fileA, 0.01, BUFFER_RECORDS), 1);
+	gdl_type gdl(&mem, new gdl_type::log_writer_type(fileB, 0.01, BUFFER_RECORDS), 1);
+
+	systems::connect(time.output, tg.getInput<0>());
+	systems::connect(v.output, tg.getInput<1>());
+	systems::connect(count.output, tg.getInput<2>());
+	systems::connect(tg.output, pdl.input);
+
+	systems::connect(time.output, gdl.getInput<0>());
+	systems::connect(v.output, gdl.getInput<1>());
+	systems::connect(count.output, gdl.getInput<2>());
+
+	run(5000);  // Faster than realtime, so the writers buffer everything
+	pdl.closeLog();
+	gdl.closeLog();
+	EXPECT_FALSE(gdl.isLogging());
+
+	std::string a = readFile(fileA);
+	EXPECT_EQ(5000 * log::Traits<tuple_type>::serializedLength(), a.size());
+	EXPECT_TRUE(a == readFile(fileB));
+
+	log::Reader<tuple_type> lr(fileB);
+	lr.getRecord();
+	tuple_type t = lr.getRecord();
+	EXPECT_EQ(T_s, t.get<0>());
+	EXPECT_EQ(v_type(1.0, 2.0, -1.0), t.get<1>());
+	EXPECT_EQ(1, t.get<2>());
+}
+
+TEST_F(GroupedDataLoggerTest, WaitsForAllInputs) {
+	{
+		gdl_type gdl(&mem, new gdl_type::log_writer_type(fileA, T_s), 2);
+		systems::connect(time.output, gdl.getInput<0>());
+		systems::connect(v.output, gdl.getInput<1>());
+		run(10);
+
+		systems::connect(count.output, gdl.getInput<2>());
+		run(10);
+	}
+
+	EXPECT_EQ(5 * log::Traits<tuple_type>::serializedLength(), readFile(fileA).size());
+}
+
+TEST_F(GroupedDataLoggerTest, TakesAnyLogWriter) {
+	typedef log::SegmentedWriter<tuple_type> writer_type;
+	const std::string baseName(fileA);
+	{
+		systems::GroupedDataLogger<tuple_type, writer_type> gdl(&mem,
+				new writer_type(baseName.c_str(), 0.01, BUFFER_RECORDS, log::SegmentOptions(log::ColumnOptions("time,v,count"))), 1);
+		systems::connect(time.output, gdl.getInput<0>());
+		systems::connect(v.output, gdl.getInput<1>());
+		systems::connect(count.output, gdl.getInput<2>());
+		run(100);
+	}
+
+	{
+		log::SegmentedReader sr(baseName.c_str());
+		EXPECT_EQ(100u, sr.numRecords());
+		tuple_type t = sr.getRecord<tuple_type, log::Traits<tuple_type> >(1);
+		EXPECT_EQ(T_s, t.get<0>());
+		EXPECT_EQ(v_type(1.0, 2.0, -1.0), t.get<1>());
+		EXPECT_EQ(1, t.get<2>());
+	}
+
+	std::remove(log::detail::segmentFileName(baseName, 0).c_str());
+	std::remove(log::detail::segmentIndexFileName(baseName).c_str());
+}
+
+
+}
@@ -0,0 +1,161 @@
+/*
+ * haptic_path.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <barrett/units.h>
+#include <barrett/systems/helpers.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/haptic_path.h>
+
+#include "./exposed_io_system.h"
+
+
+namespace {
+using namespace barrett;
+
+BARRETT_UNITS_FIXED_SIZE_TYPEDEFS;
+
+
+typedef std::vector<cp_type, Eigen::aligned_allocator<cp_type> > path_type;
+
+class HapticPathTest : public ::testing::Test {
+public:
+	HapticPathTest() : mem(0.002), hp(NULL) {
+		// A long, dense helix (about 12 m)
+		path_type path;
+		for (double t = 0.0; t < 60.0; t += 0.001) {
+			path.push_back(cp_type(0.3 * std::cos(t), 0.3 * std::sin(t), 0.01 * t));
+		}
+
+		mem.startManaging(depth);
+		setPath(path);
+	}
+	~HapticPathTest() {
+		delete hp;
+	}
+
+	void setPath(const path_type& path) {
+		delete hp;
+		hp = new systems::HapticPath(path);
+		systems::connect(tool.output, hp->input);
+		systems::connect(hp->depthOutput, depth.input);
+	}
+
+	double runCycle(const cp_type& cp) {
+		tool.setValue(cp);
+		mem.runExecutionCycle();
+		return depth.getInputValue();
+	}
+
+	// Dense brute-force search of the spline
+	double bruteForceDistance(const cp_type& cp) {
+		const math::Spline<cp_type>& spline = hp->getSpline();
+		double best = 1e300;
+		for (double s = spline.initialS(); s <= spline.finalS(); s += 0.0002) {
+			best = std::min(best, (spline.eval(s) - cp).norm());
+		}
+		return best;
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	systems::HapticPath* hp;
+	systems::ExposedOutput<cp_type> tool;
+	ExposedIOSystem<double> depth;
+};
+
+
+TEST_F(HapticPathTest, GlobalProjectionMatchesBruteForce) {
+	const cp_type points[] = {
+		cp_type(0.0, 0.0, 0.3),
+		cp_type(0.31, 0.02, 0.12),
+		cp_type(-0.5, 0.4, 0.9),
+		cp_type(0.1, -0.25, -0.2),
+		cp_type(0.3, 0.0, 1.0),
+	};
+
+	for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); ++i) {
+		// Far apart, so each one is a jump
+		double d = runCycle(points[i]);
+		EXPECT_LE(d, bruteForceDistance(points[i]) + 1e-6) << "point " << i;
+	}
+	EXPECT_EQ(sizeof(points) / sizeof(points[0]), hp->getNumGlobalSearches());
+}
+
+TEST_F(HapticPathTest, TracksWithoutGlobalSearches) {
+	// Follow the path slightly outside of it
+	for (int i = 0; i < 1000; ++i) {
+		double t = 5.0 + i * 0.002;
+		cp_type cp(0.32 * std::cos(t), 0.32 * std::sin(t), 0.01 * t + 0.005);
+		double d = runCycle(cp);
+		if (i % 100 == 0) {
+			EXPECT_NEAR(bruteForceDistance(cp), d, 1e-6) << "cycle " << i;
+		}
+	}
+	EXPECT_EQ(1u, hp->getNumGlobalSearches());
+}
+
+TEST_F(HapticPathTest, JumpFallsBackToGlobalSearch) {
+	runCycle(cp_type(0.3, 0.0, 0.0));
+	EXPECT_EQ(1u, hp->getNumGlobalSearches());
+
+	cp_type far(0.0, 0.3, 0.5);
+	double d = runCycle(far);
+	EXPECT_EQ(2u, hp->getNumGlobalSearches());
+	EXPECT_LE(d, bruteForceDistance(far) + 1e-6);
+}
+
+TEST_F(HapticPathTest, SwitchesToACloserBranch) {
+	// A U: two 0.5 m arms, 0.2 m apart, joined by a half circle.
+	path_type path;
+	for (double x = 0.5; x > 0.0; x -= 0.001) {
+		path.push_back(cp_type(x, 0.0, 0.0));
+	}
+	for (double t = -M_PI / 2.0; t < M_PI / 2.0; t += 0.01) {
+		path.push_back(cp_type(-0.1 * std::cos(t), 0.1 + 0.1 * std::sin(t), 0.0));
+	}
+	for (double x = 0.0; x <= 0.5; x += 0.001) {
+		path.push_back(cp_type(x, 0.2, 0.0));
+	}
+	setPath(path);
+
+	// Move slowly from near the first arm to near the second. Each step is far
+	// smaller than the distance to either arm.
+	const int N = 1800;
+	for (int i = 0; i <= N; ++i) {
+		cp_type cp(0.4, 0.01 + 0.18 * i / N, 0.0);
+		double d = runCycle(cp);
+		EXPECT_NEAR(std::min(cp[1], 0.2 - cp[1]), d, 1e-6) << "cycle " << i;
+	}
+
+	// The first cycle, and the switch to the second arm
+	EXPECT_EQ(2u, hp->getNumGlobalSearches());
+	EXPECT_NEAR(0.2, hp->getSpline().eval(hp->getNearestS())[1], 1e-6);
+}
+
+TEST_F(HapticPathTest, OutputsAreUnitVectors) {
+	ExposedIOSystem<cf_type> dir;
+	ExposedIOSystem<cp_type> tangent;
+	mem.startManaging(dir);
+	mem.startManaging(tangent);
+	systems::connect(hp->directionOutput, dir.input);
+	systems::connect(hp->tangentDirectionOutput, tangent.input);
+
+	runCycle(cp_type(0.4, 0.1, 0.2));
+	EXPECT_NEAR(1.0, dir.getInputValue().norm(), 1e-9);
+	EXPECT_NEAR(1.0, tangent.getInputValue().norm(), 1e-9);
+
+	// The direction points from the tool to the path, normal to the path.
+	EXPECT_NEAR(0.0, dir.getInputValue().dot(tangent.getInputValue()), 1e-6);
+}
+
+
+}
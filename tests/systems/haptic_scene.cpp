@@ -0,0 +1,205 @@
+/*
+ * haptic_scene.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <barrett/units.h>
+#include <barrett/systems/helpers.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/haptic_ball.h>
+#include <barrett/systems/haptic_box.h>
+#include <barrett/systems/haptic_scene.h>
+
+#include "./exposed_io_system.h"
+
+
+namespace {
+using namespace barrett;
+
+BARRETT_UNITS_FIXED_SIZE_TYPEDEFS;
+
+
+class HapticSceneTest : public ::testing::Test {
+public:
+	HapticSceneTest() : mem(0.002) {
+		mem.startManaging(depth);
+		mem.startManaging(direction);
+		systems::connect(tool.output, scene.input);
+		systems::connect(scene.depthOutput, depth.input);
+		systems::connect(scene.directionOutput, direction.input);
+	}
+
+	void runCycle(const cp_type& cp) {
+		tool.setValue(cp);
+		mem.runExecutionCycle();
+
+		// ExposedIOSystem doesn't pull its input, so do it here.
+		depth.getInputValue();
+		direction.getInputValue();
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	systems::HapticScene scene;
+	systems::ExposedOutput<cp_type> tool;
+	ExposedIOSystem<double> depth;
+	ExposedIOSystem<cf_type> direction;
+};
+
+
+TEST_F(HapticSceneTest, SingleBallMatchesHapticBall) {
+	const cp_type center(0.4, -0.1, 0.2);
+	const double radius = 0.1;
+	scene.add(new systems::HapticScene::Ball(center, radius));
+
+	systems::HapticBall ball(center, radius);
+	ExposedIOSystem<double> ballDepth;
+	ExposedIOSystem<cf_type> ballDirection;
+	mem.startManaging(ballDepth);
+	mem.startManaging(ballDirection);
+	systems::connect(tool.output, ball.input);
+	systems::connect(ball.depthOutput, ballDepth.input);
+	systems::connect(ball.directionOutput, ballDirection.input);
+
+	// Approach from outside, push through the surface, and come back out.
+	for (int i = -40; i <= 40; ++i) {
+		double x = center[0] + radius + 0.03 - 0.001 * (40 - std::abs(i));
+		runCycle(cp_type(x, center[1] + 0.002, center[2]));
+
+		// The scene reports the magnitude of the penetration; HapticBall
+		// reports its signed depth.
+		EXPECT_NEAR(std::abs(ballDepth.getInputValue()), depth.getInputValue(), 1e-12) << "i = " << i;
+		if (ballDepth.getInputValue() != 0.0) {
+			cf_type expected = math::sign(ballDepth.getInputValue()) * ballDirection.getInputValue();
+			EXPECT_TRUE(expected.isApprox(direction.getInputValue(), 1e-12)) << "i = " << i;
+		}
+	}
+}
+
+TEST_F(HapticSceneTest, SingleBoxMatchesHapticBox) {
+	const cp_type center(0.4, -0.1, 0.2);
+	const math::Vector<3>::type size(0.2, 0.1, 0.3);
+	scene.add(new systems::HapticScene::Box(center, size));
+
+	systems::HapticBox box(center, size);
+	ExposedIOSystem<double> boxDepth;
+	ExposedIOSystem<cf_type> boxDirection;
+	mem.startManaging(boxDepth);
+	mem.startManaging(boxDirection);
+	systems::connect(tool.output, box.input);
+	systems::connect(box.depthOutput, boxDepth.input);
+	systems::connect(box.directionOutput, boxDirection.input);
+
+	// Push through a face, far enough to be let in, and come back out.
+	for (int i = -40; i <= 40; ++i) {
+		double x = center[0] + size[0] / 2.0 + 0.01 - 0.001 * (40 - std::abs(i));
+		runCycle(cp_type(x, center[1] + 0.01, center[2] - 0.02));
+
+		EXPECT_NEAR(boxDepth.getInputValue(), depth.getInputValue(), 1e-12) << "i = " << i;
+		if (boxDepth.getInputValue() != 0.0) {
+			EXPECT_TRUE(boxDirection.getInputValue().isApprox(direction.getInputValue(), 1e-12)) << "i = " << i;
+		}
+	}
+}
+
+TEST_F(HapticSceneTest, OnlyNearbyShapesAreEvaluated) {
+	// A 10x10x5 grid of small balls
+	for (int i = 0; i < 10; ++i) {
+		for (int j = 0; j < 10; ++j) {
+			for (int k = 0; k < 5; ++k) {
+				scene.add(new systems::HapticScene::Ball(cp_type(0.1 * i, 0.1 * j, 0.1 * k), 0.02));
+			}
+		}
+	}
+	EXPECT_EQ(500u, scene.size());
+
+	// Just outside one ball
+	runCycle(cp_type(0.3 + 0.03, 0.5, 0.2));
+	EXPECT_EQ(1u, scene.getNumActive());
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+
+	// Touching it
+	runCycle(cp_type(0.3 + 0.019, 0.5, 0.2));
+	EXPECT_EQ(1u, scene.getNumActive());
+	EXPECT_NEAR(0.001, depth.getInputValue(), 1e-12);
+	EXPECT_TRUE(cf_type(1.0, 0.0, 0.0).isApprox(direction.getInputValue()));
+
+	// Between balls
+	runCycle(cp_type(0.35, 0.55, 0.25));
+	EXPECT_EQ(0u, scene.getNumActive());
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+}
+
+TEST_F(HapticSceneTest, OverlappingShapesAreSummed) {
+	scene.add(new systems::HapticScene::Ball(cp_type(-0.1, 0.0, 0.0), 0.105));
+	scene.add(new systems::HapticScene::Ball(cp_type(0.0, 0.1, 0.0), 0.105));
+
+	runCycle(cp_type(0.0, 0.0, 0.0));
+	EXPECT_EQ(2u, scene.getNumActive());
+
+	// Each ball pushes 0.005 away from its center.
+	EXPECT_NEAR(0.005 * std::sqrt(2.0), depth.getInputValue(), 1e-12);
+	EXPECT_TRUE(cf_type(1.0, -1.0, 0.0).normalized().isApprox(direction.getInputValue()));
+}
+
+TEST_F(HapticSceneTest, ShapesCanBeAddedAndRemovedWhileRunning) {
+	const cp_type cp(0.0, 0.0, 0.099);
+
+	runCycle(cp);
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+
+	systems::HapticScene::Box* box =
+			new systems::HapticScene::Box(cp_type(0.0, 0.0, 0.0), math::Vector<3>::type(0.2, 0.2, 0.2));
+	scene.add(box);
+	scene.add(new systems::HapticScene::Ball(cp_type(1.0, 1.0, 1.0), 0.1));
+	EXPECT_EQ(2u, scene.size());
+
+	runCycle(cp);
+	EXPECT_EQ(1u, scene.getNumActive());
+	EXPECT_NEAR(0.001, depth.getInputValue(), 1e-12);
+	EXPECT_TRUE(cf_type(0.0, 0.0, 1.0).isApprox(direction.getInputValue()));
+
+	EXPECT_TRUE(scene.remove(box));
+	EXPECT_FALSE(scene.remove(box));
+	EXPECT_EQ(1u, scene.size());
+
+	runCycle(cp);
+	EXPECT_EQ(0u, scene.getNumActive());
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+
+	scene.clear();
+	EXPECT_EQ(0u, scene.size());
+	runCycle(cp);
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+}
+
+TEST_F(HapticSceneTest, CulledShapesReset) {
+	const cp_type center(0.0, 0.0, 0.0);
+	scene.add(new systems::HapticScene::Ball(center, 0.1));
+
+	// Jump deep inside: the ball switches to keeping the tool in.
+	runCycle(cp_type(0.0, 0.0, 0.05));
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+
+	// Moving out toward the surface from inside is free...
+	runCycle(cp_type(0.0, 0.0, 0.095));
+	EXPECT_DOUBLE_EQ(0.0, depth.getInputValue());
+	// ...and leaving is resisted.
+	runCycle(cp_type(0.0, 0.0, 0.105));
+	EXPECT_NEAR(0.005, depth.getInputValue(), 1e-12);
+
+	// Leave the bounds entirely, then come back in from outside.
+	runCycle(cp_type(0.0, 0.0, 0.5));
+	EXPECT_EQ(0u, scene.getNumActive());
+	runCycle(cp_type(0.0, 0.0, 0.095));
+	EXPECT_NEAR(0.005, depth.getInputValue(), 1e-12);
+	EXPECT_TRUE(cf_type(0.0, 0.0, 1.0).isApprox(direction.getInputValue()));
+}
+
+
+}
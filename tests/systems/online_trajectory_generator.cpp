@@ -0,0 +1,181 @@
+/*
+ * online_trajectory_generator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include <barrett/math/matrix.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/online_trajectory_generator.h>
+
+#include "exposed_io_system.h"
+
+
+namespace {
+using namespace barrett;
+
+
+const double T_s = 0.002;
+const double V = 1.0, A = 2.0, J = 10.0;
+typedef math::Vector<2>::type v_type;
+typedef systems::OnlineTrajectoryGenerator<v_type> otg_type;
+
+class OnlineTrajectoryGeneratorTest : public ::testing::Test {
+public:
+	OnlineTrajectoryGeneratorTest() :
+		mem(T_s), otg(v_type(V), v_type(A), v_type(J)), numSamples(0)
+	{
+		mem.startManaging(eios);
+		systems::connect(otg.output, eios.input);
+	}
+
+	// ExposedIOSystem doesn't read its input during operate(), so pull the
+	// generator's output explicitly to make sure it is updated every cycle.
+	// Checks that the output respects the limits (estimated by finite
+	// differences) since the last call to reset().
+	v_type runCycle() {
+		mem.runExecutionCycle();
+		v_type pNext = eios.getInputValue();
+
+		if (numSamples >= 1) {
+			v_type vNext = (pNext - p) / T_s;
+			v_type aNext = (vNext - v) / T_s;
+			for (size_t i = 0; i < v_type::SIZE; ++i) {
+				EXPECT_LE(std::abs(vNext[i]), V + 1e-6);
+				if (numSamples >= 2) {
+					EXPECT_LE(std::abs(aNext[i]), A + J * T_s);
+				}
+				if (numSamples >= 3) {
+					EXPECT_LE(std::abs(aNext[i] - a[i]) / T_s, 2.0 * J);
+				}
+			}
+			v = vNext;
+			a = aNext;
+		}
+		p = pNext;
+		++numSamples;
+
+		return p;
+	}
+
+	void reset(const v_type& position) {
+		otg.reset(position);
+		numSamples = 0;
+	}
+
+	// Returns the number of cycles it took to finish the move.
+	int runUntilDone() {
+		int n = 0;
+		while ( !otg.isDone() ) {
+			runCycle();
+			++n;
+			if (n > 10000) {
+				ADD_FAILURE() << "The move didn't finish";
+				break;
+			}
+		}
+		return n;
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	otg_type otg;
+	ExposedIOSystem<v_type> eios;
+
+	int numSamples;
+	v_type p, v, a;
+};
+
+
+TEST_F(OnlineTrajectoryGeneratorTest, UndefinedUntilReset) {
+	EXPECT_TRUE(otg.isDone());
+	mem.runExecutionCycle();
+	EXPECT_FALSE(eios.inputValueDefined());
+
+	reset(v_type(1.0, -1.0));
+	EXPECT_EQ(v_type(1.0, -1.0), runCycle());
+	EXPECT_TRUE(otg.isDone());
+}
+
+TEST_F(OnlineTrajectoryGeneratorTest, FirstTargetWithoutResetHolds) {
+	otg.setTarget(v_type(0.5, 0.25));
+	EXPECT_EQ(v_type(0.5, 0.25), runCycle());
+	EXPECT_TRUE(otg.isDone());
+}
+
+TEST_F(OnlineTrajectoryGeneratorTest, CoordinatesArriveTogether) {
+	reset(v_type(0.0, 0.0));
+	otg.setTarget(v_type(1.0, -0.1));
+	EXPECT_FALSE(otg.isDone());
+
+	const v_type target(1.0, -0.1);
+	int arrived[2] = { -1, -1 };
+	for (int n = 0; !otg.isDone(); ++n) {
+		runCycle();
+		for (size_t i = 0; i < 2; ++i) {
+			if (arrived[i] < 0  &&  std::abs(p[i] - target[i]) < 1e-9) {
+				arrived[i] = n;
+			}
+		}
+		ASSERT_LT(n, 10000);
+	}
+
+	EXPECT_EQ(target, p);
+	EXPECT_GT(arrived[0], 0);
+	EXPECT_LE(std::abs(arrived[0] - arrived[1]), 1);
+}
+
+TEST_F(OnlineTrajectoryGeneratorTest, RespectsLimits) {
+	reset(v_type(0.0, 0.0));
+	otg.setTarget(v_type(2.0, -1.5));
+	EXPECT_GT(runUntilDone(), 0);
+	EXPECT_EQ(v_type(2.0, -1.5), runCycle());
+}
+
+TEST_F(OnlineTrajectoryGeneratorTest, RetargetMidMotionIsSmooth) {
+	reset(v_type(0.0, 0.0));
+	otg.setTarget(v_type(2.0, 1.0));
+	for (int i = 0; i < 200; ++i) {
+		runCycle();
+	}
+	EXPECT_FALSE(otg.isDone());
+
+	// Reverse while moving
+	otg.setTarget(v_type(-1.0, 0.0));
+	runUntilDone();
+	EXPECT_EQ(v_type(-1.0, 0.0), runCycle());
+}
+
+TEST_F(OnlineTrajectoryGeneratorTest, DisconnectingForgetsState) {
+	reset(v_type(0.0, 0.0));
+	otg.setTarget(v_type(1.0, 1.0));
+	runCycle();
+	runCycle();
+	EXPECT_FALSE(otg.isDone());
+
+	systems::disconnect(eios.input);
+	EXPECT_TRUE(otg.isDone());
+
+	systems::connect(otg.output, eios.input);
+	mem.runExecutionCycle();
+	EXPECT_FALSE(eios.inputValueDefined());
+}
+
+TEST_F(OnlineTrajectoryGeneratorTest, DisconnectingDropsQueuedCommands) {
+	reset(v_type(0.0, 0.0));
+	otg.setTarget(v_type(1.0, 1.0));
+	EXPECT_FALSE(otg.isDone());
+
+	systems::disconnect(eios.input);
+	EXPECT_TRUE(otg.isDone());
+
+	systems::connect(otg.output, eios.input);
+	mem.runExecutionCycle();
+	EXPECT_FALSE(eios.inputValueDefined());
+}
+
+
+}
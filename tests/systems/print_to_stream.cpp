@@ -5,4 +5,112 @@
  *      Author: dc
  */
 
-// TODO(dc): test this
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/print_to_stream.h>
+
+
+namespace {
+using namespace barrett;
+
+
+const double T_s = 0.01;
+typedef systems::PrintToStream<int> pts_type;
+
+
+class PrintToStreamTest : public ::testing::Test {
+public:
+	PrintToStreamTest() :
+		mem(T_s), eo(), i(0) {}
+
+	void run(size_t n) {
+		for (size_t j = 0; j < n; ++j) {
+			eo.setValue(i++);
+			mem.runExecutionCycle();
+		}
+	}
+
+	static void waitForPrinted(const pts_type& pts, unsigned long n) {
+		for (int j = 0; j < 200  &&  pts.getStatistics().numPrinted < n; ++j) {
+			usleep(10000);
+		}
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	systems::ExposedOutput<int> eo;
+	int i;
+	std::stringstream ss;
+};
+
+
+TEST_F(PrintToStreamTest, PrintsInBackground) {
+	pts_type pts(&mem, "x = ", ss);
+	systems::connect(eo.output, pts.input);
+
+	run(3);
+	waitForPrinted(pts, 3);
+	EXPECT_EQ("x = 0\nx = 1\nx = 2\n", ss.str());
+}
+
+TEST_F(PrintToStreamTest, PrintsQueuedValuesOnDestruction) {
+	{
+		pts_type pts(&mem, "", ss, "PrintToStream", 1000);
+		systems::connect(eo.output, pts.input);
+		run(500);
+	}
+
+	std::stringstream expected;
+	for (int j = 0; j < 500; ++j) {
+		expected << j << "\n";
+	}
+	EXPECT_EQ(expected.str(), ss.str());
+}
+
+TEST_F(PrintToStreamTest, DropsWhenFull) {
+	pts_type pts(&mem, "", ss, "PrintToStream", 4);
+	systems::connect(eo.output, pts.input);
+
+	run(100);  // Much faster than the background thread
+	waitForPrinted(pts, 100 - pts.getStatistics().numDropped);
+
+	pts_type::Statistics s = pts.getStatistics();
+	EXPECT_GT(s.numDropped, 0u);
+	EXPECT_EQ(100u, s.numPrinted + s.numDropped);
+	EXPECT_EQ(0u, s.numRateLimited);
+}
+
+TEST_F(PrintToStreamTest, Decimation) {
+	pts_type pts(NULL, "", ss);
+	pts.setRateDivisor(3);
+	mem.startManaging(pts);
+	systems::connect(eo.output, pts.input);
+
+	run(9);
+	waitForPrinted(pts, 3);
+	EXPECT_EQ(3u, pts.getStatistics().numPrinted);
+}
+
+TEST_F(PrintToStreamTest, MaxRate) {
+	pts_type pts(&mem, "", ss, "PrintToStream", 1000);
+	pts.setMaxRate(20.0);  // Every 5th cycle
+	systems::connect(eo.output, pts.input);
+
+	run(100);
+	waitForPrinted(pts, 20);
+
+	pts_type::Statistics s = pts.getStatistics();
+	EXPECT_EQ(20u, s.numPrinted);
+	EXPECT_EQ(80u, s.numRateLimited);
+	EXPECT_EQ(0u, ss.str().find("0\n5\n10\n"));
+}
+
+
+}
@@ -0,0 +1,213 @@
+/*
+ * streaming_reference.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/thread.hpp>
+
+#include <gtest/gtest.h>
+
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/streaming_reference.h>
+
+#include "exposed_io_system.h"
+
+
+namespace {
+using namespace barrett;
+
+
+const double T_s = 0.001;
+typedef systems::StreamingReference<double> sr_type;
+
+class StreamingReferenceTest : public ::testing::Test {
+public:
+	StreamingReferenceTest() :
+		mem(T_s) {}
+
+	void connect(sr_type* sr) {
+		mem.startManaging(eios);
+		systems::connect(sr->output, eios.input);
+	}
+
+	double runCycle() {
+		mem.runExecutionCycle();
+		return eios.getInputValue();
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	ExposedIOSystem<double> eios;
+};
+
+
+TEST_F(StreamingReferenceTest, UndefinedUntilFirstSample) {
+	sr_type sr(&mem);
+	connect(&sr);
+
+	mem.runExecutionCycle();
+	EXPECT_FALSE(eios.inputValueDefined());
+
+	sr.push(10.0, 3.0);
+	EXPECT_EQ(3.0, runCycle());
+	EXPECT_EQ(1u, sr.getStatistics().numReceived);
+}
+
+TEST_F(StreamingReferenceTest, LinearUpsamplesWithDelay) {
+	const double DELAY = 0.01;
+	sr_type sr(&mem, sr_type::LINEAR, DELAY);
+	connect(&sr);
+
+	// A 200 Hz ramp with slope 2, published ahead of time.
+	for (int i = 0; i <= 20; ++i) {
+		sr.push(i * 0.005, 2.0 * i * 0.005);
+	}
+
+	// Playback starts DELAY before the first sample and holds it.
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(0.0, runCycle());
+	}
+	for (int i = 0; i < 90; ++i) {
+		EXPECT_NEAR(2.0 * i * T_s, runCycle(), 1e-9);
+	}
+
+	sr_type::Statistics stats = sr.getStatistics();
+	EXPECT_EQ(21u, stats.numReceived);
+	EXPECT_EQ(0u, stats.numDropped);
+	EXPECT_EQ(0u, stats.numLate);
+	EXPECT_EQ(0u, stats.numUnderruns);
+}
+
+TEST_F(StreamingReferenceTest, HoldSteps) {
+	sr_type sr(&mem, sr_type::HOLD, 0.0);
+	connect(&sr);
+
+	sr.push(0.0, 1.0);
+	sr.push(0.0035, 2.0);
+	EXPECT_EQ(1.0, runCycle());  // t = 0
+	EXPECT_EQ(1.0, runCycle());
+	EXPECT_EQ(1.0, runCycle());
+	EXPECT_EQ(1.0, runCycle());  // t = 0.003
+	EXPECT_EQ(2.0, runCycle());  // t = 0.004
+}
+
+TEST_F(StreamingReferenceTest, CubicIsExactForQuadratics) {
+	sr_type sr(&mem, sr_type::CUBIC, 0.02);
+	connect(&sr);
+
+	// Catmull-Rom tangents are exact for a parabola sampled uniformly. (Skip
+	// the first segment, which only has a one-sided tangent.)
+	for (int i = 0; i <= 40; ++i) {
+		double t = i * 0.004;
+		sr.push(t, t * t);
+	}
+
+	for (int i = 0; i < 24; ++i) {
+		runCycle();
+	}
+	for (int i = 4; i < 100; ++i) {
+		double t = i * T_s;
+		EXPECT_NEAR(t * t, runCycle(), 1e-12) << "t = " << t;
+	}
+}
+
+TEST_F(StreamingReferenceTest, ExtrapolatesThenHoldsOnUnderrun) {
+	const double MAX_EXTRAPOLATION = 0.005;
+	sr_type sr(&mem, sr_type::LINEAR, 0.0, MAX_EXTRAPOLATION);
+	connect(&sr);
+
+	sr.push(0.0, 0.0);
+	sr.push(0.01, 1.0);
+	for (int i = 0; i <= 10; ++i) {
+		EXPECT_NEAR(i * 0.1, runCycle(), 1e-9);
+	}
+
+	// Continue along the last segment for MAX_EXTRAPOLATION...
+	for (int i = 1; i <= 5; ++i) {
+		EXPECT_NEAR(1.0 + i * 0.1, runCycle(), 1e-9);
+	}
+	// ...then hold.
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_NEAR(1.5, runCycle(), 1e-9);
+	}
+	EXPECT_EQ(10u, sr.getStatistics().numUnderruns);
+}
+
+TEST_F(StreamingReferenceTest, ResyncsFromHeldValueAfterStall) {
+	sr_type sr(&mem, sr_type::LINEAR, 0.004, 0.0);
+	connect(&sr);
+
+	sr.push(0.0, 0.0);
+	sr.push(0.001, 1.0);
+	for (int i = 0; i < 20; ++i) {
+		runCycle();
+	}
+	EXPECT_EQ(1.0, runCycle());
+
+	// Much later, the stream resumes. Rather than jumping, the output ramps
+	// from the held value over the delay.
+	sr.push(100.0, 5.0);
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_NEAR(1.0 + i, runCycle(), 1e-9);
+	}
+	EXPECT_EQ(5.0, runCycle());
+	EXPECT_EQ(1u, sr.getStatistics().numResyncs);
+}
+
+TEST_F(StreamingReferenceTest, CountsDroppedAndLateSamples) {
+	sr_type sr(&mem, sr_type::LINEAR, 0.0, 0.1, 4);
+	connect(&sr);
+
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_TRUE(sr.push(i * 0.01, i));
+	}
+	EXPECT_FALSE(sr.push(0.04, 4.0));  // queue full
+	EXPECT_EQ(1u, sr.getStatistics().numDropped);
+
+	for (int i = 0; i < 40; ++i) {
+		runCycle();
+	}
+	sr.push(0.03, 3.0);  // not increasing
+	sr.push(0.035, 3.5);  // late
+	runCycle();
+
+	sr_type::Statistics stats = sr.getStatistics();
+	EXPECT_EQ(2u, stats.numDropped);
+	EXPECT_EQ(1u, stats.numLate);
+}
+
+
+void producer(sr_type* sr, int n) {
+	for (int i = 0; i < n; ++i) {
+		while ( !sr->push(i * 0.004, i * 0.004) ) {
+			boost::this_thread::yield();
+		}
+	}
+}
+
+TEST_F(StreamingReferenceTest, ConcurrentProducer) {
+	const int NUM_SAMPLES = 5000;
+	sr_type sr(&mem, sr_type::LINEAR, 0.01, 0.0, 16);
+	connect(&sr);
+
+	boost::thread t(producer, &sr, NUM_SAMPLES);
+
+	// The producer retries when the queue is full, so every sample gets
+	// through and the output never goes backwards.
+	double prev = -1.0;
+	while (sr.getStatistics().numReceived < (unsigned long) NUM_SAMPLES  ||  prev < (NUM_SAMPLES - 1) * 0.004 - 1e-9) {
+		mem.runExecutionCycle();
+		if (eios.inputValueDefined()) {
+			double y = eios.getInputValue();
+			ASSERT_GE(y, prev);
+			prev = y;
+		}
+	}
+	t.join();
+
+	EXPECT_EQ((unsigned long) NUM_SAMPLES, sr.getStatistics().numReceived);
+}
+
+
+}
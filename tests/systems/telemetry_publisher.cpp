@@ -0,0 +1,69 @@
+/*
+ * telemetry_publisher.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <string>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <barrett/math/matrix.h>
+#include <barrett/log/telemetry.h>
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/exposed_output.h>
+#include <barrett/systems/telemetry_publisher.h>
+
+
+namespace {
+using namespace barrett;
+
+
+typedef math::Vector<3>::type v_type;
+
+
+TEST(TelemetryPublisherTest, PublishesEveryCycle) {
+	const std::string name = "bt-telemetry-publisher-test-" + boost::lexical_cast<std::string>(getpid());
+	const double T_s = 0.002;
+
+	systems::ManualExecutionManager mem(T_s);
+	systems::ExposedOutput<v_type> eo;
+	systems::TelemetryPublisher<v_type> tp(NULL, name, "jp", 16);
+	tp.setRateDivisor(2);
+	mem.startManaging(tp);
+
+	log::TelemetryReader tr(name);
+	EXPECT_EQ("jp", tr.getSchema().field(0).name);
+	EXPECT_EQ(2 * T_s, tr.getSchema().getSamplePeriod());
+
+	// Nothing is published while the input is undefined.
+	mem.runExecutionCycle();
+	EXPECT_EQ(0u, tr.numAvailable());
+
+	systems::connect(eo.output, tp.input);
+	v_type v;
+	for (int i = 0; i < 10; ++i) {
+		eo.setValue(v_type(1.0 * i, -1.0 * i, 0.5 * i));
+		mem.runExecutionCycle();
+	}
+	EXPECT_EQ(5u, tr.numAvailable());
+
+	// Every other cycle, starting wherever the rate divisor's phase falls
+	ASSERT_TRUE(tr.read(&v));
+	int first = static_cast<int>(v[0]);
+	EXPECT_LT(first, 2);
+	for (int i = first; i < 10; i += 2) {
+		EXPECT_EQ(v_type(1.0 * i, -1.0 * i, 0.5 * i), v);
+		if (i + 2 < 10) {
+			ASSERT_TRUE(tr.read(&v));
+		}
+	}
+	EXPECT_FALSE(tr.read(&v));
+}
+
+
+}
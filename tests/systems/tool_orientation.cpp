@@ -100,7 +100,7 @@ TEST(ToolOrientationTest, Blah2) {
 	gsl_vector_set(con->ref_quat, 2, -0.528556);
 	gsl_vector_set(con->ref_quat, 3, -0.496962);
 
-	bt_control_eval(&con->base, jt.asGslType(), 0.002);
+	bt_control_eval(&con->base, jt.asGslType().get(), 0.002);
 
 
 	bt_control_cartesian_xyz_q_destroy(con);
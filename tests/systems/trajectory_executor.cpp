@@ -0,0 +1,176 @@
+/*
+ * trajectory_executor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <gtest/gtest.h>
+
+#include <barrett/systems/manual_execution_manager.h>
+#include <barrett/systems/trajectory_executor.h>
+
+#include "exposed_io_system.h"
+
+
+namespace {
+using namespace barrett;
+
+
+const double T_s = 0.001;
+typedef systems::TrajectoryExecutor<double> te_type;
+
+// Moves linearly from start to end over duration seconds.
+class LineSegment : public te_type::Segment {
+public:
+	LineSegment(double start, double end, double duration, int* liveCount = NULL) :
+		start(start), end(end), duration(duration), liveCount(liveCount)
+	{
+		if (liveCount != NULL) {
+			++(*liveCount);
+		}
+	}
+	virtual ~LineSegment() {
+		if (liveCount != NULL) {
+			--(*liveCount);
+		}
+	}
+
+	virtual double finalT() const { return duration; }
+	virtual double eval(double t) const { return start + (end - start) * t / duration; }
+
+protected:
+	double start, end, duration;
+	int* liveCount;
+};
+
+class TrajectoryExecutorTest : public ::testing::Test {
+public:
+	TrajectoryExecutorTest() :
+		mem(T_s), te(4)
+	{
+		mem.startManaging(eios);
+		systems::connect(te.output, eios.input);
+	}
+
+	// ExposedIOSystem doesn't read its input during operate(), so pull the
+	// executor's output explicitly to make sure it is updated every cycle.
+	void runCycles(int n) {
+		for (int i = 0; i < n; ++i) {
+			mem.runExecutionCycle();
+			eios.inputValueDefined();
+		}
+	}
+
+protected:
+	systems::ManualExecutionManager mem;
+	te_type te;
+	ExposedIOSystem<double> eios;
+};
+
+
+TEST_F(TrajectoryExecutorTest, OutputUndefinedUntilFirstSegment) {
+	EXPECT_TRUE(te.isDone());
+	runCycles(5);
+	EXPECT_FALSE(eios.inputValueDefined());
+}
+
+TEST_F(TrajectoryExecutorTest, FollowsSegmentThenHolds) {
+	ASSERT_TRUE(te.enqueue(new LineSegment(1.0, 2.0, 10 * T_s)));
+	EXPECT_FALSE(te.isDone());
+
+	for (int i = 0; i <= 10; ++i) {
+		runCycles(1);
+		EXPECT_NEAR(1.0 + i * 0.1, eios.getInputValue(), 1e-9);
+	}
+	runCycles(1);
+	EXPECT_TRUE(te.isDone());
+
+	runCycles(5);
+	EXPECT_DOUBLE_EQ(2.0, eios.getInputValue());
+
+	double end;
+	EXPECT_FALSE(te.getEnd(&end));
+}
+
+TEST_F(TrajectoryExecutorTest, ReplaceSwitchesImmediately) {
+	te.enqueue(new LineSegment(0.0, 1.0, 1.0));
+	runCycles(5);
+	EXPECT_NEAR(4 * T_s, eios.getInputValue(), 1e-9);
+
+	te.enqueue(new LineSegment(-5.0, -6.0, 1.0), te_type::REPLACE);
+	runCycles(1);
+	EXPECT_DOUBLE_EQ(-5.0, eios.getInputValue());
+	EXPECT_EQ(1u, te.getNumOutstanding());
+}
+
+TEST_F(TrajectoryExecutorTest, QueuedSegmentsRunBackToBack) {
+	te.enqueue(new LineSegment(0.0, 1.0, 5 * T_s));
+	te.enqueue(new LineSegment(1.0, 3.0, 5 * T_s), te_type::QUEUE);
+
+	double end = 0.0;
+	EXPECT_TRUE(te.getEnd(&end));
+	EXPECT_EQ(3.0, end);
+
+	runCycles(6);
+	EXPECT_NEAR(1.0, eios.getInputValue(), 1e-9);
+	runCycles(1);
+	EXPECT_NEAR(1.4, eios.getInputValue(), 1e-9);
+	EXPECT_EQ(1u, te.getNumOutstanding());
+
+	runCycles(10);
+	EXPECT_TRUE(te.isDone());
+	EXPECT_DOUBLE_EQ(3.0, eios.getInputValue());
+}
+
+TEST_F(TrajectoryExecutorTest, BlendedSegmentsAreContinuous) {
+	te.enqueue(new LineSegment(0.0, 1.0, 100 * T_s));
+	te.enqueue(new LineSegment(1.0, 0.0, 100 * T_s), te_type::BLEND, 20 * T_s);
+
+	runCycles(1);
+	double prev = eios.getInputValue();
+	double maxStep = 0.0;
+	for (int i = 0; i < 250; ++i) {
+		runCycles(1);
+		maxStep = std::max(maxStep, std::abs(eios.getInputValue() - prev));
+		prev = eios.getInputValue();
+	}
+
+	// Without blending the output would turn around exactly at 1.0.
+	EXPECT_LT(maxStep, 0.02);
+	EXPECT_TRUE(te.isDone());
+	EXPECT_DOUBLE_EQ(0.0, eios.getInputValue());
+}
+
+TEST_F(TrajectoryExecutorTest, RefusesSegmentsPastCapacity) {
+	int liveCount = 0;
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_TRUE(te.enqueue(new LineSegment(0.0, 1.0, 1.0, &liveCount), te_type::QUEUE));
+	}
+	LineSegment extra(0.0, 1.0, 1.0);
+	EXPECT_FALSE(te.enqueue(&extra, te_type::QUEUE));
+
+	// There is always room for a REPLACE. Replaced Segments are freed by the
+	// next call to enqueue().
+	EXPECT_TRUE(te.enqueue(new LineSegment(0.0, 1.0, 1.0, &liveCount), te_type::REPLACE));
+	runCycles(1);
+	EXPECT_EQ(1u, te.getNumOutstanding());
+	EXPECT_TRUE(te.enqueue(new LineSegment(0.0, 1.0, 1.0, &liveCount), te_type::QUEUE));
+	EXPECT_EQ(2, liveCount);
+}
+
+TEST_F(TrajectoryExecutorTest, DisconnectingAbandonsSegments) {
+	te.enqueue(new LineSegment(0.0, 1.0, 1.0));
+	runCycles(3);
+	EXPECT_FALSE(te.isDone());
+
+	systems::disconnect(eios.input);
+	EXPECT_TRUE(te.isDone());
+
+	// The stale hold value must not reappear when reconnected.
+	systems::connect(te.output, eios.input);
+	runCycles(1);
+	EXPECT_FALSE(eios.inputValueDefined());
+}
+
+
+}
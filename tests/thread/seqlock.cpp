@@ -0,0 +1,85 @@
+/*
+ * seqlock.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/thread.hpp>
+
+#include <gtest/gtest.h>
+
+#include <barrett/thread/seqlock.h>
+
+
+namespace {
+using namespace barrett;
+
+
+struct Record {
+	static const int SIZE = 32;
+
+	Record() { set(0); }
+	void set(int n) {
+		for (int i = 0; i < SIZE; ++i) {
+			data[i] = n;
+		}
+	}
+	bool isConsistent() const {
+		for (int i = 1; i < SIZE; ++i) {
+			if (data[i] != data[0]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int data[SIZE];
+};
+
+
+TEST(SeqLockTest, StartsUnwritten) {
+	thread::SeqLock<int> sl(42);
+	EXPECT_FALSE(sl.hasBeenWritten());
+	EXPECT_EQ(0u, sl.getNumWrites());
+	EXPECT_EQ(42, sl.read());
+}
+
+TEST(SeqLockTest, ReadReturnsLastWrite) {
+	thread::SeqLock<int> sl;
+	for (int i = 1; i <= 10; ++i) {
+		sl.write(i);
+		EXPECT_EQ(i, sl.read());
+		EXPECT_EQ((unsigned int) i, sl.getNumWrites());
+	}
+	EXPECT_TRUE(sl.hasBeenWritten());
+}
+
+
+void writeRecords(thread::SeqLock<Record>* sl, int n) {
+	Record r;
+	for (int i = 1; i <= n; ++i) {
+		r.set(i);
+		sl->write(r);
+	}
+}
+
+TEST(SeqLockTest, ConcurrentReadsAreNeverTorn) {
+	const int NUM_WRITES = 200000;
+
+	thread::SeqLock<Record> sl;
+	boost::thread writer(writeRecords, &sl, NUM_WRITES);
+
+	Record r;
+	int last = 0;
+	do {
+		sl.read(&r);
+		ASSERT_TRUE(r.isConsistent());
+		ASSERT_LE(last, r.data[0]);  // values are never stale
+		last = r.data[0];
+	} while (last != NUM_WRITES);
+
+	writer.join();
+}
+
+
+}